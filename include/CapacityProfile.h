@@ -0,0 +1,74 @@
+/**
+ * @author Omar Chatila
+ * @file CapacityProfile.h
+ * @brief Leaf capacity of bucketed trees per size class
+ *
+ * A profile maps size classes (floor(log2(n))) to the leaf capacity that performed best for them. Profiles are
+ * recorded by the functions of CapacityTuner.h and can be stored in a text file with one "sizeClass capacity"
+ * pair per line.
+ */
+
+#ifndef QUADKDBENCH_CAPACITYPROFILE_H
+#define QUADKDBENCH_CAPACITYPROFILE_H
+
+#include <bits/stdc++.h>
+
+/**
+ * @brief Leaf capacity used when no profile is given, grows with log10(pointNumber)
+ * @param pointNumber number of points of the tree
+ * @return max(log10(pointNumber), 4)
+ */
+inline int defaultLeafCapacity(long pointNumber) {
+    return (int) std::max(std::log10((double) std::max(pointNumber, 1L)), 4.0);
+}
+
+/**
+ * @brief Best leaf capacity per size class
+ */
+class CapacityProfile {
+private:
+    std::map<int, int> capacities;   /**< Leaf capacity by size class */
+
+    /**
+     * @param pointNumber number of points
+     * @return size class of pointNumber, floor(log2(pointNumber))
+     */
+    static int sizeClass(long pointNumber);
+
+public:
+    /**
+     * @brief Stores capacity as the best leaf capacity for the size class of pointNumber
+     * @param pointNumber number of points the capacity was measured with
+     * @param capacity best leaf capacity
+     */
+    void record(long pointNumber, int capacity);
+
+    /**
+     * @brief Leaf capacity for a tree of pointNumber points
+     *
+     * Uses the recorded size class closest to the one of pointNumber, defaultLeafCapacity() if nothing is recorded
+     * @param pointNumber number of points of the tree
+     * @return leaf capacity
+     */
+    [[nodiscard]] int capacityFor(long pointNumber) const;
+
+    /**
+     * @return True if no size class is recorded
+     */
+    [[nodiscard]] bool empty() const;
+
+    /**
+     * @brief Writes one "sizeClass capacity" line per recorded size class
+     * @param os The output stream
+     */
+    void save(std::ostream &os) const;
+
+    /**
+     * @brief Reads a profile written by save()
+     * @param is The input stream
+     * @return profile containing all size classes of is
+     */
+    static CapacityProfile load(std::istream &is);
+};
+
+#endif //QUADKDBENCH_CAPACITYPROFILE_H
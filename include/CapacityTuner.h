@@ -0,0 +1,67 @@
+/**
+ * @author Omar Chatila
+ * @file CapacityTuner.h
+ * @brief Sweeps the leaf capacity of the bucketed trees and records the fastest setting per size class
+ *
+ * For every size, a tree is built with each candidate capacity and the workload is timed on it. The capacity with
+ * the lowest time (best of several repetitions) is recorded in a CapacityProfile for the size class of the size.
+ */
+
+#ifndef QUADKDBENCH_CAPACITYTUNER_H
+#define QUADKDBENCH_CAPACITYTUNER_H
+
+#include "Util.h"
+#include "CapacityProfile.h"
+#include "Workload.h"
+#include <bits/stdc++.h>
+
+/**
+ * @brief Operation whose running time is minimized
+ */
+enum TuningWorkload {
+    BUILD,                  /**< Building the tree */
+    RANGE_QUERY_SMALL,      /**< Range queries covering 0.1% of the area */
+    RANGE_QUERY_MEDIUM,     /**< Range queries covering 1% of the area */
+    RANGE_QUERY_LARGE,      /**< Range queries covering 10% of the area */
+    CONTAINS,               /**< Lookups of contained points */
+    KNN                     /**< 10-nearest-neighbor searches */
+};
+
+/**
+ * @brief Parameters of a capacity sweep
+ */
+struct TuningOptions {
+    std::vector<int> sizes{1 << 14, 1 << 16, 1 << 18, 1 << 20};          /**< Numbers of points, one per size class */
+    std::vector<int> capacities{4, 8, 16, 32, 64, 128, 256};           /**< Candidate leaf capacities */
+    int repetitions = 3;                                                /**< Timed runs per candidate, best counts */
+    int operations = 1000;                                              /**< Queries per run of a query workload */
+    uint64_t seed = WORKLOAD_SEED;                                      /**< Seed of points and queries */
+};
+
+/**
+ * @param workload workload
+ * @return lower case name of workload, used in file names of profiles
+ */
+std::string workloadName(TuningWorkload workload);
+
+/**
+ * @brief Finds the fastest leaf capacity of KDBTreeEfficient for every size of options
+ * @param workload workload that is timed
+ * @param distribution distribution of the points
+ * @param options sizes, candidates and repetitions
+ * @return profile with one entry per size
+ */
+CapacityProfile tuneKDBTreeCapacity(TuningWorkload workload, PointDistribution distribution,
+                                    const TuningOptions &options = TuningOptions());
+
+/**
+ * @brief Finds the fastest leaf capacity of PointRegionQuadTree for every size of options
+ * @param workload workload that is timed
+ * @param distribution distribution of the points
+ * @param options sizes, candidates and repetitions
+ * @return profile with one entry per size
+ */
+CapacityProfile tunePRQuadTreeCapacity(TuningWorkload workload, PointDistribution distribution,
+                                       const TuningOptions &options = TuningOptions());
+
+#endif //QUADKDBENCH_CAPACITYTUNER_H
@@ -0,0 +1,230 @@
+/**
+ * @author Omar Chatila
+ * @file CompressedQuadTree.h
+ * @brief Implementation of a path-compressed Point-Region-QuadTree with counted duplicates
+ *
+ * Equal points are stored once together with their multiplicity, so duplicates never force a split.
+ * Before a node is split, its square shrinks to the smallest Quadtree cell enclosing all its points.
+ * Chains of subdivisions with a single non-empty child are skipped, every inner node has at least
+ * two non-empty children. The number of nodes and the height are bounded by the number of distinct points.
+ */
+
+#ifndef QUADKDBENCH_COMPRESSEDQUADTREE_H
+#define QUADKDBENCH_COMPRESSEDQUADTREE_H
+
+#include "Util.h"
+#include "KNNScratch.h"
+#include <bits/stdc++.h>
+
+/**
+ * @brief A point together with the number of times it was inserted
+ */
+struct CountedPoint {
+    Point point;   /**< The point */
+    int count;     /**< Multiplicity of the point */
+};
+
+/**
+ * @brief A class representing a path-compressed QuadTree data structure.
+ */
+class CompressedQuadTree {
+    /**
+     * @brief Overloaded << operator to stream the QuadTree information.
+     * @param os The output stream.
+     * @param quadTree The QuadTree instance to be streamed.
+     * @return The output stream.
+     */
+    friend std::ostream &operator<<(std::ostream &os, const CompressedQuadTree &quadTree) {
+        os << std::fixed << std::setprecision(1);
+        return os << "A:" << quadTree.square << "n:" << quadTree.size << "\n";
+    }
+
+private:
+    CompressedQuadTree *children[4]{};  /**< Pointers to the 4 children, nullptr for empty quadrants */
+    Area square{};                      /**< The area covered by the QuadTree node. */
+    vector<CountedPoint> entries;       /**< Distinct points of a leaf, empty for inner nodes */
+    int capacity;                       /**< Maximum number of distinct points in a leaf */
+    long size;                          /**< Number of points in the subtree, duplicates included */
+
+    /**
+     * @brief Constructs a QuadTree node with already grouped duplicates
+     * @param square The square area covered by the node
+     * @param entries distinct points and their multiplicities
+     * @param capacity Maximum number of distinct points in a leaf
+     */
+    CompressedQuadTree(Area square, vector<CountedPoint> &&entries, int capacity);
+
+    /**
+     * @brief Shrinks the square to the smallest Quadtree cell containing all entries
+     */
+    void compress();
+
+    /**
+     * @brief Distributes the entries into the 4 quadrants and creates a child for each non-empty quadrant
+     */
+    void subdivide();
+
+    /**
+     * @brief Reports all points of this subtree to sink, duplicates are reported count times
+     * @param sink callable taking a Point or output iterator
+     */
+    template<typename Sink>
+    void reportAll(Sink &sink);
+
+    /**
+     * @brief Helper method for query(Area &, Sink). Reports the points of this subtree inside queryRectangle
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param sink callable taking a Point or output iterator
+     */
+    template<typename Sink>
+    void queryHelper(Area &queryRectangle, Sink &sink);
+
+    /**
+     * @brief Helper method for kNearestNeighbors. Offers the points of this subtree to the candidate heap
+     *
+     * Visits the children in order of increasing distance of their squares to queryPoint and skips children
+     * that are farther away than the current k-th best candidate
+     *
+     * @param queryPoint The point of which the k nearest neighbors are determined
+     * @param scratch Candidate heap of the running search
+     */
+    void kNearestNeighborsHelper(const Point &queryPoint, KNNScratch &scratch);
+
+public:
+    /**
+     * @brief Constructs a QuadTree with the specified square area and elements. Equal points are grouped
+     * @param square The square area covered by the QuadTree.
+     * @param elements The vector of points contained in the QuadTree, may contain duplicates
+     * @param capacity Maximum number of distinct points in a leaf
+     */
+    CompressedQuadTree(Area square, vector<Point> &elements, int capacity = 1);
+
+    /**
+     * @brief destroys the Quadtree and deallocates memory
+     */
+    ~CompressedQuadTree();
+
+    /**
+     * @brief Builds the Quadtree
+     *
+     * Splits as long as a node contains more than capacity distinct points, empty quadrants get no child
+     */
+    void buildTree();
+
+    /**
+     * @brief Checks if a node is a leaf
+     * @return True if node is leaf, false otherwise
+     */
+    [[nodiscard]] bool isNodeLeaf() const;
+
+    /**
+     * @brief Calculates height of the Quadtree
+     * @return The height of the Quadtree
+     */
+    int getHeight();
+
+    /**
+     * @brief Checks if a given point is contained by the Quadtree
+     * @param point
+     * @return True if Quadtree contains point, false otherwise
+     */
+    bool contains(Point &point);
+
+    /**
+     * @brief Determines how often a point was inserted
+     * @param point
+     * @return multiplicity of point, 0 if the Quadtree does not contain it
+     */
+    int multiplicity(Point &point);
+
+    /**
+     * @param queryRectangle Rectangle that contains points of interest
+     * @return list<Point> of points contained by queryRectangle, duplicates included
+     */
+    list<Point> query(Area &queryRectangle);
+
+    /**
+     * @brief Reports every point contained by queryRectangle to sink, duplicates are reported count times
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param sink callable taking a Point or output iterator
+     * @return sink after all points have been reported
+     */
+    template<typename Sink>
+    Sink query(Area &queryRectangle, Sink sink);
+
+    /**
+     * @brief Appends the points contained by queryRectangle to result
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param result vector that is reused between queries, it is not cleared
+     */
+    void query(Area &queryRectangle, vector<Point> &result);
+
+    /**
+     * @brief Counts the points contained by queryRectangle, duplicates included
+     * @param queryRectangle Rectangle that contains points of interest
+     * @return number of points inside queryRectangle
+     */
+    long count(Area &queryRectangle);
+
+    /**
+     * Get k nearest neighbors of a query point, a duplicate may occur several times
+     * @param queryPoint The point of which the k nearest neighbors are determined
+     * @param k The number of neighbors
+     * @return vector containing k nearest neighbors of queryPoint
+     */
+    vector<Point> kNearestNeighbors(Point &queryPoint, int k);
+
+    /**
+     * Get k nearest neighbors of a query point without allocating
+     * @param queryPoint The point of which the k nearest neighbors are determined
+     * @param k The number of neighbors
+     * @param scratch Candidate heap that is reused between queries
+     * @param result vector that is overwritten with the k nearest neighbors, ordered by distance
+     */
+    void kNearestNeighbors(Point &queryPoint, int k, KNNScratch &scratch, vector<Point> &result);
+};
+
+
+template<typename Sink>
+Sink CompressedQuadTree::query(Area &queryRectangle, Sink sink) {
+    queryHelper(queryRectangle, sink);
+    return sink;
+}
+
+template<typename Sink>
+void CompressedQuadTree::reportAll(Sink &sink) {
+    for (auto &entry: this->entries) {
+        for (int i = 0; i < entry.count; i++) {
+            emitPoint(sink, entry.point);
+        }
+    }
+    for (auto child: this->children) {
+        if (child != nullptr) {
+            child->reportAll(sink);
+        }
+    }
+}
+
+template<typename Sink>
+void CompressedQuadTree::queryHelper(Area &queryRectangle, Sink &sink) {
+    if (containsArea(queryRectangle, this->square)) {
+        reportAll(sink);
+        return;
+    } else if (this->isNodeLeaf()) {
+        for (auto &entry: this->entries) {
+            if (containsPoint(queryRectangle, entry.point)) {
+                for (int i = 0; i < entry.count; i++) {
+                    emitPoint(sink, entry.point);
+                }
+            }
+        }
+        return;
+    }
+    for (auto child: this->children) {
+        if (child != nullptr && intersects(queryRectangle, child->square)) {
+            child->queryHelper(queryRectangle, sink);
+        }
+    }
+}
+
+#endif //QUADKDBENCH_COMPRESSEDQUADTREE_H
@@ -0,0 +1,175 @@
+/**
+ * @author Omar Chatila
+ * @file ConcurrentPRQuadTree.h
+ * @brief Implementation of a Point-Region-QuadTree that accepts insertions from many threads
+ *
+ * A leaf bucket is a fixed array of slots. Writers reserve a slot with an atomic counter and mark it as ready
+ * once the point is stored. A full leaf is split by building its 4 children privately and publishing them with
+ * a single compare-and-swap on the children pointer, the thread losing the race discards its children.
+ * Nodes are never removed, so readers running contains() and query() never block and never see a node
+ * disappear. Points of a square too small to be split are pushed to a lock-free overflow list of the leaf.
+ */
+
+#ifndef QUADKDBENCH_CONCURRENTPRQUADTREE_H
+#define QUADKDBENCH_CONCURRENTPRQUADTREE_H
+
+#include "Util.h"
+#include <atomic>
+#include <memory>
+#include <bits/stdc++.h>
+
+/**
+ * @brief A class representing a Point-Region-QuadTree with concurrent insertion.
+ */
+class ConcurrentPRQuadTree {
+private:
+    /**
+     * @brief The 4 children of a split node, published together
+     */
+    struct Children {
+        ConcurrentPRQuadTree *quadrants[4]{};   /**< Children indexed by Quadrant */
+    };
+
+    /**
+     * @brief Entry of the overflow list of an unsplittable leaf
+     */
+    struct OverflowEntry {
+        Point point;                 /**< The stored point */
+        OverflowEntry *next;         /**< Entry pushed before this one */
+    };
+
+    Area square{};                                 /**< The area covered by the QuadTree node. */
+    int capacity;                                  /**< Number of slots of a leaf */
+    std::unique_ptr<Point[]> slots;                /**< Points of the leaf */
+    std::unique_ptr<std::atomic<bool>[]> ready;    /**< ready[i] is set once slots[i] holds its point */
+    std::atomic<int> reserved{0};                  /**< Number of reserved slots, may exceed capacity */
+    std::atomic<Children *> children{nullptr};     /**< Children of the node, nullptr for leaves */
+    std::atomic<OverflowEntry *> overflow{nullptr}; /**< Points that did not fit into an unsplittable leaf */
+
+    /**
+     * @brief Determines the child of this node containing point
+     * @param point point to be located
+     * @return quadrant index (0 to 3)
+     */
+    [[nodiscard]] int quadrantOf(const Point &point) const;
+
+    /**
+     * @return True if the square can be split into 4 smaller squares
+     */
+    [[nodiscard]] bool isSplittable() const;
+
+    /**
+     * @brief Builds the 4 children of a full leaf and publishes them unless another thread was faster
+     *
+     * Waits until the writers of all slots have stored their points
+     */
+    void split();
+
+    /**
+     * @brief Stores point in a free slot of a privately owned node
+     * @param point point to be stored
+     */
+    void store(const Point &point);
+
+    /**
+     * @brief Helper method for query(Area &, Sink). Reports the points of this subtree inside queryRectangle
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param sink callable taking a Point or output iterator
+     */
+    template<typename Sink>
+    void queryHelper(Area &queryRectangle, Sink &sink);
+
+public:
+    /**
+     * @brief Constructs an empty QuadTree
+     * @param square The square area covered by the QuadTree.
+     * @param capacity Capacity of a leaf
+     */
+    ConcurrentPRQuadTree(Area square, int capacity);
+
+    /**
+     * @brief destroys the Quadtree and deallocates memory. No thread may access the tree anymore
+     */
+    ~ConcurrentPRQuadTree();
+
+    ConcurrentPRQuadTree(const ConcurrentPRQuadTree &) = delete;
+
+    ConcurrentPRQuadTree &operator=(const ConcurrentPRQuadTree &) = delete;
+
+    /**
+     * @brief Adds a point to the Quadtree. Can be called by several threads at the same time
+     * @param point Point to be added
+     */
+    void add(const Point &point);
+
+    /**
+     * @brief Checks if a given point is contained by the Quadtree. Does not block concurrent insertions
+     * @param point
+     * @return True if Quadtree contains point, false otherwise
+     */
+    bool contains(Point &point);
+
+    /**
+     * @brief Calculates height of the Quadtree
+     * @return The height of the Quadtree
+     */
+    int getHeight();
+
+    /**
+     * @param queryRectangle Rectangle that contains points of interest
+     * @return list<Point> of points contained by queryRectangle
+     */
+    list<Point> query(Area &queryRectangle);
+
+    /**
+     * @brief Reports every point contained by queryRectangle to sink. Does not block concurrent insertions
+     *
+     * Points whose insertion has finished before the query started are always reported
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param sink callable taking a Point or output iterator
+     * @return sink after all points have been reported
+     */
+    template<typename Sink>
+    Sink query(Area &queryRectangle, Sink sink);
+
+    /**
+     * @brief Appends the points contained by queryRectangle to result
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param result vector that is reused between queries, it is not cleared
+     */
+    void query(Area &queryRectangle, vector<Point> &result);
+};
+
+
+template<typename Sink>
+Sink ConcurrentPRQuadTree::query(Area &queryRectangle, Sink sink) {
+    queryHelper(queryRectangle, sink);
+    return sink;
+}
+
+template<typename Sink>
+void ConcurrentPRQuadTree::queryHelper(Area &queryRectangle, Sink &sink) {
+    Children *current = this->children.load(std::memory_order_acquire);
+    if (current != nullptr) {
+        for (auto child: current->quadrants) {
+            if (intersects(queryRectangle, child->square)) {
+                child->queryHelper(queryRectangle, sink);
+            }
+        }
+        return;
+    }
+    // the slots of a split leaf stay unchanged, so a leaf split during the scan is still read consistently
+    int filled = min(this->reserved.load(std::memory_order_acquire), this->capacity);
+    for (int i = 0; i < filled; i++) {
+        if (this->ready[i].load(std::memory_order_acquire) && containsPoint(queryRectangle, this->slots[i])) {
+            emitPoint(sink, this->slots[i]);
+        }
+    }
+    for (auto entry = this->overflow.load(std::memory_order_acquire); entry != nullptr; entry = entry->next) {
+        if (containsPoint(queryRectangle, entry->point)) {
+            emitPoint(sink, entry->point);
+        }
+    }
+}
+
+#endif //QUADKDBENCH_CONCURRENTPRQUADTREE_H
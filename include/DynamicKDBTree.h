@@ -0,0 +1,152 @@
+/**
+ * @author Omar Chatila
+ * @file DynamicKDBTree.h
+ * @brief Dynamic KDB-Tree built with the logarithmic method (Bkd-Tree)
+ *
+ * New points are collected in a small buffer. Whenever the buffer is full, it is merged with the static
+ * KDBTreeEfficient forests of the lowest levels into one new forest, level i holds either nothing or exactly
+ * bufferCapacity * 2^i points. Every point is copied O(log(n)) times, so inserts take amortized O(log(n)^2),
+ * queries visit the buffer and at most log(n) static trees.
+ */
+
+#ifndef QUADKDBENCH_DYNAMICKDBTREE_H
+#define QUADKDBENCH_DYNAMICKDBTREE_H
+
+#include "Util.h"
+#include "KNNScratch.h"
+#include "KDBTreeEfficient.h"
+#include <bits/stdc++.h>
+
+/**
+ * @brief A class representing a KDB-Tree that supports insertions
+ */
+class DynamicKDBTree {
+private:
+    /**
+     * @brief Static forest of one level
+     */
+    struct Level {
+        Point *points{};             /**< Points of the forest, owned by the level */
+        int size = 0;                /**< Number of points, 0 if the level is empty */
+        KDBTreeEfficient *tree{};    /**< Tree built on points, nullptr if the level is empty */
+    };
+
+    Area area{};                     /**< The area covered by all trees */
+    int bufferCapacity;              /**< Number of points collected before they are merged into a tree */
+    int leafCapacity;                /**< Capacity of a leaf of the trees */
+    vector<Point> buffer;            /**< Points that are not in a tree yet */
+    vector<Level> levels;            /**< levels[i] holds 0 or bufferCapacity * 2^i points */
+    long size = 0;                   /**< Number of points */
+
+    /**
+     * @brief Merges the full buffer and all non-empty levels below the first empty one into a new tree
+     */
+    void merge();
+
+public:
+    /**
+     * @brief Constructs an empty tree
+     * @param area The area covered by the tree
+     * @param bufferCapacity Number of points collected before they are merged into a tree
+     * @param leafCapacity Capacity of a leaf of the trees
+     */
+    explicit DynamicKDBTree(Area area, int bufferCapacity = 1024, int leafCapacity = 8);
+
+    /**
+     * @brief destroys all trees and deallocates memory
+     */
+    ~DynamicKDBTree();
+
+    DynamicKDBTree(const DynamicKDBTree &) = delete;
+
+    DynamicKDBTree &operator=(const DynamicKDBTree &) = delete;
+
+    /**
+     * @brief Adds a given Point, takes amortized O(log(n)^2)
+     * @param point Point to be added
+     */
+    void add(const Point &point);
+
+    /**
+     * @brief Checks if a given point is contained by the buffer or one of the trees
+     * @param point
+     * @return True if the tree contains point, false otherwise
+     */
+    bool contains(Point &point);
+
+    /**
+     * @param queryRectangle Rectangle that contains points of interest
+     * @return list<Point> of points contained by queryRectangle
+     */
+    list<Point> query(Area &queryRectangle);
+
+    /**
+     * @brief Reports every point contained by queryRectangle to sink, the trees are queried one after another
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param sink callable taking a Point or output iterator
+     * @return sink after all points have been reported
+     */
+    template<typename Sink>
+    Sink query(Area &queryRectangle, Sink sink);
+
+    /**
+     * @brief Appends the points contained by queryRectangle to result
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param result vector that is reused between queries, it is not cleared
+     */
+    void query(Area &queryRectangle, vector<Point> &result);
+
+    /**
+     * @brief Counts the points contained by queryRectangle
+     * @param queryRectangle Rectangle that contains points of interest
+     * @return number of points inside queryRectangle
+     */
+    long count(Area &queryRectangle);
+
+    /**
+     * Get k nearest neighbors of a query point
+     * @param queryPoint The point of which the k nearest neighbors are determined
+     * @param k The number of neighbors
+     * @return vector containing k nearest neighbors of queryPoint
+     */
+    vector<Point> kNearestNeighbors(const Point &queryPoint, int k) const;
+
+    /**
+     * Get k nearest neighbors of a query point without allocating
+     *
+     * All trees share one candidate heap, so trees that are farther away than the k-th best candidate are pruned
+     * @param queryPoint The point of which the k nearest neighbors are determined
+     * @param k The number of neighbors
+     * @param scratch Candidate heap that is reused between queries
+     * @param result vector that is overwritten with the k nearest neighbors, ordered by distance
+     */
+    void kNearestNeighbors(const Point &queryPoint, int k, KNNScratch &scratch, vector<Point> &result) const;
+
+    /**
+     * @return number of points
+     */
+    [[nodiscard]] long getSize() const;
+
+    /**
+     * @return number of non-empty levels
+     */
+    [[nodiscard]] int getTreeCount() const;
+};
+
+
+template<typename Sink>
+Sink DynamicKDBTree::query(Area &queryRectangle, Sink sink) {
+    for (auto &point: this->buffer) {
+        if (containsPoint(queryRectangle, point)) {
+            emitPoint(sink, point);
+        }
+    }
+    for (auto &level: this->levels) {
+        if (level.tree != nullptr) {
+            sink = level.tree->query(queryRectangle, sink);
+        }
+    }
+    return sink;
+}
+
+#endif //QUADKDBENCH_DYNAMICKDBTREE_H
@@ -0,0 +1,84 @@
+/**
+ * @author Omar Chatila
+ * @file FrozenKDTree.h
+ * @brief Read-only KD-Tree for fast membership tests
+ *
+ * The tree is perfect: all 2^height leaves lie on the same level and hold at most capacity points. Split keys are
+ * stored in BFS (Eytzinger) order, node i has children 2i and 2i + 1. A key is a whole point compared
+ * lexicographically, the coordinate of the split axis first. So points equal to the key in the split coordinate
+ * have a fixed side and contains() descends without branches, i = 2i + (key < p), in exactly height steps. Every
+ * step prefetches the 4 keys of the grandchildren, which share one cache line.
+ */
+
+#ifndef QUADKDBENCH_FROZENKDTREE_H
+#define QUADKDBENCH_FROZENKDTREE_H
+
+#include "Util.h"
+#include <bits/stdc++.h>
+
+/**
+ * @brief Split key of an inner node, primary is the coordinate of the split axis, secondary the other one
+ */
+struct alignas(16) FrozenSplitKey {
+    double primary;
+    double secondary;
+};
+
+class FrozenKDTree {
+private:
+    FrozenSplitKey *keys = nullptr;     /**< Keys in BFS order, index 0 is unused, 64 byte aligned */
+    vector<Point> points;               /**< Points in leaf order */
+    int height = 0;                     /**< Number of inner levels, the leaves are nodes 2^height .. 2^(height+1)-1 */
+
+    /**
+     * @brief Partitions points[from, to) and records the keys of the subtree rooted at node
+     * @param node BFS index
+     * @param level depth of node, the split axis is x on even levels
+     * @param firstLeaf index of the first leaf below node
+     * @param leafCount number of leaves below node
+     */
+    void buildTree(size_t node, int level, size_t firstLeaf, size_t leafCount);
+
+    /**
+     * @return index of the first point of leaf, points of leaf j are [leafStart(j), leafStart(j + 1))
+     */
+    [[nodiscard]] size_t leafStart(size_t leaf) const;
+
+public:
+    /**
+     * @brief Builds the frozen tree on a copy of points
+     * @param points the points, not changed
+     * @param size number of points
+     * @param capacity maximum number of points of a leaf
+     */
+    FrozenKDTree(const Point *points, int size, int capacity);
+
+    FrozenKDTree(const FrozenKDTree &) = delete;
+
+    FrozenKDTree &operator=(const FrozenKDTree &) = delete;
+
+    FrozenKDTree(FrozenKDTree &&other) noexcept;
+
+    FrozenKDTree &operator=(FrozenKDTree &&other) noexcept;
+
+    ~FrozenKDTree();
+
+    /**
+     * Checks if given point is contained by the tree
+     * @param point
+     * @return True if the tree contains point, false otherwise
+     */
+    [[nodiscard]] bool contains(const Point &point) const;
+
+    /**
+     * @return number of inner levels
+     */
+    [[nodiscard]] int getHeight() const;
+
+    /**
+     * @return number of points
+     */
+    [[nodiscard]] long size() const;
+};
+
+#endif //QUADKDBENCH_FROZENKDTREE_H
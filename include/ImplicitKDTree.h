@@ -0,0 +1,178 @@
+/**
+ * @author Omar Chatila
+ * @file ImplicitKDTree.h
+ * @brief Implementation of a pointer-free KD-Tree
+ *
+ * Static KD-Tree without node objects. The tree is left-balanced (complete), so with n points
+ * node i has children 2i and 2i + 1, interior nodes are 1 .. n-1 and leaves are n .. 2n-1.
+ * Only the split values are stored, in BFS (Eytzinger) order. The points array is partitioned
+ * in place such that every subtree covers a contiguous range of it.
+ * Building the tree in O(nlog(n))
+ */
+
+#ifndef QUADKDBENCH_IMPLICITKDTREE_H
+#define QUADKDBENCH_IMPLICITKDTREE_H
+
+#include "Util.h"
+#include <bits/stdc++.h>
+
+using namespace std;
+
+class ImplicitKDTree {
+private:
+    Point *points;              /**< The array of points, partitioned in leaf order. */
+    Area area{};                /**< The area covered by the KD-Tree. */
+    int size;                   /**< Number of points */
+    int deepestLevel;           /**< BFS index of the first node on the deepest level */
+    vector<double> splits;      /**< Split values of the interior nodes in BFS order, index 0 is unused */
+
+    /**
+     * @brief Maps the BFS index of a leaf to the position of its point
+     *
+     * Leaves on the deepest level come first in the points array, followed by the leaves one level above
+     * @param node BFS index of a leaf
+     * @return index into the points array
+     */
+    [[nodiscard]] int leafPosition(int node) const;
+
+    /**
+     * @brief Position of the first point of the subtree rooted at node
+     * @param node BFS index
+     * @return lower bound of the points range (inclusive)
+     */
+    [[nodiscard]] int firstPoint(int node) const;
+
+    /**
+     * @brief Position of the last point of the subtree rooted at node
+     * @param node BFS index
+     * @return upper bound of the points range (inclusive)
+     */
+    [[nodiscard]] int lastPoint(int node) const;
+
+    /**
+     * @brief private helper function to build the KD-Tree
+     *
+     * Uses level parameter to determine whether to split on X or Y-axis
+     * @param node BFS index of the current node
+     * @param level current level
+     * @param from lower bound of point array
+     * @param to upper bound of point array
+     */
+    void buildTree(int node, int level, int from, int to);
+
+    /**
+     * @brief Checks if the subtree rooted at node contains the point
+     *
+     * Points equal to a split value may lie on both sides, in that case both subtrees are searched
+     * @param node BFS index of the current node
+     * @param level current level
+     * @param point point to look for
+     * @return True if subtree contains point, false otherwise
+     */
+    bool containsHelper(int node, int level, const Point &point) const;
+
+    /**
+     * @brief Reports points of the subtree rooted at node that are contained by queryRectangle to sink
+     * @param node BFS index of the current node
+     * @param level current level
+     * @param cell area covered by the node
+     * @param from lower bound of point array
+     * @param to upper bound of point array
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param sink callable taking a Point or output iterator
+     */
+    template<typename Sink>
+    void queryHelper(int node, int level, Area &cell, int from, int to, Area &queryRectangle, Sink &sink) const;
+
+public:
+    /**
+     * @Brief Constructor for the whole tree. Uses x-coordinate as split coordinate at the root
+     * @param points array of points, rearranged by buildTree()
+     * @param area containing all points
+     * @param size number of points
+     */
+    ImplicitKDTree(Point *points, Area &area, int size);
+
+    /**
+     * @brief Builds the KD-Tree by partitioning the points array and recording the split values
+     */
+    void buildTree();
+
+    /**
+     * Checks if given point is contained by the KD-Tree
+     * @param point
+     * @return True if KD-Tree contains point, false otherwise
+     */
+    bool contains(Point p) const;
+
+    /**
+     * @param queryRectangle Rectangle that contains points of interest
+     * @return list<Point> of points contained by queryRectangle
+     */
+    list<Point> query(Area queryArea) const;
+
+    /**
+     * @brief Reports every point contained by queryRectangle to sink, no intermediate lists are built
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param sink callable taking a Point or output iterator
+     * @return sink after all points have been reported
+     */
+    template<typename Sink>
+    Sink query(Area &queryRectangle, Sink sink) const;
+
+    /**
+     * @brief Appends the points contained by queryRectangle to result
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param result vector that is reused between queries, it is not cleared
+     */
+    void query(Area &queryRectangle, vector<Point> &result) const;
+
+    /**
+     * @brief Calculates height of the KD-Tree
+     * @return The height of the KD-Tree
+     */
+    [[nodiscard]] int getHeight() const;
+
+    /**
+     * @return array of points the tree was built on, in tree order
+     */
+    Point *getPoints();
+};
+
+template<typename Sink>
+Sink ImplicitKDTree::query(Area &queryRectangle, Sink sink) const {
+    if (size > 0) {
+        Area cell = this->area;
+        queryHelper(1, 0, cell, 0, size - 1, queryRectangle, sink);
+    }
+    return sink;
+}
+
+template<typename Sink>
+void ImplicitKDTree::queryHelper(int node, int level, Area &cell, int from, int to, Area &queryRectangle,
+                                 Sink &sink) const {
+    if (node >= size) {
+        if (containsPoint(queryRectangle, this->points[from])) {
+            emitPoint(sink, this->points[from]);
+        }
+        return;
+    } else if (containsArea(queryRectangle, cell)) {
+        emitPoints(sink, this->points + from, this->points + to + 1);
+        return;
+    }
+
+    double split = splits[node];
+    int midIndex = lastPoint(2 * node);
+    Area leftCell = level % 2 == 0 ? Area{cell.xMin, split, cell.yMin, cell.yMax}
+                                   : Area{cell.xMin, cell.xMax, cell.yMin, split};
+    Area rightCell = level % 2 == 0 ? Area{split, cell.xMax, cell.yMin, cell.yMax}
+                                    : Area{cell.xMin, cell.xMax, split, cell.yMax};
+    if (intersects(queryRectangle, leftCell)) {
+        queryHelper(2 * node, level + 1, leftCell, from, midIndex, queryRectangle, sink);
+    }
+    if (intersects(queryRectangle, rightCell)) {
+        queryHelper(2 * node + 1, level + 1, rightCell, midIndex + 1, to, queryRectangle, sink);
+    }
+}
+
+#endif //QUADKDBENCH_IMPLICITKDTREE_H
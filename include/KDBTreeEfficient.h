@@ -6,73 +6,187 @@
 #define QUADKDBENCH_KDBTreeEfficient_H
 
 #include "Util.h"
+#include "WorkStealingPool.h"
+#include "KNNScratch.h"
+#include "NodeArena.h"
+#include "CapacityProfile.h"
+#include "LeafScan.h"
+#include "FrozenKDTree.h"
 #include <bits/stdc++.h>
 
 using namespace std;
 
-class KDBTreeEfficient {
-
-    struct CompareKDBTree {
-        const Point &queryPoint;
-
-        explicit CompareKDBTree(const Point &p) : queryPoint(p) {}
-
-        bool operator()(KDBTreeEfficient *a, KDBTreeEfficient *b) const {
-            return sqDistanceFrom(a->area, queryPoint) > sqDistanceFrom(b->area, queryPoint);
-        }
-    };
+// KDB-Tree on points with coordinates of type T (double, float or int32_t)
+template<typename T>
+class BasicKDBTreeEfficient {
+public:
+    using PointType = BasicPoint<T>;
+    using AreaType = BasicArea<T>;
+    using Scratch = BasicKNNScratch<T>;
 
-    friend std::ostream &operator<<(std::ostream &os, const KDBTreeEfficient &KDBTreeEfficient) {
+private:
+    friend std::ostream &operator<<(std::ostream &os, const BasicKDBTreeEfficient &KDBTreeEfficient) {
         os << std::fixed << std::setprecision(1);
 
         return os << "A:" << KDBTreeEfficient.area << "f:" << KDBTreeEfficient.from << "t:" << KDBTreeEfficient.to
-                  << "xMed" << std::max(KDBTreeEfficient.xMedian, 0.0) << "yMed"
-                  << std::max(KDBTreeEfficient.yMedian, 0.0) << "\n";
+                  << "xMed" << std::max<T>(KDBTreeEfficient.xMedian, 0) << "yMed"
+                  << std::max<T>(KDBTreeEfficient.yMedian, 0) << "\n";
     }
 
-private:
-    Point *points;
-    Area area{};
+    // searches all trees of its forest with one candidate heap
+    friend class DynamicKDBTree;
+
+    // the LeafScan kernels compare doubles, trees of other coordinate types scan their leaves point by point
+    static constexpr bool LEAF_SCAN = std::is_same_v<T, double>;
+
+    PointType *points;
+    AreaType area{};
     int from, to;
     int capacity;
-    KDBTreeEfficient *leftChild{};
-    KDBTreeEfficient *rightChild{};
-    double xMedian, yMedian;
+    BasicKDBTreeEfficient *leftChild{};
+    BasicKDBTreeEfficient *rightChild{};
+    T xMedian, yMedian;
+    Aggregate *summary{};
+    BasicWeightFunction<T> weight{};
+    NodeArena *arena{};
+    double *xs{};               // x coordinates in the order of points, nullptr until buildColumns()
+    double *ys{};               // y coordinates in the order of points
+    bool ownsColumns = false;   // set for the node that allocated xs and ys
+
+    BasicKDBTreeEfficient(PointType *points, int level, AreaType &area, int from, int to, int capacity,
+                          T medianValue);
+
+    // median of the split coordinate, leaves are not split and skip the selection
+    static T splitValue(PointType *points, int level, int from, int to, int capacity);
 
     void buildTree(int level);
 
+    void buildTree(int level, WorkStealingPool &pool);
+
+    void setChildren(int level, WorkStealingPool &pool);
+
     void setVerticalChildren(int level);
 
     void setHorizontalChildren(int level);
 
-    void kNearestNeighborsHelper(KDBTreeEfficient *node, int k,
-                                 priority_queue<KDBTreeEfficient *, std::vector<KDBTreeEfficient *>, CompareKDBTree> &queue,
-                                 std::vector<Point> &result, Point &point);
+    void aggregateHelper(AreaType &queryRectangle, Aggregate &result);
+
+    void setColumns(double *xColumn, double *yColumn);
+
+    bool containsHelper(const PointType &point, int level);
+
+    template<typename Sink>
+    void queryHelper(AreaType &queryRectangle, Sink &sink);
+
+    void kNearestNeighborsHelper(const PointType &queryPoint, Scratch &scratch) const;
 
 public:
-    KDBTreeEfficient(Point *points, int level, Area &area, int from, int to, int capacity);
+    BasicKDBTreeEfficient(PointType *points, int level, AreaType &area, int from, int to, int capacity);
+
+    BasicKDBTreeEfficient(PointType *points, int level, AreaType &area, int from, int to, int capacity,
+                          WorkStealingPool &pool);
+
+    BasicKDBTreeEfficient(PointType *points, int level, AreaType &area, int from, int to, int capacity,
+                          NodeArena &arena);
+
+    BasicKDBTreeEfficient(PointType *points, int level, AreaType &area, int from, int to,
+                          const CapacityProfile &profile);
 
-    ~KDBTreeEfficient();
+    ~BasicKDBTreeEfficient();
 
-    bool contains(Point p);
+    bool contains(PointType p);
 
-    list<Point> query(Area queryArea);
+    // read-only copy with leaves of the same capacity and a branchless contains(), coordinates become doubles
+    FrozenKDTree freeze() const;
+
+    list<PointType> query(AreaType queryArea);
+
+    template<typename Sink>
+    Sink query(AreaType &queryRectangle, Sink sink);
+
+    void query(AreaType &queryRectangle, vector<PointType> &result);
+
+    long count(AreaType &queryRectangle);
+
+    void buildAggregates(BasicWeightFunction<T> weight);
+
+    Aggregate aggregate(AreaType &queryRectangle);
 
     void buildTree();
 
+    void buildTree(WorkStealingPool &pool);
+
+    // copies the coordinates into separate x and y arrays, leaves are then filtered with LeafScan kernels.
+    // Does nothing for coordinates other than double
+    void buildColumns();
+
+    bool hasColumns() const;
+
+    // replaces the split cell of every node by the bounding box of its points, call after buildTree()
+    void tightenAreas();
+
+    // number of nodes query(queryRectangle) visits
+    long queryVisits(AreaType &queryRectangle);
+
     int getHeight();
 
     bool isLeaf() const;
 
-    Point *getPoints();
+    PointType *getPoints();
+
+    BasicKDBTreeEfficient *getLeftChild();
 
-    KDBTreeEfficient *getLeftChild();
+    BasicKDBTreeEfficient *getRightChild();
 
-    KDBTreeEfficient *getRightChild();
+    vector<PointType> kNearestNeighbors(const PointType &point, int k) const;
 
-    vector<Point> kNearestNeighbors(Point &point, int k);
+    void kNearestNeighbors(const PointType &queryPoint, int k, Scratch &scratch, vector<PointType> &result) const;
 
 };
 
+using KDBTreeEfficient = BasicKDBTreeEfficient<double>;
+
+
+template<typename T>
+template<typename Sink>
+Sink BasicKDBTreeEfficient<T>::query(AreaType &queryRectangle, Sink sink) {
+    queryHelper(queryRectangle, sink);
+    return sink;
+}
+
+template<typename T>
+template<typename Sink>
+void BasicKDBTreeEfficient<T>::queryHelper(AreaType &queryRectangle, Sink &sink) {
+    if (this->isLeaf()) {
+        if constexpr (LEAF_SCAN) {
+            if (this->xs != nullptr) {
+                for (int start = this->from; start <= this->to; start += LEAF_SCAN_BLOCK) {
+                    int count = min(LEAF_SCAN_BLOCK, this->to - start + 1);
+                    for (uint64_t mask = leafRangeMask(this->xs + start, this->ys + start, count, queryRectangle);
+                         mask != 0; mask &= mask - 1) {
+                        emitPoint(sink, this->points[start + __builtin_ctzll(mask)]);
+                    }
+                }
+                return;
+            }
+        }
+        for (int i = this->from; i <= this->to; i++) {
+            if (containsPoint(queryRectangle, this->points[i])) {
+                emitPoint(sink, this->points[i]);
+            }
+        }
+        return;
+    } else if (containsArea(queryRectangle, this->area)) {
+        emitPoints(sink, this->points + from, this->points + to + 1);
+        return;
+    }
+
+    if (this->leftChild != nullptr && intersects(queryRectangle, this->leftChild->area)) {
+        this->leftChild->queryHelper(queryRectangle, sink);
+    }
+    if (this->rightChild != nullptr && intersects(queryRectangle, this->rightChild->area)) {
+        this->rightChild->queryHelper(queryRectangle, sink);
+    }
+}
 
 #endif //QUADKDBENCH_KDBTreeEfficient_H
@@ -0,0 +1,238 @@
+/**
+ * @author Omar Chatila
+ * @file KDBTreeND.h
+ * @brief KDB-Tree on points with D dimensions
+ *
+ * Generalizes KDBTreeEfficient: node i of level l splits at the median of axis l % D. With capacity 1 every leaf holds
+ * a single point like the nodes of KDTreeEfficient. The axis is stored in the node, so descents do not compute it.
+ */
+
+#ifndef QUADKDBENCH_KDBTREEND_H
+#define QUADKDBENCH_KDBTREEND_H
+
+#include "PointND.h"
+#include "KNNScratch.h"
+#include <bits/stdc++.h>
+
+/**
+ * @brief Bucketed KD-Tree on an array of D-dimensional points
+ * @tparam D number of dimensions
+ * @tparam T coordinate type
+ */
+template<int D, typename T = double>
+class KDBTreeND {
+public:
+    static constexpr int dimension = D;
+    using PointType = PointND<D, T>;
+    using BoxType = BoxND<D, T>;
+    using Scratch = BasicKNNScratch<T, PointType>;
+
+private:
+    PointType *points;              /**< Array of all points, reordered by the build */
+    BoxType box{};                  /**< Cell of this node */
+    int from, to;                   /**< Range of the points of this node, inclusive */
+    int capacity;                   /**< Maximum number of points of a leaf */
+    int axis;                       /**< Split axis, level % D */
+    KDBTreeND *leftChild{};         /**< Points up to the median */
+    KDBTreeND *rightChild{};        /**< Points after the median */
+    T medianValue;                  /**< Split coordinate on axis, T{} for leaves */
+
+    template<typename Sink>
+    void queryHelper(const BoxType &queryBox, Sink &sink) const;
+
+    void kNearestNeighborsHelper(const PointType &queryPoint, Scratch &scratch) const;
+
+public:
+    /**
+     * @brief Creates the root of a tree on points[from..to], the tree is created by buildTree()
+     * @param points array of points, reordered by the build
+     * @param level 0 for the root
+     * @param box box containing all points
+     * @param from index of the first point
+     * @param to index of the last point
+     * @param capacity maximum number of points of a leaf
+     */
+    KDBTreeND(PointType *points, int level, const BoxType &box, int from, int to, int capacity);
+
+    ~KDBTreeND();
+
+    void buildTree();
+
+    [[nodiscard]] bool isLeaf() const;
+
+    int getHeight() const;
+
+    bool contains(const PointType &point) const;
+
+    template<typename Sink>
+    Sink query(const BoxType &queryBox, Sink sink) const;
+
+    void query(const BoxType &queryBox, vector<PointType> &result) const;
+
+    long count(const BoxType &queryBox) const;
+
+    vector<PointType> kNearestNeighbors(const PointType &queryPoint, int k) const;
+
+    void kNearestNeighbors(const PointType &queryPoint, int k, Scratch &scratch, vector<PointType> &result) const;
+};
+
+template<int D, typename T>
+KDBTreeND<D, T>::KDBTreeND(PointType *points, int level, const BoxType &box, int from, int to, int capacity)
+        : points(points), box(box), from(from), to(to), capacity(capacity), axis(level % D),
+          medianValue(to - from < capacity ? T{} : median(points, level % D, from, to + 1, (from + to) / 2)) {
+}
+
+template<int D, typename T>
+KDBTreeND<D, T>::~KDBTreeND() {
+    delete leftChild;
+    delete rightChild;
+}
+
+template<int D, typename T>
+void KDBTreeND<D, T>::buildTree() {
+    if (this->isLeaf()) {
+        return;
+    }
+    int midIndex = (from + to) / 2;
+    BoxType leftBox = this->box, rightBox = this->box;
+    leftBox.max[axis] = rightBox.min[axis] = this->medianValue;
+    this->leftChild = new KDBTreeND(this->points, axis + 1, leftBox, from, midIndex, capacity);
+    this->rightChild = new KDBTreeND(this->points, axis + 1, rightBox, midIndex + 1, to, capacity);
+    this->leftChild->buildTree();
+    this->rightChild->buildTree();
+}
+
+template<int D, typename T>
+bool KDBTreeND<D, T>::isLeaf() const {
+    return this->to - this->from < this->capacity;
+}
+
+template<int D, typename T>
+int KDBTreeND<D, T>::getHeight() const {
+    if (this->isLeaf()) {
+        return 1;
+    }
+    return max(this->leftChild->getHeight(), this->rightChild->getHeight()) + 1;
+}
+
+template<int D, typename T>
+bool KDBTreeND<D, T>::contains(const PointType &point) const {
+    const KDBTreeND *current = this;
+    while (!current->isLeaf()) {
+        T coordinate = point[current->axis];
+        if (coordinate < current->medianValue) {
+            current = current->leftChild;
+        } else if (coordinate > current->medianValue) {
+            current = current->rightChild;
+        } else {
+            // coordinates equal to the median may lie on both sides
+            if (current->leftChild->contains(point)) {
+                return true;
+            }
+            current = current->rightChild;
+        }
+    }
+    for (int i = current->from; i <= current->to; i++) {
+        if (current->points[i] == point) return true;
+    }
+    return false;
+}
+
+template<int D, typename T>
+template<typename Sink>
+Sink KDBTreeND<D, T>::query(const BoxType &queryBox, Sink sink) const {
+    queryHelper(queryBox, sink);
+    return sink;
+}
+
+template<int D, typename T>
+template<typename Sink>
+void KDBTreeND<D, T>::queryHelper(const BoxType &queryBox, Sink &sink) const {
+    if (this->isLeaf()) {
+        for (int i = this->from; i <= this->to; i++) {
+            if (containsPoint(queryBox, this->points[i])) {
+                emitPoint(sink, this->points[i]);
+            }
+        }
+        return;
+    } else if (containsArea(queryBox, this->box)) {
+        emitPoints(sink, this->points + from, this->points + to + 1);
+        return;
+    }
+    if (intersects(queryBox, this->leftChild->box)) {
+        this->leftChild->queryHelper(queryBox, sink);
+    }
+    if (intersects(queryBox, this->rightChild->box)) {
+        this->rightChild->queryHelper(queryBox, sink);
+    }
+}
+
+template<int D, typename T>
+void KDBTreeND<D, T>::query(const BoxType &queryBox, vector<PointType> &result) const {
+    query(queryBox, back_inserter(result));
+}
+
+template<int D, typename T>
+long KDBTreeND<D, T>::count(const BoxType &queryBox) const {
+    if (containsArea(queryBox, this->box)) {
+        return to - from + 1;
+    } else if (this->isLeaf()) {
+        long result = 0;
+        for (int i = this->from; i <= this->to; i++) {
+            result += containsPoint(queryBox, this->points[i]);
+        }
+        return result;
+    }
+    long result = 0;
+    if (intersects(queryBox, this->leftChild->box)) {
+        result += this->leftChild->count(queryBox);
+    }
+    if (intersects(queryBox, this->rightChild->box)) {
+        result += this->rightChild->count(queryBox);
+    }
+    return result;
+}
+
+template<int D, typename T>
+vector<PointND<D, T>> KDBTreeND<D, T>::kNearestNeighbors(const PointType &queryPoint, int k) const {
+    vector<PointType> result;
+    Scratch scratch;
+    kNearestNeighbors(queryPoint, k, scratch, result);
+    return result;
+}
+
+template<int D, typename T>
+void KDBTreeND<D, T>::kNearestNeighbors(const PointType &queryPoint, int k, Scratch &scratch,
+                                        vector<PointType> &result) const {
+    scratch.reset(k);
+    kNearestNeighborsHelper(queryPoint, scratch);
+    scratch.extractSorted(result);
+}
+
+template<int D, typename T>
+void KDBTreeND<D, T>::kNearestNeighborsHelper(const PointType &queryPoint, Scratch &scratch) const {
+    scratch.visit();
+    if (this->isLeaf()) {
+        for (int i = this->from; i <= this->to; i++) {
+            scratch.offer(this->points[i], pointDistance(this->points[i], queryPoint));
+        }
+        return;
+    }
+    // visit the closer child first, the second one is often pruned by then
+    const KDBTreeND *nearChild = this->leftChild;
+    const KDBTreeND *farChild = this->rightChild;
+    auto nearDistance = sqDistanceFrom(nearChild->box, queryPoint);
+    auto farDistance = sqDistanceFrom(farChild->box, queryPoint);
+    if (farDistance < nearDistance) {
+        swap(nearChild, farChild);
+        swap(nearDistance, farDistance);
+    }
+    if (nearDistance < scratch.radius()) {
+        nearChild->kNearestNeighborsHelper(queryPoint, scratch);
+    }
+    if (farDistance < scratch.radius()) {
+        farChild->kNearestNeighborsHelper(queryPoint, scratch);
+    }
+}
+
+#endif //QUADKDBENCH_KDBTREEND_H
@@ -11,55 +11,49 @@
 #define QUADKDBENCH_KDTREEEFFICIENT_H
 
 #include "Util.h"
+#include "WorkStealingPool.h"
+#include "KNNScratch.h"
+#include "NodeArena.h"
+#include "FrozenKDTree.h"
 #include <bits/stdc++.h>
 
 using namespace std;
 
-class KDTreeEfficient {
-    /**
-     * @brief A comparison struct for prioritizing KD-Tree areas based on distance from a query point.
-     */
-    struct CompareKDETree {
-        const Point &queryPoint;
-
-        /**
-         * @brief Constructor for CompareMKDTree.
-         * @param p The query point to calculate distances from.
-         */
-        explicit CompareKDETree(const Point &p) : queryPoint(p) {}
-
-        /**
-         * @brief Overloaded operator to compare KD-Tree nodes based on squared distance from the query point.
-         * @param a The first KD-Tree node.
-         * @param b The second KD-Tree node.
-         * @return True if the squared distance of point p to  node a is greater than to node b; false otherwise.
-         */
-        bool operator()(KDTreeEfficient *a, KDTreeEfficient *b) const {
-            return sqDistanceFrom(a->area, queryPoint) > sqDistanceFrom(b->area, queryPoint);
-        }
-    };
+/**
+ * @brief KD-Tree with one point per leaf
+ * @tparam T coordinate type, double, float or int32_t
+ */
+template<typename T>
+class BasicKDTreeEfficient {
+public:
+    using PointType = BasicPoint<T>;
+    using AreaType = BasicArea<T>;
+    using Scratch = BasicKNNScratch<T>;
 
+private:
     /**
      * Overloads output stream operator to print information of KD-Tree node
      * @param os
      * @param kdTreeEfficient
      * @return String representation of KD-Tree
      */
-    friend std::ostream &operator<<(std::ostream &os, const KDTreeEfficient &kdTreeEfficient) {
+    friend std::ostream &operator<<(std::ostream &os, const BasicKDTreeEfficient &kdTreeEfficient) {
         os << std::fixed << std::setprecision(1);
 
         return os << "A:" << kdTreeEfficient.area << "f:" << kdTreeEfficient.from << "t:" << kdTreeEfficient.to
-                  << "xMed" << std::max(kdTreeEfficient.xMedian, 0.0) << "yMed"
-                  << std::max(kdTreeEfficient.yMedian, 0.0) << "\n";
+                  << "xMed" << std::max<T>(kdTreeEfficient.xMedian, 0) << "yMed"
+                  << std::max<T>(kdTreeEfficient.yMedian, 0) << "\n";
     }
 
-private:
-    Point *points;                  /**< The vector of points associated with the KD-Tree node. */
-    Area area{};                    /**< The area covered by the SortKDTree node. */
-    int from, to;                   /**< Lower bound of points, higher bound of points */
-    KDTreeEfficient *leftChild{};   /**< Pointer to the left child of the SortKDTree node. */
-    KDTreeEfficient *rightChild{};  /**< Pointer to the right child of the SortKDTree node. */
-    double xMedian, yMedian;        /**< Median of x- / y-coordinate */
+    PointType *points;                  /**< The vector of points associated with the KD-Tree node. */
+    AreaType area{};                    /**< The area covered by the node, the bounding box of its points after tightenAreas() */
+    int from, to;                       /**< Lower bound of points, higher bound of points */
+    BasicKDTreeEfficient *leftChild{};  /**< Pointer to the left child of the SortKDTree node. */
+    BasicKDTreeEfficient *rightChild{}; /**< Pointer to the right child of the SortKDTree node. */
+    T xMedian, yMedian;                 /**< Median of x- / y-coordinate */
+    Aggregate *summary{};               /**< Aggregate of the subtree, set by buildAggregates() */
+    BasicWeightFunction<T> weight{};    /**< Weight of a point, set by buildAggregates() */
+    NodeArena *arena{};                 /**< Arena of nodes and aggregates, nullptr if they are on the heap */
 
     /**
      * @Brief Constructs a KD-Tree with the specified area and points
@@ -72,7 +66,21 @@ private:
      * @param from lower bound of point array
      * @param to upper bound of point array
      */
-    KDTreeEfficient(Point *points, int level, Area &area, int from, int to);
+    BasicKDTreeEfficient(PointType *points, int level, AreaType &area, int from, int to);
+
+    /**
+     * @Brief Constructs a KD-Tree node whose split value was already determined
+     *
+     * The points array has to be partitioned around medianValue already
+     *
+     * @param points array of points
+     * @param level current level
+     * @param area containing all points
+     * @param from lower bound of point array
+     * @param to upper bound of point array
+     * @param medianValue median of the x- or y-coordinate depending on level
+     */
+    BasicKDTreeEfficient(PointType *points, int level, AreaType &area, int from, int to, T medianValue);
 
     /**
      * @brief private helper function to build the KD-Tree
@@ -82,6 +90,22 @@ private:
      */
     void buildTree(int level);
 
+    /**
+     * @brief private helper function to build the KD-Tree in parallel
+     *
+     * Left subtrees are spawned as tasks, subtrees with at most PARALLEL_BUILD_GRAIN points are built serially
+     * @param level current level
+     * @param pool pool running the subtree builds
+     */
+    void buildTree(int level, WorkStealingPool &pool);
+
+    /**
+     * @brief Creates both children, large ranges determine their medians with parallelMedian()
+     * @param level current level
+     * @param pool pool running the partition steps
+     */
+    void setChildren(int level, WorkStealingPool &pool);
+
     /**
      * @Brief makes vertical split of the area und creates to children accordingly
      * @param lev level to decide split-coordinate
@@ -95,18 +119,38 @@ private:
     void setHorizontalChildren(int level);
 
     /**
-     * @brief Helper method for kNearestNeighbors(Point &queryPoint, int k). Adds k-nearest neighbor of KD-Tree node to result vector
+     * @brief Helper method for contains(Point). Descends into both children if point ties the median of a node
+     * @param point point to be found
+     * @param level level of this node
+     * @return True if this subtree contains point, false otherwise
+     */
+    bool containsHelper(const PointType &point, int level);
+
+    /**
+     * @brief Helper method for aggregate(Area &). Adds the weights of the points of this subtree inside queryRectangle
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param result aggregate the points are added to
+     */
+    void aggregateHelper(AreaType &queryRectangle, Aggregate &result);
+
+    /**
+     * @brief Helper method for query(Area &, Sink). Reports the points of this subtree inside queryRectangle
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param sink callable taking a Point or output iterator
+     */
+    template<typename Sink>
+    void queryHelper(AreaType &queryRectangle, Sink &sink);
+
+    /**
+     * @brief Helper method for kNearestNeighbors. Offers the points of this subtree to the candidate heap
      *
-     * Recursively traverses KD-Tree nodes to find k nearest neighbors. Uses priority to keep track of proximity to query Point
+     * Descends into the child closer to queryPoint first and skips children whose area is farther away
+     * than the current k-th best candidate
      *
-     * @param node The KD-Tree that is used for k-NNS
-     * @param k The number of neighbors
-     * @param queue Priority Queue that prioritizes nodes by proximity of its square to a queryPoint
-     * @param result Vector that contains the k nearest neighbors
+     * @param queryPoint The point of which the k nearest neighbors are determined
+     * @param scratch Candidate heap of the running search
      */
-    void kNearestNeighborsHelper(KDTreeEfficient *node, int k,
-                                 priority_queue<KDTreeEfficient *, std::vector<KDTreeEfficient *>, CompareKDETree> &queue,
-                                 std::vector<Point> &result);
+    void kNearestNeighborsHelper(const PointType &queryPoint, Scratch &scratch) const;
 
 public:
     /**
@@ -115,25 +159,92 @@ public:
      * @param area
      * @param size
      */
-    KDTreeEfficient(Point *points, Area &area, int size);
+    BasicKDTreeEfficient(PointType *points, AreaType &area, int size);
+
+    /**
+     * @Brief Constructor only for root node. Determines the root median in parallel
+     * @param points
+     * @param area
+     * @param size
+     * @param pool pool running the partition steps
+     */
+    BasicKDTreeEfficient(PointType *points, AreaType &area, int size, WorkStealingPool &pool);
+
+    /**
+     * @Brief Constructor only for root node. Nodes and aggregates are allocated in arena
+     *
+     * The arena has to outlive the tree. Destroying the tree does not free the nodes, the arena does.
+     * The tree is always built serially, buildTree(WorkStealingPool &) falls back to buildTree()
+     * @param points
+     * @param area
+     * @param size
+     * @param arena arena for nodes and aggregates
+     */
+    BasicKDTreeEfficient(PointType *points, AreaType &area, int size, NodeArena &arena);
 
     /**
      * destroys the KD-Tree and deallocates memory
      */
-    ~KDTreeEfficient();
+    ~BasicKDTreeEfficient();
 
     /**
      * Checks if given point is contained by the KD-Tree
      * @param point
      * @return True if KD-Tree contains point, false otherwise
      */
-    bool contains(Point p);
+    bool contains(PointType p);
+
+    /**
+     * @brief Creates a read-only copy of the tree with a branchless contains(), one point per leaf
+     * @return frozen tree on a copy of the points of this tree
+     */
+    FrozenKDTree freeze() const;
 
     /**
      * @param queryRectangle Rectangle that contains points of interest
      * @return list<Point> of points contained by queryRectangle
      */
-    list<Point> query(Area queryArea);
+    list<PointType> query(AreaType queryArea);
+
+    /**
+     * @brief Reports every point contained by queryRectangle to sink, no intermediate lists are built
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param sink callable taking a Point or output iterator
+     * @return sink after all points have been reported
+     */
+    template<typename Sink>
+    Sink query(AreaType &queryRectangle, Sink sink);
+
+    /**
+     * @brief Appends the points contained by queryRectangle to result
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param result vector that is reused between queries, it is not cleared
+     */
+    void query(AreaType &queryRectangle, vector<PointType> &result);
+
+    /**
+     * @brief Counts the points contained by queryRectangle
+     *
+     * Subtrees inside queryRectangle add their size in O(1) instead of being traversed
+     * @param queryRectangle Rectangle that contains points of interest
+     * @return number of points inside queryRectangle
+     */
+    long count(AreaType &queryRectangle);
+
+    /**
+     * @brief Stores count, sum, minimum and maximum of weight in every node
+     * @param weight weight of a point
+     */
+    void buildAggregates(BasicWeightFunction<T> weight);
+
+    /**
+     * @brief Aggregates the weights of the points contained by queryRectangle
+     *
+     * Requires buildAggregates(). Subtrees inside queryRectangle add their stored aggregate in O(1)
+     * @param queryRectangle Rectangle that contains points of interest
+     * @return aggregate of the points inside queryRectangle
+     */
+    Aggregate aggregate(AreaType &queryRectangle);
 
     /**
      * @brief private helper function to build the KD-Tree
@@ -143,6 +254,29 @@ public:
      */
     void buildTree();
 
+    /**
+     * @brief Replaces the split cell of every node by the bounding box of its points
+     *
+     * Queries and kNN searches then prune by the boxes, which skips empty parts of the cells on clustered data.
+     * Call after buildTree()
+     */
+    void tightenAreas();
+
+    /**
+     * @brief Counts the nodes query(queryRectangle) visits
+     * @param queryRectangle Rectangle that contains points of interest
+     * @return number of visited nodes including this one
+     */
+    long queryVisits(AreaType &queryRectangle);
+
+    /**
+     * @brief Builds the KD-Tree in parallel
+     *
+     * Both subtrees of a node are independent, so they are forked onto the pool. Produces the same split values as buildTree()
+     * @param pool pool running the subtree builds
+     */
+    void buildTree(WorkStealingPool &pool);
+
     /**
      * @brief Calculates height of the Quadtree
      * @return The height of the Quadtree
@@ -155,13 +289,60 @@ public:
      */
     [[nodiscard]] bool isLeaf() const;
 
+    /**
+     * @return array of points the tree was built on, in tree order
+     */
+    PointType *getPoints();
+
     /**
     * Get k nearest neighbors of a query point
     * @param queryPoint The point of which the k nearest neighbors are determined
     * @param k The number of neighbors
     * @return vector containing k nearest neighbors of queryPoint
     */
-    vector<Point> kNearestNeighbors(Point &point, int k);
+    vector<PointType> kNearestNeighbors(const PointType &point, int k) const;
+
+    /**
+    * Get k nearest neighbors of a query point without allocating
+    * @param queryPoint The point of which the k nearest neighbors are determined
+    * @param k The number of neighbors
+    * @param scratch Candidate heap that is reused between queries
+    * @param result vector that is overwritten with the k nearest neighbors, ordered by distance
+    */
+    void kNearestNeighbors(const PointType &queryPoint, int k, Scratch &scratch, vector<PointType> &result) const;
 };
 
+/**
+ * KD-Tree with double coordinates
+ */
+using KDTreeEfficient = BasicKDTreeEfficient<double>;
+
+template<typename T>
+template<typename Sink>
+Sink BasicKDTreeEfficient<T>::query(AreaType &queryRectangle, Sink sink) {
+    queryHelper(queryRectangle, sink);
+    return sink;
+}
+
+template<typename T>
+template<typename Sink>
+void BasicKDTreeEfficient<T>::queryHelper(AreaType &queryRectangle, Sink &sink) {
+    if (this->isLeaf()) {
+        if (containsPoint(queryRectangle, this->points[from])) {
+            emitPoint(sink, this->points[from]);
+        }
+        return;
+    } else if (containsArea(queryRectangle, this->area)) {
+        emitPoints(sink, this->points + from, this->points + to + 1);
+        return;
+    }
+
+    if (this->leftChild != nullptr && intersects(queryRectangle, this->leftChild->area)) {
+        this->leftChild->queryHelper(queryRectangle, sink);
+    }
+    if (this->rightChild != nullptr && intersects(queryRectangle, this->rightChild->area)) {
+        this->rightChild->queryHelper(queryRectangle, sink);
+    }
+}
+
 #endif //QUADKDBENCH_KDTREEEFFICIENT_H
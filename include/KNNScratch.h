@@ -0,0 +1,118 @@
+/**
+ * @author Omar Chatila
+ * @file KNNScratch.h
+ * @brief Reusable state of an exact k-nearest-neighbor search
+ */
+
+#pragma once
+
+#include "Util.h"
+#include <limits>
+
+/**
+ * @brief Bounded max-heap of the k best candidates found so far
+ *
+ * The farthest candidate is on top of the heap, its squared distance is the pruning radius of the search.
+ * Reusing one KNNScratch for repeated queries keeps its buffer, so queries do not allocate.
+ * The const kNN methods of the trees keep all search state here, so threads sharing a tree use one scratch each.
+ * @tparam T coordinate type of the points
+ * @tparam P point type, PointND for searches in more than 2 dimensions
+ */
+template<typename T, typename P = BasicPoint<T>>
+class BasicKNNScratch {
+public:
+    using Distance = SquaredDistance<T>;
+
+    /**
+     * @brief A point together with its squared distance to the query point
+     */
+    struct Candidate {
+        Distance distance;      /**< Squared distance to the query point */
+        P point;                /**< The candidate point */
+
+        bool operator<(const Candidate &other) const {
+            return distance < other.distance;
+        }
+    };
+
+    /**
+     * @brief Starts a new search
+     * @param k number of neighbors
+     */
+    void reset(int k) {
+        this->k = max(k, 0);
+        this->visitedNodes = 0;
+        heap.clear();
+        heap.reserve(this->k);
+    }
+
+    /**
+     * @brief Squared distance a point or cell must stay below to improve the result
+     * @return squared distance of the k-th best candidate, infinity (the maximum for integers) while fewer than k
+     * candidates were found
+     */
+    [[nodiscard]] Distance radius() const {
+        if (k == 0) {
+            return Distance{};
+        }
+        if (heap.size() < (size_t) k) {
+            return std::numeric_limits<Distance>::has_infinity ? std::numeric_limits<Distance>::infinity()
+                                                               : std::numeric_limits<Distance>::max();
+        }
+        return heap.front().distance;
+    }
+
+    /**
+     * @brief Adds point to the candidates if it is closer than the current k-th best candidate
+     * @param point candidate point
+     * @param distance squared distance between point and query point
+     */
+    void offer(const P &point, Distance distance) {
+        if (heap.size() < (size_t) k) {
+            heap.push_back(Candidate{distance, point});
+            std::push_heap(heap.begin(), heap.end());
+        } else if (k > 0 && distance < heap.front().distance) {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.back() = Candidate{distance, point};
+            std::push_heap(heap.begin(), heap.end());
+        }
+    }
+
+    /**
+     * @brief Writes the candidates ordered by increasing distance to result
+     *
+     * Ends the search, the scratch has to be reset before it is used again
+     * @param result vector that is overwritten with the k nearest neighbors
+     */
+    void extractSorted(vector<P> &result) {
+        std::sort_heap(heap.begin(), heap.end());
+        result.clear();
+        for (auto &candidate: heap) {
+            result.push_back(candidate.point);
+        }
+    }
+
+    /**
+     * @brief Counts a tree node visited by the running search
+     */
+    void visit() {
+        visitedNodes++;
+    }
+
+    /**
+     * @return number of nodes visited since the last reset, counted by the KD-Trees
+     */
+    [[nodiscard]] long getVisitedNodes() const {
+        return visitedNodes;
+    }
+
+private:
+    int k = 0;                  /**< Number of neighbors */
+    long visitedNodes = 0;      /**< Nodes visited by the running search */
+    vector<Candidate> heap;     /**< Max-heap of the best candidates */
+};
+
+/**
+ * Scratch of the searches on points with double coordinates
+ */
+using KNNScratch = BasicKNNScratch<double>;
@@ -0,0 +1,74 @@
+/**
+ * @author Omar Chatila
+ * @file LeafScan.h
+ * @brief Vectorized filtering of leaf points stored as separate x and y arrays
+ *
+ * A block of up to 64 points is compared against a query rectangle or a point and the result is returned as a
+ * bitmask, bit i is set if point i matches. The kernel is chosen at startup from the instruction sets of the
+ * CPU (AVX-512, AVX2 or scalar) and can be overridden with selectLeafScanKernel().
+ */
+
+#ifndef QUADKDBENCH_LEAFSCAN_H
+#define QUADKDBENCH_LEAFSCAN_H
+
+#include "Util.h"
+#include <bits/stdc++.h>
+
+/**
+ * Number of doubles the coordinate arrays are padded with, a kernel may read this far past the last point
+ */
+constexpr int LEAF_SCAN_PADDING = 8;
+
+/**
+ * Number of points filtered by one call of leafRangeMask() or leafEqualMask()
+ */
+constexpr int LEAF_SCAN_BLOCK = 64;
+
+/**
+ * @brief Implementation of the leaf scans
+ */
+enum LeafScanKernel {
+    SCALAR_KERNEL,   /**< One point at a time, available everywhere */
+    AVX2_KERNEL,     /**< 4 points per comparison */
+    AVX512_KERNEL    /**< 8 points per comparison */
+};
+
+/**
+ * @return fastest kernel supported by the CPU
+ */
+LeafScanKernel bestLeafScanKernel();
+
+/**
+ * @brief Replaces the kernel used by leafRangeMask() and leafEqualMask(). Not thread safe
+ * @param kernel kernel to be used
+ * @return false if the CPU does not support kernel, the kernel is unchanged then
+ */
+bool selectLeafScanKernel(LeafScanKernel kernel);
+
+/**
+ * @return kernel currently used
+ */
+LeafScanKernel currentLeafScanKernel();
+
+/**
+ * @brief Filters a block of points by a query rectangle
+ * @param xs x coordinates, readable up to LEAF_SCAN_PADDING entries past count
+ * @param ys y coordinates, readable up to LEAF_SCAN_PADDING entries past count
+ * @param count number of points, at most LEAF_SCAN_BLOCK
+ * @param area query rectangle, borders included as in containsPoint()
+ * @return mask with bit i set if point i is contained by area
+ */
+uint64_t leafRangeMask(const double *xs, const double *ys, int count, const Area &area);
+
+/**
+ * @brief Finds the points of a block that are equal to (x, y)
+ * @param xs x coordinates, readable up to LEAF_SCAN_PADDING entries past count
+ * @param ys y coordinates, readable up to LEAF_SCAN_PADDING entries past count
+ * @param count number of points, at most LEAF_SCAN_BLOCK
+ * @param x x coordinate of the point
+ * @param y y coordinate of the point
+ * @return mask with bit i set if point i equals (x, y)
+ */
+uint64_t leafEqualMask(const double *xs, const double *ys, int count, double x, double y);
+
+#endif //QUADKDBENCH_LEAFSCAN_H
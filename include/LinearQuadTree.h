@@ -0,0 +1,183 @@
+/**
+ * @author Omar Chatila
+ * @file LinearQuadTree.h
+ * @brief Implementation of a pointer-free, Morton-ordered (linear) Quadtree
+ *
+ * Coordinates are quantized to a 2^32 x 2^32 grid over the area and interleaved into 64-bit Z-order (Morton)
+ * codes. The points are sorted by code, so every Quadtree cell is a contiguous slice of the points array,
+ * found by binary search on the sorted code array. No nodes are stored.
+ * Building the tree in O(nlog(n))
+ */
+
+#ifndef QUADKDBENCH_LINEARQUADTREE_H
+#define QUADKDBENCH_LINEARQUADTREE_H
+
+#include "Util.h"
+#include "KNNScratch.h"
+#include <bits/stdc++.h>
+
+using namespace std;
+
+/**
+ * Cells with at most this many points are not split further by kNearestNeighbors()
+ */
+constexpr int LINEAR_QUADTREE_LEAF_CAPACITY = 8;
+
+class LinearQuadTree {
+private:
+    Point *points;              /**< The array of points, sorted by Morton code. */
+    Area area{};                /**< The area covered by the Quadtree. */
+    int size;                   /**< Number of points */
+    vector<uint64_t> codes;     /**< Morton code of every point, sorted */
+
+    /**
+     * @brief Maps a coordinate to its grid cell
+     * @param value coordinate
+     * @param min lower bound of the area in this dimension
+     * @param max upper bound of the area in this dimension
+     * @return cell index in [0, 2^32 - 1], values outside the area are clamped
+     */
+    static uint32_t quantize(double value, double min, double max);
+
+    /**
+     * @brief Spreads the 32 bits of value to the even bit positions of a 64-bit integer
+     * @param value bits to be spread
+     * @return value with a zero bit inserted above every bit
+     */
+    static uint64_t spreadBits(uint32_t value);
+
+    /**
+     * @brief Calculates the Morton code of a point, x-bits are at even, y-bits at odd positions
+     * @param point point inside the area
+     * @return Z-order code of the grid cell containing point
+     */
+    [[nodiscard]] uint64_t mortonCode(const Point &point) const;
+
+    /**
+     * @brief Calculates the smallest Morton code inside the rectangle [zMin, zMax] that is greater than code
+     *
+     * BIGMIN of Tropf and Herzog. code has to lie between zMin and zMax but outside the rectangle
+     * @param code Morton code outside of the rectangle
+     * @param zMin Morton code of the lower left corner
+     * @param zMax Morton code of the upper right corner
+     * @return next Morton code inside the rectangle
+     */
+    static uint64_t bigMin(uint64_t code, uint64_t zMin, uint64_t zMax);
+
+    /**
+     * @brief Checks if the grid cell of code lies inside the rectangle spanned by zMin and zMax
+     * @param code Morton code
+     * @param zMin Morton code of the lower left corner
+     * @param zMax Morton code of the upper right corner
+     * @return True if the cell is inside the rectangle, false otherwise
+     */
+    static bool insideRectangle(uint64_t code, uint64_t zMin, uint64_t zMax);
+
+    /**
+     * @brief Helper method for kNearestNeighbors. Offers the points of a Quadtree cell to the candidate heap
+     * @param queryPoint The point of which the k nearest neighbors are determined
+     * @param scratch Candidate heap of the running search
+     * @param cell area covered by the cell
+     * @param level depth of the cell, the root has level 0
+     * @param firstCode smallest Morton code of the cell
+     * @param from index of the first point of the cell
+     * @param to index behind the last point of the cell
+     */
+    void kNearestNeighborsHelper(const Point &queryPoint, KNNScratch &scratch, Area cell, int level,
+                                 uint64_t firstCode, int from, int to) const;
+
+public:
+    /**
+     * @Brief Constructor for the whole tree
+     * @param points array of points, sorted by buildTree()
+     * @param area containing all points
+     * @param size number of points
+     */
+    LinearQuadTree(Point *points, Area &area, int size);
+
+    /**
+     * @brief Builds the Quadtree by sorting the points by their Morton codes
+     */
+    void buildTree();
+
+    /**
+     * @brief Checks if a given point is contained by the Quadtree. Binary search on the Morton code
+     * @param point
+     * @return True if Quadtree contains point, false otherwise
+     */
+    bool contains(Point &point) const;
+
+    /**
+     * @param queryRectangle Rectangle that contains points of interest
+     * @return list<Point> of points contained by queryRectangle
+     */
+    list<Point> query(Area &queryRectangle) const;
+
+    /**
+     * @brief Reports every point contained by queryRectangle to sink
+     *
+     * Scans the Morton interval of queryRectangle and skips codes outside of it with bigMin()
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param sink callable taking a Point or output iterator
+     * @return sink after all points have been reported
+     */
+    template<typename Sink>
+    Sink query(Area &queryRectangle, Sink sink) const;
+
+    /**
+     * @brief Appends the points contained by queryRectangle to result
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param result vector that is reused between queries, it is not cleared
+     */
+    void query(Area &queryRectangle, vector<Point> &result) const;
+
+    /**
+     * Get k nearest neighbors of a query point
+     * @param queryPoint The point of which the k nearest neighbors are determined
+     * @param k The number of neighbors
+     * @return vector containing k nearest neighbors of queryPoint
+     */
+    vector<Point> kNearestNeighbors(Point &queryPoint, int k) const;
+
+    /**
+     * Get k nearest neighbors of a query point without allocating
+     * @param queryPoint The point of which the k nearest neighbors are determined
+     * @param k The number of neighbors
+     * @param scratch Candidate heap that is reused between queries
+     * @param result vector that is overwritten with the k nearest neighbors, ordered by distance
+     */
+    void kNearestNeighbors(Point &queryPoint, int k, KNNScratch &scratch, vector<Point> &result) const;
+
+    /**
+     * @return array of points the tree was built on, in tree order
+     */
+    Point *getPoints();
+};
+
+template<typename Sink>
+Sink LinearQuadTree::query(Area &queryRectangle, Sink sink) const {
+    Area clipped{max(queryRectangle.xMin, area.xMin), min(queryRectangle.xMax, area.xMax),
+                 max(queryRectangle.yMin, area.yMin), min(queryRectangle.yMax, area.yMax)};
+    if (size == 0 || clipped.xMin > clipped.xMax || clipped.yMin > clipped.yMax) {
+        return sink;
+    }
+    uint64_t zMin = mortonCode(Point{clipped.xMin, clipped.yMin});
+    uint64_t zMax = mortonCode(Point{clipped.xMax, clipped.yMax});
+
+    auto current = lower_bound(codes.begin(), codes.end(), zMin);
+    while (current != codes.end() && *current <= zMax) {
+        if (insideRectangle(*current, zMin, zMax)) {
+            // cells on the border of the rectangle can contain points outside of it
+            Point &point = points[current - codes.begin()];
+            if (containsPoint(queryRectangle, point)) {
+                emitPoint(sink, point);
+            }
+            ++current;
+        } else {
+            current = lower_bound(current, codes.end(), bigMin(*current, zMin, zMax));
+        }
+    }
+    return sink;
+}
+
+#endif //QUADKDBENCH_LINEARQUADTREE_H
@@ -0,0 +1,150 @@
+/**
+ * @author Omar Chatila
+ * @file NodeArena.h
+ * @brief Monotonic bump allocator for tree nodes
+ *
+ * Nodes are placed one after another into large blocks in the order they are created. Single nodes are never
+ * freed, all blocks are returned at once when the arena is released or destroyed, so a tree built in an arena
+ * is torn down without visiting its nodes. Blocks can be backed by transparent huge pages.
+ */
+
+#ifndef QUADKDBENCH_NODEARENA_H
+#define QUADKDBENCH_NODEARENA_H
+
+#include "Util.h"
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+
+/**
+ * Default size of a block of a NodeArena
+ */
+constexpr size_t NODE_ARENA_BLOCK_SIZE = 1 << 21;
+
+/**
+ * @brief Bump allocator, usable as memory resource of pmr containers
+ *
+ * Not thread safe, trees built by a WorkStealingPool do not use an arena. The arena has to outlive every tree
+ * that allocates from it.
+ */
+class NodeArena : public std::pmr::memory_resource {
+public:
+    /**
+     * @brief Creates an empty arena, no memory is reserved before the first allocation
+     * @param blockSize minimum size of a block in bytes
+     * @param hugePages true if blocks should be backed by transparent huge pages
+     */
+    explicit NodeArena(size_t blockSize = NODE_ARENA_BLOCK_SIZE, bool hugePages = false);
+
+    /**
+     * @brief Releases all blocks
+     */
+    ~NodeArena() override;
+
+    NodeArena(const NodeArena &) = delete;
+
+    NodeArena &operator=(const NodeArena &) = delete;
+
+    /**
+     * @brief Returns all blocks to the operating system. Destructors of objects in the arena are not called
+     */
+    void release();
+
+    /**
+     * @return number of bytes handed out since the last release, including alignment padding
+     */
+    [[nodiscard]] size_t bytesUsed() const;
+
+    /**
+     * @return number of bytes reserved by blocks
+     */
+    [[nodiscard]] size_t bytesReserved() const;
+
+private:
+    /**
+     * @brief Header at the beginning of every block
+     */
+    struct Block {
+        Block *previous;   /**< Block allocated before this one */
+        size_t size;       /**< Size of the block including the header */
+    };
+
+    Block *blocks{};          /**< Most recently allocated block */
+    char *current{};          /**< Next free byte of the current block */
+    char *end{};              /**< End of the current block */
+    size_t blockSize;         /**< Minimum size of a new block */
+    bool hugePages;           /**< Advise the kernel to back blocks by huge pages */
+    size_t used = 0;          /**< Bytes handed out */
+    size_t reserved = 0;      /**< Bytes of all blocks */
+
+    /**
+     * @brief Allocates a new block that can hold at least bytes with the given alignment
+     * @param bytes size of the allocation that did not fit
+     * @param alignment alignment of the allocation that did not fit
+     */
+    void grow(size_t bytes, size_t alignment);
+
+    void *do_allocate(size_t bytes, size_t alignment) override;
+
+    void do_deallocate(void *pointer, size_t bytes, size_t alignment) override;
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+};
+
+inline void *NodeArena::do_allocate(size_t bytes, size_t alignment) {
+    auto address = reinterpret_cast<uintptr_t>(current);
+    uintptr_t aligned = (address + alignment - 1) & ~(uintptr_t) (alignment - 1);
+    if (current == nullptr || aligned + bytes > reinterpret_cast<uintptr_t>(end)) {
+        grow(bytes, alignment);
+        address = reinterpret_cast<uintptr_t>(current);
+        aligned = (address + alignment - 1) & ~(uintptr_t) (alignment - 1);
+    }
+    used += aligned + bytes - address;
+    current = reinterpret_cast<char *>(aligned + bytes);
+    return reinterpret_cast<void *>(aligned);
+}
+
+inline void NodeArena::do_deallocate(void *, size_t, size_t) {
+    // memory is only returned by release()
+}
+
+inline bool NodeArena::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
+
+/**
+ * @brief Memory resource used by the element vectors of a tree node
+ * @param arena arena of the tree, may be nullptr
+ * @return arena if set, the default resource otherwise
+ */
+inline std::pmr::memory_resource *nodeResource(NodeArena *arena) {
+    return arena != nullptr ? arena : std::pmr::get_default_resource();
+}
+
+/**
+ * @brief Placement form new(arena) Node(...) used to create tree nodes
+ *
+ * Allocates from arena or, if arena is nullptr, from the global heap. Nodes of the heap are deleted as usual.
+ * @param bytes size of the node
+ * @param arena arena of the tree, may be nullptr
+ * @return memory for the node
+ */
+inline void *operator new(size_t bytes, NodeArena *arena) {
+    if (arena == nullptr) {
+        return ::operator new(bytes);
+    }
+    return arena->allocate(bytes, alignof(std::max_align_t));
+}
+
+/**
+ * @brief Called if the constructor of a node created by new(arena) throws
+ * @param pointer memory of the node
+ * @param arena arena of the tree, may be nullptr
+ */
+inline void operator delete(void *pointer, NodeArena *arena) noexcept {
+    if (arena == nullptr) {
+        ::operator delete(pointer);
+    }
+}
+
+#endif //QUADKDBENCH_NODEARENA_H
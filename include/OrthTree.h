@@ -0,0 +1,292 @@
+/**
+ * @author Omar Chatila
+ * @file OrthTree.h
+ * @brief Point-Region tree with 2^D children per node, the D-dimensional PointRegionQuadTree
+ *
+ * Every inner node splits its box at the center of every axis. For D = 2 this is a Point-Region-Quadtree, for D = 3
+ * an octree. Bit i of the index of a child is set if the child lies above the center on axis i.
+ */
+
+#ifndef QUADKDBENCH_ORTHTREE_H
+#define QUADKDBENCH_ORTHTREE_H
+
+#include "PointND.h"
+#include "KNNScratch.h"
+#include <bits/stdc++.h>
+
+/**
+ * Nodes of this depth are not split, so more than capacity equal points end in one leaf instead of recursing forever
+ */
+constexpr int ORTHTREE_MAX_DEPTH = 48;
+
+/**
+ * @brief Point-Region tree with 2^D children per node
+ * @tparam D number of dimensions
+ * @tparam T coordinate type
+ */
+template<int D, typename T = double>
+class OrthTree {
+public:
+    static constexpr int dimension = D;
+    static constexpr int CHILDREN = 1 << D;
+    using PointType = PointND<D, T>;
+    using BoxType = BoxND<D, T>;
+    using Scratch = BasicKNNScratch<T, PointType>;
+
+private:
+    OrthTree *children[CHILDREN]{};     /**< Children indexed by their position relative to the center */
+    BoxType box{};                      /**< The box covered by the node */
+    vector<PointType> elements;         /**< Points of a leaf, empty for inner nodes */
+    int capacity;                       /**< Capacity of a leaf */
+    int depth;                          /**< Depth of the node, 0 for the root */
+    long size;                          /**< Number of points in the subtree */
+
+    OrthTree(const BoxType &box, vector<PointType> &&elements, int capacity, int depth);
+
+    /**
+     * @return center of the box
+     */
+    PointType center() const;
+
+    /**
+     * @return index of the child containing point, points on the center planes belong to the lower child
+     */
+    static int childIndex(const PointType &point, const PointType &center);
+
+    /**
+     * @brief Distributes the points to 2^D children
+     */
+    void subdivide();
+
+    template<typename Sink>
+    void queryHelper(const BoxType &queryBox, Sink &sink) const;
+
+    void kNearestNeighborsHelper(const PointType &queryPoint, Scratch &scratch) const;
+
+public:
+    /**
+     * @brief Creates the root of a tree on a copy of points, the tree is created by buildTree()
+     * @param box box containing all points
+     * @param points the points
+     * @param capacity capacity of a leaf
+     */
+    OrthTree(const BoxType &box, const vector<PointType> &points, int capacity);
+
+    ~OrthTree();
+
+    void buildTree();
+
+    [[nodiscard]] bool isLeaf() const;
+
+    int getHeight() const;
+
+    bool contains(const PointType &point) const;
+
+    template<typename Sink>
+    Sink query(const BoxType &queryBox, Sink sink) const;
+
+    void query(const BoxType &queryBox, vector<PointType> &result) const;
+
+    long count(const BoxType &queryBox) const;
+
+    vector<PointType> kNearestNeighbors(const PointType &queryPoint, int k) const;
+
+    void kNearestNeighbors(const PointType &queryPoint, int k, Scratch &scratch, vector<PointType> &result) const;
+};
+
+/**
+ * Octree with double coordinates
+ */
+using Octree = OrthTree<3>;
+
+template<int D, typename T>
+OrthTree<D, T>::OrthTree(const BoxType &box, const vector<PointType> &points, int capacity)
+        : OrthTree(box, vector<PointType>(points), capacity, 0) {
+}
+
+template<int D, typename T>
+OrthTree<D, T>::OrthTree(const BoxType &box, vector<PointType> &&elements, int capacity, int depth)
+        : box(box), elements(std::move(elements)), capacity(capacity), depth(depth) {
+    this->size = (long) this->elements.size();
+}
+
+template<int D, typename T>
+OrthTree<D, T>::~OrthTree() {
+    for (auto child: children) {
+        delete child;
+    }
+}
+
+template<int D, typename T>
+PointND<D, T> OrthTree<D, T>::center() const {
+    PointType result;
+    forEachAxis<D>([&](auto axis) {
+        result[axis] = centerCoordinate(this->box.min[axis], this->box.max[axis]);
+    });
+    return result;
+}
+
+template<int D, typename T>
+int OrthTree<D, T>::childIndex(const PointType &point, const PointType &center) {
+    int index = 0;
+    forEachAxis<D>([&](auto axis) {
+        index |= (int) (point[axis] > center[axis]) << axis;
+    });
+    return index;
+}
+
+template<int D, typename T>
+void OrthTree<D, T>::buildTree() {
+    if ((long) this->elements.size() > capacity && depth < ORTHTREE_MAX_DEPTH) {
+        subdivide();
+        for (auto child: children) {
+            child->buildTree();
+        }
+    }
+}
+
+template<int D, typename T>
+void OrthTree<D, T>::subdivide() {
+    PointType mid = center();
+    vector<PointType> childrenElements[CHILDREN];
+    for (auto &point: this->elements) {
+        childrenElements[childIndex(point, mid)].push_back(point);
+    }
+    vector<PointType>().swap(this->elements);
+    for (int i = 0; i < CHILDREN; i++) {
+        BoxType childBox = this->box;
+        for (int axis = 0; axis < D; axis++) {
+            if (i >> axis & 1) {
+                childBox.min[axis] = mid[axis];
+            } else {
+                childBox.max[axis] = mid[axis];
+            }
+        }
+        children[i] = new OrthTree(childBox, std::move(childrenElements[i]), capacity, depth + 1);
+    }
+}
+
+template<int D, typename T>
+bool OrthTree<D, T>::isLeaf() const {
+    return children[0] == nullptr;
+}
+
+template<int D, typename T>
+int OrthTree<D, T>::getHeight() const {
+    if (this->isLeaf()) {
+        return 1;
+    }
+    int height = 0;
+    for (auto child: children) {
+        height = max(height, child->getHeight());
+    }
+    return height + 1;
+}
+
+template<int D, typename T>
+bool OrthTree<D, T>::contains(const PointType &point) const {
+    const OrthTree *current = this;
+    while (!current->isLeaf()) {
+        current = current->children[childIndex(point, current->center())];
+    }
+    return std::find(current->elements.begin(), current->elements.end(), point) != current->elements.end();
+}
+
+template<int D, typename T>
+template<typename Sink>
+Sink OrthTree<D, T>::query(const BoxType &queryBox, Sink sink) const {
+    queryHelper(queryBox, sink);
+    return sink;
+}
+
+template<int D, typename T>
+template<typename Sink>
+void OrthTree<D, T>::queryHelper(const BoxType &queryBox, Sink &sink) const {
+    if (this->isLeaf()) {
+        for (auto &point: this->elements) {
+            if (containsPoint(queryBox, point)) {
+                emitPoint(sink, point);
+            }
+        }
+        return;
+    }
+    for (auto child: children) {
+        if (child->size > 0 && intersects(queryBox, child->box)) {
+            child->queryHelper(queryBox, sink);
+        }
+    }
+}
+
+template<int D, typename T>
+void OrthTree<D, T>::query(const BoxType &queryBox, vector<PointType> &result) const {
+    query(queryBox, back_inserter(result));
+}
+
+template<int D, typename T>
+long OrthTree<D, T>::count(const BoxType &queryBox) const {
+    if (containsArea(queryBox, this->box)) {
+        return this->size;
+    } else if (this->isLeaf()) {
+        long result = 0;
+        for (auto &point: this->elements) {
+            result += containsPoint(queryBox, point);
+        }
+        return result;
+    }
+    long result = 0;
+    for (auto child: children) {
+        if (child->size > 0 && intersects(queryBox, child->box)) {
+            result += child->count(queryBox);
+        }
+    }
+    return result;
+}
+
+template<int D, typename T>
+vector<PointND<D, T>> OrthTree<D, T>::kNearestNeighbors(const PointType &queryPoint, int k) const {
+    vector<PointType> result;
+    Scratch scratch;
+    kNearestNeighbors(queryPoint, k, scratch, result);
+    return result;
+}
+
+template<int D, typename T>
+void OrthTree<D, T>::kNearestNeighbors(const PointType &queryPoint, int k, Scratch &scratch,
+                                       vector<PointType> &result) const {
+    scratch.reset(k);
+    kNearestNeighborsHelper(queryPoint, scratch);
+    scratch.extractSorted(result);
+}
+
+template<int D, typename T>
+void OrthTree<D, T>::kNearestNeighborsHelper(const PointType &queryPoint, Scratch &scratch) const {
+    scratch.visit();
+    if (this->isLeaf()) {
+        for (auto &point: this->elements) {
+            scratch.offer(point, pointDistance(point, queryPoint));
+        }
+        return;
+    }
+    // visit the children by increasing distance (insertion sort), the farther ones are often pruned by then
+    const OrthTree *order[CHILDREN];
+    SquaredDistance<T> distances[CHILDREN];
+    int nonEmpty = 0;
+    for (auto child: children) {
+        if (child->size == 0) {
+            continue;
+        }
+        SquaredDistance<T> distance = sqDistanceFrom(child->box, queryPoint);
+        int j = nonEmpty++;
+        for (; j > 0 && distances[j - 1] > distance; j--) {
+            order[j] = order[j - 1];
+            distances[j] = distances[j - 1];
+        }
+        order[j] = child;
+        distances[j] = distance;
+    }
+    for (int i = 0; i < nonEmpty && distances[i] < scratch.radius(); i++) {
+        order[i]->kNearestNeighborsHelper(queryPoint, scratch);
+    }
+}
+
+#endif //QUADKDBENCH_ORTHTREE_H
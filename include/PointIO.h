@@ -0,0 +1,136 @@
+/**
+ * @author Omar Chatila
+ * @file PointIO.h
+ * @brief Loading and storing point sets
+ *
+ * Text files contain one point per line, x and y separated by commas, semicolons or whitespace, like
+ * random_points.txt. Lines that do not start with two numbers (headers, comments) are skipped. Text files are mapped
+ * into memory and parsed by several threads, each one parsing the lines starting in its part of the file.
+ *
+ * Binary point files start with a PointFileHeader of 64 bytes followed by the coordinates x0 y0 x1 y1 ... as
+ * doubles or floats in little endian. Files with double coordinates are used without copying, MappedPointFile
+ * maps them privately so trees may reorder the points (copy-on-write) without changing the file.
+ */
+
+#ifndef QUADKDBENCH_POINTIO_H
+#define QUADKDBENCH_POINTIO_H
+
+#include "Util.h"
+#include <bits/stdc++.h>
+
+/**
+ * @brief Type of the coordinates stored in a binary point file
+ */
+enum CoordinateType : uint32_t {
+    FLOAT64_COORDINATES = 0,    /**< 8 byte doubles, loaded without copying */
+    FLOAT32_COORDINATES = 1     /**< 4 byte floats, converted to doubles when loaded */
+};
+
+/**
+ * Magic number at the start of every binary point file
+ */
+constexpr char POINT_FILE_MAGIC[8] = {'Q', 'K', 'D', 'P', 'O', 'I', 'N', 'T'};
+
+/**
+ * Current version of the binary point format
+ */
+constexpr uint32_t POINT_FILE_VERSION = 1;
+
+/**
+ * @brief Header of a binary point file
+ */
+struct PointFileHeader {
+    char magic[8];              /**< POINT_FILE_MAGIC */
+    uint32_t version;           /**< POINT_FILE_VERSION */
+    uint32_t coordinateType;    /**< CoordinateType of the coordinates */
+    uint64_t pointNumber;       /**< Number of points */
+    double xMin;                /**< Bounds of the points */
+    double xMax;
+    double yMin;
+    double yMax;
+    uint8_t reserved[8];        /**< Zero, pads the header to 64 bytes */
+};
+
+static_assert(sizeof(PointFileHeader) == 64, "the points of a binary file start at byte 64");
+
+/**
+ * @brief Parses a text file of points
+ * @param path path of the file
+ * @param threads number of parsing threads, hardware concurrency if 0
+ * @return points in the order of the file
+ * @throws std::runtime_error if the file cannot be read
+ */
+vector<Point> loadPointsText(const std::string &path, int threads = 0);
+
+/**
+ * @brief Writes points to a binary point file
+ * @param path path of the file, replaced if it exists
+ * @param points the points
+ * @param pointNumber number of points
+ * @param type type of the stored coordinates, FLOAT32_COORDINATES rounds them
+ * @throws std::runtime_error if the file cannot be written
+ */
+void savePointsBinary(const std::string &path, const Point *points, long pointNumber,
+                      CoordinateType type = FLOAT64_COORDINATES);
+
+/**
+ * @brief Points of a binary point file mapped into memory
+ *
+ * The points can be given to the Point* constructors of the trees as long as the MappedPointFile lives. They must
+ * not be released with free(), so trees built on them are deleted with delete instead of destroyTree().
+ */
+class MappedPointFile {
+private:
+    void *mapping = nullptr;        /**< Start of the mapped file */
+    size_t mappingSize = 0;         /**< Size of the mapping in bytes */
+    Point *points = nullptr;        /**< The points, inside the mapping or a converted copy */
+    bool converted = false;         /**< True if points is a copy released with free() */
+    PointFileHeader header{};       /**< Header of the file */
+
+    void release();
+
+public:
+    /**
+     * @brief Maps a binary point file
+     * @param path path of a file written by savePointsBinary()
+     * @throws std::runtime_error if the file cannot be read or is no valid point file
+     */
+    explicit MappedPointFile(const std::string &path);
+
+    MappedPointFile(const MappedPointFile &) = delete;
+
+    MappedPointFile &operator=(const MappedPointFile &) = delete;
+
+    MappedPointFile(MappedPointFile &&other) noexcept;
+
+    MappedPointFile &operator=(MappedPointFile &&other) noexcept;
+
+    ~MappedPointFile();
+
+    /**
+     * @return the points, writable
+     */
+    Point *data();
+
+    /**
+     * @return number of points
+     */
+    [[nodiscard]] long size() const;
+
+    /**
+     * @return bounds of the points stored in the header
+     */
+    [[nodiscard]] Area bounds() const;
+
+    /**
+     * @return type of the coordinates in the file
+     */
+    [[nodiscard]] CoordinateType coordinateType() const;
+
+    /**
+     * @return True if the points are used from the file without copying
+     */
+    [[nodiscard]] bool isZeroCopy() const;
+};
+
+#endif //QUADKDBENCH_POINTIO_H
@@ -0,0 +1,204 @@
+/**
+ * @author Omar Chatila
+ * @file PointND.h
+ * @brief Points and boxes with a compile-time number of dimensions
+ *
+ * The geometry helpers have the same names as the 2D ones of Util.h. Their loops over the axes run over the
+ * template parameter D, so the compiler unrolls them completely.
+ */
+
+#ifndef QUADKDBENCH_POINTND_H
+#define QUADKDBENCH_POINTND_H
+
+#include "Util.h"
+#include <array>
+
+/**
+ * @brief Calls f(std::integral_constant<int, axis>) for every axis in 0..D-1 without a loop
+ */
+template<int D, typename F>
+inline void forEachAxis(F &&f) {
+    [&]<int... axis>(std::integer_sequence<int, axis...>) {
+        (f(std::integral_constant<int, axis>{}), ...);
+    }(std::make_integer_sequence<int, D>{});
+}
+
+/**
+ * @brief A point with D coordinates
+ * @tparam D number of dimensions
+ * @tparam T coordinate type
+ */
+template<int D, typename T = double>
+struct PointND {
+    static constexpr int dimension = D;
+
+    std::array<T, D> coordinates; /**< The coordinates, x first */
+
+    T &operator[](int axis) {
+        return coordinates[axis];
+    }
+
+    const T &operator[](int axis) const {
+        return coordinates[axis];
+    }
+
+    friend std::ostream &operator<<(std::ostream &os, const PointND &point) {
+        os << "[";
+        for (int axis = 0; axis < D; axis++) {
+            os << (axis > 0 ? ":" : "") << point[axis];
+        }
+        return os << "]";
+    }
+
+    bool operator==(const PointND &other) const {
+        return coordinates == other.coordinates;
+    }
+};
+
+/**
+ * @brief Axis-aligned box, the D-dimensional Area
+ * @tparam D number of dimensions
+ * @tparam T coordinate type
+ */
+template<int D, typename T = double>
+struct BoxND {
+    std::array<T, D> min;   /**< Lower corner */
+    std::array<T, D> max;   /**< Upper corner */
+
+    friend std::ostream &operator<<(std::ostream &os, const BoxND &box) {
+        os << "[";
+        for (int axis = 0; axis < D; axis++) {
+            os << (axis > 0 ? " : " : "") << box.min[axis] << ":" << box.max[axis];
+        }
+        return os << "]";
+    }
+
+    bool operator==(const BoxND &other) const {
+        return min == other.min && max == other.max;
+    }
+};
+
+/**
+ * @brief Checks if box contains point, borders included
+ */
+template<int D, typename T>
+inline bool containsPoint(const BoxND<D, T> &box, const PointND<D, T> &point) {
+    bool result = true;
+    forEachAxis<D>([&](auto axis) {
+        result &= point[axis] >= box.min[axis] && point[axis] <= box.max[axis];
+    });
+    return result;
+}
+
+/**
+ * @brief Checks if two boxes intersect each other, also true if only their borders touch
+ */
+template<int D, typename T>
+inline bool intersects(const BoxND<D, T> &first, const BoxND<D, T> &other) {
+    bool result = true;
+    forEachAxis<D>([&](auto axis) {
+        result &= first.min[axis] <= other.max[axis] && first.max[axis] >= other.min[axis];
+    });
+    return result;
+}
+
+/**
+ * @brief Checks if container contains contained
+ */
+template<int D, typename T>
+inline bool containsArea(const BoxND<D, T> &container, const BoxND<D, T> &contained) {
+    bool result = true;
+    forEachAxis<D>([&](auto axis) {
+        result &= container.min[axis] <= contained.min[axis] && container.max[axis] >= contained.max[axis];
+    });
+    return result;
+}
+
+/**
+ * @brief Squared distance between box and point, 0 if box contains point
+ */
+template<int D, typename T>
+inline SquaredDistance<T> sqDistanceFrom(const BoxND<D, T> &box, const PointND<D, T> &point) {
+    using Distance = SquaredDistance<T>;
+    Distance result{};
+    forEachAxis<D>([&](auto axis) {
+        Distance d = max(max((Distance) box.min[axis] - (Distance) point[axis], Distance{}),
+                         (Distance) point[axis] - (Distance) box.max[axis]);
+        result += d * d;
+    });
+    return result;
+}
+
+/**
+ * @brief Squared distance between two points
+ */
+template<int D, typename T>
+inline SquaredDistance<T> pointDistance(const PointND<D, T> &p1, const PointND<D, T> &p2) {
+    using Distance = SquaredDistance<T>;
+    Distance result{};
+    forEachAxis<D>([&](auto axis) {
+        Distance d = (Distance) p1[axis] - (Distance) p2[axis];
+        result += d * d;
+    });
+    return result;
+}
+
+/**
+ * @brief Element of rank pos of points[left..right) by coordinate axis, rearranges the points like median()
+ */
+template<int D, typename T>
+inline T median(PointND<D, T> *points, int axis, int left, int right, int pos) {
+    std::nth_element(points + left, points + pos, points + right,
+                     [axis](const PointND<D, T> &a, const PointND<D, T> &b) { return a[axis] < b[axis]; });
+    return points[pos][axis];
+}
+
+/**
+ * @brief Passes a point to the sink of a range query
+ * @param sink callable taking a PointND or output iterator
+ * @param point point to be reported
+ */
+template<typename Sink, int D, typename T>
+inline void emitPoint(Sink &sink, const PointND<D, T> &point) {
+    if constexpr (std::is_invocable_v<Sink &, const PointND<D, T> &>) {
+        sink(point);
+    } else {
+        *sink = point;
+        ++sink;
+    }
+}
+
+/**
+ * @brief Passes a contiguous range of points to the sink of a range query
+ * @param sink callable taking a PointND or output iterator
+ * @param first pointer to the first point
+ * @param last pointer behind the last point
+ */
+template<typename Sink, int D, typename T>
+inline void emitPoints(Sink &sink, const PointND<D, T> *first, const PointND<D, T> *last) {
+    if constexpr (std::is_invocable_v<Sink &, const PointND<D, T> &>) {
+        for (; first != last; ++first) {
+            sink(*first);
+        }
+    } else {
+        sink = std::copy(first, last, sink);
+    }
+}
+
+namespace std {
+    /**
+     * @brief Hash specialization for PointND
+     */
+    template<int D, typename T>
+    struct hash<PointND<D, T>> {
+        size_t operator()(const PointND<D, T> &p) const {
+            size_t result = 0;
+            for (int axis = 0; axis < D; axis++) {
+                result = (result << 1) ^ hash<T>()(p[axis]);
+            }
+            return result;
+        }
+    };
+}
+
+#endif //QUADKDBENCH_POINTND_H
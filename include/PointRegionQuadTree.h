@@ -6,42 +6,31 @@
 #define QUADKDBENCH_PointRegionQuadTree_H
 
 #include "Util.h"
+#include "KNNScratch.h"
+#include "NodeArena.h"
+#include "CapacityProfile.h"
+#include "WorkStealingPool.h"
 #include <bits/stdc++.h>
 
 /**
  * @brief A class representing a Point-Region-QuadTree data structure.
+ * @tparam T coordinate type, double, float or int32_t. Integer coordinates are split at exact centers
  */
-class PointRegionQuadTree {
-    /**
-     * @brief A comparison struct for prioritizing Point-Region-QuadTree nodes based on distance from a query point.
-     */
-    struct ComparePointRegionQuadTree {
-        const Point &queryPoint;
-
-        /**
-         * @brief Constructor for CompareQuadTree.
-         * @param p The query point to calculate distances from.
-         */
-        explicit ComparePointRegionQuadTree(const Point &p) : queryPoint(p) {}
-
-        /**
-         * @brief Overloaded operator to compare QuadTree nodes based on squared distance from the query point.
-         * @param a The first QuadTree node.
-         * @param b The second QuadTree node.
-         * @return True if the squared distance from node a is greater than from node b; false otherwise.
-         */
-        bool operator()(PointRegionQuadTree *a, PointRegionQuadTree *b) const {
-            return sqDistanceFrom(a->square, queryPoint) > sqDistanceFrom(b->square, queryPoint);
-        }
-    };
+template<typename T>
+class BasicPointRegionQuadTree {
+public:
+    using PointType = BasicPoint<T>;
+    using AreaType = BasicArea<T>;
+    using Scratch = BasicKNNScratch<T>;
 
+private:
     /**
      * Overloads output stream operator to print information of KD-Tree node
      * @param os
      * @param kdTreeEfficient
      * @return String representation of KD-Tree
      */
-    friend std::ostream &operator<<(std::ostream &os, const PointRegionQuadTree &PointRegionQuadTree) {
+    friend std::ostream &operator<<(std::ostream &os, const BasicPointRegionQuadTree &PointRegionQuadTree) {
         os << std::fixed << std::setprecision(1);
         if (!PointRegionQuadTree.elements.empty())
             return os << "A:" << PointRegionQuadTree.square << "elements:" << PointRegionQuadTree.elements.front()
@@ -49,20 +38,37 @@ class PointRegionQuadTree {
         return os << "A:" << PointRegionQuadTree.square << "\n";
     }
 
-private:
-    PointRegionQuadTree *children[4]{};  /**< Pointers to the 4 children of the QuadTree node. */
-    Area square{};                       /**< The area covered by the QuadTree node. */
-    vector<Point> elements;              /**< The vector of points associated with the QuadTree node. */
-    int capacity;                        /**< Capacity of a leaf */
+    BasicPointRegionQuadTree *children[4]{}; /**< Pointers to the 4 children of the QuadTree node. */
+    AreaType square{};                       /**< The area covered by the QuadTree node. */
+    std::pmr::vector<PointType> elements;    /**< The vector of points associated with the QuadTree node. */
+    int capacity;                            /**< Capacity of a leaf */
+    long size;                               /**< Number of points in the subtree */
+    Aggregate *summary{};                    /**< Aggregate of the subtree, set by buildAggregates() */
+    BasicWeightFunction<T> weight{};         /**< Weight of a point, set by buildAggregates() */
+    NodeArena *arena{};                      /**< Arena of nodes and element vectors, nullptr if they are on the heap */
+
+    /**
+    * @brief Constructs a child node
+    * @param square The square area covered by the node
+    * @param elements The points of the node, allocated by the resource of arena
+    * @param capacity Capacity of a leaf
+    * @param arena arena of the tree, may be nullptr
+    */
+    BasicPointRegionQuadTree(AreaType square, std::pmr::vector<PointType> &&elements, int capacity, NodeArena *arena);
 
     /**
     * @brief Locates the quadrant of the QuadTree based on the specified coordinates.
-    * @param pointX The x-coordinate of the point to be located.
-    * @param pointY The y-coordinate of the point to be located.
+    * @param point The point to be located.
     * @param current The current QuadTree node being considered.
     * @return The QuadTree node representing the located quadrant.
     */
-    static PointRegionQuadTree *locateQuadrant(double pointX, double pointY, PointRegionQuadTree *current);
+    static BasicPointRegionQuadTree *locateQuadrant(const PointType &point, BasicPointRegionQuadTree *current);
+
+    /**
+    * @brief Checks if subdivide() can separate the points of this node
+    * @return False if all points are equal or halving the square would not change its borders, true otherwise
+    */
+    [[nodiscard]] bool canSubdivide() const;
 
     /**
     * @brief Subdivides the square and points into 4 partitions and creates 4 children
@@ -70,18 +76,53 @@ private:
     void subdivide();
 
     /**
-    * @brief Helper method for kNearestNeighbors(Point &queryPoint, int k). Adds k-nearest neighbor of Quadtree node to result vector
+    * @brief Subdivides like subdivide(), large point sets are classified in parallel chunks
+    * @param pool pool classifying the points
+    */
+    void subdivide(WorkStealingPool &pool);
+
+    /**
+    * @brief Builds the subtree, nodes above PARALLEL_BUILD_DEPTH build their children as tasks
+    * @param depth depth of this node
+    * @param pool pool running the tasks
+    */
+    void buildTree(int depth, WorkStealingPool &pool);
+
+    /**
+    * @brief Helper method for aggregate(Area &). Adds the weights of the points of this subtree inside queryRectangle
+    * @param queryRectangle Rectangle that contains points of interest
+    * @param result aggregate the points are added to
+    */
+    void aggregateHelper(AreaType &queryRectangle, Aggregate &result);
+
+    /**
+    * @brief Recomputes the aggregate of this node from its points or from the aggregates of its children
+    */
+    void updateAggregate();
+
+    /**
+    * @brief Turns a node whose subtree holds at most capacity points back into a leaf and deletes its children
+    */
+    void collapse();
+
+    /**
+    * @brief Helper method for query(Area &, Sink). Reports the points of this subtree inside queryRectangle
+    * @param queryRectangle Rectangle that contains points of interest
+    * @param sink callable taking a Point or output iterator
+    */
+    template<typename Sink>
+    void queryHelper(AreaType &queryRectangle, Sink &sink);
+
+    /**
+    * @brief Helper method for kNearestNeighbors. Offers the points of this subtree to the candidate heap
     *
-    * Recursively traverses Quadtree nodes to find k nearest neighbors. Uses priority to keep track of proximity to query Point
+    * Visits the children in order of increasing distance of their squares to queryPoint and skips children
+    * that are farther away than the current k-th best candidate
     *
-    * @param node The Quadtree that is used for k-NNS
-    * @param k The number of neighbors
-    * @param queue Priority Queue that prioritizes nodes by proximity of its square to a queryPoint
-    * @param result Vector that contains the k nearest neighbors
+    * @param queryPoint The point of which the k nearest neighbors are determined
+    * @param scratch Candidate heap of the running search
     */
-    void kNearestNeighborsHelper(PointRegionQuadTree *node, int k,
-                                 priority_queue<PointRegionQuadTree *, std::vector<PointRegionQuadTree *>, ComparePointRegionQuadTree> &queue,
-                                 std::vector<Point> &result, Point &queryPoint);
+    void kNearestNeighborsHelper(const PointType &queryPoint, Scratch &scratch) const;
 
 public:
     /**
@@ -89,18 +130,37 @@ public:
     * @param square The square area covered by the QuadTree.
     * @param elements The vector of points contained in the QuadTree.
     */
-    PointRegionQuadTree(Area square, vector<Point> &elements, int capacity);
+    BasicPointRegionQuadTree(AreaType square, vector<PointType> &elements, int capacity);
+
+    /**
+    * @brief Constructs a QuadTree whose nodes, element vectors and aggregates are allocated in arena
+    *
+    * The arena has to outlive the tree. Destroying the tree does not free the nodes, the arena does
+    * @param square The square area covered by the QuadTree.
+    * @param elements The vector of points contained in the QuadTree.
+    * @param capacity Capacity of a leaf
+    * @param arena arena for nodes, element vectors and aggregates
+    */
+    BasicPointRegionQuadTree(AreaType square, vector<PointType> &elements, int capacity, NodeArena &arena);
+
+    /**
+    * @brief Constructs a QuadTree whose leaf capacity is taken from a tuned profile
+    * @param square The square area covered by the QuadTree.
+    * @param elements The vector of points contained in the QuadTree.
+    * @param profile leaf capacity per size class, the class of elements.size() is used for all nodes
+    */
+    BasicPointRegionQuadTree(AreaType square, vector<PointType> &elements, const CapacityProfile &profile);
 
     /**
     * @brief destroys the Quadtree and deallocates memory
     */
-    ~PointRegionQuadTree();
+    ~BasicPointRegionQuadTree();
 
     /**
     * @brief Checks if a node is a leaf
     * @return True if node is leaf, false otherwise
     */
-    bool isNodeLeaf();
+    bool isNodeLeaf() const;
 
     /**
     * @brief Checks if a node is a leaf containing a point
@@ -116,22 +176,71 @@ public:
 
     /**
     * @brief Builds the Quadtree
-    * Builds Quadtree by subdividing its square and points into 4 Quadrants. Splits as long as elements.size() > 1
+    * Builds Quadtree by subdividing its square and points into 4 Quadrants. Splits as long as a node holds more than
+    * capacity points that subdivide() can separate, so leaves of equal points may exceed the capacity
     */
     void buildTree();
 
+    /**
+    * @brief Builds the Quadtree in parallel. The result is identical to buildTree()
+    *
+    * Trees allocated in a NodeArena are built serially
+    * @param pool pool running the tasks
+    */
+    void buildTree(WorkStealingPool &pool);
+
     /**
     * @param queryRectangle Rectangle that contains points of interest
     * @return list<Point> of points contained by queryRectangle
     */
-    list<Point> query(Area &queryRectangle);
+    list<PointType> query(AreaType &queryRectangle);
+
+    /**
+    * @brief Reports every point contained by queryRectangle to sink, no intermediate lists are built
+    * @param queryRectangle Rectangle that contains points of interest
+    * @param sink callable taking a Point or output iterator
+    * @return sink after all points have been reported
+    */
+    template<typename Sink>
+    Sink query(AreaType &queryRectangle, Sink sink);
+
+    /**
+    * @brief Appends the points contained by queryRectangle to result
+    * @param queryRectangle Rectangle that contains points of interest
+    * @param result vector that is reused between queries, it is not cleared
+    */
+    void query(AreaType &queryRectangle, vector<PointType> &result);
+
+    /**
+    * @brief Counts the points contained by queryRectangle
+    *
+    * Subtrees inside queryRectangle add their number of elements in O(1) instead of being traversed
+    * @param queryRectangle Rectangle that contains points of interest
+    * @return number of points inside queryRectangle
+    */
+    long count(AreaType &queryRectangle);
+
+    /**
+    * @brief Stores count, sum, minimum and maximum of weight in every node. Kept up to date by add()
+    * @param weight weight of a point
+    */
+    void buildAggregates(BasicWeightFunction<T> weight);
+
+    /**
+    * @brief Aggregates the weights of the points contained by queryRectangle
+    *
+    * Requires buildAggregates(). Subtrees inside queryRectangle add their stored aggregate in O(1)
+    * @param queryRectangle Rectangle that contains points of interest
+    * @return aggregate of the points inside queryRectangle
+    */
+    Aggregate aggregate(AreaType &queryRectangle);
 
     /**
     * @brief Checks if a given point is contained by the Quadtree
     * @param point
     * @return True if Quadtree contains point, false otherwise
     */
-    bool contains(Point &point);
+    bool contains(PointType &point);
 
     /**
     * Checks if Quadtree is empty, meaning it does not contains any elements
@@ -143,7 +252,17 @@ public:
      * Adds a given Point to the Quadtree
      * @param point Point to be added
      */
-    void add(Point &point);
+    void add(PointType &point);
+
+    /**
+     * @brief Removes one occurrence of point from the Quadtree and updates the aggregates
+     *
+     * Interior nodes on the path drop their copy of the subtree points, so query() descends into them afterwards.
+     * Nodes whose subtree is left with at most capacity points are collapsed into a leaf
+     * @param point Point to be removed
+     * @return True if point was contained and removed, false otherwise
+     */
+    bool remove(PointType &point);
 
     /**
      * Get k nearest neighbors of a query point
@@ -151,8 +270,52 @@ public:
      * @param k The number of neighbors
      * @return vector containing k nearest neighbors of queryPoint
      */
-    vector<Point> kNearestNeighbors(Point &queryPoint, int k);
+    vector<PointType> kNearestNeighbors(const PointType &queryPoint, int k) const;
+
+    /**
+     * Get k nearest neighbors of a query point without allocating
+     * @param queryPoint The point of which the k nearest neighbors are determined
+     * @param k The number of neighbors
+     * @param scratch Candidate heap that is reused between queries
+     * @param result vector that is overwritten with the k nearest neighbors, ordered by distance
+     */
+    void kNearestNeighbors(const PointType &queryPoint, int k, Scratch &scratch, vector<PointType> &result) const;
 };
 
+/**
+ * Point-Region-QuadTree with double coordinates
+ */
+using PointRegionQuadTree = BasicPointRegionQuadTree<double>;
+
+
+template<typename T>
+template<typename Sink>
+Sink BasicPointRegionQuadTree<T>::query(AreaType &queryRectangle, Sink sink) {
+    queryHelper(queryRectangle, sink);
+    return sink;
+}
+
+template<typename T>
+template<typename Sink>
+void BasicPointRegionQuadTree<T>::queryHelper(AreaType &queryRectangle, Sink &sink) {
+    // leaves of equal points may hold more than capacity points
+    if (this->isNodeLeaf()) {
+        for (auto &point: this->elements) {
+            if (containsPoint(queryRectangle, point)) {
+                emitPoint(sink, point);
+            }
+        }
+        return;
+    } else if (containsArea(queryRectangle, this->square) && (long) this->elements.size() == this->size) {
+        emitPoints(sink, this->elements.data(), this->elements.data() + this->elements.size());
+        return;
+    }
+
+    for (auto child: this->children) {
+        if (child != nullptr && intersects(queryRectangle, child->square)) {
+            child->queryHelper(queryRectangle, sink);
+        }
+    }
+}
 
 #endif //QUADKDBENCH_PointRegionQuadTree_H
@@ -9,75 +9,79 @@
 #define QUADKDBENCH_QUADTREE_H
 
 #include "Util.h"
+#include "KNNScratch.h"
+#include "NodeArena.h"
+#include "WorkStealingPool.h"
 #include <bits/stdc++.h>
 
 /**
  * @brief A class representing a QuadTree data structure.
+ * @tparam T coordinate type, double, float or int32_t. Integer coordinates are split at exact centers
  */
-class QuadTree {
-    /**
-     * @brief A comparison struct for prioritizing QuadTree nodes based on distance from a query point.
-     */
-    struct CompareQuadTree {
-        const Point &queryPoint;
-
-        /**
-         * @brief Constructor for CompareQuadTree.
-         * @param p The query point to calculate distances from.
-         */
-        explicit CompareQuadTree(const Point &p) : queryPoint(p) {}
-
-        /**
-         * @brief Overloaded operator to compare QuadTree nodes based on squared distance from the query point.
-         * @param a The first QuadTree node.
-         * @param b The second QuadTree node.
-         * @return True if the squared distance from node a is greater than from node b; false otherwise.
-         */
-        bool operator()(QuadTree *a, QuadTree *b) const {
-            return sqDistanceFrom(a->square, queryPoint) > sqDistanceFrom(b->square, queryPoint);
-        }
-    };
+template<typename T>
+class BasicQuadTree {
+public:
+    using PointType = BasicPoint<T>;
+    using AreaType = BasicArea<T>;
+    using Scratch = BasicKNNScratch<T>;
 
+private:
     /**
      * @brief Overloaded << operator to stream the QuadTree information.
      * @param os The output stream.
      * @param quadTree The QuadTree instance to be streamed.
      * @return The output stream.
      */
-    friend std::ostream &operator<<(std::ostream &os, const QuadTree &quadTree) {
+    friend std::ostream &operator<<(std::ostream &os, const BasicQuadTree &quadTree) {
         os << std::fixed << std::setprecision(1);
         if (!quadTree.elements.empty())
             return os << "A:" << quadTree.square << "elements:" << quadTree.elements.front() << "\n";
         return os << "A:" << quadTree.square << "\n";
     }
 
-private:
-    QuadTree *children[4]{}; /**< Pointers to the 4 children of the QuadTree node. */
-    Area square;             /**< The area covered by the QuadTree node. */
-    vector<Point> elements;  /**< The vector of points associated with the QuadTree node. */
+    BasicQuadTree *children[4]{};         /**< Pointers to the 4 children of the QuadTree node. */
+    AreaType square;                      /**< The area covered by the QuadTree node. */
+    std::pmr::vector<PointType> elements; /**< The vector of points associated with the QuadTree node. */
+    long size;                            /**< Number of points in the subtree */
+    NodeArena *arena{};                   /**< Arena of nodes and element vectors, nullptr if they are on the heap */
+
+    /**
+     * @brief Constructs a child node
+     * @param square The square area covered by the node
+     * @param elements The points of the node, allocated by the resource of arena
+     * @param arena arena of the tree, may be nullptr
+     */
+    BasicQuadTree(AreaType square, std::pmr::vector<PointType> &&elements, NodeArena *arena);
+
+    /**
+     * @brief Helper method for query(Area &, Sink). Reports the points of this subtree inside queryRectangle
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param sink callable taking a Point or output iterator
+     */
+    template<typename Sink>
+    void queryHelper(AreaType &queryRectangle, Sink &sink);
 
     /**
-     * @brief Helper method for kNearestNeighbors(Point &queryPoint, int k). Adds k-nearest neighbor of Quadtree node to result vector
+     * @brief Helper method for kNearestNeighbors. Offers the points of this subtree to the candidate heap
      *
-     * Recursively traverses Quadtree nodes to find k nearest neighbors. Uses priority to keep track of proximity to query Point
+     * Visits the children in order of increasing distance of their squares to queryPoint and skips children
+     * that are farther away than the current k-th best candidate
      *
-     * @param node The Quadtree that is used for k-NNS
-     * @param k The number of neighbors
-     * @param queue Priority Queue that prioritizes nodes by proximity of its square to a queryPoint
-     * @param result Vector that contains the k nearest neighbors
+     * @param queryPoint The point of which the k nearest neighbors are determined
+     * @param scratch Candidate heap of the running search
      */
-    void kNearestNeighborsHelper(QuadTree *node, int k,
-                                 priority_queue<QuadTree *, std::vector<QuadTree *>, CompareQuadTree> &queue,
-                                 std::vector<Point> &result);
+    void kNearestNeighborsHelper(const PointType &queryPoint, Scratch &scratch) const;
 
     /**
      * @brief Determines the quadrant of a point based on the given split coordinates.
+     *
+     * Branchless, for integer coordinates the comparisons are exact
      * @param point The point to be located.
      * @param xMid The x-coordinate of the midpoint.
      * @param yMid The y-coordinate of the midpoint.
      * @return The quadrant index (0 to 3) where the point belongs.
      */
-    static int determineQuadrant(const Point &point, double xMid, double yMid);
+    static int determineQuadrant(const PointType &point, T xMid, T yMid);
 
     /**
      * @brief Locates the quadrant of the QuadTree based on the specified coordinates.
@@ -86,31 +90,65 @@ private:
      * @param current The current QuadTree node being considered.
      * @return The QuadTree node representing the located quadrant.
      */
-    static QuadTree *locateQuadrant(Point &point, QuadTree *current);
+    static BasicQuadTree *locateQuadrant(PointType &point, BasicQuadTree *current);
 
     /**
      * @brief Subdivides the square and points into 4 partitions and creates 4 children
      */
     void subdivide();
 
+    /**
+     * @brief Checks if halving the square still changes one of its borders
+     * @return True if subdivide() creates children smaller than this node, false otherwise
+     */
+    [[nodiscard]] bool canSubdivide() const;
+
+    /**
+     * @brief Subdivides like subdivide(), large point sets are classified in parallel chunks
+     * @param pool pool classifying the points
+     */
+    void subdivide(WorkStealingPool &pool);
+
+    /**
+     * @brief Builds the subtree, nodes above PARALLEL_BUILD_DEPTH build their children as tasks
+     * @param depth depth of this node
+     * @param pool pool running the tasks
+     */
+    void buildTree(int depth, WorkStealingPool &pool);
+
+    /**
+     * @brief Turns a node whose subtree holds at most one point back into a leaf and deletes its children
+     */
+    void collapse();
+
 public:
     /**
      * @brief Constructs a QuadTree with the specified square area and elements.
      * @param square The square area covered by the QuadTree.
      * @param elements The vector of points contained in the QuadTree.
      */
-    QuadTree(Area square, vector<Point> &elements);
+    BasicQuadTree(AreaType square, vector<PointType> &elements);
+
+    /**
+     * @brief Constructs a QuadTree whose nodes and element vectors are allocated in arena
+     *
+     * The arena has to outlive the tree. Destroying the tree does not free the nodes, the arena does
+     * @param square The square area covered by the QuadTree.
+     * @param elements The vector of points contained in the QuadTree.
+     * @param arena arena for nodes and element vectors
+     */
+    BasicQuadTree(AreaType square, vector<PointType> &elements, NodeArena &arena);
 
     /**
      * @brief destroys the Quadtree and deallocates memory
      */
-    ~QuadTree();
+    ~BasicQuadTree();
 
     /**
      * @brief Checks if a node is a leaf
      * @return True if node is leaf, false otherwise
      */
-    bool isNodeLeaf();
+    bool isNodeLeaf() const;
 
     /**
      * @brief Checks if a node is a leaf containing a point
@@ -127,21 +165,46 @@ public:
     /**
      * @brief Builds the Quadtree
      * Builds Quadtree by subdividing its square and points into 4 Quadrants. Splits as long as elements.size() > 1
+     * and the square can be halved
      */
     void buildTree();
 
+    /**
+     * @brief Builds the Quadtree in parallel. The result is identical to buildTree()
+     *
+     * Trees allocated in a NodeArena are built serially
+     * @param pool pool running the tasks
+     */
+    void buildTree(WorkStealingPool &pool);
+
     /**
      * @param queryRectangle Rectangle that contains points of interest
      * @return list<Point> of points contained by queryRectangle
      */
-    list<Point> query(Area &queryRectangle);
+    list<PointType> query(AreaType &queryRectangle);
+
+    /**
+     * @brief Reports every point contained by queryRectangle to sink, no intermediate lists are built
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param sink callable taking a Point or output iterator
+     * @return sink after all points have been reported
+     */
+    template<typename Sink>
+    Sink query(AreaType &queryRectangle, Sink sink);
+
+    /**
+     * @brief Appends the points contained by queryRectangle to result
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param result vector that is reused between queries, it is not cleared
+     */
+    void query(AreaType &queryRectangle, vector<PointType> &result);
 
     /**
      * @brief Checks if a given point is contained by the Quadtree
      * @param point
      * @return True if Quadtree contains point, false otherwise
      */
-    bool contains(Point &point);
+    bool contains(PointType &point);
 
     /**
      * Checks if Quadtree is empty, meaning it does not contains any elements
@@ -153,7 +216,17 @@ public:
      * Adds a given Point to the Quadtree
      * @param point Point to be added
      */
-    void add(Point &point);
+    void add(PointType &point);
+
+    /**
+     * @brief Removes one occurrence of point from the Quadtree
+     *
+     * Interior nodes on the path drop their copy of the subtree points, so query() descends into them afterwards.
+     * Nodes whose subtree is left with at most one point are collapsed into a leaf
+     * @param point Point to be removed
+     * @return True if point was contained and removed, false otherwise
+     */
+    bool remove(PointType &point);
 
     /**
      * Get k nearest neighbors of a query point
@@ -161,8 +234,54 @@ public:
      * @param k The number of neighbors
      * @return vector containing k nearest neighbors of queryPoint
      */
-    vector<Point> kNearestNeighbors(Point &queryPoint, int k);
+    vector<PointType> kNearestNeighbors(const PointType &queryPoint, int k) const;
+
+    /**
+     * Get k nearest neighbors of a query point without allocating
+     * @param queryPoint The point of which the k nearest neighbors are determined
+     * @param k The number of neighbors
+     * @param scratch Candidate heap that is reused between queries
+     * @param result vector that is overwritten with the k nearest neighbors, ordered by distance
+     */
+    void kNearestNeighbors(const PointType &queryPoint, int k, Scratch &scratch, vector<PointType> &result) const;
 };
 
+/**
+ * QuadTree with double coordinates
+ */
+using QuadTree = BasicQuadTree<double>;
+
+
+template<typename T>
+template<typename Sink>
+Sink BasicQuadTree<T>::query(AreaType &queryRectangle, Sink sink) {
+    queryHelper(queryRectangle, sink);
+    return sink;
+}
+
+template<typename T>
+template<typename Sink>
+void BasicQuadTree<T>::queryHelper(AreaType &queryRectangle, Sink &sink) {
+    // if Quadtree is a leaf, report its points contained by queryRectangle. Leaves hold more than one point only
+    // if the points are equal or their square cannot be halved
+    if (this->isNodeLeaf()) {
+        for (auto &point: this->elements) {
+            if (containsPoint(queryRectangle, point)) {
+                emitPoint(sink, point);
+            }
+        }
+        return;
+        // if queryRectangle contains the Quadtree square, all its elements are inside queryRectangle
+    } else if (containsArea(queryRectangle, this->square) && (long) this->elements.size() == this->size) {
+        emitPoints(sink, this->elements.data(), this->elements.data() + this->elements.size());
+        return;
+    }
+    // For each child: check if its area intersects queryRectangle. If yes, recursively report its points
+    for (auto child: this->children) {
+        if (child != nullptr && intersects(queryRectangle, child->square)) {
+            child->queryHelper(queryRectangle, sink);
+        }
+    }
+}
 
 #endif //QUADKDBENCH_QUADTREE_H
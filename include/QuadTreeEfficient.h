@@ -0,0 +1,196 @@
+/**
+ * @author Omar Chatila
+ * @file QuadTreeEfficient.h
+ * @brief Implementation of a Point-QuadTree with leaf capacity 1 on a shared points array
+ *
+ * Instead of copying the points of a node into 4 new vectors, the points array is partitioned in place
+ * into 4 contiguous ranges, one per quadrant. Every node only stores the bounds of its range.
+ */
+
+#ifndef QUADKDBENCH_QUADTREEEFFICIENT_H
+#define QUADKDBENCH_QUADTREEEFFICIENT_H
+
+#include "Util.h"
+#include "KNNScratch.h"
+#include <bits/stdc++.h>
+
+/**
+ * @brief A class representing a QuadTree on index ranges of a points array.
+ */
+class QuadTreeEfficient {
+    /**
+     * @brief Overloaded << operator to stream the QuadTree information.
+     * @param os The output stream.
+     * @param quadTree The QuadTree instance to be streamed.
+     * @return The output stream.
+     */
+    friend std::ostream &operator<<(std::ostream &os, const QuadTreeEfficient &quadTree) {
+        os << std::fixed << std::setprecision(1);
+        return os << "A:" << quadTree.square << "f:" << quadTree.from << "t:" << quadTree.to << "\n";
+    }
+
+private:
+    QuadTreeEfficient *children[4]{};  /**< Pointers to the 4 children of the QuadTree node. */
+    Area square{};                     /**< The area covered by the QuadTree node. */
+    Point *points;                     /**< The array of points shared by all nodes. */
+    int from, to;                      /**< Lower bound of points, higher bound of points (inclusive) */
+
+    /**
+     * @brief Constructs a QuadTree node covering the points range [from, to]
+     * @param points array of points
+     * @param square The square area covered by the node
+     * @param from lower bound of point array
+     * @param to upper bound of point array
+     */
+    QuadTreeEfficient(Point *points, Area square, int from, int to);
+
+    /**
+     * @brief Partitions the points range into 4 contiguous quadrant ranges and creates 4 children
+     *
+     * The ranges are ordered by the Quadrant enum: NORTH_WEST, NORTH_EAST, SOUTH_WEST, SOUTH_EAST
+     */
+    void subdivide();
+
+    /**
+     * @brief Helper method for query(Area &, Sink). Reports the points of this subtree inside queryRectangle
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param sink callable taking a Point or output iterator
+     */
+    template<typename Sink>
+    void queryHelper(Area &queryRectangle, Sink &sink);
+
+    /**
+     * @brief Helper method for kNearestNeighbors. Offers the points of this subtree to the candidate heap
+     *
+     * Visits the children in order of increasing distance of their squares to queryPoint and skips children
+     * that are farther away than the current k-th best candidate
+     *
+     * @param queryPoint The point of which the k nearest neighbors are determined
+     * @param scratch Candidate heap of the running search
+     */
+    void kNearestNeighborsHelper(const Point &queryPoint, KNNScratch &scratch);
+
+public:
+    /**
+     * @brief Constructs a QuadTree containing all points of the array
+     * @param points array of points, rearranged by buildTree()
+     * @param square The square area covered by the QuadTree
+     * @param size number of points
+     */
+    QuadTreeEfficient(Point *points, Area &square, int size);
+
+    /**
+     * @brief destroys the Quadtree and deallocates memory
+     */
+    ~QuadTreeEfficient();
+
+    /**
+     * @brief Builds the Quadtree
+     *
+     * Subdivides as long as a node contains more than one point. Equal points end up in one leaf
+     * once the square cannot be split any further
+     */
+    void buildTree();
+
+    /**
+     * @brief Checks if a node is a leaf
+     * @return True if node is leaf, false otherwise
+     */
+    [[nodiscard]] bool isNodeLeaf() const;
+
+    /**
+     * @brief Calculates height of the Quadtree
+     * @return The height of the Quadtree
+     */
+    int getHeight();
+
+    /**
+     * @brief Checks if a given point is contained by the Quadtree
+     * @param point
+     * @return True if Quadtree contains point, false otherwise
+     */
+    bool contains(Point &point);
+
+    /**
+     * @param queryRectangle Rectangle that contains points of interest
+     * @return list<Point> of points contained by queryRectangle
+     */
+    list<Point> query(Area &queryRectangle);
+
+    /**
+     * @brief Reports every point contained by queryRectangle to sink, no intermediate lists are built
+     *
+     * Squares inside queryRectangle are reported as one contiguous slice of the points array
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param sink callable taking a Point or output iterator
+     * @return sink after all points have been reported
+     */
+    template<typename Sink>
+    Sink query(Area &queryRectangle, Sink sink);
+
+    /**
+     * @brief Appends the points contained by queryRectangle to result
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param result vector that is reused between queries, it is not cleared
+     */
+    void query(Area &queryRectangle, vector<Point> &result);
+
+    /**
+     * @brief Counts the points contained by queryRectangle
+     * @param queryRectangle Rectangle that contains points of interest
+     * @return number of points inside queryRectangle
+     */
+    long count(Area &queryRectangle);
+
+    /**
+     * Get k nearest neighbors of a query point
+     * @param queryPoint The point of which the k nearest neighbors are determined
+     * @param k The number of neighbors
+     * @return vector containing k nearest neighbors of queryPoint
+     */
+    vector<Point> kNearestNeighbors(Point &queryPoint, int k);
+
+    /**
+     * Get k nearest neighbors of a query point without allocating
+     * @param queryPoint The point of which the k nearest neighbors are determined
+     * @param k The number of neighbors
+     * @param scratch Candidate heap that is reused between queries
+     * @param result vector that is overwritten with the k nearest neighbors, ordered by distance
+     */
+    void kNearestNeighbors(Point &queryPoint, int k, KNNScratch &scratch, vector<Point> &result);
+
+    /**
+     * @return array of points the tree was built on, in tree order
+     */
+    Point *getPoints();
+};
+
+
+template<typename Sink>
+Sink QuadTreeEfficient::query(Area &queryRectangle, Sink sink) {
+    queryHelper(queryRectangle, sink);
+    return sink;
+}
+
+template<typename Sink>
+void QuadTreeEfficient::queryHelper(Area &queryRectangle, Sink &sink) {
+    // squares inside queryRectangle report their whole range
+    if (containsArea(queryRectangle, this->square)) {
+        emitPoints(sink, this->points + from, this->points + to + 1);
+        return;
+    } else if (this->isNodeLeaf()) {
+        for (int i = from; i <= to; i++) {
+            if (containsPoint(queryRectangle, this->points[i])) {
+                emitPoint(sink, this->points[i]);
+            }
+        }
+        return;
+    }
+    for (auto child: this->children) {
+        if (child->from <= child->to && intersects(queryRectangle, child->square)) {
+            child->queryHelper(queryRectangle, sink);
+        }
+    }
+}
+
+#endif //QUADKDBENCH_QUADTREEEFFICIENT_H
@@ -4,47 +4,58 @@
  * @brief Implementation of a KD-Tree
  *
  * This version of KD-Trees uses a sorting algorithm to determine the median
- * Building the tree in O(nlog(n)^2)
+ * Building the tree in O(nlog(n)^2), or in O(nlog(n)) with buildTreePresorted()
  */
 
 #ifndef QUADKDBENCH_SORTKDTREE_H
 #define QUADKDBENCH_SORTKDTREE_H
 
 #include "Util.h"
+#include "KNNScratch.h"
+#include "NodeArena.h"
 #include <bits/stdc++.h>
 
 using namespace std;
 
-class SortKDTree {
-    /**
-     * @brief A comparison struct for prioritizing KD-Tree areas based on distance from a query point.
-     */
-    struct CompareMKDTree {
-        const Point &queryPoint;
+/**
+ * A child of a SortKDTree node holding more than this fraction of the points of the node violates the balance
+ * invariant of add()
+ */
+constexpr double SCAPEGOAT_ALPHA = 0.7;
 
-        /**
-         * @brief Constructor for CompareMKDTree.
-         * @param p The query point to calculate distances from.
-         */
-        explicit CompareMKDTree(const Point &p) : queryPoint(p) {}
+/**
+ * @brief KD-Tree whose nodes store their points sorted by the split coordinate
+ * @tparam T coordinate type, double, float or int32_t
+ */
+template<typename T>
+class BasicSortKDTree {
+public:
+    using PointType = BasicPoint<T>;
+    using AreaType = BasicArea<T>;
+    using Scratch = BasicKNNScratch<T>;
 
-        /**
-         * @brief Overloaded operator to compare SortKDTree nodes based on squared distance from the query point.
-         * @param a The first SortKDTree node.
-         * @param b The second SortKDTree node.
-         * @return True if the squared distance of point p to  node a is greater than to node b; false otherwise.
-         */
-        bool operator()(SortKDTree *a, SortKDTree *b) const {
-            return sqDistanceFrom(a->area, queryPoint) > sqDistanceFrom(b->area, queryPoint);
-        }
+private:
+    /**
+     * @brief Node of the compacted tree, the left child directly follows its parent
+     */
+    struct CompactNode {
+        T split;          /**< Median of the split coordinate, not used by leaves */
+        int right;        /**< Index of the right child, -1 for leaves */
+        int from;         /**< First index of the subtree points in leafPoints */
+        int to;           /**< Index after the last subtree point in leafPoints */
     };
 
-private:
-    Area area{};                 /**< The area covered by the SortKDTree node. */
+    AreaType area{};                 /**< The area covered by the SortKDTree node, the bounding box of its points if tightAreas is set */
     int level;                 /**< The level of the node node in the KD Tree. */
-    vector<Point> points;      /**< The vector of points associated with the KD-Tree node. */
-    SortKDTree *leftChild{};       /**< Pointer to the left child of the SortKDTree node. */
-    SortKDTree *rightChild{};      /**< Pointer to the right child of the SortKDTree node. */
+    std::pmr::vector<PointType> points; /**< The vector of points associated with the KD-Tree node. */
+    long size;                 /**< Number of points in the subtree */
+    T split{};                 /**< Median of the split coordinate, bounds the areas of the children */
+    BasicSortKDTree *leftChild{};       /**< Pointer to the left child of the SortKDTree node. */
+    BasicSortKDTree *rightChild{};      /**< Pointer to the right child of the SortKDTree node. */
+    NodeArena *arena{};            /**< Arena of nodes and point vectors, nullptr if they are on the heap */
+    bool tightAreas = false;       /**< Set by tightenAreas(), add() keeps the bounding boxes up to date */
+    vector<CompactNode> compactNodes; /**< Nodes in preorder after compact(), empty before */
+    vector<PointType> leafPoints;       /**< Points in leaf order after compact(), every subtree is a range */
 
     /**
      * @Brief Constructs a KD-Tree with the specified area and points
@@ -55,7 +66,21 @@ private:
      * @param area containing all points
      * @param level current level inside the tree
      */
-    SortKDTree(vector<Point> &points, Area &area, int level);
+    BasicSortKDTree(vector<PointType> &points, AreaType &area, int level);
+
+    /**
+     * @Brief Constructs a child node, points are sorted like in SortKDTree(vector<Point> &, Area &, int)
+     * @param points vector of points, allocated by the resource of arena
+     * @param area containing all points
+     * @param level current level inside the tree
+     * @param arena arena of the tree, may be nullptr
+     */
+    BasicSortKDTree(std::pmr::vector<PointType> &&points, AreaType &area, int level, NodeArena *arena);
+
+    /**
+     * @brief Sorts the points by x-coordinate on even and by y-coordinate on odd levels
+     */
+    void sortPoints();
 
     /**
      * @Brief makes vertical split of the area und creates to children accordingly
@@ -69,21 +94,119 @@ private:
      */
     void setHorizontalChildren(int level);
 
-    void appendPoint(Point &point, int level);
+    /**
+     * @brief Builds the subtree with buildTreePresorted(int *, int *, int *, int *, int), points have to be sorted
+     */
+    void rebuildPresorted();
+
+    /**
+     * @brief Replaces the subtree by a balanced one built from the same points
+     */
+    void rebuild();
+
+    /**
+     * @brief Appends the points of the subtree to result
+     * @param result vector the points are appended to
+     */
+    void collectPoints(std::pmr::vector<PointType> &result);
 
     /**
-     * @brief Helper method for kNearestNeighbors(Point &queryPoint, int k). Adds k-nearest neighbor of KD-Tree node to result vector
+     * @brief Helper method for buildTreePresorted(). Splits the subtree using the presorted index arrays
      *
-     * Recursively traverses KD-Tree nodes to find k nearest neighbors. Uses priority to keep track of proximity to query Point
+     * order lists the points of this node sorted like points, otherOrder lists them sorted by the other
+     * coordinate. otherOrder is partitioned stably into the points of the left and the right child, which turns
+     * it into the sort order of both children
+     * @param base points of the root, the indices refer to them
+     * @param order indices of the points of this node sorted by the split coordinate of this level
+     * @param otherOrder indices of the points of this node sorted by the other coordinate
+     * @param buffer scratch space for at least as many indices as this node has points
+     * @param lev level of this node
+     */
+    void buildTreePresorted(const PointType *base, int *order, int *otherOrder, int *buffer, int lev);
+
+    /**
+     * @brief Helper method for compact(). Appends node and its subtree in preorder
+     * @param node root of the subtree
+     * @return index of node in compactNodes
+     */
+    int appendCompact(BasicSortKDTree *node);
+
+    /**
+     * @brief Helper method for contains() of a compacted tree
+     * @param index index of the node in compactNodes
+     * @param lev level of the node
+     * @param point point to be found
+     * @return True if the subtree contains point
+     */
+    bool compactContains(int index, int lev, PointType &point);
+
+    /**
+     * @brief Helper method for getHeight() of a compacted tree
+     * @param index index of the node in compactNodes
+     * @return height of the subtree
+     */
+    int compactHeight(int index);
+
+    /**
+     * @brief Areas of the two children of a compacted node, computed like in setVerticalChildren()
+     * @param index index of the node in compactNodes
+     * @param lev level of the node
+     * @param nodeArea area of the node
+     * @param lower receives the area of the left child
+     * @param higher receives the area of the right child
+     */
+    void compactChildAreas(int index, int lev, const AreaType &nodeArea, AreaType &lower, AreaType &higher);
+
+    /**
+     * @brief Helper method for query(Area &, Sink) of a compacted tree
+     * @param index index of the node in compactNodes
+     * @param lev level of the node
+     * @param nodeArea area of the node
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param sink callable taking a Point or output iterator
+     */
+    template<typename Sink>
+    void compactQueryHelper(int index, int lev, AreaType nodeArea, AreaType &queryRectangle, Sink &sink);
+
+    /**
+     * @brief Counts the compact nodes compactQueryHelper() visits
+     * @param index index of the compact node
+     * @param lev level of the node
+     * @param nodeArea area of the node
+     * @param queryRectangle Rectangle that contains points of interest
+     * @return number of visited nodes of the subtree
+     */
+    long compactQueryVisits(int index, int lev, AreaType nodeArea, AreaType &queryRectangle);
+
+    /**
+     * @brief Helper method for kNearestNeighbors() of a compacted tree
+     * @param index index of the node in compactNodes
+     * @param lev level of the node
+     * @param nodeArea area of the node
+     * @param queryPoint The point of which the k nearest neighbors are determined
+     * @param scratch Candidate heap of the running search
+     */
+    void compactKNearestNeighborsHelper(int index, int lev, const AreaType &nodeArea, const PointType &queryPoint,
+                                        Scratch &scratch);
+
+    /**
+     * @brief Helper method for query(Area &, Sink). Reports the points of this subtree inside queryRectangle
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param sink callable taking a Point or output iterator
+     */
+    template<typename Sink>
+    void queryHelper(AreaType &queryRectangle, Sink &sink);
+
+    /**
+     * @brief Helper method for kNearestNeighbors. Offers the points of this subtree to the candidate heap
      *
-     * @param node The KD-Tree that is used for k-NNS
-     * @param k The number of neighbors
-     * @param queue Priority Queue that prioritizes nodes by proximity of its square to a queryPoint
-     * @param result Vector that contains the k nearest neighbors
+     * Descends into the child closer to queryPoint first and skips children whose area is farther away
+     * than the current k-th best candidate
+     *
+     * @param queryPoint The point of which the k nearest neighbors are determined
+     * @param scratch Candidate heap of the running search
      */
-    void kNearestNeighborsHelper(SortKDTree *node, int k,
-                                 priority_queue<SortKDTree *, std::vector<SortKDTree *>, CompareMKDTree> &queue,
-                                 std::vector<Point> &result);
+    void kNearestNeighborsHelper(const PointType &queryPoint, Scratch &scratch);
 
 public:
 
@@ -96,12 +219,22 @@ public:
      * @param area containing all points
      * @param level current level inside the tree
      */
-    SortKDTree(vector<Point> &points, Area &area);
+    BasicSortKDTree(vector<PointType> &points, AreaType &area);
+
+    /**
+     * @Brief Constructs a KD-Tree whose nodes and point vectors are allocated in arena
+     *
+     * The arena has to outlive the tree. Destroying the tree does not free the nodes, the arena does
+     * @param points vector of points
+     * @param area containing all points
+     * @param arena arena for nodes and point vectors
+     */
+    BasicSortKDTree(vector<PointType> &points, AreaType &area, NodeArena &arena);
 
     /**
      * destroys the KD-Tree and deallocates memory
      */
-    ~SortKDTree();
+    ~BasicSortKDTree();
 
     /**
      * @brief private helper function to build the KD-Tree
@@ -116,18 +249,72 @@ public:
      */
     void buildTree();
 
+    /**
+     * @Brief Builds the same KD-Tree as buildTree() in O(nlog(n))
+     *
+     * The points are sorted once by x and once by y into index arrays. Each split partitions these arrays
+     * linearly instead of sorting the points of every child again
+     */
+    void buildTreePresorted();
+
+    /**
+     * @brief Replaces the built tree by a compact form and frees the nodes
+     *
+     * Interior nodes keep only their split value and the index of the right child, every point is stored once
+     * in leaf order. contains(), query(), kNearestNeighbors() and getHeight() use the compact form afterwards,
+     * add() must not be called anymore
+     */
+    void compact();
+
+    /**
+     * @return True if compact() has been called
+     */
+    bool isCompact();
+
+    /**
+     * @brief Replaces the split cell of every node by the bounding box of its points
+     *
+     * Queries and kNN searches then prune by the boxes, which skips empty parts of the cells on clustered data.
+     * add() grows the boxes on its path and tightens the nodes it splits or rebuilds. The compact form derives
+     * the cells of its nodes from the split values, so it only starts from the box of the root
+     */
+    void tightenAreas();
+
+    /**
+     * @brief Counts the nodes query(queryRectangle) visits
+     * @param queryRectangle Rectangle that contains points of interest
+     * @return number of visited nodes including this one
+     */
+    long queryVisits(AreaType &queryRectangle);
+
     /**
      * Checks if given point is contained by the KD-Tree
      * @param point
      * @return True if KD-Tree contains point, false otherwise
      */
-    bool contains(Point p);
+    bool contains(PointType p);
 
     /**
      * @param queryRectangle Rectangle that contains points of interest
      * @return list<Point> of points contained by queryRectangle
      */
-    list<Point> query(Area &queryArea);
+    list<PointType> query(AreaType &queryArea);
+
+    /**
+     * @brief Reports every point contained by queryRectangle to sink, no intermediate lists are built
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param sink callable taking a Point or output iterator
+     * @return sink after all points have been reported
+     */
+    template<typename Sink>
+    Sink query(AreaType &queryRectangle, Sink sink);
+
+    /**
+     * @brief Appends the points contained by queryRectangle to result
+     * @param queryRectangle Rectangle that contains points of interest
+     * @param result vector that is reused between queries, it is not cleared
+     */
+    void query(AreaType &queryRectangle, vector<PointType> &result);
 
     /**
      * @brief Calculates height of the Quadtree
@@ -142,10 +329,16 @@ public:
     bool isLeaf();
 
     /**
-     * @brief Adds a given Point to the KD-Tree
+     * @brief Adds a given Point to the KD-Tree and keeps it balanced
+     *
+     * The point is routed by the split values and the leaf it reaches is split. Interior nodes on the path drop
+     * their copy of the subtree points, so query() descends into them afterwards. If a child ends up with more
+     * than SCAPEGOAT_ALPHA of the points of its parent, the highest such parent is rebuilt with the median build.
+     * Inserts take amortized O(log(n)^2), the height stays O(log(n)). Not available after compact()
      * @param point Point to be added
+     * @throws std::logic_error if the tree has been compacted
      */
-    void add(Point &point);
+    void add(PointType &point);
 
     /**
      * Get k nearest neighbors of a query point
@@ -153,7 +346,81 @@ public:
      * @param k The number of neighbors
      * @return vector containing k nearest neighbors of queryPoint
      */
-    vector<Point> kNearestNeighbors(Point &point, int k);
+    vector<PointType> kNearestNeighbors(PointType &point, int k);
+
+    /**
+     * Get k nearest neighbors of a query point without allocating
+     * @param queryPoint The point of which the k nearest neighbors are determined
+     * @param k The number of neighbors
+     * @param scratch Candidate heap that is reused between queries
+     * @param result vector that is overwritten with the k nearest neighbors, ordered by distance
+     */
+    void kNearestNeighbors(PointType &queryPoint, int k, Scratch &scratch, vector<PointType> &result);
 };
 
+/**
+ * SortKDTree with double coordinates
+ */
+using SortKDTree = BasicSortKDTree<double>;
+
+template<typename T>
+template<typename Sink>
+Sink BasicSortKDTree<T>::query(AreaType &queryRectangle, Sink sink) {
+    if (this->isCompact()) {
+        compactQueryHelper(0, this->level, this->area, queryRectangle, sink);
+        return sink;
+    }
+    queryHelper(queryRectangle, sink);
+    return sink;
+}
+
+template<typename T>
+template<typename Sink>
+void BasicSortKDTree<T>::compactQueryHelper(int index, int lev, AreaType nodeArea, AreaType &queryRectangle,
+                                            Sink &sink) {
+    CompactNode &node = this->compactNodes[index];
+    if (node.right < 0) {
+        for (int i = node.from; i < node.to; i++) {
+            if (containsPoint(queryRectangle, this->leafPoints[i])) {
+                emitPoint(sink, this->leafPoints[i]);
+            }
+        }
+        return;
+    } else if (containsArea(queryRectangle, nodeArea)) {
+        // the points of a subtree are contiguous
+        emitPoints(sink, this->leafPoints.data() + node.from, this->leafPoints.data() + node.to);
+        return;
+    }
+    AreaType lower{}, higher{};
+    compactChildAreas(index, lev, nodeArea, lower, higher);
+    if (intersects(queryRectangle, lower)) {
+        compactQueryHelper(index + 1, lev + 1, lower, queryRectangle, sink);
+    }
+    if (intersects(queryRectangle, higher)) {
+        compactQueryHelper(node.right, lev + 1, higher, queryRectangle, sink);
+    }
+}
+
+template<typename T>
+template<typename Sink>
+void BasicSortKDTree<T>::queryHelper(AreaType &queryRectangle, Sink &sink) {
+    if (this->isLeaf()) {
+        for (auto &point: this->points) {
+            if (containsPoint(queryRectangle, point)) {
+                emitPoint(sink, point);
+            }
+        }
+        return;
+    } else if (containsArea(queryRectangle, this->area) && (long) this->points.size() == this->size) {
+        emitPoints(sink, this->points.data(), this->points.data() + this->points.size());
+        return;
+    }
+    if (this->leftChild != nullptr && intersects(queryRectangle, this->leftChild->area)) {
+        this->leftChild->queryHelper(queryRectangle, sink);
+    }
+    if (this->rightChild != nullptr && intersects(queryRectangle, this->rightChild->area)) {
+        this->rightChild->queryHelper(queryRectangle, sink);
+    }
+}
+
 #endif //QUADKDBENCH_SORTKDTREE_H
@@ -12,10 +12,18 @@
 #include <sstream>
 #include "KDTreeEfficient.h"
 #include "KDBTreeEfficient.h"
+#include "ImplicitKDTree.h"
 #include "QuadTree.h"
+#include "QuadTreeEfficient.h"
+#include "LinearQuadTree.h"
+#include "CompressedQuadTree.h"
 #include "Util.h"
 #include "SortKDTree.h"
 #include "PointRegionQuadTree.h"
+#include "ConcurrentPRQuadTree.h"
+#include "DynamicKDBTree.h"
+#include "CapacityTuner.h"
+#include "Workload.h"
 #include "KDBTreeEfficient.h"
 
 using namespace std;
@@ -27,7 +35,7 @@ using namespace std;
  */
 inline KDTreeEfficient *buildEKD_Random(int pointNumber) {
     auto *pointArray = (Point *) malloc(pointNumber * sizeof(Point));
-    std::vector<Point> points = getRandomPoints(pointNumber);
+    std::vector<Point> points = generatePoints(pointNumber, UNIFORM);
     int i = 0;
     for (auto point: points) {
         pointArray[i++] = point;
@@ -39,15 +47,30 @@ inline KDTreeEfficient *buildEKD_Random(int pointNumber) {
     return kdTreeEfficient;
 }
 
+/**
+ * @brief Builds a pointer-free KD-Tree containing pointNumber points
+ * @param pointNumber number of random points
+ * @return ImplicitKDTree containing random points
+ */
+inline ImplicitKDTree *buildImplicitKD_Random(int pointNumber) {
+    Point *pointArray = generatePointsArray(pointNumber, UNIFORM);
+    double bounds = pointNumber;
+    Area area{0, bounds, 0, bounds};
+    auto *implicitKDTree = new ImplicitKDTree(pointArray, area, pointNumber);
+    implicitKDTree->buildTree();
+    return implicitKDTree;
+}
+
 /**
  * @brief Builds an efficient KDB-Tree containing pointNumber points
  * @param pointNumber number of random points
+ * @param profile tuned leaf capacities, the default capacity is used if it is empty
  * @return KDBTreeEfficient containing random points
  */
-inline KDBTreeEfficient *buildKDB_Random(int pointNumber) {
+inline KDBTreeEfficient *buildKDB_Random(int pointNumber, const CapacityProfile &profile = CapacityProfile()) {
     int size = pointNumber - 1;
     auto *pointArray = (Point *) malloc(pointNumber * sizeof(Point));
-    std::vector<Point> points = getRandomPoints(pointNumber);
+    std::vector<Point> points = generatePoints(pointNumber, UNIFORM);
     int i = 0;
     for (auto point: points) {
         pointArray[i++] = point;
@@ -55,8 +78,7 @@ inline KDBTreeEfficient *buildKDB_Random(int pointNumber) {
     double bounds = pointNumber;
     Area area{0, bounds, 0, bounds};
     int start = 0;
-    int capacity = (int) max(log10(pointNumber), 4.0);
-    auto *kdbTreeEfficient = new KDBTreeEfficient(pointArray, 0, area, start, size, capacity);
+    auto *kdbTreeEfficient = new KDBTreeEfficient(pointArray, 0, area, start, size, profile);
     kdbTreeEfficient->buildTree();
     return kdbTreeEfficient;
 }
@@ -67,7 +89,7 @@ inline KDBTreeEfficient *buildKDB_Random(int pointNumber) {
  * @return Quadtree containing random points
  */
 inline QuadTree *buildQuadTreeRandom(int pointNumber) {
-    std::vector<Point> points = getRandomPoints(pointNumber);
+    std::vector<Point> points = generatePoints(pointNumber, UNIFORM);
     double bounds = pointNumber;
     Area area{0, bounds, 0, bounds};
     auto *quadTree = new QuadTree(area, points);
@@ -75,17 +97,59 @@ inline QuadTree *buildQuadTreeRandom(int pointNumber) {
     return quadTree;
 }
 
+/**
+ * @brief Builds a Quadtree on a shared points array containing pointNumber points
+ * @param pointNumber number of random points
+ * @return QuadTreeEfficient containing random points
+ */
+inline QuadTreeEfficient *buildQuadTreeEfficientRandom(int pointNumber) {
+    Point *pointArray = generatePointsArray(pointNumber, UNIFORM);
+    double bounds = pointNumber;
+    Area area{0, bounds, 0, bounds};
+    auto *quadTree = new QuadTreeEfficient(pointArray, area, pointNumber);
+    quadTree->buildTree();
+    return quadTree;
+}
+
+/**
+ * @brief Builds a Morton-ordered linear Quadtree containing pointNumber points
+ * @param pointNumber number of random points
+ * @return LinearQuadTree containing random points
+ */
+inline LinearQuadTree *buildLinearQuadTreeRandom(int pointNumber) {
+    Point *pointArray = generatePointsArray(pointNumber, UNIFORM);
+    double bounds = pointNumber;
+    Area area{0, bounds, 0, bounds};
+    auto *quadTree = new LinearQuadTree(pointArray, area, pointNumber);
+    quadTree->buildTree();
+    return quadTree;
+}
+
+/**
+ * @brief Builds a compressed Quadtree containing pointNumber points
+ * @param pointNumber number of random points
+ * @return CompressedQuadTree containing random points
+ */
+inline CompressedQuadTree *buildCompressedQuadTreeRandom(int pointNumber) {
+    std::vector<Point> points = generatePoints(pointNumber, UNIFORM);
+    double bounds = pointNumber;
+    Area area{0, bounds, 0, bounds};
+    auto *quadTree = new CompressedQuadTree(area, points);
+    quadTree->buildTree();
+    return quadTree;
+}
+
 /**
  * @brief Builds an Point-Region-Quadtree containing pointNumber points
  * @param pointNumber number of random points
+ * @param profile tuned leaf capacities, the default capacity is used if it is empty
  * @return Point-Region-Quadtree containing random points
  */
-inline PointRegionQuadTree *buildPRQuadTreeRandom(int pointNumber) {
-    std::vector<Point> points = getRandomPoints(pointNumber);
+inline PointRegionQuadTree *buildPRQuadTreeRandom(int pointNumber, const CapacityProfile &profile = CapacityProfile()) {
+    std::vector<Point> points = generatePoints(pointNumber, UNIFORM);
     double bounds = pointNumber;
-    int capacity = (int) max(log10(pointNumber), 4.0);
     Area area{0, bounds, 0, bounds};
-    auto quadTree = new PointRegionQuadTree(area, points, capacity);
+    auto quadTree = new PointRegionQuadTree(area, points, profile);
     quadTree->buildTree();
     return quadTree;
 }
@@ -96,14 +160,253 @@ inline PointRegionQuadTree *buildPRQuadTreeRandom(int pointNumber) {
  * @return SortKDTree containing random points
  */
 inline SortKDTree *buildSortKDTreeRandom(int pointNumber) {
-    vector<Point> points = getRandomPoints(pointNumber);
+    vector<Point> points = generatePoints(pointNumber, UNIFORM);
     double bounds = pointNumber;
     Area area{0, bounds, 0, bounds};
     auto myKdTree = new SortKDTree(points, area);
-    myKdTree->buildTree();
+    myKdTree->buildTreePresorted();
     return myKdTree;
 }
 
+/**
+ * @brief Inserts pointNumber random points one by one into a DynamicKDBTree
+ * @param pointNumber number of random points
+ * @return DynamicKDBTree containing random points
+ */
+inline DynamicKDBTree *buildDynamicKDBTreeRandom(int pointNumber) {
+    vector<Point> points = generatePoints(pointNumber, UNIFORM);
+    double bounds = pointNumber;
+    Area area{0, bounds, 0, bounds};
+    auto *tree = new DynamicKDBTree(area);
+    for (auto &point: points) {
+        tree->add(point);
+    }
+    return tree;
+}
+
+/**
+ * @brief Builds a compacted SortKDTree containing pointNumber points
+ * @param pointNumber number of random points
+ * @return compacted SortKDTree containing random points
+ */
+inline SortKDTree *buildSortKDTreeCompactRandom(int pointNumber) {
+    SortKDTree *myKdTree = buildSortKDTreeRandom(pointNumber);
+    myKdTree->compact();
+    return myKdTree;
+}
+
+/**
+ * @brief Builds a tree of type Tree on points, used by benchmarks running every tree on the same workload
+ * @param points points of the tree, e.g. created by generatePoints()
+ * @param area area containing all points
+ * @return tree containing points, deleted with destroyTree()
+ */
+template<typename Tree>
+Tree *buildTreeOnPoints(vector<Point> &points, Area &area);
+
+/**
+ * @brief Builds an efficient KD-Tree on a copy of points
+ */
+template<>
+inline KDTreeEfficient *buildTreeOnPoints<KDTreeEfficient>(vector<Point> &points, Area &area) {
+    auto *pointArray = (Point *) malloc(points.size() * sizeof(Point));
+    std::copy(points.begin(), points.end(), pointArray);
+    auto *kdTreeEfficient = new KDTreeEfficient(pointArray, area, (int) points.size());
+    kdTreeEfficient->buildTree();
+    return kdTreeEfficient;
+}
+
+/**
+ * @brief Builds an efficient KDB-Tree on a copy of points
+ */
+template<>
+inline KDBTreeEfficient *buildTreeOnPoints<KDBTreeEfficient>(vector<Point> &points, Area &area) {
+    auto *pointArray = (Point *) malloc(points.size() * sizeof(Point));
+    std::copy(points.begin(), points.end(), pointArray);
+    int size = (int) points.size();
+    auto *kdbTreeEfficient = new KDBTreeEfficient(pointArray, 0, area, 0, size - 1, defaultLeafCapacity(size));
+    kdbTreeEfficient->buildTree();
+    return kdbTreeEfficient;
+}
+
+/**
+ * @brief Builds a Point-Region-Quadtree with the default leaf capacity
+ */
+template<>
+inline PointRegionQuadTree *buildTreeOnPoints<PointRegionQuadTree>(vector<Point> &points, Area &area) {
+    auto quadTree = new PointRegionQuadTree(area, points, defaultLeafCapacity((long) points.size()));
+    quadTree->buildTree();
+    return quadTree;
+}
+
+/**
+ * @brief Builds a SortKDTree with the presorted build
+ */
+template<>
+inline SortKDTree *buildTreeOnPoints<SortKDTree>(vector<Point> &points, Area &area) {
+    auto myKdTree = new SortKDTree(points, area);
+    myKdTree->buildTreePresorted();
+    return myKdTree;
+}
+
+/**
+ * @brief Builds a Point-Quadtree, equal points are split down to the resolution of double
+ */
+template<>
+inline QuadTree *buildTreeOnPoints<QuadTree>(vector<Point> &points, Area &area) {
+    auto *quadTree = new QuadTree(area, points);
+    quadTree->buildTree();
+    return quadTree;
+}
+
+/**
+ * @brief Builds an efficient Quadtree on a copy of points, equal points are split down to the resolution of double
+ */
+template<>
+inline QuadTreeEfficient *buildTreeOnPoints<QuadTreeEfficient>(vector<Point> &points, Area &area) {
+    auto *pointArray = (Point *) malloc(points.size() * sizeof(Point));
+    std::copy(points.begin(), points.end(), pointArray);
+    auto *quadTree = new QuadTreeEfficient(pointArray, area, (int) points.size());
+    quadTree->buildTree();
+    return quadTree;
+}
+
+/**
+ * @brief Builds a linear Quadtree on a copy of points
+ */
+template<>
+inline LinearQuadTree *buildTreeOnPoints<LinearQuadTree>(vector<Point> &points, Area &area) {
+    auto *pointArray = (Point *) malloc(points.size() * sizeof(Point));
+    std::copy(points.begin(), points.end(), pointArray);
+    auto *quadTree = new LinearQuadTree(pointArray, area, (int) points.size());
+    quadTree->buildTree();
+    return quadTree;
+}
+
+/**
+ * @brief Builds a compressed Quadtree with leaf capacity 1
+ */
+template<>
+inline CompressedQuadTree *buildTreeOnPoints<CompressedQuadTree>(vector<Point> &points, Area &area) {
+    auto *quadTree = new CompressedQuadTree(area, points);
+    quadTree->buildTree();
+    return quadTree;
+}
+
+/**
+ * @brief Builds an implicit KD-Tree on a copy of points
+ */
+template<>
+inline ImplicitKDTree *buildTreeOnPoints<ImplicitKDTree>(vector<Point> &points, Area &area) {
+    auto *pointArray = (Point *) malloc(points.size() * sizeof(Point));
+    std::copy(points.begin(), points.end(), pointArray);
+    auto *implicitKDTree = new ImplicitKDTree(pointArray, area, (int) points.size());
+    implicitKDTree->buildTree();
+    return implicitKDTree;
+}
+
+/**
+ * @brief Builds a dynamic KDB-Tree by adding the points one by one
+ */
+template<>
+inline DynamicKDBTree *buildTreeOnPoints<DynamicKDBTree>(vector<Point> &points, Area &area) {
+    auto *tree = new DynamicKDBTree(area);
+    for (auto &point: points) {
+        tree->add(point);
+    }
+    return tree;
+}
+
+/**
+ * @brief Deletes a tree and the point array it was built on
+ * @param tree tree created by buildTreeOnPoints()
+ */
+inline void destroyTree(KDTreeEfficient *tree) {
+    Point *pointArray = tree->getPoints();
+    delete tree;
+    free(pointArray);
+}
+
+/**
+ * @brief Deletes a tree and the point array it was built on
+ * @param tree tree created by buildTreeOnPoints()
+ */
+inline void destroyTree(KDBTreeEfficient *tree) {
+    Point *pointArray = tree->getPoints();
+    delete tree;
+    free(pointArray);
+}
+
+/**
+ * @brief Deletes a tree
+ * @param tree tree created by buildTreeOnPoints()
+ */
+inline void destroyTree(PointRegionQuadTree *tree) {
+    delete tree;
+}
+
+/**
+ * @brief Deletes a tree
+ * @param tree tree created by buildTreeOnPoints()
+ */
+inline void destroyTree(SortKDTree *tree) {
+    delete tree;
+}
+
+/**
+ * @brief Deletes a tree
+ * @param tree tree created by buildTreeOnPoints()
+ */
+inline void destroyTree(QuadTree *tree) {
+    delete tree;
+}
+
+/**
+ * @brief Deletes a tree and the point array it was built on
+ * @param tree tree created by buildTreeOnPoints()
+ */
+inline void destroyTree(QuadTreeEfficient *tree) {
+    Point *pointArray = tree->getPoints();
+    delete tree;
+    free(pointArray);
+}
+
+/**
+ * @brief Deletes a tree and the point array it was built on
+ * @param tree tree created by buildTreeOnPoints()
+ */
+inline void destroyTree(LinearQuadTree *tree) {
+    Point *pointArray = tree->getPoints();
+    delete tree;
+    free(pointArray);
+}
+
+/**
+ * @brief Deletes a tree
+ * @param tree tree created by buildTreeOnPoints()
+ */
+inline void destroyTree(CompressedQuadTree *tree) {
+    delete tree;
+}
+
+/**
+ * @brief Deletes a tree and the point array it was built on
+ * @param tree tree created by buildTreeOnPoints()
+ */
+inline void destroyTree(ImplicitKDTree *tree) {
+    Point *pointArray = tree->getPoints();
+    delete tree;
+    free(pointArray);
+}
+
+/**
+ * @brief Deletes a tree
+ * @param tree tree created by buildTreeOnPoints()
+ */
+inline void destroyTree(DynamicKDBTree *tree) {
+    delete tree;
+}
+
 /**
  * @brief Naive range query-algorithm
  * @param points points of interest
@@ -151,6 +454,39 @@ inline void qtContainsPoint(QuadTree *quadtree, vector<Point> &points) {
     }
 }
 
+/**
+ * @brief Runs QuadTreeEfficient contains function on several points
+ * @param quadtree Quadtree
+ * @param points Points
+ */
+inline void qtEContainsPoint(QuadTreeEfficient *quadtree, vector<Point> &points) {
+    for (auto point: points) {
+        quadtree->contains(point);
+    }
+}
+
+/**
+ * @brief Runs CompressedQuadTree contains function on several points
+ * @param quadtree compressed Quadtree
+ * @param points Points
+ */
+inline void compressedQtContainsPoint(CompressedQuadTree *quadtree, vector<Point> &points) {
+    for (auto point: points) {
+        quadtree->contains(point);
+    }
+}
+
+/**
+ * @brief Runs LinearQuadTree contains function on several points
+ * @param quadtree linear Quadtree
+ * @param points Points
+ */
+inline void linearQtContainsPoint(LinearQuadTree *quadtree, vector<Point> &points) {
+    for (auto point: points) {
+        quadtree->contains(point);
+    }
+}
+
 /**
  * @brief Runs Point-Region-Quadtree contains function on several points
  * @param quadtree PR-Quadtree
@@ -173,6 +509,17 @@ inline void kdEContainsPoint(KDTreeEfficient *kdTreeEfficient, vector<Point> &po
     }
 }
 
+/**
+ * @brief Runs ImplicitKDTree contains function on several points
+ * @param implicitKDTree pointer-free KD-Tree
+ * @param points Points
+ */
+inline void implicitKDContainsPoint(ImplicitKDTree *implicitKDTree, vector<Point> &points) {
+    for (auto point: points) {
+        implicitKDTree->contains(point);
+    }
+}
+
 /**
  * @brief Runs KDBTreeEfficient contains function on several points
  * @param kdTreeEfficient PR-Quadtree
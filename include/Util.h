@@ -14,6 +14,8 @@
 #include <random>
 #include <set>
 #include <unordered_set>
+#include <type_traits>
+#include <limits>
 #include "algorithm"
 
 
@@ -26,10 +28,12 @@ enum Quadrant {
 
 /**
  * @brief A struct representing a 2D point with x and y coordinates.
+ * @tparam T coordinate type, double, float or int32_t
  */
-struct Point {
-    double x; /**< The x-coordinate of the point. */
-    double y; /**< The y-coordinate of the point. */
+template<typename T>
+struct BasicPoint {
+    T x; /**< The x-coordinate of the point. */
+    T y; /**< The y-coordinate of the point. */
 
     /**
      * @brief Overloaded << operator to stream the Point information.
@@ -37,7 +41,7 @@ struct Point {
      * @param point The Point instance to be streamed.
      * @return The output stream.
      */
-    friend std::ostream &operator<<(std::ostream &os, const Point &point) {
+    friend std::ostream &operator<<(std::ostream &os, const BasicPoint &point) {
         return os << "[" << (point.x) << ":" << (point.y) << "]";
     }
 
@@ -46,34 +50,41 @@ struct Point {
      * @param other The other Point to compare with.
      * @return True if the x and y coordinates of the points are equal; false otherwise.
      */
-    bool operator==(const Point &other) const {
+    bool operator==(const BasicPoint &other) const {
         return x == other.x && y == other.y;
     }
 };
 
+/**
+ * Point with double coordinates
+ */
+using Point = BasicPoint<double>;
+
 namespace std {
     /**
      * @brief Hash specialization for the Point struct.
      */
-    template<>
-    struct hash<Point> {
+    template<typename T>
+    struct hash<BasicPoint<T>> {
         /**
          * @brief Operator to generate a unique hash for a Point.
          * @param p The Point for which the hash is generated.
          * @return The hash value.
          */
-        size_t operator()(const Point &p) const {
+        size_t operator()(const BasicPoint<T> &p) const {
             // Combine the hashes of x and y to generate a unique hash for the point
-            return hash<double>()(p.x) ^ (hash<double>()(p.y) << 1);
+            return hash<T>()(p.x) ^ (hash<T>()(p.y) << 1);
         }
     };
 }
 
 /**
  * Area struct for Quadtree squares and KD-Tree rectangles
+ * @tparam T coordinate type, double, float or int32_t
  */
-struct Area {
-    friend std::ostream &operator<<(std::ostream &os, const Area &area) {
+template<typename T>
+struct BasicArea {
+    friend std::ostream &operator<<(std::ostream &os, const BasicArea &area) {
         return os << "[" << (area.xMin) << ":" << (area.xMax) << "] : ["
                   << (area.yMin) << ":" << (area.yMax) << ']';
     }
@@ -83,27 +94,155 @@ struct Area {
      * @param other The other Point to compare with.
      * @return True if areas are equal; false otherwise.
      */
-    bool operator==(const Area &other) const {
+    bool operator==(const BasicArea &other) const {
         return xMin == other.xMin && yMin == other.yMin
                && xMax == other.xMax && yMax == other.yMax;
     }
 
-    double xMin, xMax, yMin, yMax;
+    T xMin, xMax, yMin, yMax;
+};
+
+/**
+ * Area with double coordinates
+ */
+using Area = BasicArea<double>;
+
+/**
+ * @brief Type of squared distances between points with coordinates of type T
+ *
+ * 64 bit integers for integer coordinates, exact as long as all coordinates lie in [-2^30, 2^30]
+ */
+template<typename T>
+using SquaredDistance = std::conditional_t<std::is_integral_v<T>, int64_t, T>;
+
+/**
+ * Weight of a point with coordinates of type T used by aggregate queries
+ */
+template<typename T>
+using BasicWeightFunction = double (*)(const BasicPoint<T> &);
+
+/**
+ * Weight of a point used by aggregate queries
+ */
+using WeightFunction = BasicWeightFunction<double>;
+
+/**
+ * @brief Count, sum, minimum and maximum of the weights of a set of points
+ */
+struct Aggregate {
+    long count = 0;                                          /**< Number of points */
+    double sum = 0.0;                                        /**< Sum of the weights */
+    double min = std::numeric_limits<double>::infinity();    /**< Lowest weight, infinity if empty */
+    double max = -std::numeric_limits<double>::infinity();   /**< Highest weight, -infinity if empty */
+
+    /**
+     * @brief Adds the weight of a single point
+     * @param weight weight of the point
+     */
+    void add(double weight) {
+        count++;
+        sum += weight;
+        min = std::min(min, weight);
+        max = std::max(max, weight);
+    }
+
+    /**
+     * @brief Adds all points summarized by other
+     * @param other aggregate of a disjoint set of points
+     */
+    void add(const Aggregate &other) {
+        count += other.count;
+        sum += other.sum;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
 };
 
+/**
+ * @brief Quadrant of point relative to the center (xMid, yMid), x > xMid is east and y <= yMid is south
+ *
+ * Computed without branches, bit 0 is east and bit 1 is south like the indices of Quadrant. For integer
+ * coordinates the comparisons are exact, so points on the center lines always go to the same quadrant.
+ * @param point point to be located
+ * @param xMid mid x-coordinate
+ * @param yMid mid y-coordinate
+ * @return index of the quadrant
+ */
+template<typename T>
+inline int quadrantOf(const BasicPoint<T> &point, T xMid, T yMid) {
+    return (int) (point.x > xMid) | ((int) (point.y <= yMid) << 1);
+}
+
+/**
+ * @brief Center coordinate of [low, high], rounded down for integer coordinates
+ */
+template<typename T>
+inline T centerCoordinate(T low, T high) {
+    if constexpr (std::is_integral_v<T>) {
+        return (T) (((int64_t) low + (int64_t) high) >> 1);
+    } else {
+        return low + (high - low) / 2;
+    }
+}
+
+/**
+ * @brief Converts points to another coordinate type, rounding to the nearest value for integer coordinates
+ * @param points points with double coordinates
+ * @return converted points in the same order
+ */
+template<typename T>
+inline vector<BasicPoint<T>> convertPoints(const vector<Point> &points) {
+    vector<BasicPoint<T>> result(points.size());
+    std::transform(points.begin(), points.end(), result.begin(), [](const Point &p) {
+        if constexpr (std::is_integral_v<T>) {
+            return BasicPoint<T>{(T) std::llround(p.x), (T) std::llround(p.y)};
+        } else {
+            return BasicPoint<T>{(T) p.x, (T) p.y};
+        }
+    });
+    return result;
+}
+
+/**
+ * @brief Converts an area to another coordinate type, widened to the next integers for integer coordinates
+ * @param area area with double coordinates
+ * @return converted area containing all converted points of area
+ */
+template<typename T>
+inline BasicArea<T> convertArea(const Area &area) {
+    if constexpr (std::is_integral_v<T>) {
+        return BasicArea<T>{(T) std::floor(area.xMin), (T) std::ceil(area.xMax),
+                            (T) std::floor(area.yMin), (T) std::ceil(area.yMax)};
+    } else {
+        return BasicArea<T>{(T) area.xMin, (T) area.xMax, (T) area.yMin, (T) area.yMax};
+    }
+}
+
+/**
+ * @brief splits area into 4 quadrants and writes them to quadrants
+ * @param area Area to be split
+ * @param xMid mid x-coordinate
+ * @param yMid mid y-coordinate
+ * @param quadrants array of at least 4 areas, indexed by Quadrant
+ */
+template<typename T>
+inline void splitArea(BasicArea<T> &area, T xMid, T yMid, BasicArea<T> *quadrants) {
+    quadrants[NORTH_EAST] = BasicArea<T>{xMid, area.xMax, yMid, area.yMax};
+    quadrants[NORTH_WEST] = BasicArea<T>{area.xMin, xMid, yMid, area.yMax};
+    quadrants[SOUTH_WEST] = BasicArea<T>{area.xMin, xMid, area.yMin, yMid};
+    quadrants[SOUTH_EAST] = BasicArea<T>{xMid, area.xMax, area.yMin, yMid};
+}
+
 /**
  * @brief splits area into 4 quadrants and returns them
  * @param area Area to be split
  * @param xMid mid x-coordinate
  * @param yMid mid y-coordinate
- * @return array of the 4 quadrants
+ * @return array of the 4 quadrants, has to be freed by the caller
  */
 inline Area *splitArea(Area &area, double xMid, double yMid) {
     Area *areas = (Area *) std::malloc(sizeof(Area) << 2);
-    areas[NORTH_EAST] = Area{xMid, area.xMax, yMid, area.yMax};
-    areas[NORTH_WEST] = Area{area.xMin, xMid, yMid, area.yMax};
-    areas[SOUTH_WEST] = Area{area.xMin, xMid, area.yMin, yMid};
-    areas[SOUTH_EAST] = Area{xMid, area.xMax, area.yMin, yMid};
+    splitArea(area, xMid, yMid, areas);
     return areas;
 }
 
@@ -116,7 +255,8 @@ inline Area *splitArea(Area &area, double xMid, double yMid) {
  * @param other  area
  * @return true if they intersect each other, otherwise false
  */
-inline bool intersects(Area &first, Area &other) {
+template<typename T>
+inline bool intersects(const BasicArea<T> &first, const BasicArea<T> &other) {
     return first.xMin <= other.xMax && first.xMax >= other.xMin && first.yMax >= other.yMin && first.yMin <= other.yMax;
 }
 
@@ -126,7 +266,8 @@ inline bool intersects(Area &first, Area &other) {
  * @param contained Area possibly contained by container
  * @return True if container contains contained, false otherwise
  */
-inline bool containsArea(Area &container, Area &contained) {
+template<typename T>
+inline bool containsArea(const BasicArea<T> &container, const BasicArea<T> &contained) {
     return container.xMin <= contained.xMin && container.xMax >= contained.xMax && container.yMin <= contained.yMin &&
            container.yMax >= contained.yMax;
 }
@@ -137,10 +278,93 @@ inline bool containsArea(Area &container, Area &contained) {
  * @param point
  * @return true if area contains point, otherwise false
  */
-inline bool containsPoint(Area &area, Point &point) {
+template<typename T>
+inline bool containsPoint(const BasicArea<T> &area, const BasicPoint<T> &point) {
     return (point.x >= area.xMin && point.y >= area.yMin && point.x <= area.xMax && point.y <= area.yMax);
 }
 
+/**
+ * @brief Calculates the smallest area containing all points of a non-empty range
+ * @param begin first point
+ * @param end position after the last point
+ * @return bounding box of the points
+ */
+template<typename T>
+inline BasicArea<T> boundingBox(const BasicPoint<T> *begin, const BasicPoint<T> *end) {
+    BasicArea<T> box{begin->x, begin->x, begin->y, begin->y};
+    for (const BasicPoint<T> *point = begin + 1; point < end; point++) {
+        box.xMin = min(box.xMin, point->x);
+        box.xMax = max(box.xMax, point->x);
+        box.yMin = min(box.yMin, point->y);
+        box.yMax = max(box.yMax, point->y);
+    }
+    return box;
+}
+
+/**
+ * @brief Calculates the smallest area containing both areas
+ * @param first area
+ * @param other area
+ * @return bounding box of first and other
+ */
+template<typename T>
+inline BasicArea<T> enclosingArea(const BasicArea<T> &first, const BasicArea<T> &other) {
+    return BasicArea<T>{min(first.xMin, other.xMin), max(first.xMax, other.xMax),
+                min(first.yMin, other.yMin), max(first.yMax, other.yMax)};
+}
+
+/**
+ * @brief Passes a point to the sink of a range query
+ * @param sink callable taking a Point or output iterator
+ * @param point point to be reported
+ */
+template<typename Sink, typename T>
+inline void emitPoint(Sink &sink, const BasicPoint<T> &point) {
+    if constexpr (std::is_invocable_v<Sink &, const BasicPoint<T> &>) {
+        sink(point);
+    } else {
+        *sink = point;
+        ++sink;
+    }
+}
+
+/**
+ * @brief Passes a contiguous range of points to the sink of a range query
+ * @param sink callable taking a Point or output iterator
+ * @param first pointer to the first point
+ * @param last pointer behind the last point
+ */
+template<typename Sink, typename T>
+inline void emitPoints(Sink &sink, const BasicPoint<T> *first, const BasicPoint<T> *last) {
+    if constexpr (std::is_invocable_v<Sink &, const BasicPoint<T> &>) {
+        for (; first != last; ++first) {
+            sink(*first);
+        }
+    } else {
+        sink = std::copy(first, last, sink);
+    }
+}
+
+/**
+ * @brief returns the element of rank pos of a points array based on coordinate within specified bounds
+ * rearranges array such that points larger than this element are right
+ * and points lower are left of index pos
+ * @param points array of points objects
+ * @param x true if split by x-coordinates, otherwise y-coordinates
+ * @param left index: left bound of array
+ * @param right index: right bound of array (exclusive)
+ * @param pos index: position of the split element
+ * @return split value of specified coordinate
+ */
+template<typename T>
+inline T median(BasicPoint<T> *points, bool x, int left, int right, int pos) {
+    std::nth_element(points + left, points + pos, points + right, [&x](const BasicPoint<T> &a, const BasicPoint<T> &b) {
+        return x ? a.x < b.x : a.y < b.y;
+    });
+
+    return x ? points[pos].x : points[pos].y;
+}
+
 /**
  * @brief returns median of a points array based on coordinate within specified bounds
  * returns median and rearranges array such that points larger than median right
@@ -151,15 +375,10 @@ inline bool containsPoint(Area &area, Point &point) {
  * @param right index: right bound of array
  * @return median of specified coordinate
  */
-inline double median(Point *points, bool x, int left, int right) {
+template<typename T>
+inline T median(BasicPoint<T> *points, bool x, int left, int right) {
     int size = right - left;
-    int pos = left + size / 2;
-
-    std::nth_element(points + left, points + pos, points + right, [&x](const Point &a, const Point &b) {
-        return x ? a.x < b.x : a.y < b.y;
-    });
-
-    return x ? points[pos].x : points[pos].y;
+    return median(points, x, left, right, left + size / 2);
 }
 
 /**
@@ -178,37 +397,52 @@ inline vector<vector<Point>> splitVector(vector<Point> &originalVector) {
 
 /**
  * @brief Returns value of Point in the middle of the list.
- * If size is even, average of both mid values is returned
+ * If size is even, average of both mid values is returned, rounded down for integer coordinates
  * @param list pointlist
  * @param x true if x-coordinate is required, otherwise false
  * @return value of middle point
  */
-inline double getMedian(vector<Point> &list, bool x) {
-    if (x) {
-        if (list.size() > 1) {
-            return (list.size() % 2 == 0) ?
-                   (list.at((list.size() / 2)).x + list.at((list.size() / 2) - 1).x) / 2.0 :
-                   list.at(list.size() / 2).x;
-        }
-        return list.at(0).x;
+template<typename PointVector>
+inline auto getMedian(PointVector &list, bool x) {
+    using T = decltype(list.at(0).x);
+    size_t middle = list.size() / 2;
+    T high = x ? list.at(middle).x : list.at(middle).y;
+    if (list.size() % 2 == 1) {
+        return high;
+    }
+    T low = x ? list.at(middle - 1).x : list.at(middle - 1).y;
+    if constexpr (std::is_integral_v<T>) {
+        return centerCoordinate(low, high);
     } else {
-        if (list.size() > 1) {
-            return (list.size() % 2 == 0) ?
-                   (list.at((list.size() / 2)).y + list.at((list.size() / 2) - 1).y) / 2.0 :
-                   list.at(list.size() / 2).y;
-        }
-        return list.at(0).y;
+        return (T) ((low + high) / 2.0);
     }
 }
 
+/**
+ * Seed of randomEngine() and of the generators of Workload.h if none is given
+ */
+constexpr uint64_t WORKLOAD_SEED = 20240112;
+
+/**
+ * @brief Random engine of the calling thread, seeded with WORKLOAD_SEED
+ *
+ * The generators below draw from it instead of seeding an engine per call, so a program calling them in the same
+ * order gets the same points on every run. Point sets that do not depend on the call order are created by the
+ * seeded generators of Workload.h
+ * @return engine of the calling thread
+ */
+inline std::mt19937 &randomEngine() {
+    thread_local std::mt19937 engine(WORKLOAD_SEED);
+    return engine;
+}
+
 /**
  * @brief Creates vector with uniformly distributed random points and proportionally large bounds
  * @param pointNumber Number of points to be created
  * @return vector with random points
  */
 inline vector<Point> getRandomPoints(int pointNumber) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    std::mt19937 &gen = randomEngine();
     std::uniform_real_distribution<double> dis(0, pointNumber);
 
     vector<Point> points;
@@ -228,8 +462,7 @@ inline vector<Point> getRandomPoints(int pointNumber) {
  * @return vector with random points
  */
 inline vector<Point> getDensePoints(int pointNumber) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    std::mt19937 &gen = randomEngine();
     std::uniform_real_distribution<double> dis(0, 1000);
 
     vector<Point> points;
@@ -255,8 +488,7 @@ inline vector<Point> getDensePoints(int pointNumber) {
  * @return array with random points
  */
 inline Point *getRandomPointsArray(int pointNumber) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    std::mt19937 &gen = randomEngine();
     std::uniform_real_distribution<double> dis(0, pointNumber);
 
     auto *points = (Point *) malloc(pointNumber * sizeof(Point));
@@ -279,8 +511,7 @@ inline Point *getRandomPointsArray(int pointNumber) {
  * @return array with random points
  */
 inline Point *getDensePointsArray(int pointNumber) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    std::mt19937 &gen = randomEngine();
     std::uniform_real_distribution<double> dis(0, 1000);
 
     auto *points = (Point *) malloc(pointNumber * sizeof(Point));
@@ -305,8 +536,7 @@ inline Point *getDensePointsArray(int pointNumber) {
  * @return point
  */
 inline Point getRandomPoint(int bounds) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    std::mt19937 &gen = randomEngine();
     std::uniform_real_distribution<double> dis(0, bounds);
     return {dis(gen), dis(gen)};
 }
@@ -317,9 +547,11 @@ inline Point getRandomPoint(int bounds) {
  * @param point for distance calculation
  * @return distance between area an point
  */
-inline double sqDistanceFrom(const Area &area, const Point &point) {
-    double dx = max(max(area.xMin - point.x, 0.0), point.x - area.xMax);
-    double dy = max(max(area.yMin - point.y, 0.0), point.y - area.yMax);
+template<typename T>
+inline SquaredDistance<T> sqDistanceFrom(const BasicArea<T> &area, const BasicPoint<T> &point) {
+    using D = SquaredDistance<T>;
+    D dx = max(max((D) area.xMin - (D) point.x, D{}), (D) point.x - (D) area.xMax);
+    D dy = max(max((D) area.yMin - (D) point.y, D{}), (D) point.y - (D) area.yMax);
     return dx * dx + dy * dy;
 }
 
@@ -329,6 +561,10 @@ inline double sqDistanceFrom(const Area &area, const Point &point) {
  * @param p2 second point
  * @return squared distance
  */
-inline double pointDistance(const Point &p1, const Point &p2) {
-    return (p1.x - p2.x) * (p1.x - p2.x) + (p1.y - p2.y) * (p1.y - p2.y);
+template<typename T>
+inline SquaredDistance<T> pointDistance(const BasicPoint<T> &p1, const BasicPoint<T> &p2) {
+    using D = SquaredDistance<T>;
+    D dx = (D) p1.x - (D) p2.x;
+    D dy = (D) p1.y - (D) p2.y;
+    return dx * dx + dy * dy;
 }
\ No newline at end of file
@@ -0,0 +1,207 @@
+/**
+ * @author Omar Chatila
+ * @file WorkStealingPool.h
+ * @brief Fork-join thread pool with work stealing used for parallel tree construction
+ *
+ * Every worker owns a deque. Spawned tasks are pushed to the back of the deque of the spawning thread,
+ * the owner pops from the back (depth first) and idle threads steal from the front (largest tasks first).
+ * Threads waiting for a TaskGroup keep executing tasks instead of blocking.
+ */
+
+#ifndef QUADKDBENCH_WORKSTEALINGPOOL_H
+#define QUADKDBENCH_WORKSTEALINGPOOL_H
+
+#include "Util.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+
+/**
+ * Subtrees with at most this many points are built serially
+ */
+constexpr int PARALLEL_BUILD_GRAIN = 1 << 14;
+
+/**
+ * Ranges with more than this many points use parallelMedian() instead of std::nth_element
+ */
+constexpr int PARALLEL_PARTITION_THRESHOLD = 1 << 20;
+
+/**
+ * Quadtree nodes below this depth build their 4 children as separate tasks
+ */
+constexpr int PARALLEL_BUILD_DEPTH = 4;
+
+class WorkStealingPool {
+public:
+    /**
+     * @brief Counter of outstanding tasks that are joined together
+     */
+    class TaskGroup {
+        friend class WorkStealingPool;
+
+        std::atomic<int> pending{0};   /**< Number of spawned tasks that have not finished yet */
+    };
+
+    /**
+     * @brief Creates a pool
+     * @param threadCount number of threads working on tasks, including the thread calling wait()
+     */
+    explicit WorkStealingPool(unsigned threadCount = std::thread::hardware_concurrency());
+
+    /**
+     * @brief Stops and joins all workers
+     */
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    /**
+     * @brief Schedules function as part of group
+     * @param group group that is joined by wait()
+     * @param function task to be run
+     */
+    template<typename Function>
+    void spawn(TaskGroup &group, Function &&function);
+
+    /**
+     * @brief Runs pending tasks until every task of group has finished
+     * @param group group to be joined
+     */
+    void wait(TaskGroup &group);
+
+    /**
+     * @brief Calls function(lo, hi) on consecutive chunks of [from, to) in parallel
+     * @param from lower bound (inclusive)
+     * @param to upper bound (exclusive)
+     * @param grain minimal chunk size
+     * @param function called once per chunk
+     */
+    template<typename Function>
+    void parallelFor(int from, int to, int grain, Function &&function);
+
+    /**
+     * @return number of threads working on tasks
+     */
+    [[nodiscard]] unsigned threadCount() const;
+
+private:
+    struct Task {
+        std::function<void()> function;   /**< Work to be done */
+        TaskGroup *group;                 /**< Group that is notified on completion */
+    };
+
+    struct WorkQueue {
+        std::mutex lock;                  /**< Guards tasks */
+        std::deque<Task> tasks;           /**< Tasks spawned by the owning thread */
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;   /**< queues[0] is shared by external threads */
+    std::vector<std::thread> workers;                 /**< Worker i owns queues[i + 1] */
+    std::atomic<bool> stopping{false};                /**< Set by the destructor */
+    std::atomic<int> queued{0};                       /**< Number of tasks in all queues */
+    std::mutex sleepLock;                             /**< Lock for wakeUp */
+    std::condition_variable wakeUp;                   /**< Notified when a task is pushed */
+
+    static thread_local WorkStealingPool *currentPool;
+    static thread_local int currentQueue;
+
+    /**
+     * @return index of the queue owned by the calling thread
+     */
+    int queueIndex() const;
+
+    /**
+     * @brief Pushes a task to the queue of the calling thread
+     * @param task task to be pushed
+     */
+    void push(Task task);
+
+    /**
+     * @brief Runs one task of the own queue or steals one from another queue
+     * @param self index of the own queue
+     * @return True if a task was run, false if all queues were empty
+     */
+    bool runOne(int self);
+
+    /**
+     * @brief Main loop of a worker thread
+     * @param self index of the own queue
+     */
+    void workerLoop(int self);
+};
+
+template<typename Function>
+void WorkStealingPool::spawn(TaskGroup &group, Function &&function) {
+    group.pending.fetch_add(1, std::memory_order_relaxed);
+    push(Task{std::function<void()>(std::forward<Function>(function)), &group});
+}
+
+template<typename Function>
+void WorkStealingPool::parallelFor(int from, int to, int grain, Function &&function) {
+    int chunkCount = (int) std::max(1u, threadCount() * 4);
+    int chunk = std::max(grain, (to - from + chunkCount - 1) / chunkCount);
+    TaskGroup group;
+    int lo = from;
+    for (; lo + chunk < to; lo += chunk) {
+        spawn(group, [&function, lo, chunk] { function(lo, lo + chunk); });
+    }
+    if (lo < to) {
+        function(lo, to);
+    }
+    wait(group);
+}
+
+/**
+ * @brief Parallel counterpart of median(Point *, bool, int, int, int)
+ *
+ * Quickselect whose three-way partition steps are distributed over the pool, ranges at or below
+ * PARALLEL_PARTITION_THRESHOLD are finished with std::nth_element. Instantiated for double, float and int32_t
+ * coordinates
+ * @param pool pool running the partition steps
+ * @param points array of points objects
+ * @param x true if split by x-coordinates, otherwise y-coordinates
+ * @param left index: left bound of array
+ * @param right index: right bound of array (exclusive)
+ * @param pos index: position of the split element
+ * @return split value of specified coordinate
+ */
+template<typename T>
+T parallelMedian(WorkStealingPool &pool, BasicPoint<T> *points, bool x, int left, int right, int pos);
+
+/**
+ * @brief Parallel counterpart of median(Point *, bool, int, int)
+ * @param pool pool running the partition steps
+ * @param points array of points objects
+ * @param x true if median by x-coordinates, otherwise y-coordinates
+ * @param left index: left bound of array
+ * @param right index: right bound of array (exclusive)
+ * @return median of specified coordinate
+ */
+template<typename T>
+T parallelMedian(WorkStealingPool &pool, BasicPoint<T> *points, bool x, int left, int right);
+
+/**
+ * @brief Distributes points to the 4 quadrants of a Quadtree node in parallel chunks
+ *
+ * Classifies with quadrantOf() like the serial subdivide() of the Quadtrees and keeps the order of the points
+ * within every quadrant, so children are identical to the serial ones.
+ * Instantiated for double, float and int32_t coordinates
+ * @param pool pool classifying the chunks
+ * @param points points of the node
+ * @param size number of points
+ * @param xMid mid x-coordinate
+ * @param yMid mid y-coordinate
+ * @param quadrants 4 empty vectors indexed by Quadrant, resized to the number of points of their quadrant
+ */
+template<typename T>
+void parallelQuadrantSplit(WorkStealingPool &pool, const BasicPoint<T> *points, int size, T xMid, T yMid,
+                           std::pmr::vector<BasicPoint<T>> *quadrants);
+
+#endif //QUADKDBENCH_WORKSTEALINGPOOL_H
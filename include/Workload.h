@@ -0,0 +1,193 @@
+/**
+ * @author Omar Chatila
+ * @file Workload.h
+ * @brief Deterministic point sets and queries of several distributions
+ *
+ * All generators take a seed and produce the same points for the same seed on every run, independent of the number
+ * of threads. Only mt19937_64 is taken from the standard library, the distributions are computed here because the
+ * ones of <random> differ between standard libraries. Large sets are generated in parallel in chunks
+ * of WORKLOAD_CHUNK points, every chunk draws from its own engine derived from the seed and the chunk index.
+ */
+
+#ifndef QUADKDBENCH_WORKLOAD_H
+#define QUADKDBENCH_WORKLOAD_H
+
+#include "Util.h"
+#include "PointND.h"
+#include <bits/stdc++.h>
+
+/**
+ * Number of points generated by one task
+ */
+constexpr int WORKLOAD_CHUNK = 1 << 16;
+
+/**
+ * @brief Distribution of generated points
+ *
+ * All distributions except DENSE lie in [0, n]^2 for n points, DENSE lies in [0, 1000]^2
+ */
+enum PointDistribution {
+    UNIFORM,          /**< Uniform in the whole area */
+    DENSE,            /**< Uniform in an area of constant size */
+    CLUSTERED,        /**< Gaussian clusters, about 4096 points per cluster */
+    ZIPF_HOTSPOTS,    /**< 64 narrow hotspots whose popularity follows Zipf's law, 5% uniform background */
+    CURVES,           /**< Points close to 4 lines and 4 sine curves */
+    JITTERED_GRID,    /**< One point per cell of a square grid, moved by up to a quarter of a cell */
+    DUPLICATES        /**< About 16 exact copies per location, half of the locations in a hotspot of width 1 */
+};
+
+/**
+ * Number of values of PointDistribution
+ */
+constexpr int POINT_DISTRIBUTION_COUNT = 7;
+
+/**
+ * @param distribution distribution
+ * @return lower case name of distribution
+ */
+std::string distributionName(PointDistribution distribution);
+
+/**
+ * @param pointNumber number of points
+ * @param distribution distribution of the points
+ * @return area containing all points generated by generatePoints()
+ */
+Area workloadArea(int pointNumber, PointDistribution distribution);
+
+/**
+ * @brief Generates pointNumber points of distribution
+ * @param pointNumber number of points
+ * @param distribution distribution of the points
+ * @param seed seed, equal seeds give equal points
+ * @return vector with the points
+ */
+std::vector<Point> generatePoints(int pointNumber, PointDistribution distribution, uint64_t seed = WORKLOAD_SEED);
+
+/**
+ * @brief Generates pointNumber points of distribution into an array allocated with malloc
+ * @param pointNumber number of points
+ * @param distribution distribution of the points
+ * @param seed seed, equal seeds give equal points
+ * @return array with the points, released with free()
+ */
+Point *generatePointsArray(int pointNumber, PointDistribution distribution, uint64_t seed = WORKLOAD_SEED);
+
+/**
+ * @brief Generates square query areas centered at points of a set, so skewed sets are queried where their points are
+ * @param points points the centers are chosen from
+ * @param area area of the points
+ * @param number number of query areas
+ * @param selectivity fraction of area covered by one query area
+ * @param seed seed, equal seeds give equal areas
+ * @return vector with the query areas
+ */
+std::vector<Area> generateQueryAreas(std::vector<Point> &points, Area &area, int number, double selectivity,
+                                     uint64_t seed = WORKLOAD_SEED);
+
+/**
+ * @brief Picks indices of query points, generateQueryPoints(points, ...) returns the points at these indices
+ * @param pointNumber number of points the indices are chosen from
+ * @param number number of indices
+ * @param seed seed, equal seeds give equal indices
+ * @return vector with indices in [0, pointNumber)
+ */
+std::vector<int> generateQueryIndices(int pointNumber, int number, uint64_t seed = WORKLOAD_SEED);
+
+/**
+ * @brief Picks query points of a set
+ * @param points points the query points are chosen from
+ * @param number number of query points
+ * @param seed seed, equal seeds give equal query points
+ * @return vector with the query points
+ */
+std::vector<Point> generateQueryPoints(std::vector<Point> &points, int number, uint64_t seed = WORKLOAD_SEED);
+
+/**
+ * @brief Generates query points uniformly distributed in area, on skewed sets most of them lie in sparse regions
+ * @param area area of the query points
+ * @param number number of query points
+ * @param seed seed, equal seeds give equal query points
+ * @return vector with the query points
+ */
+std::vector<Point> generateQueryPoints(Area &area, int number, uint64_t seed = WORKLOAD_SEED);
+
+/**
+ * @brief Generates pointNumber points with D coordinates
+ *
+ * Coordinates 2i and 2i + 1 are the x and y coordinates of generatePoints() with seed + i, so every pair of axes
+ * follows distribution and clusters of different pairs are combined independently
+ * @param pointNumber number of points
+ * @param distribution distribution of every pair of axes
+ * @param seed seed, equal seeds give equal points
+ * @return vector with the points
+ */
+template<int D>
+std::vector<PointND<D>> generatePointsND(int pointNumber, PointDistribution distribution,
+                                         uint64_t seed = WORKLOAD_SEED) {
+    std::vector<PointND<D>> points(pointNumber);
+    for (int pair = 0; 2 * pair < D; pair++) {
+        std::vector<Point> plane = generatePoints(pointNumber, distribution, seed + pair);
+        for (int i = 0; i < pointNumber; i++) {
+            points[i][2 * pair] = plane[i].x;
+            if (2 * pair + 1 < D) {
+                points[i][2 * pair + 1] = plane[i].y;
+            }
+        }
+    }
+    return points;
+}
+
+/**
+ * @return box containing all points generated by generatePointsND()
+ */
+template<int D>
+BoxND<D> workloadBoxND(int pointNumber, PointDistribution distribution) {
+    Area area = workloadArea(pointNumber, distribution);
+    BoxND<D> box;
+    for (int axis = 0; axis < D; axis++) {
+        box.min[axis] = axis % 2 == 0 ? area.xMin : area.yMin;
+        box.max[axis] = axis % 2 == 0 ? area.xMax : area.yMax;
+    }
+    return box;
+}
+
+/**
+ * @brief Generates cubic query boxes centered at points of a set, the D-dimensional generateQueryAreas()
+ * @param points points the centers are chosen from
+ * @param box box of the points
+ * @param number number of query boxes
+ * @param selectivity fraction of box covered by one query box
+ * @param seed seed, equal seeds give equal boxes
+ * @return vector with the query boxes
+ */
+template<int D>
+std::vector<BoxND<D>> generateQueryBoxesND(std::vector<PointND<D>> &points, const BoxND<D> &box, int number,
+                                           double selectivity, uint64_t seed = WORKLOAD_SEED) {
+    double fraction = std::pow(selectivity, 1.0 / D);
+    std::vector<BoxND<D>> boxes;
+    for (int index: generateQueryIndices((int) points.size(), number, seed)) {
+        BoxND<D> queryBox;
+        for (int axis = 0; axis < D; axis++) {
+            double half = (box.max[axis] - box.min[axis]) * fraction / 2;
+            queryBox.min[axis] = points[index][axis] - half;
+            queryBox.max[axis] = points[index][axis] + half;
+        }
+        boxes.push_back(queryBox);
+    }
+    return boxes;
+}
+
+/**
+ * @brief Picks query points of a set with D coordinates
+ */
+template<int D>
+std::vector<PointND<D>> generateQueryPointsND(std::vector<PointND<D>> &points, int number,
+                                              uint64_t seed = WORKLOAD_SEED) {
+    std::vector<PointND<D>> queryPoints;
+    for (int index: generateQueryIndices((int) points.size(), number, seed)) {
+        queryPoints.push_back(points[index]);
+    }
+    return queryPoints;
+}
+
+#endif //QUADKDBENCH_WORKLOAD_H
@@ -4,7 +4,11 @@
 
 #include "../include/KDTreeEfficient.h"
 #include "../include/KDBTreeEfficient.h"
+#include "../include/ImplicitKDTree.h"
 #include "../include/TreeHelper.h"
+#include "../include/PointIO.h"
+#include "../include/KDBTreeND.h"
+#include "../include/OrthTree.h"
 #include "../benchmark/include/benchmark/benchmark.h"
 #include "cmath"
 
@@ -18,7 +22,7 @@ using namespace std;
 
 static void buildKDETree(benchmark::State &state) {
     int pointNumber = state.range(0);
-    auto *points = getRandomPointsArray(pointNumber);
+    auto *points = generatePointsArray(pointNumber, UNIFORM);
     double bounds = pointNumber;
     Area area{0, bounds, 0, bounds};
 
@@ -33,12 +37,12 @@ static void buildKDETree(benchmark::State &state) {
 
 static void buildKDBTree(benchmark::State &state) {
     int pointNumber = state.range(0);
-    auto *points = getRandomPointsArray(pointNumber);
+    auto *points = generatePointsArray(pointNumber, UNIFORM);
     double bounds = pointNumber;
     Area area{0, bounds, 0, bounds};
-    int capacity = (int) max(log10(pointNumber), 4.0);
+    int capacity = defaultLeafCapacity(pointNumber);
     for ([[maybe_unused]] auto _: state) {
-        auto *kdbTreeEfficient = new KDBTreeEfficient(points, 0, area, 0, pointNumber, capacity);
+        auto *kdbTreeEfficient = new KDBTreeEfficient(points, 0, area, 0, pointNumber - 1, capacity);
         benchmark::DoNotOptimize(kdbTreeEfficient);
         kdbTreeEfficient->buildTree();
         delete kdbTreeEfficient;
@@ -46,15 +50,191 @@ static void buildKDBTree(benchmark::State &state) {
     state.SetComplexityN(state.range(0));
 }
 
+static void buildKDETreeArena(benchmark::State &state) {
+    int pointNumber = state.range(0);
+    auto *points = generatePointsArray(pointNumber, UNIFORM);
+    double bounds = pointNumber;
+    Area area{0, bounds, 0, bounds};
+    NodeArena arena(NODE_ARENA_BLOCK_SIZE, state.range(1) != 0);
+
+    for ([[maybe_unused]] auto _: state) {
+        auto *kdTreeEfficient = new KDTreeEfficient(points, area, pointNumber, arena);
+        benchmark::DoNotOptimize(kdTreeEfficient);
+        kdTreeEfficient->buildTree();
+        delete kdTreeEfficient;
+        arena.release();
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void buildKDBTreeArena(benchmark::State &state) {
+    int pointNumber = state.range(0);
+    auto *points = generatePointsArray(pointNumber, UNIFORM);
+    double bounds = pointNumber;
+    Area area{0, bounds, 0, bounds};
+    int capacity = defaultLeafCapacity(pointNumber);
+    NodeArena arena(NODE_ARENA_BLOCK_SIZE, state.range(1) != 0);
+    for ([[maybe_unused]] auto _: state) {
+        auto *kdbTreeEfficient = new KDBTreeEfficient(points, 0, area, 0, pointNumber - 1, capacity, arena);
+        benchmark::DoNotOptimize(kdbTreeEfficient);
+        kdbTreeEfficient->buildTree();
+        delete kdbTreeEfficient;
+        arena.release();
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void buildKDETreeParallel(benchmark::State &state) {
+    int pointNumber = state.range(0);
+    auto *points = generatePointsArray(pointNumber, UNIFORM);
+    double bounds = pointNumber;
+    Area area{0, bounds, 0, bounds};
+    WorkStealingPool pool(state.range(1));
+
+    for ([[maybe_unused]] auto _: state) {
+        auto *kdTreeEfficient = new KDTreeEfficient(points, area, pointNumber, pool);
+        benchmark::DoNotOptimize(kdTreeEfficient);
+        kdTreeEfficient->buildTree(pool);
+        delete kdTreeEfficient;
+    }
+    free(points);
+    state.SetComplexityN(state.range(0));
+}
+
+static void buildKDBTreeParallel(benchmark::State &state) {
+    int pointNumber = state.range(0);
+    auto *points = generatePointsArray(pointNumber, UNIFORM);
+    double bounds = pointNumber;
+    Area area{0, bounds, 0, bounds};
+    int capacity = defaultLeafCapacity(pointNumber);
+    WorkStealingPool pool(state.range(1));
+
+    for ([[maybe_unused]] auto _: state) {
+        auto *kdbTreeEfficient = new KDBTreeEfficient(points, 0, area, 0, pointNumber - 1, capacity, pool);
+        benchmark::DoNotOptimize(kdbTreeEfficient);
+        kdbTreeEfficient->buildTree(pool);
+        delete kdbTreeEfficient;
+    }
+    free(points);
+    state.SetComplexityN(state.range(0));
+}
+
+static void buildImplicitKDTree(benchmark::State &state) {
+    int pointNumber = state.range(0);
+    auto *points = generatePointsArray(pointNumber, UNIFORM);
+    double bounds = pointNumber;
+    Area area{0, bounds, 0, bounds};
+
+    for ([[maybe_unused]] auto _: state) {
+        auto *implicitKDTree = new ImplicitKDTree(points, area, pointNumber);
+        benchmark::DoNotOptimize(implicitKDTree);
+        implicitKDTree->buildTree();
+        delete implicitKDTree;
+    }
+    free(points);
+    state.SetComplexityN(state.range(0));
+}
+
 static void buildQuadTree(benchmark::State &state) {
     int pointNumber = state.range(0);
     double bounds = pointNumber;
-    vector<Point> points = getRandomPoints(pointNumber);
+    vector<Point> points = generatePoints(pointNumber, UNIFORM);
+
+    Area area{0, bounds, 0, bounds};
+    for ([[maybe_unused]] auto _: state) {
+        auto *quadTree = new QuadTree(area, points);
+        benchmark::DoNotOptimize(quadTree);
+        quadTree->buildTree();
+        delete quadTree;
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void buildQuadTreeParallel(benchmark::State &state) {
+    int pointNumber = state.range(0);
+    double bounds = pointNumber;
+    vector<Point> points = generatePoints(pointNumber, UNIFORM);
+    WorkStealingPool pool(state.range(1));
 
     Area area{0, bounds, 0, bounds};
     for ([[maybe_unused]] auto _: state) {
         auto *quadTree = new QuadTree(area, points);
         benchmark::DoNotOptimize(quadTree);
+        quadTree->buildTree(pool);
+        delete quadTree;
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void buildQuadTreeArena(benchmark::State &state) {
+    int pointNumber = state.range(0);
+    double bounds = pointNumber;
+    vector<Point> points = generatePoints(pointNumber, UNIFORM);
+    NodeArena arena(NODE_ARENA_BLOCK_SIZE, state.range(1) != 0);
+
+    Area area{0, bounds, 0, bounds};
+    for ([[maybe_unused]] auto _: state) {
+        auto *quadTree = new QuadTree(area, points, arena);
+        benchmark::DoNotOptimize(quadTree);
+        quadTree->buildTree();
+        delete quadTree;
+        arena.release();
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void buildQuadTreeEfficient(benchmark::State &state) {
+    int pointNumber = state.range(0);
+    double bounds = pointNumber;
+    Point *points = generatePointsArray(pointNumber, UNIFORM);
+    Area area{0, bounds, 0, bounds};
+    for ([[maybe_unused]] auto _: state) {
+        auto *quadTree = new QuadTreeEfficient(points, area, pointNumber);
+        benchmark::DoNotOptimize(quadTree);
+        quadTree->buildTree();
+        delete quadTree;
+    }
+    free(points);
+    state.SetComplexityN(state.range(0));
+}
+
+static void buildLinearQuadTree(benchmark::State &state) {
+    int pointNumber = state.range(0);
+    double bounds = pointNumber;
+    Point *points = generatePointsArray(pointNumber, UNIFORM);
+    Area area{0, bounds, 0, bounds};
+    for ([[maybe_unused]] auto _: state) {
+        auto *quadTree = new LinearQuadTree(points, area, pointNumber);
+        benchmark::DoNotOptimize(quadTree);
+        quadTree->buildTree();
+        delete quadTree;
+    }
+    free(points);
+    state.SetComplexityN(state.range(0));
+}
+
+static void buildCompressedQuadTree(benchmark::State &state) {
+    int pointNumber = state.range(0);
+    double bounds = pointNumber;
+    vector<Point> points = generatePoints(pointNumber, UNIFORM);
+    Area area{0, bounds, 0, bounds};
+    for ([[maybe_unused]] auto _: state) {
+        auto *quadTree = new CompressedQuadTree(area, points);
+        benchmark::DoNotOptimize(quadTree);
+        quadTree->buildTree();
+        delete quadTree;
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void buildCompressedQuadTree_Duplicates(benchmark::State &state) {
+    int pointNumber = state.range(0);
+    double bounds = pointNumber;
+    vector<Point> points = generatePoints(pointNumber, DUPLICATES);
+    Area area{0, bounds, 0, bounds};
+    for ([[maybe_unused]] auto _: state) {
+        auto *quadTree = new CompressedQuadTree(area, points);
+        benchmark::DoNotOptimize(quadTree);
         quadTree->buildTree();
         delete quadTree;
     }
@@ -63,9 +243,9 @@ static void buildQuadTree(benchmark::State &state) {
 
 static void buildPRQuadTree(benchmark::State &state) {
     int pointNumber = state.range(0);
-    int capacity = (int) max(log10(pointNumber), 4.0);
+    int capacity = defaultLeafCapacity(pointNumber);
     double bounds = pointNumber;
-    vector<Point> points = getRandomPoints(pointNumber);
+    vector<Point> points = generatePoints(pointNumber, UNIFORM);
     Area area{0, bounds, 0, bounds};
     for ([[maybe_unused]] auto _: state) {
         auto *prQuadTree = new PointRegionQuadTree(area, points, capacity);
@@ -76,22 +256,67 @@ static void buildPRQuadTree(benchmark::State &state) {
     state.SetComplexityN(state.range(0));
 }
 
+static void buildPRQuadTreeArena(benchmark::State &state) {
+    int pointNumber = state.range(0);
+    int capacity = defaultLeafCapacity(pointNumber);
+    double bounds = pointNumber;
+    vector<Point> points = generatePoints(pointNumber, UNIFORM);
+    Area area{0, bounds, 0, bounds};
+    NodeArena arena(NODE_ARENA_BLOCK_SIZE, state.range(1) != 0);
+    for ([[maybe_unused]] auto _: state) {
+        auto *prQuadTree = new PointRegionQuadTree(area, points, capacity, arena);
+        benchmark::DoNotOptimize(prQuadTree);
+        prQuadTree->buildTree();
+        delete prQuadTree;
+        arena.release();
+    }
+    state.SetComplexityN(state.range(0));
+}
+
 static void buildSKDTree(benchmark::State &state) {
-    vector<Point> points = getRandomPoints(state.range(0));
+    vector<Point> points = generatePoints(state.range(0), UNIFORM);
+    double bounds = state.range(0);
+    Area area{0, bounds, 0, bounds};
+    for ([[maybe_unused]] auto _: state) {
+        auto *sortKDTree = new SortKDTree(points, area);
+        benchmark::DoNotOptimize(sortKDTree);
+        sortKDTree->buildTree();
+        delete sortKDTree;
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void buildSKDTreePresorted(benchmark::State &state) {
+    vector<Point> points = generatePoints(state.range(0), UNIFORM);
     double bounds = state.range(0);
     Area area{0, bounds, 0, bounds};
     for ([[maybe_unused]] auto _: state) {
         auto *sortKDTree = new SortKDTree(points, area);
         benchmark::DoNotOptimize(sortKDTree);
+        sortKDTree->buildTreePresorted();
+        delete sortKDTree;
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void buildSKDTreeArena(benchmark::State &state) {
+    vector<Point> points = generatePoints(state.range(0), UNIFORM);
+    double bounds = state.range(0);
+    Area area{0, bounds, 0, bounds};
+    NodeArena arena(NODE_ARENA_BLOCK_SIZE, state.range(1) != 0);
+    for ([[maybe_unused]] auto _: state) {
+        auto *sortKDTree = new SortKDTree(points, area, arena);
+        benchmark::DoNotOptimize(sortKDTree);
         sortKDTree->buildTree();
         delete sortKDTree;
+        arena.release();
     }
     state.SetComplexityN(state.range(0));
 }
 
 static void buildDenseKDETree(benchmark::State &state) {
     int pointNumber = state.range(0);
-    auto *points = getDensePointsArray(pointNumber);
+    auto *points = generatePointsArray(pointNumber, DENSE);
     Area area{0, 1000, 0, 1000};
 
     for ([[maybe_unused]] auto _: state) {
@@ -106,11 +331,11 @@ static void buildDenseKDETree(benchmark::State &state) {
 
 static void buildDenseKDBTree(benchmark::State &state) {
     int pointNumber = state.range(0);
-    auto *points = getDensePointsArray(pointNumber);
+    auto *points = generatePointsArray(pointNumber, DENSE);
     Area area{0, 1000, 0, 1000};
-    int capacity = (int) max(log10(pointNumber), 4.0);
+    int capacity = defaultLeafCapacity(pointNumber);
     for ([[maybe_unused]] auto _: state) {
-        auto *kdbTreeEfficient = new KDBTreeEfficient(points, 0, area, 0, pointNumber, capacity);
+        auto *kdbTreeEfficient = new KDBTreeEfficient(points, 0, area, 0, pointNumber - 1, capacity);
         benchmark::DoNotOptimize(kdbTreeEfficient);
         kdbTreeEfficient->buildTree();
         delete kdbTreeEfficient;
@@ -120,7 +345,7 @@ static void buildDenseKDBTree(benchmark::State &state) {
 
 static void buildDenseQuadTree(benchmark::State &state) {
     int pointNumber = state.range(0);
-    vector<Point> points = getDensePoints(pointNumber);
+    vector<Point> points = generatePoints(pointNumber, DENSE);
     Area area{0, 1000, 0, 1000};
     for ([[maybe_unused]] auto _: state) {
         auto *quadTree = new QuadTree(area, points);
@@ -133,8 +358,8 @@ static void buildDenseQuadTree(benchmark::State &state) {
 
 static void buildDensePRQuadTree(benchmark::State &state) {
     int pointNumber = state.range(0);
-    int capacity = (int) max(log10(pointNumber), 4.0);
-    vector<Point> points = getDensePoints(pointNumber);
+    int capacity = defaultLeafCapacity(pointNumber);
+    vector<Point> points = generatePoints(pointNumber, DENSE);
     Area area{0, 1000, 0, 1000};
     for ([[maybe_unused]] auto _: state) {
         auto *prQuadTree = new PointRegionQuadTree(area, points, capacity);
@@ -145,8 +370,23 @@ static void buildDensePRQuadTree(benchmark::State &state) {
     state.SetComplexityN(state.range(0));
 }
 
+static void buildDensePRQuadTreeParallel(benchmark::State &state) {
+    int pointNumber = state.range(0);
+    int capacity = defaultLeafCapacity(pointNumber);
+    vector<Point> points = generatePoints(pointNumber, DENSE);
+    Area area{0, 1000, 0, 1000};
+    WorkStealingPool pool(state.range(1));
+    for ([[maybe_unused]] auto _: state) {
+        auto *prQuadTree = new PointRegionQuadTree(area, points, capacity);
+        benchmark::DoNotOptimize(prQuadTree);
+        prQuadTree->buildTree(pool);
+        delete prQuadTree;
+    }
+    state.SetComplexityN(state.range(0));
+}
+
 static void buildDensesortKDTree(benchmark::State &state) {
-    vector<Point> points = getDensePoints(state.range(0));
+    vector<Point> points = generatePoints(state.range(0), DENSE);
     Area area{0, 1000, 0, 1000};
     for ([[maybe_unused]] auto _: state) {
         auto *sortKDTree = new SortKDTree(points, area);
@@ -161,20 +401,141 @@ static void buildDensesortKDTree(benchmark::State &state) {
 
 // Build dynamically
 
+static void ingestConcurrentPRQuadTree(benchmark::State &state) {
+    int size = state.range(0);
+    int threadCount = state.range(1);
+    int capacity = defaultLeafCapacity(size);
+    double bounds = size;
+    Area area{0, bounds, 0, bounds};
+    vector<Point> points = generatePoints(size, UNIFORM);
+    for ([[maybe_unused]] auto _: state) {
+        auto *quadTree = new ConcurrentPRQuadTree(area, capacity);
+        vector<thread> producers;
+        for (int t = 0; t < threadCount; t++) {
+            producers.emplace_back([&, t] {
+                for (int i = t; i < size; i += threadCount) {
+                    quadTree->add(points[i]);
+                }
+            });
+        }
+        for (auto &producer: producers) {
+            producer.join();
+        }
+        benchmark::DoNotOptimize(quadTree);
+        state.PauseTiming();
+        delete quadTree;
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+static void ingestMutexPRQuadTree(benchmark::State &state) {
+    int size = state.range(0);
+    int threadCount = state.range(1);
+    int capacity = defaultLeafCapacity(size);
+    double bounds = size;
+    Area area{0, bounds, 0, bounds};
+    vector<Point> points = generatePoints(size, UNIFORM);
+    vector<Point> empty;
+    for ([[maybe_unused]] auto _: state) {
+        auto *quadTree = new PointRegionQuadTree(area, empty, capacity);
+        std::mutex lock;
+        vector<thread> producers;
+        for (int t = 0; t < threadCount; t++) {
+            producers.emplace_back([&, t] {
+                for (int i = t; i < size; i += threadCount) {
+                    std::lock_guard<std::mutex> guard(lock);
+                    quadTree->add(points[i]);
+                }
+            });
+        }
+        for (auto &producer: producers) {
+            producer.join();
+        }
+        benchmark::DoNotOptimize(quadTree);
+        state.PauseTiming();
+        delete quadTree;
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+static void churnPRQuadTree(benchmark::State &state) {
+    int size = state.range(0);
+    // every iteration slides the window by batch points: the oldest are removed, new ones are added
+    int batch = max(size / 64, 1);
+    int capacity = defaultLeafCapacity(size);
+    double bounds = size;
+    Area area{0, bounds, 0, bounds};
+    vector<Point> points = generatePoints(size, UNIFORM);
+    vector<Point> incoming = generatePoints(size, UNIFORM, WORKLOAD_SEED + 1);
+    auto *quadTree = new PointRegionQuadTree(area, points, capacity);
+    quadTree->buildTree();
+    deque<Point> window(points.begin(), points.end());
+    int next = 0;
+    for ([[maybe_unused]] auto _: state) {
+        for (int i = 0; i < batch; i++) {
+            quadTree->remove(window.front());
+            window.pop_front();
+            Point point = incoming[next];
+            next = (next + 1) % size;
+            quadTree->add(point);
+            window.push_back(point);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+    delete quadTree;
+}
+
+static void churnPRQuadTree_Rebuild(benchmark::State &state) {
+    int size = state.range(0);
+    int batch = max(size / 64, 1);
+    for ([[maybe_unused]] auto _: state) {
+        PointRegionQuadTree *quadTree = buildPRQuadTreeRandom(size);
+        benchmark::DoNotOptimize(quadTree);
+        state.PauseTiming();
+        delete quadTree;
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+static void ingestDynamicKDBTree(benchmark::State &state) {
+    int size = state.range(0);
+    double bounds = size;
+    Area area{0, bounds, 0, bounds};
+    vector<Point> points = generatePoints(size, UNIFORM);
+    for ([[maybe_unused]] auto _: state) {
+        auto *tree = new DynamicKDBTree(area);
+        benchmark::DoNotOptimize(tree);
+        for (auto &point: points) {
+            tree->add(point);
+        }
+        state.PauseTiming();
+        delete tree;
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+    state.SetComplexityN(state.range(0));
+}
+
 static void buildKDTree_Dynamically(benchmark::State &state) {
     int size = state.range(0);
     vector<Point> points;
     double bounds = size;
     Area area{0, bounds, 0, bounds};
-    auto *sortKDTree = new SortKDTree(points, area);
-    vector<Point> randomPoints = getRandomPoints(size);
+    vector<Point> randomPoints = generatePoints(size, UNIFORM);
     for ([[maybe_unused]] auto _: state) {
+        auto *sortKDTree = new SortKDTree(points, area);
         benchmark::DoNotOptimize(sortKDTree);
         for (int i = 0; i < size; i++) {
             sortKDTree->add(randomPoints[i]);
         }
+        state.PauseTiming();
+        state.counters["height"] = sortKDTree->getHeight();
+        delete sortKDTree;
+        state.ResumeTiming();
     }
-    delete sortKDTree;
     state.SetComplexityN(state.range(0));
 }
 
@@ -184,18 +545,18 @@ static void buildQuadTree_Dynamically(benchmark::State &state) {
     points.reserve(size);
     double bounds = size;
     Area area{0, bounds, 0, bounds};
-    auto *quadTree = new QuadTree(area, points);
-    auto *randomPoints = (Point *) (malloc(size * sizeof(Point)));
-    for (int i = 0; i < size; i++) {
-        randomPoints[i] = getRandomPoint(size);
-    }
+    auto *randomPoints = generatePointsArray(size, UNIFORM);
     for ([[maybe_unused]] auto _: state) {
+        auto *quadTree = new QuadTree(area, points);
         benchmark::DoNotOptimize(quadTree);
         for (int i = 0; i < size; i++) {
             quadTree->add(randomPoints[i]);
         }
+        state.PauseTiming();
+        state.counters["height"] = quadTree->getHeight();
+        delete quadTree;
+        state.ResumeTiming();
     }
-    delete quadTree;
     free(randomPoints);
     state.SetComplexityN(state.range(0));
 }
@@ -214,6 +575,48 @@ static void queryQuadTree(benchmark::State &state) {
     state.SetComplexityN(state.range(0));
 }
 
+static void queryQuadTreeEfficient(benchmark::State &state) {
+    int size = state.range(0);
+    QuadTreeEfficient *quadTree = buildQuadTreeEfficientRandom(size);
+    Area bigArea{0.3 * size, 0.5 * size, 0.54 * size, 0.64 * size};
+    vector<Point> result;
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(quadTree);
+        result.clear();
+        quadTree->query(bigArea, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    delete quadTree;
+    state.SetComplexityN(state.range(0));
+}
+
+static void queryLinearQuadTree(benchmark::State &state) {
+    int size = state.range(0);
+    LinearQuadTree *quadTree = buildLinearQuadTreeRandom(size);
+    Area bigArea{0.3 * size, 0.5 * size, 0.54 * size, 0.64 * size};
+    vector<Point> result;
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(quadTree);
+        result.clear();
+        quadTree->query(bigArea, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    delete quadTree;
+    state.SetComplexityN(state.range(0));
+}
+
+static void queryCompressedQuadTree(benchmark::State &state) {
+    int size = state.range(0);
+    CompressedQuadTree *quadTree = buildCompressedQuadTreeRandom(size);
+    Area bigArea{0.3 * size, 0.5 * size, 0.54 * size, 0.64 * size};
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(quadTree);
+        quadTree->query(bigArea);
+    }
+    delete quadTree;
+    state.SetComplexityN(state.range(0));
+}
+
 static void queryPRQuadTree(benchmark::State &state) {
     int size = state.range(0);
     PointRegionQuadTree *quadTree = buildPRQuadTreeRandom(size);
@@ -228,7 +631,7 @@ static void queryPRQuadTree(benchmark::State &state) {
 
 static void queryKDETree(benchmark::State &state) {
     int size = state.range(0);
-    auto *points = getRandomPointsArray(size);
+    auto *points = generatePointsArray(size, UNIFORM);
     double bounds = size;
     Area area{0, bounds, 0, bounds};
     auto *kdTreeEfficient = new KDTreeEfficient(points, area, size);
@@ -242,14 +645,26 @@ static void queryKDETree(benchmark::State &state) {
     state.SetComplexityN(state.range(0));
 }
 
-static void queryKDBTree(benchmark::State &state) {
+static void queryDynamicKDBTree(benchmark::State &state) {
     int size = state.range(0);
-    auto *points = getRandomPointsArray(size);
-    double bounds = size;
-    int capacity = (int) max(log10(bounds), 4.0);
-    Area area{0, bounds, 0, bounds};
-    auto *kdbTreeEfficient = new KDBTreeEfficient(points, 0, area, 0, size, capacity);
-    kdbTreeEfficient->buildTree();
+    DynamicKDBTree *tree = buildDynamicKDBTreeRandom(size);
+    Area bigArea{0.3 * size, 0.5 * size, 0.54 * size, 0.64 * size};
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(tree);
+        tree->query(bigArea);
+    }
+    delete tree;
+    state.SetComplexityN(state.range(0));
+}
+
+static void queryKDBTree(benchmark::State &state) {
+    int size = state.range(0);
+    auto *points = generatePointsArray(size, UNIFORM);
+    double bounds = size;
+    int capacity = defaultLeafCapacity(size);
+    Area area{0, bounds, 0, bounds};
+    auto *kdbTreeEfficient = new KDBTreeEfficient(points, 0, area, 0, size - 1, capacity);
+    kdbTreeEfficient->buildTree();
     Area bigArea{0.3 * size, 0.5 * size, 0.54 * size, 0.64 * size};
     for ([[maybe_unused]] auto _: state) {
         benchmark::DoNotOptimize(kdbTreeEfficient);
@@ -259,6 +674,158 @@ static void queryKDBTree(benchmark::State &state) {
     state.SetComplexityN(state.range(0));
 }
 
+static void queryImplicitKDTree(benchmark::State &state) {
+    int size = state.range(0);
+    ImplicitKDTree *implicitKDTree = buildImplicitKD_Random(size);
+    Area bigArea{0.3 * size, 0.5 * size, 0.54 * size, 0.64 * size};
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(implicitKDTree);
+        implicitKDTree->query(bigArea);
+    }
+    delete implicitKDTree;
+    state.SetComplexityN(state.range(0));
+}
+
+static void queryPRQuadTree_Buffer(benchmark::State &state) {
+    int size = state.range(0);
+    PointRegionQuadTree *quadTree = buildPRQuadTreeRandom(size);
+    Area bigArea{0.3 * size, 0.5 * size, 0.54 * size, 0.64 * size};
+    vector<Point> result;
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(quadTree);
+        result.clear();
+        quadTree->query(bigArea, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    delete quadTree;
+    state.SetComplexityN(state.range(0));
+}
+
+static void queryKDETree_Buffer(benchmark::State &state) {
+    int size = state.range(0);
+    KDTreeEfficient *kdTreeEfficient = buildEKD_Random(size);
+    Area bigArea{0.3 * size, 0.5 * size, 0.54 * size, 0.64 * size};
+    vector<Point> result;
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(kdTreeEfficient);
+        result.clear();
+        kdTreeEfficient->query(bigArea, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    delete kdTreeEfficient;
+    state.SetComplexityN(state.range(0));
+}
+
+static void queryKDBTree_Buffer(benchmark::State &state) {
+    int size = state.range(0);
+    KDBTreeEfficient *kdbTreeEfficient = buildKDB_Random(size);
+    Area bigArea{0.3 * size, 0.5 * size, 0.54 * size, 0.64 * size};
+    vector<Point> result;
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(kdbTreeEfficient);
+        result.clear();
+        kdbTreeEfficient->query(bigArea, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    delete kdbTreeEfficient;
+    state.SetComplexityN(state.range(0));
+}
+
+static void queryKDBTree_Capacity(benchmark::State &state) {
+    int size = state.range(0);
+    CapacityProfile profile;
+    profile.record(size, (int) state.range(1));
+    KDBTreeEfficient *kdbTreeEfficient = buildKDB_Random(size, profile);
+    Area bigArea{0.3 * size, 0.5 * size, 0.54 * size, 0.64 * size};
+    vector<Point> result;
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(kdbTreeEfficient);
+        result.clear();
+        kdbTreeEfficient->query(bigArea, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    delete kdbTreeEfficient;
+}
+
+static void queryPRQuadTree_Capacity(benchmark::State &state) {
+    int size = state.range(0);
+    CapacityProfile profile;
+    profile.record(size, (int) state.range(1));
+    PointRegionQuadTree *quadTree = buildPRQuadTreeRandom(size, profile);
+    Area bigArea{0.3 * size, 0.5 * size, 0.54 * size, 0.64 * size};
+    vector<Point> result;
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(quadTree);
+        result.clear();
+        quadTree->query(bigArea, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    delete quadTree;
+}
+
+static void queryKDBTree_Columns(benchmark::State &state) {
+    int size = state.range(0);
+    KDBTreeEfficient *kdbTreeEfficient = buildKDB_Random(size);
+    kdbTreeEfficient->buildColumns();
+    Area bigArea{0.3 * size, 0.5 * size, 0.54 * size, 0.64 * size};
+    vector<Point> result;
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(kdbTreeEfficient);
+        result.clear();
+        kdbTreeEfficient->query(bigArea, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    delete kdbTreeEfficient;
+    state.SetComplexityN(state.range(0));
+}
+
+// range query on dense points, arguments are point count, leaf capacity and whether leaf columns are built
+static void queryDenseKDBTree_Leaves(benchmark::State &state) {
+    int size = state.range(0);
+    auto *points = generatePointsArray(size, DENSE);
+    Area area{0, 1000, 0, 1000};
+    auto *kdbTreeEfficient = new KDBTreeEfficient(points, 0, area, 0, size - 1, (int) state.range(1));
+    kdbTreeEfficient->buildTree();
+    if (state.range(2) != 0) {
+        kdbTreeEfficient->buildColumns();
+    }
+    Area queryArea{300, 500, 540, 640};
+    vector<Point> result;
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(kdbTreeEfficient);
+        result.clear();
+        kdbTreeEfficient->query(queryArea, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    delete kdbTreeEfficient;
+}
+
+static void queryKDETree_Count(benchmark::State &state) {
+    int size = state.range(0);
+    KDTreeEfficient *kdTreeEfficient = buildEKD_Random(size);
+    Area bigArea{0.3 * size, 0.5 * size, 0.54 * size, 0.64 * size};
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(kdTreeEfficient);
+        long count = 0;
+        kdTreeEfficient->query(bigArea, [&count](const Point &) { count++; });
+        benchmark::DoNotOptimize(count);
+    }
+    delete kdTreeEfficient;
+    state.SetComplexityN(state.range(0));
+}
+
+static void querysortKDTreeCompact(benchmark::State &state) {
+    int size = state.range(0);
+    SortKDTree *sortKDTree = buildSortKDTreeCompactRandom(size);
+    Area bigArea{0.3 * size, 0.5 * size, 0.54 * size, 0.64 * size};
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(sortKDTree);
+        sortKDTree->query(bigArea);
+    }
+    delete sortKDTree;
+    state.SetComplexityN(state.range(0));
+}
+
 static void querysortKDTree(benchmark::State &state) {
     int size = state.range(0);
     SortKDTree *sortKDTree = buildSortKDTreeRandom(size);
@@ -271,9 +838,68 @@ static void querysortKDTree(benchmark::State &state) {
     state.SetComplexityN(state.range(0));
 }
 
+static void countPRQuadTree(benchmark::State &state) {
+    int size = state.range(0);
+    PointRegionQuadTree *quadTree = buildPRQuadTreeRandom(size);
+    Area bigArea{0.3 * size, 0.5 * size, 0.54 * size, 0.64 * size};
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(quadTree);
+        benchmark::DoNotOptimize(quadTree->count(bigArea));
+    }
+    delete quadTree;
+    state.SetComplexityN(state.range(0));
+}
+
+static void countKDETree(benchmark::State &state) {
+    int size = state.range(0);
+    KDTreeEfficient *kdTreeEfficient = buildEKD_Random(size);
+    Area bigArea{0.3 * size, 0.5 * size, 0.54 * size, 0.64 * size};
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(kdTreeEfficient);
+        benchmark::DoNotOptimize(kdTreeEfficient->count(bigArea));
+    }
+    delete kdTreeEfficient;
+    state.SetComplexityN(state.range(0));
+}
+
+static void countKDBTree(benchmark::State &state) {
+    int size = state.range(0);
+    KDBTreeEfficient *kdbTreeEfficient = buildKDB_Random(size);
+    Area bigArea{0.3 * size, 0.5 * size, 0.54 * size, 0.64 * size};
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(kdbTreeEfficient);
+        benchmark::DoNotOptimize(kdbTreeEfficient->count(bigArea));
+    }
+    delete kdbTreeEfficient;
+    state.SetComplexityN(state.range(0));
+}
+
+static void aggregateKDBTree(benchmark::State &state) {
+    int size = state.range(0);
+    KDBTreeEfficient *kdbTreeEfficient = buildKDB_Random(size);
+    kdbTreeEfficient->buildAggregates([](const Point &p) { return p.x; });
+    Area bigArea{0.3 * size, 0.5 * size, 0.54 * size, 0.64 * size};
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(kdbTreeEfficient);
+        benchmark::DoNotOptimize(kdbTreeEfficient->aggregate(bigArea));
+    }
+    delete kdbTreeEfficient;
+    state.SetComplexityN(state.range(0));
+}
+
+static void countNaive(benchmark::State &state) {
+    int size = state.range(0);
+    vector<Point> points = generatePoints(state.range(0), UNIFORM);
+    Area bigArea{0.3 * size, 0.5 * size, 0.54 * size, 0.64 * size};
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(getQueryNaive(points, bigArea).size());
+    }
+    state.SetComplexityN(state.range(0));
+}
+
 static void queryNaive(benchmark::State &state) {
     int size = state.range(0);
-    vector<Point> points = getRandomPoints(state.range(0));
+    vector<Point> points = generatePoints(state.range(0), UNIFORM);
     Area bigArea{0.3 * size, 0.5 * size, 0.54 * size, 0.64 * size};
     for ([[maybe_unused]] auto _: state) {
         benchmark::DoNotOptimize(getQueryNaive(points, bigArea));
@@ -285,7 +911,7 @@ static void queryNaive(benchmark::State &state) {
 static void quadTree_contains(benchmark::State &state) {
     int size = state.range(0);
     QuadTree *quadTree = buildQuadTreeRandom(size);
-    std::vector<Point> points = getRandomPoints(size);
+    std::vector<Point> points = generatePoints(size, UNIFORM);
     std::vector<Point> searchPoints;
     searchPoints.reserve(size / 100);
     int step = size / 100;
@@ -300,10 +926,64 @@ static void quadTree_contains(benchmark::State &state) {
     state.SetComplexityN(state.range(0));
 }
 
+static void quadTreeEfficient_contains(benchmark::State &state) {
+    int size = state.range(0);
+    QuadTreeEfficient *quadTree = buildQuadTreeEfficientRandom(size);
+    std::vector<Point> points = generatePoints(size, UNIFORM);
+    std::vector<Point> searchPoints;
+    searchPoints.reserve(size / 100);
+    int step = size / 100;
+    for (int i = 0; i < state.range(0); i += step) {
+        searchPoints.push_back(points.at(i));
+    }
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(quadTree);
+        qtEContainsPoint(quadTree, searchPoints);
+    }
+    delete quadTree;
+    state.SetComplexityN(state.range(0));
+}
+
+static void linearQuadTree_contains(benchmark::State &state) {
+    int size = state.range(0);
+    LinearQuadTree *quadTree = buildLinearQuadTreeRandom(size);
+    std::vector<Point> points = generatePoints(size, UNIFORM);
+    std::vector<Point> searchPoints;
+    searchPoints.reserve(size / 100);
+    int step = size / 100;
+    for (int i = 0; i < state.range(0); i += step) {
+        searchPoints.push_back(points.at(i));
+    }
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(quadTree);
+        linearQtContainsPoint(quadTree, searchPoints);
+    }
+    delete quadTree;
+    state.SetComplexityN(state.range(0));
+}
+
+static void compressedQuadTree_contains(benchmark::State &state) {
+    int size = state.range(0);
+    CompressedQuadTree *quadTree = buildCompressedQuadTreeRandom(size);
+    std::vector<Point> points = generatePoints(size, UNIFORM);
+    std::vector<Point> searchPoints;
+    searchPoints.reserve(size / 100);
+    int step = size / 100;
+    for (int i = 0; i < state.range(0); i += step) {
+        searchPoints.push_back(points.at(i));
+    }
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(quadTree);
+        compressedQtContainsPoint(quadTree, searchPoints);
+    }
+    delete quadTree;
+    state.SetComplexityN(state.range(0));
+}
+
 static void pr_quadTree_contains(benchmark::State &state) {
     int size = state.range(0);
     PointRegionQuadTree *quadTree = buildPRQuadTreeRandom(size);
-    std::vector<Point> points = getRandomPoints(size);
+    std::vector<Point> points = generatePoints(size, UNIFORM);
     std::vector<Point> searchPoints;
     searchPoints.reserve(size / 100);
     int step = size / 100;
@@ -322,7 +1002,7 @@ static void pr_quadTree_contains(benchmark::State &state) {
 static void kDTreeEfficient_Contains(benchmark::State &state) {
     int size = state.range(0);
     KDTreeEfficient *tree = buildEKD_Random(size);
-    std::vector<Point> points = getRandomPoints(size);
+    std::vector<Point> points = generatePoints(size, UNIFORM);
     std::vector<Point> searchPoints;
     int step = size / 100;
     for (int i = 0; i < state.range(0); i += step) {
@@ -340,7 +1020,7 @@ static void kDTreeEfficient_Contains(benchmark::State &state) {
 static void kDBTreeEfficient_Contains(benchmark::State &state) {
     int size = state.range(0);
     KDBTreeEfficient *tree = buildKDB_Random(size);
-    std::vector<Point> points = getRandomPoints(size);
+    std::vector<Point> points = generatePoints(size, UNIFORM);
     std::vector<Point> searchPoints;
     int step = size / 100;
     for (int i = 0; i < state.range(0); i += step) {
@@ -355,10 +1035,46 @@ static void kDBTreeEfficient_Contains(benchmark::State &state) {
     state.SetComplexityN(state.range(0));
 }
 
+static void implicitKDTree_Contains(benchmark::State &state) {
+    int size = state.range(0);
+    ImplicitKDTree *tree = buildImplicitKD_Random(size);
+    std::vector<Point> points = generatePoints(size, UNIFORM);
+    std::vector<Point> searchPoints;
+    int step = size / 100;
+    for (int i = 0; i < state.range(0); i += step) {
+        searchPoints.push_back(points.at(i));
+    }
+
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(tree);
+        implicitKDContainsPoint(tree, searchPoints);
+    }
+    delete tree;
+    state.SetComplexityN(state.range(0));
+}
+
 static void sortKDTree_Contains(benchmark::State &state) {
     int size = state.range(0);
     SortKDTree *tree = buildSortKDTreeRandom(size);
-    std::vector<Point> points = getRandomPoints(size);
+    std::vector<Point> points = generatePoints(size, UNIFORM);
+    std::vector<Point> searchPoints;
+    int step = size / 100;
+    for (int i = 0; i < state.range(0); i += step) {
+        searchPoints.push_back(points.at(i));
+    }
+
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(tree);
+        sKDContainsPoint(tree, searchPoints);
+    }
+    delete tree;
+    state.SetComplexityN(state.range(0));
+}
+
+static void sortKDTreeCompact_Contains(benchmark::State &state) {
+    int size = state.range(0);
+    SortKDTree *tree = buildSortKDTreeCompactRandom(size);
+    std::vector<Point> points = generatePoints(size, UNIFORM);
     std::vector<Point> searchPoints;
     int step = size / 100;
     for (int i = 0; i < state.range(0); i += step) {
@@ -375,7 +1091,7 @@ static void sortKDTree_Contains(benchmark::State &state) {
 
 static void naive_Contains(benchmark::State &state) {
     int size = state.range(0);
-    std::vector<Point> points = getRandomPoints(size);
+    std::vector<Point> points = generatePoints(size, UNIFORM);
     std::vector<Point> searchPoints;
     int step = size / 100;
     for (int i = 0; i < state.range(0); i += step) {
@@ -390,9 +1106,9 @@ static void naive_Contains(benchmark::State &state) {
     state.SetComplexityN(state.range(0));
 }
 
-static void sortKDTree_NNS(benchmark::State &state) {
+static void sortKDTreeCompact_NNS(benchmark::State &state) {
     int size = state.range(0);
-    SortKDTree *tree = buildSortKDTreeRandom(size);
+    SortKDTree *tree = buildSortKDTreeCompactRandom(size);
     Point queryPoint{0.35 * size, 0.75 * size};
 
     for ([[maybe_unused]] auto _: state) {
@@ -403,9 +1119,9 @@ static void sortKDTree_NNS(benchmark::State &state) {
     state.SetComplexityN(state.range(0));
 }
 
-static void eKDTree_NNS(benchmark::State &state) {
+static void sortKDTree_NNS(benchmark::State &state) {
     int size = state.range(0);
-    KDTreeEfficient *tree = buildEKD_Random(size);
+    SortKDTree *tree = buildSortKDTreeRandom(size);
     Point queryPoint{0.35 * size, 0.75 * size};
 
     for ([[maybe_unused]] auto _: state) {
@@ -416,9 +1132,9 @@ static void eKDTree_NNS(benchmark::State &state) {
     state.SetComplexityN(state.range(0));
 }
 
-static void KDBTree_NNS(benchmark::State &state) {
+static void eKDTree_NNS(benchmark::State &state) {
     int size = state.range(0);
-    KDBTreeEfficient *tree = buildKDB_Random(size);
+    KDTreeEfficient *tree = buildEKD_Random(size);
     Point queryPoint{0.35 * size, 0.75 * size};
 
     for ([[maybe_unused]] auto _: state) {
@@ -429,9 +1145,9 @@ static void KDBTree_NNS(benchmark::State &state) {
     state.SetComplexityN(state.range(0));
 }
 
-static void quadTree_NNS(benchmark::State &state) {
+static void dynamicKDBTree_NNS(benchmark::State &state) {
     int size = state.range(0);
-    QuadTree *tree = buildQuadTreeRandom(size);
+    DynamicKDBTree *tree = buildDynamicKDBTreeRandom(size);
     Point queryPoint{0.35 * size, 0.75 * size};
 
     for ([[maybe_unused]] auto _: state) {
@@ -442,9 +1158,9 @@ static void quadTree_NNS(benchmark::State &state) {
     state.SetComplexityN(state.range(0));
 }
 
-static void pr_quadTree_NNS(benchmark::State &state) {
+static void KDBTree_NNS(benchmark::State &state) {
     int size = state.range(0);
-    PointRegionQuadTree *tree = buildPRQuadTreeRandom(size);
+    KDBTreeEfficient *tree = buildKDB_Random(size);
     Point queryPoint{0.35 * size, 0.75 * size};
 
     for ([[maybe_unused]] auto _: state) {
@@ -455,336 +1171,2077 @@ static void pr_quadTree_NNS(benchmark::State &state) {
     state.SetComplexityN(state.range(0));
 }
 
-static void naive_NNS(benchmark::State &state) {
+// point distributions of Workload.h, the second argument is a PointDistribution
+template<typename Tree>
+static void buildWorkload(benchmark::State &state) {
     int size = state.range(0);
-    std::vector<Point> points = getRandomPoints(size);
-    Point queryPoint{0.35 * size, 0.75 * size};
-
+    auto distribution = (PointDistribution) state.range(1);
+    Area area = workloadArea(size, distribution);
+    vector<Point> points = generatePoints(size, distribution);
     for ([[maybe_unused]] auto _: state) {
-        benchmark::DoNotOptimize(points);
-        naive_kNNS(queryPoint, points, 10);
+        Tree *tree = buildTreeOnPoints<Tree>(points, area);
+        benchmark::DoNotOptimize(tree);
+        destroyTree(tree);
     }
-    state.SetComplexityN(state.range(0));
+    state.SetLabel(distributionName(distribution));
 }
 
-static void sortKDTree_kNNS(benchmark::State &state) {
-    int k = state.range(0);
-    int n = 10'000'000;
-    SortKDTree *tree = buildSortKDTreeRandom(n);
-    Point queryPoint{0.35 * n, 0.75 * n};
+template<typename Tree>
+static void queryWorkload(benchmark::State &state) {
+    int size = state.range(0);
+    auto distribution = (PointDistribution) state.range(1);
+    Area area = workloadArea(size, distribution);
+    vector<Point> points = generatePoints(size, distribution);
+    Tree *tree = buildTreeOnPoints<Tree>(points, area);
+    vector<Area> queryAreas = generateQueryAreas(points, area, 100, 0.001);
+    vector<Point> result;
+    for ([[maybe_unused]] auto _: state) {
+        for (auto &queryArea: queryAreas) {
+            result.clear();
+            tree->query(queryArea, result);
+            benchmark::DoNotOptimize(result.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t) queryAreas.size());
+    state.SetLabel(distributionName(distribution));
+    destroyTree(tree);
+}
 
+template<typename Tree>
+static void containsWorkload(benchmark::State &state) {
+    int size = state.range(0);
+    auto distribution = (PointDistribution) state.range(1);
+    Area area = workloadArea(size, distribution);
+    vector<Point> points = generatePoints(size, distribution);
+    Tree *tree = buildTreeOnPoints<Tree>(points, area);
+    vector<Point> searchPoints = generateQueryPoints(points, 1000);
     for ([[maybe_unused]] auto _: state) {
-        benchmark::DoNotOptimize(tree);
-        tree->kNearestNeighbors(queryPoint, k);
+        for (auto &searchPoint: searchPoints) {
+            benchmark::DoNotOptimize(tree->contains(searchPoint));
+        }
     }
-    delete tree;
-    state.SetComplexityN(state.range(0));
+    state.SetItemsProcessed(state.iterations() * (int64_t) searchPoints.size());
+    state.SetLabel(distributionName(distribution));
+    destroyTree(tree);
 }
 
-static void eKDTree_kNNS(benchmark::State &state) {
+template<typename Tree>
+static void kNNSWorkload(benchmark::State &state) {
+    int size = state.range(0);
+    auto distribution = (PointDistribution) state.range(1);
+    Area area = workloadArea(size, distribution);
+    vector<Point> points = generatePoints(size, distribution);
+    Tree *tree = buildTreeOnPoints<Tree>(points, area);
+    vector<Point> queryPoints = generateQueryPoints(points, 100);
+    KNNScratch scratch;
+    vector<Point> result;
+    for ([[maybe_unused]] auto _: state) {
+        for (auto &queryPoint: queryPoints) {
+            tree->kNearestNeighbors(queryPoint, 10, scratch, result);
+            benchmark::DoNotOptimize(result.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t) queryPoints.size());
+    state.SetLabel(distributionName(distribution));
+    destroyTree(tree);
+}
+
+// the second argument selects the tree (0) or its frozen copy (1), search points are points of the tree
+template<typename Tree>
+static void containsFrozen(benchmark::State &state) {
+    int size = state.range(0);
+    bool frozen = state.range(1);
+    Area area = workloadArea(size, UNIFORM);
+    vector<Point> points = generatePoints(size, UNIFORM);
+    Tree *tree = buildTreeOnPoints<Tree>(points, area);
+    vector<Point> searchPoints = generateQueryPoints(points, 1000);
+    if (frozen) {
+        FrozenKDTree frozenTree = tree->freeze();
+        for ([[maybe_unused]] auto _: state) {
+            for (auto &searchPoint: searchPoints) {
+                benchmark::DoNotOptimize(frozenTree.contains(searchPoint));
+            }
+        }
+    } else {
+        for ([[maybe_unused]] auto _: state) {
+            for (auto &searchPoint: searchPoints) {
+                benchmark::DoNotOptimize(tree->contains(searchPoint));
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t) searchPoints.size());
+    state.SetLabel(frozen ? "frozen" : "pointer");
+    destroyTree(tree);
+}
+
+// coordinate type T, the same uniform points rounded to T
+template<typename T>
+static void buildKDBTreeCoordinates(benchmark::State &state) {
+    int pointNumber = state.range(0);
+    vector<BasicPoint<T>> points = convertPoints<T>(generatePoints(pointNumber, UNIFORM));
+    BasicArea<T> area = convertArea<T>(workloadArea(pointNumber, UNIFORM));
+    vector<BasicPoint<T>> buildPoints(points.size());
+    for ([[maybe_unused]] auto _: state) {
+        state.PauseTiming();
+        std::copy(points.begin(), points.end(), buildPoints.begin());
+        state.ResumeTiming();
+        auto *kdbTree = new BasicKDBTreeEfficient<T>(buildPoints.data(), 0, area, 0, pointNumber - 1,
+                                                     defaultLeafCapacity(pointNumber));
+        kdbTree->buildTree();
+        benchmark::DoNotOptimize(kdbTree);
+        delete kdbTree;
+    }
+    state.counters["pointBytes"] = sizeof(BasicPoint<T>);
+}
+
+template<typename T>
+static void queryKDBTreeCoordinates(benchmark::State &state) {
+    int pointNumber = state.range(0);
+    vector<Point> generated = generatePoints(pointNumber, UNIFORM);
+    Area workArea = workloadArea(pointNumber, UNIFORM);
+    vector<BasicPoint<T>> points = convertPoints<T>(generated);
+    BasicArea<T> area = convertArea<T>(workArea);
+    BasicKDBTreeEfficient<T> kdbTree(points.data(), 0, area, 0, pointNumber - 1, defaultLeafCapacity(pointNumber));
+    kdbTree.buildTree();
+    vector<BasicArea<T>> queryAreas;
+    for (auto &queryArea: generateQueryAreas(generated, workArea, 100, 0.001)) {
+        queryAreas.push_back(convertArea<T>(queryArea));
+    }
+    vector<BasicPoint<T>> result;
+    for ([[maybe_unused]] auto _: state) {
+        for (auto &queryArea: queryAreas) {
+            result.clear();
+            kdbTree.query(queryArea, result);
+            benchmark::DoNotOptimize(result.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t) queryAreas.size());
+    state.counters["pointBytes"] = sizeof(BasicPoint<T>);
+}
+
+template<typename T>
+static void containsKDBTreeCoordinates(benchmark::State &state) {
+    int pointNumber = state.range(0);
+    vector<Point> generated = generatePoints(pointNumber, UNIFORM);
+    vector<BasicPoint<T>> points = convertPoints<T>(generated);
+    BasicArea<T> area = convertArea<T>(workloadArea(pointNumber, UNIFORM));
+    vector<BasicPoint<T>> searchPoints = convertPoints<T>(generateQueryPoints(generated, 1000));
+    BasicKDBTreeEfficient<T> kdbTree(points.data(), 0, area, 0, pointNumber - 1, defaultLeafCapacity(pointNumber));
+    kdbTree.buildTree();
+    for ([[maybe_unused]] auto _: state) {
+        for (auto &searchPoint: searchPoints) {
+            benchmark::DoNotOptimize(kdbTree.contains(searchPoint));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t) searchPoints.size());
+    state.counters["pointBytes"] = sizeof(BasicPoint<T>);
+}
+
+template<typename T>
+static void kNNSKDBTreeCoordinates(benchmark::State &state) {
+    int pointNumber = state.range(0);
+    vector<Point> generated = generatePoints(pointNumber, UNIFORM);
+    vector<BasicPoint<T>> points = convertPoints<T>(generated);
+    BasicArea<T> area = convertArea<T>(workloadArea(pointNumber, UNIFORM));
+    vector<BasicPoint<T>> queryPoints = convertPoints<T>(generateQueryPoints(generated, 100));
+    BasicKDBTreeEfficient<T> kdbTree(points.data(), 0, area, 0, pointNumber - 1, defaultLeafCapacity(pointNumber));
+    kdbTree.buildTree();
+    BasicKNNScratch<T> scratch;
+    vector<BasicPoint<T>> result;
+    for ([[maybe_unused]] auto _: state) {
+        for (auto &queryPoint: queryPoints) {
+            kdbTree.kNearestNeighbors(queryPoint, 10, scratch, result);
+            benchmark::DoNotOptimize(result.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t) queryPoints.size());
+    state.counters["pointBytes"] = sizeof(BasicPoint<T>);
+}
+
+template<typename T>
+static void buildQuadTreeCoordinates(benchmark::State &state) {
+    int pointNumber = state.range(0);
+    vector<BasicPoint<T>> points = convertPoints<T>(generatePoints(pointNumber, UNIFORM));
+    BasicArea<T> area = convertArea<T>(workloadArea(pointNumber, UNIFORM));
+    for ([[maybe_unused]] auto _: state) {
+        auto *quadTree = new BasicQuadTree<T>(area, points);
+        quadTree->buildTree();
+        benchmark::DoNotOptimize(quadTree);
+        delete quadTree;
+    }
+    state.counters["pointBytes"] = sizeof(BasicPoint<T>);
+}
+
+template<typename T>
+static void queryQuadTreeCoordinates(benchmark::State &state) {
+    int pointNumber = state.range(0);
+    vector<Point> generated = generatePoints(pointNumber, UNIFORM);
+    Area workArea = workloadArea(pointNumber, UNIFORM);
+    vector<BasicPoint<T>> points = convertPoints<T>(generated);
+    BasicQuadTree<T> quadTree(convertArea<T>(workArea), points);
+    quadTree.buildTree();
+    vector<BasicArea<T>> queryAreas;
+    for (auto &queryArea: generateQueryAreas(generated, workArea, 100, 0.001)) {
+        queryAreas.push_back(convertArea<T>(queryArea));
+    }
+    vector<BasicPoint<T>> result;
+    for ([[maybe_unused]] auto _: state) {
+        for (auto &queryArea: queryAreas) {
+            result.clear();
+            quadTree.query(queryArea, result);
+            benchmark::DoNotOptimize(result.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t) queryAreas.size());
+    state.counters["pointBytes"] = sizeof(BasicPoint<T>);
+}
+
+template<typename T>
+static void kNNQuadTreeCoordinates(benchmark::State &state) {
+    int pointNumber = state.range(0);
+    vector<Point> generated = generatePoints(pointNumber, UNIFORM);
+    vector<BasicPoint<T>> points = convertPoints<T>(generated);
+    BasicQuadTree<T> quadTree(convertArea<T>(workloadArea(pointNumber, UNIFORM)), points);
+    quadTree.buildTree();
+    vector<BasicPoint<T>> queryPoints = convertPoints<T>(generateQueryPoints(generated, 100));
+    BasicKNNScratch<T> scratch;
+    vector<BasicPoint<T>> result;
+    for ([[maybe_unused]] auto _: state) {
+        for (auto &queryPoint: queryPoints) {
+            quadTree.kNearestNeighbors(queryPoint, 10, scratch, result);
+            benchmark::DoNotOptimize(result.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t) queryPoints.size());
+    state.counters["pointBytes"] = sizeof(BasicPoint<T>);
+}
+
+/**
+ * @brief Builds a KDBTreeND on points or an OrthTree on a copy of points, leaves hold capacity points
+ */
+template<typename Tree>
+static Tree *buildTreeND(vector<typename Tree::PointType> &points, typename Tree::BoxType &box, int capacity) {
+    Tree *tree;
+    if constexpr (std::is_same_v<Tree, KDBTreeND<Tree::dimension>>) {
+        tree = new Tree(points.data(), 0, box, 0, (int) points.size() - 1, capacity);
+    } else {
+        tree = new Tree(box, points, capacity);
+    }
+    tree->buildTree();
+    return tree;
+}
+
+// dimension D of the tree, the second argument is the distribution of every pair of axes
+template<typename Tree>
+static void buildDimension(benchmark::State &state) {
+    constexpr int D = Tree::dimension;
+    int pointNumber = state.range(0);
+    auto distribution = (PointDistribution) state.range(1);
+    vector<PointND<D>> points = generatePointsND<D>(pointNumber, distribution);
+    BoxND<D> box = workloadBoxND<D>(pointNumber, distribution);
+    vector<PointND<D>> buildPoints(points.size());
+    for ([[maybe_unused]] auto _: state) {
+        state.PauseTiming();
+        std::copy(points.begin(), points.end(), buildPoints.begin());
+        state.ResumeTiming();
+        Tree *tree = buildTreeND<Tree>(buildPoints, box, defaultLeafCapacity(pointNumber));
+        benchmark::DoNotOptimize(tree);
+        delete tree;
+    }
+    state.SetLabel(distributionName(distribution));
+}
+
+template<typename Tree>
+static void queryDimension(benchmark::State &state) {
+    constexpr int D = Tree::dimension;
+    int pointNumber = state.range(0);
+    auto distribution = (PointDistribution) state.range(1);
+    vector<PointND<D>> points = generatePointsND<D>(pointNumber, distribution);
+    BoxND<D> box = workloadBoxND<D>(pointNumber, distribution);
+    vector<BoxND<D>> queryBoxes = generateQueryBoxesND<D>(points, box, 100, 0.001);
+    Tree *tree = buildTreeND<Tree>(points, box, defaultLeafCapacity(pointNumber));
+    vector<PointND<D>> result;
+    for ([[maybe_unused]] auto _: state) {
+        for (auto &queryBox: queryBoxes) {
+            result.clear();
+            tree->query(queryBox, result);
+            benchmark::DoNotOptimize(result.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t) queryBoxes.size());
+    state.SetLabel(distributionName(distribution));
+    delete tree;
+}
+
+template<typename Tree>
+static void containsDimension(benchmark::State &state) {
+    constexpr int D = Tree::dimension;
+    int pointNumber = state.range(0);
+    auto distribution = (PointDistribution) state.range(1);
+    vector<PointND<D>> points = generatePointsND<D>(pointNumber, distribution);
+    BoxND<D> box = workloadBoxND<D>(pointNumber, distribution);
+    vector<PointND<D>> searchPoints = generateQueryPointsND<D>(points, 1000);
+    Tree *tree = buildTreeND<Tree>(points, box, defaultLeafCapacity(pointNumber));
+    for ([[maybe_unused]] auto _: state) {
+        for (auto &searchPoint: searchPoints) {
+            benchmark::DoNotOptimize(tree->contains(searchPoint));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t) searchPoints.size());
+    state.SetLabel(distributionName(distribution));
+    delete tree;
+}
+
+template<typename Tree>
+static void kNNSDimension(benchmark::State &state) {
+    constexpr int D = Tree::dimension;
+    int pointNumber = state.range(0);
+    auto distribution = (PointDistribution) state.range(1);
+    vector<PointND<D>> points = generatePointsND<D>(pointNumber, distribution);
+    BoxND<D> box = workloadBoxND<D>(pointNumber, distribution);
+    vector<PointND<D>> queryPoints = generateQueryPointsND<D>(points, 100);
+    Tree *tree = buildTreeND<Tree>(points, box, defaultLeafCapacity(pointNumber));
+    typename Tree::Scratch scratch;
+    vector<PointND<D>> result;
+    for ([[maybe_unused]] auto _: state) {
+        for (auto &queryPoint: queryPoints) {
+            tree->kNearestNeighbors(queryPoint, 10, scratch, result);
+            benchmark::DoNotOptimize(result.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t) queryPoints.size());
+    state.counters["visits"] = (double) scratch.getVisitedNodes();
+    state.SetLabel(distributionName(distribution));
+    delete tree;
+}
+
+/**
+ * @brief Writes uniform points to a file in the temporary directory unless it exists
+ * @param pointNumber number of points
+ * @param binary True for a binary point file, false for a text file like random_points.txt
+ * @return path of the file
+ */
+static string pointFile(int pointNumber, bool binary) {
+    auto path = std::filesystem::temp_directory_path()
+                / ("quadkd-points-" + to_string(pointNumber) + (binary ? ".bin" : ".txt"));
+    if (!std::filesystem::exists(path)) {
+        vector<Point> points = generatePoints(pointNumber, UNIFORM);
+        if (binary) {
+            savePointsBinary(path, points.data(), pointNumber);
+        } else {
+            ofstream file(path);
+            file << setprecision(17);
+            for (auto &p: points) {
+                file << p.x << "," << p.y << "\n";
+            }
+        }
+    }
+    return path;
+}
+
+// the second argument is the number of parsing threads
+static void loadPointsFromText(benchmark::State &state) {
+    int pointNumber = state.range(0);
+    string path = pointFile(pointNumber, false);
+    for ([[maybe_unused]] auto _: state) {
+        vector<Point> points = loadPointsText(path, (int) state.range(1));
+        benchmark::DoNotOptimize(points.data());
+    }
+    state.SetItemsProcessed(state.iterations() * pointNumber);
+    state.SetBytesProcessed(state.iterations() * (int64_t) std::filesystem::file_size(path));
+}
+
+// ingest and build, the second argument selects the text file (0) or the mapped binary file (1)
+static void ingestKDBTree(benchmark::State &state) {
+    int pointNumber = state.range(0);
+    bool binary = state.range(1);
+    string path = pointFile(pointNumber, binary);
+    for ([[maybe_unused]] auto _: state) {
+        if (binary) {
+            MappedPointFile file(path);
+            Area area = file.bounds();
+            auto *kdbTree = new KDBTreeEfficient(file.data(), 0, area, 0, (int) file.size() - 1,
+                                                 defaultLeafCapacity(file.size()));
+            kdbTree->buildTree();
+            benchmark::DoNotOptimize(kdbTree);
+            delete kdbTree;
+        } else {
+            vector<Point> points = loadPointsText(path);
+            Area area = boundingBox(points.data(), points.data() + points.size());
+            KDBTreeEfficient *kdbTree = buildTreeOnPoints<KDBTreeEfficient>(points, area);
+            benchmark::DoNotOptimize(kdbTree);
+            destroyTree(kdbTree);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * pointNumber);
+    state.SetLabel(binary ? "mapped binary" : "text");
+}
+
+// clustered data, the second argument enables tightenAreas(), "visits" is the number of nodes per query
+static void queryClusteredKDETree(benchmark::State &state) {
+    int size = state.range(0);
+    Area area = workloadArea(size, CLUSTERED);
+    vector<Point> points = generatePoints(size, CLUSTERED);
+    auto *pointArray = (Point *) malloc(size * sizeof(Point));
+    copy(points.begin(), points.end(), pointArray);
+    auto *kdTreeEfficient = new KDTreeEfficient(pointArray, area, size);
+    kdTreeEfficient->buildTree();
+    if (state.range(1) != 0) {
+        kdTreeEfficient->tightenAreas();
+    }
+    vector<Area> queryAreas = generateQueryAreas(points, area, 100, 0.0004);
+    vector<Point> result;
+    long visits = 0;
+    for (auto &queryArea: queryAreas) {
+        visits += kdTreeEfficient->queryVisits(queryArea);
+    }
+    for ([[maybe_unused]] auto _: state) {
+        for (auto &queryArea: queryAreas) {
+            result.clear();
+            kdTreeEfficient->query(queryArea, result);
+            benchmark::DoNotOptimize(result.data());
+        }
+    }
+    state.counters["visits"] = (double) visits / (double) queryAreas.size();
+    delete kdTreeEfficient;
+    free(pointArray);
+}
+
+static void queryClusteredKDBTree(benchmark::State &state) {
+    int size = state.range(0);
+    Area area = workloadArea(size, CLUSTERED);
+    vector<Point> points = generatePoints(size, CLUSTERED);
+    auto *pointArray = (Point *) malloc(size * sizeof(Point));
+    copy(points.begin(), points.end(), pointArray);
+    auto *kdbTreeEfficient = new KDBTreeEfficient(pointArray, 0, area, 0, size - 1, defaultLeafCapacity(size));
+    kdbTreeEfficient->buildTree();
+    if (state.range(1) != 0) {
+        kdbTreeEfficient->tightenAreas();
+    }
+    vector<Area> queryAreas = generateQueryAreas(points, area, 100, 0.0004);
+    vector<Point> result;
+    long visits = 0;
+    for (auto &queryArea: queryAreas) {
+        visits += kdbTreeEfficient->queryVisits(queryArea);
+    }
+    for ([[maybe_unused]] auto _: state) {
+        for (auto &queryArea: queryAreas) {
+            result.clear();
+            kdbTreeEfficient->query(queryArea, result);
+            benchmark::DoNotOptimize(result.data());
+        }
+    }
+    state.counters["visits"] = (double) visits / (double) queryAreas.size();
+    delete kdbTreeEfficient;
+    free(pointArray);
+}
+
+static void queryClusteredSKDTree(benchmark::State &state) {
+    int size = state.range(0);
+    Area area = workloadArea(size, CLUSTERED);
+    vector<Point> points = generatePoints(size, CLUSTERED);
+    auto *sortKDTree = new SortKDTree(points, area);
+    sortKDTree->buildTreePresorted();
+    if (state.range(1) != 0) {
+        sortKDTree->tightenAreas();
+    }
+    vector<Area> queryAreas = generateQueryAreas(points, area, 100, 0.0004);
+    vector<Point> result;
+    long visits = 0;
+    for (auto &queryArea: queryAreas) {
+        visits += sortKDTree->queryVisits(queryArea);
+    }
+    for ([[maybe_unused]] auto _: state) {
+        for (auto &queryArea: queryAreas) {
+            result.clear();
+            sortKDTree->query(queryArea, result);
+            benchmark::DoNotOptimize(result.data());
+        }
+    }
+    state.counters["visits"] = (double) visits / (double) queryAreas.size();
+    delete sortKDTree;
+}
+
+// kNN on clustered data with uniform query points, most of them lie in empty space between the clusters
+static void clusteredKDETree_NNS(benchmark::State &state) {
+    int size = state.range(0);
+    Area area = workloadArea(size, CLUSTERED);
+    vector<Point> points = generatePoints(size, CLUSTERED);
+    auto *pointArray = (Point *) malloc(size * sizeof(Point));
+    copy(points.begin(), points.end(), pointArray);
+    auto *kdTreeEfficient = new KDTreeEfficient(pointArray, area, size);
+    kdTreeEfficient->buildTree();
+    if (state.range(1) != 0) {
+        kdTreeEfficient->tightenAreas();
+    }
+    vector<Point> queryPoints = generateQueryPoints(area, 100);
+    KNNScratch scratch;
+    vector<Point> result;
+    long visits = 0;
+    for ([[maybe_unused]] auto _: state) {
+        for (auto &queryPoint: queryPoints) {
+            kdTreeEfficient->kNearestNeighbors(queryPoint, 10, scratch, result);
+            visits += scratch.getVisitedNodes();
+            benchmark::DoNotOptimize(result.data());
+        }
+    }
+    state.counters["visits"] = (double) visits / (double) (state.iterations() * queryPoints.size());
+    delete kdTreeEfficient;
+    free(pointArray);
+}
+
+static void clusteredKDBTree_NNS(benchmark::State &state) {
+    int size = state.range(0);
+    Area area = workloadArea(size, CLUSTERED);
+    vector<Point> points = generatePoints(size, CLUSTERED);
+    auto *pointArray = (Point *) malloc(size * sizeof(Point));
+    copy(points.begin(), points.end(), pointArray);
+    auto *kdbTreeEfficient = new KDBTreeEfficient(pointArray, 0, area, 0, size - 1, defaultLeafCapacity(size));
+    kdbTreeEfficient->buildTree();
+    if (state.range(1) != 0) {
+        kdbTreeEfficient->tightenAreas();
+    }
+    vector<Point> queryPoints = generateQueryPoints(area, 100);
+    KNNScratch scratch;
+    vector<Point> result;
+    long visits = 0;
+    for ([[maybe_unused]] auto _: state) {
+        for (auto &queryPoint: queryPoints) {
+            kdbTreeEfficient->kNearestNeighbors(queryPoint, 10, scratch, result);
+            visits += scratch.getVisitedNodes();
+            benchmark::DoNotOptimize(result.data());
+        }
+    }
+    state.counters["visits"] = (double) visits / (double) (state.iterations() * queryPoints.size());
+    delete kdbTreeEfficient;
+    free(pointArray);
+}
+
+static void clusteredSKDTree_NNS(benchmark::State &state) {
+    int size = state.range(0);
+    Area area = workloadArea(size, CLUSTERED);
+    vector<Point> points = generatePoints(size, CLUSTERED);
+    auto *sortKDTree = new SortKDTree(points, area);
+    sortKDTree->buildTreePresorted();
+    if (state.range(1) != 0) {
+        sortKDTree->tightenAreas();
+    }
+    vector<Point> queryPoints = generateQueryPoints(area, 100);
+    KNNScratch scratch;
+    vector<Point> result;
+    long visits = 0;
+    for ([[maybe_unused]] auto _: state) {
+        for (auto &queryPoint: queryPoints) {
+            sortKDTree->kNearestNeighbors(queryPoint, 10, scratch, result);
+            visits += scratch.getVisitedNodes();
+            benchmark::DoNotOptimize(result.data());
+        }
+    }
+    state.counters["visits"] = (double) visits / (double) (state.iterations() * queryPoints.size());
+    delete sortKDTree;
+}
+
+static void KDBTree_kNNS_Threads(benchmark::State &state) {
+    int size = state.range(0);
+    int threadCount = state.range(1);
+    int queriesPerThread = 1000;
+    KDBTreeEfficient *tree = buildKDB_Random(size);
+    Area area{0, (double) size, 0, (double) size};
+    vector<Point> queryPoints = generateQueryPoints(area, queriesPerThread * threadCount);
+    for ([[maybe_unused]] auto _: state) {
+        // the tree is shared, every thread has its own candidate heap
+        vector<thread> readers;
+        for (int t = 0; t < threadCount; t++) {
+            readers.emplace_back([&, t] {
+                KNNScratch scratch;
+                vector<Point> result;
+                for (int i = t * queriesPerThread; i < (t + 1) * queriesPerThread; i++) {
+                    tree->kNearestNeighbors(queryPoints[i], 10, scratch, result);
+                    benchmark::DoNotOptimize(result.data());
+                }
+            });
+        }
+        for (auto &reader: readers) {
+            reader.join();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * queriesPerThread * threadCount);
+    delete tree;
+}
+
+static void pr_quadTree_kNNS_Threads(benchmark::State &state) {
+    int size = state.range(0);
+    int threadCount = state.range(1);
+    int queriesPerThread = 1000;
+    PointRegionQuadTree *tree = buildPRQuadTreeRandom(size);
+    Area area{0, (double) size, 0, (double) size};
+    vector<Point> queryPoints = generateQueryPoints(area, queriesPerThread * threadCount);
+    for ([[maybe_unused]] auto _: state) {
+        vector<thread> readers;
+        for (int t = 0; t < threadCount; t++) {
+            readers.emplace_back([&, t] {
+                KNNScratch scratch;
+                vector<Point> result;
+                for (int i = t * queriesPerThread; i < (t + 1) * queriesPerThread; i++) {
+                    tree->kNearestNeighbors(queryPoints[i], 10, scratch, result);
+                    benchmark::DoNotOptimize(result.data());
+                }
+            });
+        }
+        for (auto &reader: readers) {
+            reader.join();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * queriesPerThread * threadCount);
+    delete tree;
+}
+
+static void quadTree_NNS(benchmark::State &state) {
+    int size = state.range(0);
+    QuadTree *tree = buildQuadTreeRandom(size);
+    Point queryPoint{0.35 * size, 0.75 * size};
+
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(tree);
+        tree->kNearestNeighbors(queryPoint, 10);
+    }
+    delete tree;
+    state.SetComplexityN(state.range(0));
+}
+
+static void linearQuadTree_NNS(benchmark::State &state) {
+    int size = state.range(0);
+    LinearQuadTree *tree = buildLinearQuadTreeRandom(size);
+    Point queryPoint{0.35 * size, 0.75 * size};
+
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(tree);
+        tree->kNearestNeighbors(queryPoint, 10);
+    }
+    delete tree;
+    state.SetComplexityN(state.range(0));
+}
+
+static void pr_quadTree_NNS(benchmark::State &state) {
+    int size = state.range(0);
+    PointRegionQuadTree *tree = buildPRQuadTreeRandom(size);
+    Point queryPoint{0.35 * size, 0.75 * size};
+
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(tree);
+        tree->kNearestNeighbors(queryPoint, 10);
+    }
+    delete tree;
+    state.SetComplexityN(state.range(0));
+}
+
+static void naive_NNS(benchmark::State &state) {
+    int size = state.range(0);
+    std::vector<Point> points = generatePoints(size, UNIFORM);
+    Point queryPoint{0.35 * size, 0.75 * size};
+
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(points);
+        naive_kNNS(queryPoint, points, 10);
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void sortKDTree_kNNS(benchmark::State &state) {
+    int k = state.range(0);
+    int n = 10'000'000;
+    SortKDTree *tree = buildSortKDTreeRandom(n);
+    Point queryPoint{0.35 * n, 0.75 * n};
+    KNNScratch scratch;
+    vector<Point> result;
+
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(tree);
+        tree->kNearestNeighbors(queryPoint, k, scratch, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    delete tree;
+    state.SetComplexityN(state.range(0));
+}
+
+static void eKDTree_kNNS(benchmark::State &state) {
     int k = state.range(0);
     int n = 10'000'000;
     KDTreeEfficient *tree = buildEKD_Random(n);
     Point queryPoint{0.35 * n, 0.75 * n};
+    KNNScratch scratch;
+    vector<Point> result;
+
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(tree);
+        tree->kNearestNeighbors(queryPoint, k, scratch, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    delete tree;
+    state.SetComplexityN(state.range(0));
+}
+
+static void KDBTree_kNNS(benchmark::State &state) {
+    int k = state.range(0);
+    int n = 10'000'000;
+    KDBTreeEfficient *tree = buildKDB_Random(n);
+    Point queryPoint{0.35 * n, 0.75 * n};
+    KNNScratch scratch;
+    vector<Point> result;
+
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(tree);
+        tree->kNearestNeighbors(queryPoint, k, scratch, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    delete tree;
+    state.SetComplexityN(state.range(0));
+}
+
+static void quadTree_kNNS(benchmark::State &state) {
+    int k = state.range(0);
+    int n = 10'000'000;
+    QuadTree *tree = buildQuadTreeRandom(n);
+    Point queryPoint{0.35 * n, 0.75 * n};
+    KNNScratch scratch;
+    vector<Point> result;
+
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(tree);
+        tree->kNearestNeighbors(queryPoint, k, scratch, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    delete tree;
+    state.SetComplexityN(state.range(0));
+}
+
+static void linearQuadTree_kNNS(benchmark::State &state) {
+    int k = state.range(0);
+    int n = 10'000'000;
+    LinearQuadTree *tree = buildLinearQuadTreeRandom(n);
+    Point queryPoint{0.35 * n, 0.75 * n};
+    KNNScratch scratch;
+    vector<Point> result;
+
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(tree);
+        tree->kNearestNeighbors(queryPoint, k, scratch, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    delete tree;
+    state.SetComplexityN(state.range(0));
+}
+
+static void pr_quadTree_kNNS(benchmark::State &state) {
+    int k = state.range(0);
+    int n = 10'000'000;
+
+    PointRegionQuadTree *tree = buildPRQuadTreeRandom(n);
+    Point queryPoint{0.35 * n, 0.75 * n};
+    KNNScratch scratch;
+    vector<Point> result;
+
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(tree);
+        tree->kNearestNeighbors(queryPoint, k, scratch, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    delete tree;
+    state.SetComplexityN(state.range(0));
+}
+
+static void naive_kNNS(benchmark::State &state) {
+    int k = state.range(0);
+    int n = 10'000'000;
+    std::vector<Point> points = generatePoints(n, UNIFORM);
+    Point queryPoint{0.35 * n, 0.75 * n};
+
+    for ([[maybe_unused]] auto _: state) {
+        benchmark::DoNotOptimize(points);
+        benchmark::DoNotOptimize(naive_kNNS(queryPoint, points, k));
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+// BUILD
+BENCHMARK(buildQuadTree)
+        ->Name("Build Quadtree")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oNLogN)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildQuadTreeEfficient)
+        ->Name("Build Quadtree-Efficient")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oNLogN)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildLinearQuadTree)
+        ->Name("Build Linear-Quadtree")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oNLogN)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildCompressedQuadTree)
+        ->Name("Build Compressed-Quadtree")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oNLogN)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildCompressedQuadTree_Duplicates)
+        ->Name("Build Compressed-Quadtree - Duplicates")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oNLogN)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildPRQuadTree)
+        ->Name("Build PR-Quadtree")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oNLogN)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildSKDTree)
+        ->Name("Build SortKDTree")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oNLogN)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildSKDTreePresorted)
+        ->Name("Build SortKDTree - Presorted")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oNLogN)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildKDETree)
+        ->Name("Build KD-Tree-Efficient")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oNLogN)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildKDBTree)
+        ->Name("Build KDB-Tree-Efficient")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oNLogN)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildQuadTreeArena)
+        ->Name("Build Quadtree - Arena")
+        ->ArgNames({"n", "hugePages"})
+        ->RangeMultiplier(2)
+        ->Ranges({{START, END}, {0, 1}})
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildPRQuadTreeArena)
+        ->Name("Build PR-Quadtree - Arena")
+        ->ArgNames({"n", "hugePages"})
+        ->RangeMultiplier(2)
+        ->Ranges({{START, END}, {0, 1}})
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildSKDTreeArena)
+        ->Name("Build SortKDTree - Arena")
+        ->ArgNames({"n", "hugePages"})
+        ->RangeMultiplier(2)
+        ->Ranges({{START, END}, {0, 1}})
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildKDETreeArena)
+        ->Name("Build KD-Tree-Efficient - Arena")
+        ->ArgNames({"n", "hugePages"})
+        ->RangeMultiplier(2)
+        ->Ranges({{START, END}, {0, 1}})
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildKDBTreeArena)
+        ->Name("Build KDB-Tree-Efficient - Arena")
+        ->ArgNames({"n", "hugePages"})
+        ->RangeMultiplier(2)
+        ->Ranges({{START, END}, {0, 1}})
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildQuadTreeParallel)
+        ->Name("Build Quadtree - Parallel")
+        ->RangeMultiplier(2)
+        ->Ranges({{START, END}, {1, 32}})
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime()
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildKDETreeParallel)
+        ->Name("Build KD-Tree-Efficient - Parallel")
+        ->RangeMultiplier(2)
+        ->Ranges({{START, END}, {1, 32}})
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime()
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildKDBTreeParallel)
+        ->Name("Build KDB-Tree-Efficient - Parallel")
+        ->RangeMultiplier(2)
+        ->Ranges({{START, END}, {1, 32}})
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime()
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildImplicitKDTree)
+        ->Name("Build Implicit-KD-Tree")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oNLogN)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildDenseQuadTree)
+        ->Name("Build Dense Quadtree")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oNLogN)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildDensePRQuadTree)
+        ->Name("Build Dense PR-Quadtree")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oNLogN)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildDensePRQuadTreeParallel)
+        ->Name("Build Dense PR-Quadtree - Parallel")
+        ->RangeMultiplier(2)
+        ->Ranges({{START, END}, {1, 32}})
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime()
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildDensesortKDTree)
+        ->Name("Build Dense SortKDTree")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oNLogN)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildDenseKDETree)
+        ->Name("Build Dense KD-Tree-Efficient")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oNLogN)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildDenseKDBTree)
+        ->Name("Build Dense KDB-Tree-Efficient")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oNLogN)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+// Build dynamically
+BENCHMARK(ingestDynamicKDBTree)
+        ->Name("Build Dynamic-KDB-dynamically")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Complexity(benchmark::oNLogN)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildKDTree_Dynamically)
+        ->Name("Build SortKDTree-dynamically")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Complexity(benchmark::oNLogN)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(buildQuadTree_Dynamically)
+        ->Name("Build Quadtree-dynamically")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Complexity(benchmark::oNLogN)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+// Concurrent insertion, items per second over thread counts
+BENCHMARK(ingestConcurrentPRQuadTree)
+        ->Name("Ingest Concurrent PR-Quadtree")
+        ->ArgNames({"n", "threads"})
+        ->RangeMultiplier(2)
+        ->Ranges({{1 << 16, 1 << 22}, {1, 32}})
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime()
+        ->Iterations(10);
+
+BENCHMARK(ingestMutexPRQuadTree)
+        ->Name("Ingest PR-Quadtree - Mutex")
+        ->ArgNames({"n", "threads"})
+        ->RangeMultiplier(2)
+        ->Ranges({{1 << 16, 1 << 22}, {1, 32}})
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime()
+        ->Iterations(10);
+
+// Sliding window of fixed size, items are replaced points per second
+BENCHMARK(churnPRQuadTree)
+        ->Name("Churn PR-Quadtree - Remove/Add")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(churnPRQuadTree_Rebuild)
+        ->Name("Churn PR-Quadtree - Rebuild")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(ITERATIONS);
+
+// Query
+BENCHMARK(queryQuadTree)
+        ->Name("Query Quadtree - Variable PointCount")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Unit(benchmark::kMicrosecond)
+        ->Complexity(benchmark::oAuto)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(queryQuadTreeEfficient)
+        ->Name("Query Quadtree-Efficient - Variable PointCount")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Unit(benchmark::kMicrosecond)
+        ->Complexity(benchmark::oAuto)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(queryLinearQuadTree)
+        ->Name("Query Linear-Quadtree - Variable PointCount")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Unit(benchmark::kMicrosecond)
+        ->Complexity(benchmark::oAuto)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(queryCompressedQuadTree)
+        ->Name("Query Compressed-Quadtree - Variable PointCount")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Unit(benchmark::kMicrosecond)
+        ->Complexity(benchmark::oAuto)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(queryPRQuadTree)
+        ->Name("Query PR-Quadtree - Variable PointCount")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Complexity(benchmark::oAuto)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(querysortKDTree)
+        ->Name("Query SortKDTree - Variable PointCount")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oAuto)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(querysortKDTreeCompact)
+        ->Name("Query SortKDTree-Compact - Variable PointCount")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oAuto)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(queryKDETree)
+        ->Name("Query KD-E - Variable PointCount")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Complexity(benchmark::oAuto)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(queryKDBTree)
+        ->Name("Query KDB-E - Variable PointCount")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Complexity(benchmark::oAuto)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(queryDynamicKDBTree)
+        ->Name("Query Dynamic-KDB - Variable PointCount")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Complexity(benchmark::oAuto)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(queryImplicitKDTree)
+        ->Name("Query Implicit-KD - Variable PointCount")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Complexity(benchmark::oAuto)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(queryPRQuadTree_Buffer)
+        ->Name("Query PR-Quadtree (reused buffer) - Variable PointCount")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Complexity(benchmark::oAuto)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(queryKDETree_Buffer)
+        ->Name("Query KD-E (reused buffer) - Variable PointCount")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Complexity(benchmark::oAuto)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(queryKDBTree_Buffer)
+        ->Name("Query KDB-E (reused buffer) - Variable PointCount")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Complexity(benchmark::oAuto)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(queryKDBTree_Columns)
+        ->Name("Query KDB-E (leaf columns) - Variable PointCount")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Complexity(benchmark::oAuto)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(queryDenseKDBTree_Leaves)
+        ->Name("Query Dense KDB-E - Leaf Scan")
+        ->ArgNames({"n", "capacity", "columns"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {4, 16, 32, 64, 128, 256}, {0, 1}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+// leaf capacity sweep, see CapacityTuner.h for tuning per workload and distribution
+BENCHMARK(queryKDBTree_Capacity)
+        ->Name("Query KDB-E - Capacity")
+        ->ArgNames({"n", "capacity"})
+        ->RangeMultiplier(2)
+        ->Ranges({{1 << 16, 1 << 22}, {4, 256}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(queryPRQuadTree_Capacity)
+        ->Name("Query PR-Quadtree - Capacity")
+        ->ArgNames({"n", "capacity"})
+        ->RangeMultiplier(2)
+        ->Ranges({{1 << 16, 1 << 22}, {4, 256}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(queryKDETree_Count)
+        ->Name("Query KD-E (callback) - Variable PointCount")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Complexity(benchmark::oAuto)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(queryNaive)->Name("Query Naive - Variable PointCount")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oAuto)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+// COUNT
+BENCHMARK(countPRQuadTree)
+        ->Name("Count PR-Quadtree - Variable PointCount")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Complexity(benchmark::oAuto)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(countKDETree)
+        ->Name("Count KD-E - Variable PointCount")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Complexity(benchmark::oAuto)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(countKDBTree)
+        ->Name("Count KDB-E - Variable PointCount")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Complexity(benchmark::oAuto)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(aggregateKDBTree)
+        ->Name("Aggregate KDB-E - Variable PointCount")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Complexity(benchmark::oAuto)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(countNaive)
+        ->Name("Count Naive (queryNaive) - Variable PointCount")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Complexity(benchmark::oAuto)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+// CONTAINS
+BENCHMARK(pr_quadTree_contains)
+        ->Name("PR-Quadtree - Contains")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oLogN)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(sortKDTree_Contains)
+        ->Name("SortKDTree - Contains")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oLogN)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(sortKDTreeCompact_Contains)
+        ->Name("SortKDTree-Compact - Contains")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oLogN)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(kDBTreeEfficient_Contains)
+        ->Name("KDB-tree - Contains")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oLogN)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(quadTree_contains)
+        ->Name("Quadtree - Contains")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oLogN)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(quadTreeEfficient_contains)
+        ->Name("Quadtree-Efficient - Contains")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oLogN)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(compressedQuadTree_contains)
+        ->Name("Compressed-Quadtree - Contains")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oLogN)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(linearQuadTree_contains)
+        ->Name("Linear-Quadtree - Contains")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oLogN)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(kDTreeEfficient_Contains)
+        ->Name("KD_Tree_Efficient - Contains")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oLogN)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(implicitKDTree_Contains)
+        ->Name("Implicit_KD_Tree - Contains")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oLogN)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(naive_Contains)->Name("Naive - Contains")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Complexity(benchmark::oN)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+
+// NNS - variable point count k = 10
+BENCHMARK(quadTree_NNS)
+        ->Name("Quadtree - NNS - var n")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Complexity(benchmark::oLogN)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(pr_quadTree_NNS)
+        ->Name("PR-Quadtree - NNS - var n")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Complexity(benchmark::oLogN)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(linearQuadTree_NNS)
+        ->Name("Linear-Quadtree - NNS - var n")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Complexity(benchmark::oLogN)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(sortKDTree_NNS)
+        ->Name("SortKDTree - NNS - var n")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oLogN)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(sortKDTreeCompact_NNS)
+        ->Name("SortKDTree-Compact - NNS - var n")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oLogN)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(eKDTree_NNS)
+        ->Name("KD_Tree_Efficient -- NNS - var n")
+        ->RangeMultiplier(2)->Range(START, END)
+        ->Complexity(benchmark::oLogN)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(dynamicKDBTree_NNS)
+        ->Name("Dynamic-KDB -- NNS - var n")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oLogN)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(KDBTree_NNS)
+        ->Name("KDB_Tree -- NNS - var n")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oLogN)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(naive_NNS)
+        ->Name("Naive - NNS - var n")
+        ->RangeMultiplier(2)
+        ->Range(START, END)
+        ->Complexity(benchmark::oN)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+// Frozen trees, contains() with Eytzinger keys against the pointer trees
+BENCHMARK_TEMPLATE(containsFrozen, KDTreeEfficient)
+        ->Name("Contains KD-E - Frozen")
+        ->ArgNames({"n", "frozen"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 24, END}, {0, 1}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK_TEMPLATE(containsFrozen, KDBTreeEfficient)
+        ->Name("Contains KDB-E - Frozen")
+        ->ArgNames({"n", "frozen"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 24, END}, {0, 1}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+// Coordinate types, double, float and int32_t points of the KDB-E and the Quadtree
+BENCHMARK_TEMPLATE(buildKDBTreeCoordinates, double)
+        ->Name("Build KDB-E - double coordinates")
+        ->RangeMultiplier(4)
+        ->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(10);
+
+BENCHMARK_TEMPLATE(buildKDBTreeCoordinates, float)
+        ->Name("Build KDB-E - float coordinates")
+        ->RangeMultiplier(4)
+        ->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(10);
+
+BENCHMARK_TEMPLATE(buildKDBTreeCoordinates, int32_t)
+        ->Name("Build KDB-E - int32 coordinates")
+        ->RangeMultiplier(4)
+        ->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(10);
+
+BENCHMARK_TEMPLATE(queryKDBTreeCoordinates, double)
+        ->Name("Query KDB-E - double coordinates")
+        ->RangeMultiplier(4)
+        ->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(queryKDBTreeCoordinates, float)
+        ->Name("Query KDB-E - float coordinates")
+        ->RangeMultiplier(4)
+        ->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(queryKDBTreeCoordinates, int32_t)
+        ->Name("Query KDB-E - int32 coordinates")
+        ->RangeMultiplier(4)
+        ->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(containsKDBTreeCoordinates, double)
+        ->Name("Contains KDB-E - double coordinates")
+        ->RangeMultiplier(4)
+        ->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(containsKDBTreeCoordinates, float)
+        ->Name("Contains KDB-E - float coordinates")
+        ->RangeMultiplier(4)
+        ->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(containsKDBTreeCoordinates, int32_t)
+        ->Name("Contains KDB-E - int32 coordinates")
+        ->RangeMultiplier(4)
+        ->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(kNNSKDBTreeCoordinates, double)
+        ->Name("kNNS KDB-E - double coordinates")
+        ->RangeMultiplier(4)
+        ->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(kNNSKDBTreeCoordinates, float)
+        ->Name("kNNS KDB-E - float coordinates")
+        ->RangeMultiplier(4)
+        ->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(kNNSKDBTreeCoordinates, int32_t)
+        ->Name("kNNS KDB-E - int32 coordinates")
+        ->RangeMultiplier(4)
+        ->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(buildQuadTreeCoordinates, double)
+        ->Name("Build Quadtree - double coordinates")
+        ->RangeMultiplier(4)
+        ->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(10);
+
+BENCHMARK_TEMPLATE(buildQuadTreeCoordinates, float)
+        ->Name("Build Quadtree - float coordinates")
+        ->RangeMultiplier(4)
+        ->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(10);
+
+BENCHMARK_TEMPLATE(buildQuadTreeCoordinates, int32_t)
+        ->Name("Build Quadtree - int32 coordinates")
+        ->RangeMultiplier(4)
+        ->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(10);
+
+BENCHMARK_TEMPLATE(queryQuadTreeCoordinates, double)
+        ->Name("Query Quadtree - double coordinates")
+        ->RangeMultiplier(4)
+        ->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(queryQuadTreeCoordinates, float)
+        ->Name("Query Quadtree - float coordinates")
+        ->RangeMultiplier(4)
+        ->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(queryQuadTreeCoordinates, int32_t)
+        ->Name("Query Quadtree - int32 coordinates")
+        ->RangeMultiplier(4)
+        ->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(kNNQuadTreeCoordinates, double)
+        ->Name("kNNS Quadtree - double coordinates")
+        ->RangeMultiplier(4)
+        ->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(kNNQuadTreeCoordinates, float)
+        ->Name("kNNS Quadtree - float coordinates")
+        ->RangeMultiplier(4)
+        ->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(kNNQuadTreeCoordinates, int32_t)
+        ->Name("kNNS Quadtree - int32 coordinates")
+        ->RangeMultiplier(4)
+        ->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+// Dimensions, KD-Trees against the 2^D-ary trees (Quadtree, octree, hextree) for D = 2, 3 and 4
+BENCHMARK_TEMPLATE(buildDimension, KDBTreeND<2>)
+        ->Name("Build KDB - 2D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(10);
+
+BENCHMARK_TEMPLATE(buildDimension, OrthTree<2>)
+        ->Name("Build Orth - 2D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(10);
+
+BENCHMARK_TEMPLATE(buildDimension, KDBTreeND<3>)
+        ->Name("Build KDB - 3D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(10);
+
+BENCHMARK_TEMPLATE(buildDimension, OrthTree<3>)
+        ->Name("Build Orth - 3D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(10);
+
+BENCHMARK_TEMPLATE(buildDimension, KDBTreeND<4>)
+        ->Name("Build KDB - 4D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(10);
+
+BENCHMARK_TEMPLATE(buildDimension, OrthTree<4>)
+        ->Name("Build Orth - 4D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(10);
+
+BENCHMARK_TEMPLATE(queryDimension, KDBTreeND<2>)
+        ->Name("Query KDB - 2D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(queryDimension, OrthTree<2>)
+        ->Name("Query Orth - 2D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(queryDimension, KDBTreeND<3>)
+        ->Name("Query KDB - 3D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(queryDimension, OrthTree<3>)
+        ->Name("Query Orth - 3D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(queryDimension, KDBTreeND<4>)
+        ->Name("Query KDB - 4D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(queryDimension, OrthTree<4>)
+        ->Name("Query Orth - 4D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(containsDimension, KDBTreeND<2>)
+        ->Name("Contains KDB - 2D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(containsDimension, OrthTree<2>)
+        ->Name("Contains Orth - 2D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(containsDimension, KDBTreeND<3>)
+        ->Name("Contains KDB - 3D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(containsDimension, OrthTree<3>)
+        ->Name("Contains Orth - 3D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(containsDimension, KDBTreeND<4>)
+        ->Name("Contains KDB - 4D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(containsDimension, OrthTree<4>)
+        ->Name("Contains Orth - 4D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(kNNSDimension, KDBTreeND<2>)
+        ->Name("kNNS KDB - 2D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(kNNSDimension, OrthTree<2>)
+        ->Name("kNNS Orth - 2D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(kNNSDimension, KDBTreeND<3>)
+        ->Name("kNNS KDB - 3D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
+
+BENCHMARK_TEMPLATE(kNNSDimension, OrthTree<3>)
+        ->Name("kNNS Orth - 3D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
 
-    for ([[maybe_unused]] auto _: state) {
-        benchmark::DoNotOptimize(tree);
-        tree->kNearestNeighbors(queryPoint, k);
-    }
-    delete tree;
-    state.SetComplexityN(state.range(0));
-}
+BENCHMARK_TEMPLATE(kNNSDimension, KDBTreeND<4>)
+        ->Name("kNNS KDB - 4D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
 
-static void KDBTree_kNNS(benchmark::State &state) {
-    int k = state.range(0);
-    int n = 10'000'000;
-    KDBTreeEfficient *tree = buildKDB_Random(n);
-    Point queryPoint{0.35 * n, 0.75 * n};
+BENCHMARK_TEMPLATE(kNNSDimension, OrthTree<4>)
+        ->Name("kNNS Orth - 4D")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, {UNIFORM, CLUSTERED}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(100);
 
-    for ([[maybe_unused]] auto _: state) {
-        benchmark::DoNotOptimize(tree);
-        tree->kNearestNeighbors(queryPoint, k);
-    }
-    delete tree;
-    state.SetComplexityN(state.range(0));
-}
+BENCHMARK(loadPointsFromText)
+        ->Name("Load points - text")
+        ->ArgNames({"n", "threads"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 24}, {1, 2, 4, 8, 0}})
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(10);
 
-static void quadTree_kNNS(benchmark::State &state) {
-    int k = state.range(0);
-    int n = 10'000'000;
-    QuadTree *tree = buildQuadTreeRandom(n);
-    Point queryPoint{0.35 * n, 0.75 * n};
+BENCHMARK(ingestKDBTree)
+        ->Name("Load and build KDB-E")
+        ->ArgNames({"n", "binary"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 24}, {0, 1}})
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(10);
+
+// Workloads, every distribution of Workload.h with fixed seeds. The Quadtree and Quadtree-E split equal points down
+// to the resolution of double, so they run without DUPLICATES. The implicit KD-Tree has no kNN
+BENCHMARK_TEMPLATE(buildWorkload, KDTreeEfficient)
+        ->Name("Build KD-E - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(10);
 
-    for ([[maybe_unused]] auto _: state) {
-        benchmark::DoNotOptimize(tree);
-        tree->kNearestNeighbors(queryPoint, k);
-    }
-    delete tree;
-    state.SetComplexityN(state.range(0));
-}
+BENCHMARK_TEMPLATE(buildWorkload, KDBTreeEfficient)
+        ->Name("Build KDB-E - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(10);
 
-static void pr_quadTree_kNNS(benchmark::State &state) {
-    int k = state.range(0);
-    int n = 10'000'000;
+BENCHMARK_TEMPLATE(buildWorkload, PointRegionQuadTree)
+        ->Name("Build PR-Quadtree - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(10);
 
-    PointRegionQuadTree *tree = buildPRQuadTreeRandom(n);
-    Point queryPoint{0.35 * n, 0.75 * n};
+BENCHMARK_TEMPLATE(buildWorkload, SortKDTree)
+        ->Name("Build SortKDTree - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(10);
 
-    for ([[maybe_unused]] auto _: state) {
-        benchmark::DoNotOptimize(tree);
-        tree->kNearestNeighbors(queryPoint, k);
-    }
-    delete tree;
-    state.SetComplexityN(state.range(0));
-}
+BENCHMARK_TEMPLATE(buildWorkload, QuadTree)
+        ->Name("Build Quadtree - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, DUPLICATES - 1, 1)})
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(10);
 
-static void naive_kNNS(benchmark::State &state) {
-    int k = state.range(0);
-    int n = 10'000'000;
-    std::vector<Point> points = getRandomPoints(n);
-    Point queryPoint{0.35 * n, 0.75 * n};
+BENCHMARK_TEMPLATE(buildWorkload, QuadTreeEfficient)
+        ->Name("Build Quadtree-E - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, DUPLICATES - 1, 1)})
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(10);
 
-    for ([[maybe_unused]] auto _: state) {
-        benchmark::DoNotOptimize(points);
-        benchmark::DoNotOptimize(naive_kNNS(queryPoint, points, k));
-    }
-    state.SetComplexityN(state.range(0));
-}
+BENCHMARK_TEMPLATE(buildWorkload, LinearQuadTree)
+        ->Name("Build Linear-Quadtree - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
+        ->Unit(benchmark::kMillisecond)
+        ->Iterations(10);
 
-// BUILD
-BENCHMARK(buildQuadTree)
-        ->Name("Build Quadtree")
-        ->RangeMultiplier(2)
-        ->Range(START, END)
-        ->Complexity(benchmark::oNLogN)
+BENCHMARK_TEMPLATE(buildWorkload, CompressedQuadTree)
+        ->Name("Build Compressed-Quadtree - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
         ->Unit(benchmark::kMillisecond)
-        ->Iterations(ITERATIONS);
+        ->Iterations(10);
 
-BENCHMARK(buildPRQuadTree)
-        ->Name("Build PR-Quadtree")
-        ->RangeMultiplier(2)
-        ->Range(START, END)
-        ->Complexity(benchmark::oNLogN)
+BENCHMARK_TEMPLATE(buildWorkload, ImplicitKDTree)
+        ->Name("Build Implicit-KD - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
         ->Unit(benchmark::kMillisecond)
-        ->Iterations(ITERATIONS);
+        ->Iterations(10);
 
-BENCHMARK(buildSKDTree)
-        ->Name("Build SortKDTree")
-        ->RangeMultiplier(2)
-        ->Range(START, END)
-        ->Complexity(benchmark::oNLogN)
+BENCHMARK_TEMPLATE(buildWorkload, DynamicKDBTree)
+        ->Name("Build Dynamic-KDB - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
         ->Unit(benchmark::kMillisecond)
+        ->Iterations(10);
+
+BENCHMARK_TEMPLATE(queryWorkload, KDTreeEfficient)
+        ->Name("Query KD-E - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
+        ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-BENCHMARK(buildKDETree)
-        ->Name("Build KD-Tree-Efficient")
-        ->RangeMultiplier(2)
-        ->Range(START, END)
-        ->Complexity(benchmark::oNLogN)
-        ->Unit(benchmark::kMillisecond)
+BENCHMARK_TEMPLATE(queryWorkload, KDBTreeEfficient)
+        ->Name("Query KDB-E - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
+        ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-BENCHMARK(buildKDBTree)
-        ->Name("Build KDB-Tree-Efficient")
-        ->RangeMultiplier(2)
-        ->Range(START, END)
-        ->Complexity(benchmark::oNLogN)
-        ->Unit(benchmark::kMillisecond)
+BENCHMARK_TEMPLATE(queryWorkload, PointRegionQuadTree)
+        ->Name("Query PR-Quadtree - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
+        ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-BENCHMARK(buildDenseQuadTree)
-        ->Name("Build Dense Quadtree")
-        ->RangeMultiplier(2)
-        ->Range(START, END)
-        ->Complexity(benchmark::oNLogN)
-        ->Unit(benchmark::kMillisecond)
+BENCHMARK_TEMPLATE(queryWorkload, SortKDTree)
+        ->Name("Query SortKDTree - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
+        ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-BENCHMARK(buildDensePRQuadTree)
-        ->Name("Build Dense PR-Quadtree")
-        ->RangeMultiplier(2)
-        ->Range(START, END)
-        ->Complexity(benchmark::oNLogN)
-        ->Unit(benchmark::kMillisecond)
+BENCHMARK_TEMPLATE(queryWorkload, QuadTree)
+        ->Name("Query Quadtree - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, DUPLICATES - 1, 1)})
+        ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-BENCHMARK(buildDensesortKDTree)
-        ->Name("Build Dense SortKDTree")
-        ->RangeMultiplier(2)
-        ->Range(START, END)
-        ->Complexity(benchmark::oNLogN)
-        ->Unit(benchmark::kMillisecond)
+BENCHMARK_TEMPLATE(queryWorkload, QuadTreeEfficient)
+        ->Name("Query Quadtree-E - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, DUPLICATES - 1, 1)})
+        ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-BENCHMARK(buildDenseKDETree)
-        ->Name("Build Dense KD-Tree-Efficient")
-        ->RangeMultiplier(2)
-        ->Range(START, END)
-        ->Complexity(benchmark::oNLogN)
-        ->Unit(benchmark::kMillisecond)
+BENCHMARK_TEMPLATE(queryWorkload, LinearQuadTree)
+        ->Name("Query Linear-Quadtree - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
+        ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-BENCHMARK(buildDenseKDBTree)
-        ->Name("Build Dense KDB-Tree-Efficient")
-        ->RangeMultiplier(2)
-        ->Range(START, END)
-        ->Complexity(benchmark::oNLogN)
-        ->Unit(benchmark::kMillisecond)
+BENCHMARK_TEMPLATE(queryWorkload, CompressedQuadTree)
+        ->Name("Query Compressed-Quadtree - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
+        ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-// Build dynamically
-/*BENCHMARK(buildKDTree_Dynamically)
-        ->Name("Build SortKDTree-dynamically")
-        ->RangeMultiplier(2)->Range(START, END)
-        ->Unit(benchmark::kMillisecond)
+BENCHMARK_TEMPLATE(queryWorkload, ImplicitKDTree)
+        ->Name("Query Implicit-KD - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
+        ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-BENCHMARK(buildQuadTree_Dynamically)
-        ->Name("Build Quadtree-dynamically")
-        ->RangeMultiplier(2)
-        ->Range(START, END)
-        ->Unit(benchmark::kMillisecond)
+BENCHMARK_TEMPLATE(queryWorkload, DynamicKDBTree)
+        ->Name("Query Dynamic-KDB - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
+        ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
-        */
 
-// Query
-BENCHMARK(queryQuadTree)
-        ->Name("Query Quadtree - Variable PointCount")
-        ->RangeMultiplier(2)->Range(START, END)
+BENCHMARK_TEMPLATE(containsWorkload, KDTreeEfficient)
+        ->Name("Contains KD-E - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
         ->Unit(benchmark::kMicrosecond)
-        ->Complexity(benchmark::oAuto)
         ->Iterations(ITERATIONS);
 
-BENCHMARK(queryPRQuadTree)
-        ->Name("Query PR-Quadtree - Variable PointCount")
-        ->RangeMultiplier(2)->Range(START, END)
-        ->Complexity(benchmark::oAuto)
+BENCHMARK_TEMPLATE(containsWorkload, KDBTreeEfficient)
+        ->Name("Contains KDB-E - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
         ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-BENCHMARK(querysortKDTree)
-        ->Name("Query SortKDTree - Variable PointCount")
-        ->RangeMultiplier(2)
-        ->Range(START, END)
-        ->Complexity(benchmark::oAuto)
+BENCHMARK_TEMPLATE(containsWorkload, PointRegionQuadTree)
+        ->Name("Contains PR-Quadtree - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
         ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-BENCHMARK(queryKDETree)
-        ->Name("Query KD-E - Variable PointCount")
-        ->RangeMultiplier(2)->Range(START, END)
-        ->Complexity(benchmark::oAuto)
+BENCHMARK_TEMPLATE(containsWorkload, SortKDTree)
+        ->Name("Contains SortKDTree - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
         ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-BENCHMARK(queryKDBTree)
-        ->Name("Query KDB-E - Variable PointCount")
-        ->RangeMultiplier(2)->Range(START, END)
-        ->Complexity(benchmark::oAuto)
+BENCHMARK_TEMPLATE(containsWorkload, QuadTree)
+        ->Name("Contains Quadtree - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, DUPLICATES - 1, 1)})
         ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-BENCHMARK(queryNaive)->Name("Query Naive - Variable PointCount")
-        ->RangeMultiplier(2)
-        ->Range(START, END)
-        ->Complexity(benchmark::oAuto)
+BENCHMARK_TEMPLATE(containsWorkload, QuadTreeEfficient)
+        ->Name("Contains Quadtree-E - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, DUPLICATES - 1, 1)})
         ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-// CONTAINS
-BENCHMARK(pr_quadTree_contains)
-        ->Name("PR-Quadtree - Contains")
-        ->RangeMultiplier(2)
-        ->Range(START, END)
-        ->Complexity(benchmark::oLogN)
+BENCHMARK_TEMPLATE(containsWorkload, LinearQuadTree)
+        ->Name("Contains Linear-Quadtree - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
         ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-BENCHMARK(sortKDTree_Contains)
-        ->Name("SortKDTree - Contains")
-        ->RangeMultiplier(2)
-        ->Range(START, END)
-        ->Complexity(benchmark::oLogN)
+BENCHMARK_TEMPLATE(containsWorkload, CompressedQuadTree)
+        ->Name("Contains Compressed-Quadtree - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
         ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-BENCHMARK(kDBTreeEfficient_Contains)
-        ->Name("KDB-tree - Contains")
-        ->RangeMultiplier(2)
-        ->Range(START, END)
-        ->Complexity(benchmark::oLogN)
+BENCHMARK_TEMPLATE(containsWorkload, ImplicitKDTree)
+        ->Name("Contains Implicit-KD - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
         ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-BENCHMARK(quadTree_contains)
-        ->Name("Quadtree - Contains")
-        ->RangeMultiplier(2)
-        ->Range(START, END)
-        ->Complexity(benchmark::oLogN)
+BENCHMARK_TEMPLATE(containsWorkload, DynamicKDBTree)
+        ->Name("Contains Dynamic-KDB - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
         ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-BENCHMARK(kDTreeEfficient_Contains)
-        ->Name("KD_Tree_Efficient - Contains")
-        ->RangeMultiplier(2)
-        ->Range(START, END)
-        ->Complexity(benchmark::oLogN)
+BENCHMARK_TEMPLATE(kNNSWorkload, KDTreeEfficient)
+        ->Name("KD-E - NNS - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
         ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-BENCHMARK(naive_Contains)->Name("Naive - Contains")
-        ->RangeMultiplier(2)->Range(START, END)
-        ->Complexity(benchmark::oN)
+BENCHMARK_TEMPLATE(kNNSWorkload, KDBTreeEfficient)
+        ->Name("KDB-E - NNS - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
         ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
+BENCHMARK_TEMPLATE(kNNSWorkload, PointRegionQuadTree)
+        ->Name("PR-Quadtree - NNS - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
 
-// NNS - variable point count k = 10
-BENCHMARK(quadTree_NNS)
-        ->Name("Quadtree - NNS - var n")
-        ->RangeMultiplier(2)->Range(START, END)
-        ->Complexity(benchmark::oLogN)
+BENCHMARK_TEMPLATE(kNNSWorkload, SortKDTree)
+        ->Name("SortKDTree - NNS - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
         ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-BENCHMARK(pr_quadTree_NNS)
-        ->Name("PR-Quadtree - NNS - var n")
-        ->RangeMultiplier(2)->Range(START, END)
-        ->Complexity(benchmark::oLogN)
+BENCHMARK_TEMPLATE(kNNSWorkload, QuadTree)
+        ->Name("Quadtree - NNS - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, DUPLICATES - 1, 1)})
         ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-BENCHMARK(sortKDTree_NNS)
-        ->Name("SortKDTree - NNS - var n")
-        ->RangeMultiplier(2)
-        ->Range(START, END)
-        ->Complexity(benchmark::oLogN)
+BENCHMARK_TEMPLATE(kNNSWorkload, QuadTreeEfficient)
+        ->Name("Quadtree-E - NNS - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, DUPLICATES - 1, 1)})
         ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-BENCHMARK(eKDTree_NNS)
-        ->Name("KD_Tree_Efficient -- NNS - var n")
-        ->RangeMultiplier(2)->Range(START, END)
-        ->Complexity(benchmark::oLogN)
+BENCHMARK_TEMPLATE(kNNSWorkload, LinearQuadTree)
+        ->Name("Linear-Quadtree - NNS - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
         ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-BENCHMARK(KDBTree_NNS)
-        ->Name("KDB_Tree -- NNS - var n")
-        ->RangeMultiplier(2)
-        ->Range(START, END)
-        ->Complexity(benchmark::oLogN)
+BENCHMARK_TEMPLATE(kNNSWorkload, CompressedQuadTree)
+        ->Name("Compressed-Quadtree - NNS - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
         ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
-BENCHMARK(naive_NNS)
-        ->Name("Naive - NNS - var n")
-        ->RangeMultiplier(2)
-        ->Range(START, END)
-        ->Complexity(benchmark::oN)
+BENCHMARK_TEMPLATE(kNNSWorkload, DynamicKDBTree)
+        ->Name("Dynamic-KDB - NNS - Workloads")
+        ->ArgNames({"n", "distribution"})
+        ->ArgsProduct({{1 << 16, 1 << 20, 1 << 22}, benchmark::CreateDenseRange(0, POINT_DISTRIBUTION_COUNT - 1, 1)})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+// Clustered data, split cells against tight bounding boxes
+BENCHMARK(queryClusteredKDETree)
+        ->Name("Query Clustered KD-E - Tight Areas")
+        ->ArgNames({"n", "tight"})
+        ->ArgsProduct({{1 << 16, 1 << 18, 1 << 20, 1 << 22}, {0, 1}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(queryClusteredKDBTree)
+        ->Name("Query Clustered KDB-E - Tight Areas")
+        ->ArgNames({"n", "tight"})
+        ->ArgsProduct({{1 << 16, 1 << 18, 1 << 20, 1 << 22}, {0, 1}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(queryClusteredSKDTree)
+        ->Name("Query Clustered SortKDTree - Tight Areas")
+        ->ArgNames({"n", "tight"})
+        ->ArgsProduct({{1 << 16, 1 << 18, 1 << 20, 1 << 22}, {0, 1}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(clusteredKDETree_NNS)
+        ->Name("Clustered KD-E - NNS - Tight Areas")
+        ->ArgNames({"n", "tight"})
+        ->ArgsProduct({{1 << 16, 1 << 18, 1 << 20, 1 << 22}, {0, 1}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(clusteredKDBTree_NNS)
+        ->Name("Clustered KDB-E - NNS - Tight Areas")
+        ->ArgNames({"n", "tight"})
+        ->ArgsProduct({{1 << 16, 1 << 18, 1 << 20, 1 << 22}, {0, 1}})
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
+BENCHMARK(clusteredSKDTree_NNS)
+        ->Name("Clustered SortKDTree - NNS - Tight Areas")
+        ->ArgNames({"n", "tight"})
+        ->ArgsProduct({{1 << 16, 1 << 18, 1 << 20, 1 << 22}, {0, 1}})
         ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
+// Concurrent readers, queries per second over thread counts
+BENCHMARK(KDBTree_kNNS_Threads)
+        ->Name("KDB_Tree -- NNS - Threads")
+        ->ArgNames({"n", "threads"})
+        ->RangeMultiplier(2)
+        ->Ranges({{1 << 16, 1 << 22}, {1, 32}})
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime()
+        ->Iterations(10);
+
+BENCHMARK(pr_quadTree_kNNS_Threads)
+        ->Name("PR-Quadtree - NNS - Threads")
+        ->ArgNames({"n", "threads"})
+        ->RangeMultiplier(2)
+        ->Ranges({{1 << 16, 1 << 22}, {1, 32}})
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime()
+        ->Iterations(10);
+
 // k-NNS - variable k
 BENCHMARK(quadTree_kNNS)
         ->Name("Quadtree - NNS - var k")
@@ -818,6 +3275,14 @@ BENCHMARK(KDBTree_kNNS)
         ->Unit(benchmark::kMicrosecond)
         ->Iterations(ITERATIONS);
 
+BENCHMARK(linearQuadTree_kNNS)
+        ->Name("Linear-Quadtree - NNS - var k")
+        ->RangeMultiplier(10)
+        ->Range(K_START, K_END)
+        ->Complexity(benchmark::oAuto)
+        ->Unit(benchmark::kMicrosecond)
+        ->Iterations(ITERATIONS);
+
 BENCHMARK(sortKDTree_kNNS)
         ->Name("SortKDTree - NNS - var k")
         ->RangeMultiplier(10)
@@ -0,0 +1,52 @@
+//
+// Created by omarc on 12/01/2024.
+//
+
+#include "../include/CapacityProfile.h"
+
+int CapacityProfile::sizeClass(long pointNumber) {
+    int result = 0;
+    while (pointNumber > 1) {
+        pointNumber >>= 1;
+        result++;
+    }
+    return result;
+}
+
+void CapacityProfile::record(long pointNumber, int capacity) {
+    this->capacities[sizeClass(pointNumber)] = std::max(capacity, 1);
+}
+
+int CapacityProfile::capacityFor(long pointNumber) const {
+    if (this->capacities.empty()) {
+        return defaultLeafCapacity(pointNumber);
+    }
+    int target = sizeClass(pointNumber);
+    auto higher = this->capacities.lower_bound(target);
+    if (higher == this->capacities.end()) {
+        return std::prev(higher)->second;
+    } else if (higher == this->capacities.begin() || higher->first == target) {
+        return higher->second;
+    }
+    auto lower = std::prev(higher);
+    return target - lower->first <= higher->first - target ? lower->second : higher->second;
+}
+
+bool CapacityProfile::empty() const {
+    return this->capacities.empty();
+}
+
+void CapacityProfile::save(std::ostream &os) const {
+    for (auto &[sizeClass, capacity]: this->capacities) {
+        os << sizeClass << " " << capacity << "\n";
+    }
+}
+
+CapacityProfile CapacityProfile::load(std::istream &is) {
+    CapacityProfile profile;
+    int sizeClass, capacity;
+    while (is >> sizeClass >> capacity) {
+        profile.capacities[sizeClass] = std::max(capacity, 1);
+    }
+    return profile;
+}
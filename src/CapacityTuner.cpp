@@ -0,0 +1,123 @@
+//
+// Created by omarc on 12/01/2024.
+//
+
+#include "../include/CapacityTuner.h"
+#include "../include/KDBTreeEfficient.h"
+#include "../include/PointRegionQuadTree.h"
+#include "../include/KNNScratch.h"
+#include <chrono>
+
+/**
+ * Receives the result sizes of the timed operations, so that they are not optimized away
+ */
+static volatile long tuningSink;
+
+std::string workloadName(TuningWorkload workload) {
+    switch (workload) {
+        case BUILD:
+            return "build";
+        case RANGE_QUERY_SMALL:
+            return "range-small";
+        case RANGE_QUERY_MEDIUM:
+            return "range-medium";
+        case RANGE_QUERY_LARGE:
+            return "range-large";
+        case CONTAINS:
+            return "contains";
+        case KNN:
+            return "knn";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Sweeps options.capacities for every size of options
+ * @param build callable (points, area, capacity) building a tree, the tree has to copy points
+ * @param destroy callable deleting a tree returned by build
+ */
+template<typename Build, typename Destroy>
+static CapacityProfile sweep(TuningWorkload workload, PointDistribution distribution, const TuningOptions &options,
+                             Build build, Destroy destroy) {
+    using Clock = std::chrono::steady_clock;
+    CapacityProfile profile;
+    for (int size: options.sizes) {
+        Area area = workloadArea(size, distribution);
+        std::vector<Point> points = generatePoints(size, distribution, options.seed);
+        std::vector<Area> rectangles;
+        if (workload == RANGE_QUERY_SMALL || workload == RANGE_QUERY_MEDIUM || workload == RANGE_QUERY_LARGE) {
+            double selectivity = workload == RANGE_QUERY_SMALL ? 0.001 : workload == RANGE_QUERY_MEDIUM ? 0.01 : 0.1;
+            rectangles = generateQueryAreas(points, area, options.operations, selectivity, options.seed);
+        }
+        std::vector<Point> probes = generateQueryPoints(points, options.operations, options.seed);
+
+        int bestCapacity = defaultLeafCapacity(size);
+        double bestTime = std::numeric_limits<double>::infinity();
+        for (int capacity: options.capacities) {
+            double time = std::numeric_limits<double>::infinity();
+            for (int repetition = 0; repetition < options.repetitions; repetition++) {
+                auto start = Clock::now();
+                auto *tree = build(points, area, capacity);
+                auto built = Clock::now();
+                long checksum = 0;
+                if (workload == CONTAINS) {
+                    for (auto &probe: probes) {
+                        checksum += tree->contains(probe);
+                    }
+                } else if (workload == KNN) {
+                    KNNScratch scratch;
+                    std::vector<Point> result;
+                    for (auto &probe: probes) {
+                        result.clear();
+                        tree->kNearestNeighbors(probe, 10, scratch, result);
+                        checksum += (long) result.size();
+                    }
+                } else if (workload != BUILD) {
+                    std::vector<Point> result;
+                    for (auto &rectangle: rectangles) {
+                        result.clear();
+                        tree->query(rectangle, result);
+                        checksum += (long) result.size();
+                    }
+                }
+                auto end = Clock::now();
+                tuningSink = checksum;
+                destroy(tree);
+                auto measured = workload == BUILD ? built - start : end - built;
+                time = min(time, std::chrono::duration<double>(measured).count());
+            }
+            if (time < bestTime) {
+                bestTime = time;
+                bestCapacity = capacity;
+            }
+        }
+        profile.record(size, bestCapacity);
+    }
+    return profile;
+}
+
+CapacityProfile tuneKDBTreeCapacity(TuningWorkload workload, PointDistribution distribution,
+                                    const TuningOptions &options) {
+    return sweep(workload, distribution, options, [](std::vector<Point> &points, Area &area, int capacity) {
+        auto *pointArray = (Point *) malloc(points.size() * sizeof(Point));
+        std::copy(points.begin(), points.end(), pointArray);
+        auto *tree = new KDBTreeEfficient(pointArray, 0, area, 0, (int) points.size() - 1, capacity);
+        tree->buildTree();
+        return tree;
+    }, [](KDBTreeEfficient *tree) {
+        Point *pointArray = tree->getPoints();
+        delete tree;
+        free(pointArray);
+    });
+}
+
+CapacityProfile tunePRQuadTreeCapacity(TuningWorkload workload, PointDistribution distribution,
+                                       const TuningOptions &options) {
+    return sweep(workload, distribution, options, [](std::vector<Point> &points, Area &area, int capacity) {
+        auto *tree = new PointRegionQuadTree(area, points, capacity);
+        tree->buildTree();
+        return tree;
+    }, [](PointRegionQuadTree *tree) {
+        delete tree;
+    });
+}
@@ -0,0 +1,226 @@
+//
+// Created by omarc on 12/01/2024.
+//
+
+#include "../include/CompressedQuadTree.h"
+
+CompressedQuadTree::CompressedQuadTree(Area square, vector<Point> &elements, int capacity) {
+    this->square = square;
+    this->capacity = max(capacity, 1);
+    this->size = (long) elements.size();
+    // group equal points into one counted entry
+    vector<Point> sorted(elements);
+    sort(sorted.begin(), sorted.end(), [](const Point &a, const Point &b) {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+    for (auto &point: sorted) {
+        if (!entries.empty() && entries.back().point == point) {
+            entries.back().count++;
+        } else {
+            entries.push_back(CountedPoint{point, 1});
+        }
+    }
+}
+
+CompressedQuadTree::CompressedQuadTree(Area square, vector<CountedPoint> &&entries, int capacity) {
+    this->square = square;
+    this->capacity = capacity;
+    this->entries = std::move(entries);
+    this->size = 0;
+    for (auto &entry: this->entries) {
+        this->size += entry.count;
+    }
+}
+
+CompressedQuadTree::~CompressedQuadTree() {
+    for (auto &child: children) {
+        delete child;
+    }
+}
+
+bool CompressedQuadTree::isNodeLeaf() const {
+    return this->children[0] == nullptr && this->children[1] == nullptr
+           && this->children[2] == nullptr && this->children[3] == nullptr;
+}
+
+void CompressedQuadTree::buildTree() {
+    if (this->entries.size() <= (size_t) this->capacity) {
+        return;
+    }
+    compress();
+    double xMid = (this->square.xMin + this->square.xMax) / 2.0;
+    double yMid = (this->square.yMin + this->square.yMax) / 2.0;
+    // points closer than the floating point resolution stay together in one leaf
+    bool splittable = xMid > this->square.xMin && xMid < this->square.xMax
+                      && yMid > this->square.yMin && yMid < this->square.yMax;
+    if (!splittable) {
+        return;
+    }
+    subdivide();
+    for (auto child: children) {
+        if (child != nullptr) {
+            child->buildTree();
+        }
+    }
+}
+
+void CompressedQuadTree::compress() {
+    double xMin = this->entries.front().point.x, xMax = xMin;
+    double yMin = this->entries.front().point.y, yMax = yMin;
+    for (auto &entry: this->entries) {
+        xMin = min(xMin, entry.point.x);
+        xMax = max(xMax, entry.point.x);
+        yMin = min(yMin, entry.point.y);
+        yMax = max(yMax, entry.point.y);
+    }
+    // descend into the quadrant containing the bounding box as long as it is contained by a single one
+    while (true) {
+        double xMid = (this->square.xMin + this->square.xMax) / 2.0;
+        double yMid = (this->square.yMin + this->square.yMax) / 2.0;
+        if (!(xMid > this->square.xMin && xMid < this->square.xMax
+              && yMid > this->square.yMin && yMid < this->square.yMax)) {
+            return;
+        }
+        // same tie breaking as quadrantOf(): x > xMid is east, y <= yMid is south
+        bool west = xMax <= xMid, east = xMin > xMid;
+        bool south = yMax <= yMid, north = yMin > yMid;
+        if (!(west || east) || !(south || north)) {
+            return;
+        }
+        this->square = Area{west ? this->square.xMin : xMid, west ? xMid : this->square.xMax,
+                            south ? this->square.yMin : yMid, south ? yMid : this->square.yMax};
+    }
+}
+
+void CompressedQuadTree::subdivide() {
+    double xMid = (this->square.xMin + this->square.xMax) / 2.0;
+    double yMid = (this->square.yMin + this->square.yMax) / 2.0;
+    Area quadrants[4];
+    splitArea(this->square, xMid, yMid, quadrants);
+    vector<CountedPoint> childrenEntries[4];
+    for (auto &entry: this->entries) {
+        childrenEntries[quadrantOf(entry.point, xMid, yMid)].push_back(entry);
+    }
+    for (int i = 0; i < 4; i++) {
+        if (!childrenEntries[i].empty()) {
+            children[i] = new CompressedQuadTree(quadrants[i], std::move(childrenEntries[i]), this->capacity);
+        }
+    }
+    // inner nodes do not keep their points
+    vector<CountedPoint>().swap(this->entries);
+}
+
+int CompressedQuadTree::getHeight() {
+    if (isNodeLeaf()) {
+        return 1;
+    }
+    int maxHeight = 0;
+    for (auto child: children) {
+        if (child != nullptr) {
+            maxHeight = max(maxHeight, child->getHeight());
+        }
+    }
+    return maxHeight + 1;
+}
+
+int CompressedQuadTree::multiplicity(Point &point) {
+    CompressedQuadTree *current = this;
+    while (!current->isNodeLeaf()) {
+        double xMid = (current->square.xMin + current->square.xMax) / 2.0;
+        double yMid = (current->square.yMin + current->square.yMax) / 2.0;
+        current = current->children[quadrantOf(point, xMid, yMid)];
+        if (current == nullptr) {
+            return 0;
+        }
+    }
+    for (auto &entry: current->entries) {
+        if (entry.point == point) {
+            return entry.count;
+        }
+    }
+    return 0;
+}
+
+bool CompressedQuadTree::contains(Point &point) {
+    return multiplicity(point) > 0;
+}
+
+std::list<Point> CompressedQuadTree::query(Area &queryRectangle) {
+    list<Point> result;
+    query(queryRectangle, back_inserter(result));
+    return result;
+}
+
+void CompressedQuadTree::query(Area &queryRectangle, vector<Point> &result) {
+    query(queryRectangle, back_inserter(result));
+}
+
+long CompressedQuadTree::count(Area &queryRectangle) {
+    if (containsArea(queryRectangle, this->square)) {
+        return this->size;
+    } else if (this->isNodeLeaf()) {
+        long result = 0;
+        for (auto &entry: this->entries) {
+            if (containsPoint(queryRectangle, entry.point)) {
+                result += entry.count;
+            }
+        }
+        return result;
+    }
+    long result = 0;
+    for (auto child: this->children) {
+        if (child != nullptr && intersects(queryRectangle, child->square)) {
+            result += child->count(queryRectangle);
+        }
+    }
+    return result;
+}
+
+void CompressedQuadTree::kNearestNeighborsHelper(const Point &queryPoint, KNNScratch &scratch) {
+    if (this->isNodeLeaf()) {
+        for (auto &entry: this->entries) {
+            double distance = pointDistance(entry.point, queryPoint);
+            // once a copy is rejected, all further copies are rejected as well
+            for (int i = 0; i < entry.count && distance < scratch.radius(); i++) {
+                scratch.offer(entry.point, distance);
+            }
+        }
+        return;
+    }
+    // order the children by proximity of their squares to queryPoint
+    CompressedQuadTree *order[4];
+    double distances[4];
+    int childCount = 0;
+    for (auto child: this->children) {
+        if (child == nullptr) {
+            continue;
+        }
+        double distance = sqDistanceFrom(child->square, queryPoint);
+        int j = childCount++;
+        for (; j > 0 && distances[j - 1] > distance; j--) {
+            order[j] = order[j - 1];
+            distances[j] = distances[j - 1];
+        }
+        order[j] = child;
+        distances[j] = distance;
+    }
+    for (int i = 0; i < childCount; i++) {
+        if (distances[i] >= scratch.radius()) {
+            break;
+        }
+        order[i]->kNearestNeighborsHelper(queryPoint, scratch);
+    }
+}
+
+std::vector<Point> CompressedQuadTree::kNearestNeighbors(Point &queryPoint, int k) {
+    vector<Point> result;
+    KNNScratch scratch;
+    kNearestNeighbors(queryPoint, k, scratch, result);
+    return result;
+}
+
+void CompressedQuadTree::kNearestNeighbors(Point &queryPoint, int k, KNNScratch &scratch, vector<Point> &result) {
+    scratch.reset(k);
+    kNearestNeighborsHelper(queryPoint, scratch);
+    scratch.extractSorted(result);
+}
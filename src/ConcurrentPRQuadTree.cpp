@@ -0,0 +1,155 @@
+//
+// Created by omarc on 12/01/2024.
+//
+
+#include "../include/ConcurrentPRQuadTree.h"
+#include <thread>
+
+ConcurrentPRQuadTree::ConcurrentPRQuadTree(Area square, int capacity) {
+    this->square = square;
+    this->capacity = max(capacity, 1);
+    this->slots = std::make_unique<Point[]>(this->capacity);
+    this->ready = std::make_unique<std::atomic<bool>[]>(this->capacity);
+    for (int i = 0; i < this->capacity; i++) {
+        this->ready[i].store(false, std::memory_order_relaxed);
+    }
+}
+
+ConcurrentPRQuadTree::~ConcurrentPRQuadTree() {
+    Children *current = children.load(std::memory_order_acquire);
+    if (current != nullptr) {
+        for (auto child: current->quadrants) {
+            delete child;
+        }
+        delete current;
+    }
+    OverflowEntry *entry = overflow.load(std::memory_order_acquire);
+    while (entry != nullptr) {
+        OverflowEntry *next = entry->next;
+        delete entry;
+        entry = next;
+    }
+}
+
+int ConcurrentPRQuadTree::quadrantOf(const Point &point) const {
+    double xMid = (this->square.xMin + this->square.xMax) / 2.0;
+    double yMid = (this->square.yMin + this->square.yMax) / 2.0;
+    return ::quadrantOf(point, xMid, yMid);
+}
+
+bool ConcurrentPRQuadTree::isSplittable() const {
+    double xMid = (this->square.xMin + this->square.xMax) / 2.0;
+    double yMid = (this->square.yMin + this->square.yMax) / 2.0;
+    return xMid > this->square.xMin && xMid < this->square.xMax
+           && yMid > this->square.yMin && yMid < this->square.yMax;
+}
+
+void ConcurrentPRQuadTree::add(const Point &point) {
+    ConcurrentPRQuadTree *current = this;
+    while (true) {
+        Children *currentChildren = current->children.load(std::memory_order_acquire);
+        if (currentChildren != nullptr) {
+            current = currentChildren->quadrants[current->quadrantOf(point)];
+            continue;
+        }
+        int slot = current->reserved.fetch_add(1, std::memory_order_acq_rel);
+        if (slot < current->capacity) {
+            current->slots[slot] = point;
+            current->ready[slot].store(true, std::memory_order_release);
+            return;
+        }
+        if (!current->isSplittable()) {
+            // equal or almost equal points, splitting would not separate them
+            auto *entry = new OverflowEntry{point, current->overflow.load(std::memory_order_relaxed)};
+            while (!current->overflow.compare_exchange_weak(entry->next, entry, std::memory_order_release,
+                                                            std::memory_order_relaxed)) {
+            }
+            return;
+        }
+        // the leaf is full, split it and retry in its children
+        current->split();
+    }
+}
+
+void ConcurrentPRQuadTree::split() {
+    if (children.load(std::memory_order_acquire) != nullptr) {
+        return;
+    }
+    // all slots are reserved, wait for the writers that have not stored their point yet
+    for (int i = 0; i < capacity; i++) {
+        while (!ready[i].load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+    double xMid = (this->square.xMin + this->square.xMax) / 2.0;
+    double yMid = (this->square.yMin + this->square.yMax) / 2.0;
+    Area quadrants[4];
+    splitArea(this->square, xMid, yMid, quadrants);
+    auto *created = new Children;
+    for (int i = 0; i < 4; i++) {
+        created->quadrants[i] = new ConcurrentPRQuadTree(quadrants[i], capacity);
+    }
+    // at most capacity points are distributed, so every child has enough slots
+    for (int i = 0; i < capacity; i++) {
+        created->quadrants[quadrantOf(slots[i])]->store(slots[i]);
+    }
+
+    Children *expected = nullptr;
+    if (!children.compare_exchange_strong(expected, created, std::memory_order_acq_rel,
+                                          std::memory_order_acquire)) {
+        // another thread published its children first
+        for (auto child: created->quadrants) {
+            delete child;
+        }
+        delete created;
+    }
+}
+
+void ConcurrentPRQuadTree::store(const Point &point) {
+    int slot = reserved.load(std::memory_order_relaxed);
+    slots[slot] = point;
+    ready[slot].store(true, std::memory_order_relaxed);
+    reserved.store(slot + 1, std::memory_order_relaxed);
+}
+
+bool ConcurrentPRQuadTree::contains(Point &point) {
+    ConcurrentPRQuadTree *current = this;
+    Children *currentChildren;
+    while ((currentChildren = current->children.load(std::memory_order_acquire)) != nullptr) {
+        current = currentChildren->quadrants[current->quadrantOf(point)];
+    }
+    int filled = min(current->reserved.load(std::memory_order_acquire), current->capacity);
+    for (int i = 0; i < filled; i++) {
+        if (current->ready[i].load(std::memory_order_acquire) && current->slots[i] == point) {
+            return true;
+        }
+    }
+    for (auto entry = current->overflow.load(std::memory_order_acquire); entry != nullptr; entry = entry->next) {
+        if (entry->point == point) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int ConcurrentPRQuadTree::getHeight() {
+    Children *current = children.load(std::memory_order_acquire);
+    if (current == nullptr) {
+        return 1;
+    }
+    int maxHeight = 0;
+    for (auto child: current->quadrants) {
+        maxHeight = max(maxHeight, child->getHeight());
+    }
+    return maxHeight + 1;
+}
+
+std::list<Point> ConcurrentPRQuadTree::query(Area &queryRectangle) {
+    list<Point> result;
+    query(queryRectangle, back_inserter(result));
+    return result;
+}
+
+void ConcurrentPRQuadTree::query(Area &queryRectangle, vector<Point> &result) {
+    query(queryRectangle, back_inserter(result));
+}
@@ -0,0 +1,121 @@
+//
+// Created by omarc on 12/01/2024.
+//
+
+#include "../include/DynamicKDBTree.h"
+
+DynamicKDBTree::DynamicKDBTree(Area area, int bufferCapacity, int leafCapacity) {
+    this->area = area;
+    this->bufferCapacity = max(bufferCapacity, 1);
+    this->leafCapacity = max(leafCapacity, 1);
+    this->buffer.reserve(this->bufferCapacity);
+}
+
+DynamicKDBTree::~DynamicKDBTree() {
+    for (auto &level: levels) {
+        delete level.tree;
+        free(level.points);
+    }
+}
+
+void DynamicKDBTree::add(const Point &point) {
+    this->buffer.push_back(point);
+    this->size++;
+    if ((int) this->buffer.size() == this->bufferCapacity) {
+        merge();
+    }
+}
+
+void DynamicKDBTree::merge() {
+    // the buffer and levels 0 to target - 1 hold exactly as many points as the target level
+    size_t target = 0;
+    while (target < this->levels.size() && this->levels[target].tree != nullptr) {
+        target++;
+    }
+    if (target == this->levels.size()) {
+        this->levels.emplace_back();
+    }
+    int mergedSize = this->bufferCapacity << target;
+    auto *merged = (Point *) malloc(mergedSize * sizeof(Point));
+    int filled = (int) this->buffer.size();
+    copy(this->buffer.begin(), this->buffer.end(), merged);
+    this->buffer.clear();
+    for (size_t i = 0; i < target; i++) {
+        Level &level = this->levels[i];
+        copy(level.points, level.points + level.size, merged + filled);
+        filled += level.size;
+        delete level.tree;
+        free(level.points);
+        level = Level{};
+    }
+
+    Level &level = this->levels[target];
+    level.points = merged;
+    level.size = mergedSize;
+    level.tree = new KDBTreeEfficient(merged, 0, this->area, 0, mergedSize - 1, this->leafCapacity);
+    level.tree->buildTree();
+}
+
+bool DynamicKDBTree::contains(Point &point) {
+    if (find(this->buffer.begin(), this->buffer.end(), point) != this->buffer.end()) {
+        return true;
+    }
+    return any_of(this->levels.begin(), this->levels.end(), [&point](Level &level) {
+        return level.tree != nullptr && level.tree->contains(point);
+    });
+}
+
+std::list<Point> DynamicKDBTree::query(Area &queryRectangle) {
+    list<Point> result;
+    query(queryRectangle, back_inserter(result));
+    return result;
+}
+
+void DynamicKDBTree::query(Area &queryRectangle, vector<Point> &result) {
+    query(queryRectangle, back_inserter(result));
+}
+
+long DynamicKDBTree::count(Area &queryRectangle) {
+    long result = 0;
+    for (auto &point: this->buffer) {
+        result += containsPoint(queryRectangle, point);
+    }
+    for (auto &level: this->levels) {
+        if (level.tree != nullptr) {
+            result += level.tree->count(queryRectangle);
+        }
+    }
+    return result;
+}
+
+std::vector<Point> DynamicKDBTree::kNearestNeighbors(const Point &queryPoint, int k) const {
+    vector<Point> result;
+    KNNScratch scratch;
+    kNearestNeighbors(queryPoint, k, scratch, result);
+    return result;
+}
+
+void DynamicKDBTree::kNearestNeighbors(const Point &queryPoint, int k, KNNScratch &scratch,
+                                       vector<Point> &result) const {
+    scratch.reset(k);
+    for (auto &point: this->buffer) {
+        scratch.offer(point, pointDistance(point, queryPoint));
+    }
+    // the largest tree holds most of the points, searching it first tightens the radius for the others
+    for (auto level = this->levels.rbegin(); level != this->levels.rend(); ++level) {
+        if (level->tree != nullptr) {
+            level->tree->kNearestNeighborsHelper(queryPoint, scratch);
+        }
+    }
+    scratch.extractSorted(result);
+}
+
+long DynamicKDBTree::getSize() const {
+    return this->size;
+}
+
+int DynamicKDBTree::getTreeCount() const {
+    return (int) count_if(this->levels.begin(), this->levels.end(), [](const Level &level) {
+        return level.tree != nullptr;
+    });
+}
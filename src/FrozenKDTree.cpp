@@ -0,0 +1,96 @@
+//
+// Created by omarc on 12/01/2024.
+//
+
+#include "../include/FrozenKDTree.h"
+
+/**
+ * @return True if a precedes b, ordered by coordinate x (or y) first and by the other coordinate second
+ */
+static bool precedes(const Point &a, const Point &b, bool x) {
+    return x ? (a.x < b.x || (a.x == b.x && a.y < b.y)) : (a.y < b.y || (a.y == b.y && a.x < b.x));
+}
+
+FrozenKDTree::FrozenKDTree(const Point *points, int size, int capacity) : points(points, points + size) {
+    size_t leaves = (size + max(capacity, 1) - 1) / max(capacity, 1);
+    while ((size_t) 1 << this->height < leaves) {
+        this->height++;
+    }
+    // 4 keys per cache line, the keys of the grandchildren 4i .. 4i+3 of node i share one line
+    size_t length = max(((size_t) 1 << this->height) * sizeof(FrozenSplitKey), (size_t) 64);
+    this->keys = static_cast<FrozenSplitKey *>(aligned_alloc(64, length));
+    if (this->height > 0) {
+        buildTree(1, 0, 0, (size_t) 1 << this->height);
+    }
+}
+
+FrozenKDTree::FrozenKDTree(FrozenKDTree &&other) noexcept {
+    *this = std::move(other);
+}
+
+FrozenKDTree &FrozenKDTree::operator=(FrozenKDTree &&other) noexcept {
+    if (this != &other) {
+        free(this->keys);
+        this->keys = std::exchange(other.keys, nullptr);
+        this->points = std::move(other.points);
+        this->height = std::exchange(other.height, 0);
+    }
+    return *this;
+}
+
+FrozenKDTree::~FrozenKDTree() {
+    free(this->keys);
+}
+
+size_t FrozenKDTree::leafStart(size_t leaf) const {
+    return leaf * this->points.size() >> this->height;
+}
+
+void FrozenKDTree::buildTree(size_t node, int level, size_t firstLeaf, size_t leafCount) {
+    if (leafCount == 1) {
+        return;
+    }
+    bool x = level % 2 == 0;
+    size_t from = leafStart(firstLeaf);
+    size_t mid = leafStart(firstLeaf + leafCount / 2);
+    size_t to = leafStart(firstLeaf + leafCount);
+    if (mid == from) {
+        // empty left subtree, every point goes right
+        this->keys[node] = FrozenSplitKey{-numeric_limits<double>::infinity(), -numeric_limits<double>::infinity()};
+    } else {
+        // the key is the largest point of the left subtree, all points after it are not smaller
+        auto byAxis = [x](const Point &a, const Point &b) { return precedes(a, b, x); };
+        std::nth_element(this->points.begin() + (long) from, this->points.begin() + (long) (mid - 1),
+                         this->points.begin() + (long) to, byAxis);
+        Point &key = this->points[mid - 1];
+        this->keys[node] = x ? FrozenSplitKey{key.x, key.y} : FrozenSplitKey{key.y, key.x};
+    }
+    buildTree(2 * node, level + 1, firstLeaf, leafCount / 2);
+    buildTree(2 * node + 1, level + 1, firstLeaf + leafCount / 2, leafCount / 2);
+}
+
+bool FrozenKDTree::contains(const Point &point) const {
+    const double coordinates[2] = {point.x, point.y};
+    size_t node = 1;
+    for (int level = 0; level < this->height; level++) {
+        __builtin_prefetch(this->keys + 4 * node);
+        const FrozenSplitKey &key = this->keys[node];
+        double primary = coordinates[level & 1];
+        double secondary = coordinates[~level & 1];
+        node = 2 * node + ((key.primary < primary) | ((key.primary == primary) & (key.secondary < secondary)));
+    }
+    size_t leaf = node - ((size_t) 1 << this->height);
+    bool found = false;
+    for (size_t i = leafStart(leaf); i < leafStart(leaf + 1); i++) {
+        found |= this->points[i] == point;
+    }
+    return found;
+}
+
+int FrozenKDTree::getHeight() const {
+    return this->height;
+}
+
+long FrozenKDTree::size() const {
+    return (long) this->points.size();
+}
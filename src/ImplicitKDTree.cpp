@@ -0,0 +1,90 @@
+//
+// Created by omarc on 12/01/2024.
+//
+
+#include "../include/ImplicitKDTree.h"
+
+ImplicitKDTree::ImplicitKDTree(Point *points, Area &area, int size) {
+    this->points = points;
+    this->area = area;
+    this->size = size;
+    this->deepestLevel = size > 0 ? (int) std::bit_floor((unsigned) (2 * size - 1)) : 1;
+}
+
+int ImplicitKDTree::leafPosition(int node) const {
+    return node >= deepestLevel ? node - deepestLevel : node + size - deepestLevel;
+}
+
+int ImplicitKDTree::firstPoint(int node) const {
+    while (node < size) {
+        node = 2 * node;
+    }
+    return leafPosition(node);
+}
+
+int ImplicitKDTree::lastPoint(int node) const {
+    while (node < size) {
+        node = 2 * node + 1;
+    }
+    return leafPosition(node);
+}
+
+void ImplicitKDTree::buildTree() {
+    splits.assign(max(size, 1), 0.0);
+    if (size > 0) {
+        buildTree(1, 0, 0, size - 1);
+    }
+}
+
+void ImplicitKDTree::buildTree(int node, int level, int from, int to) {
+    if (from == to) {
+        return;
+    }
+    // the left subtree ends at its rightmost leaf, everything left of it is <= split value
+    int midIndex = lastPoint(2 * node);
+    this->splits[node] = median(points, level % 2 == 0, from, to + 1, midIndex);
+    buildTree(2 * node, level + 1, from, midIndex);
+    buildTree(2 * node + 1, level + 1, midIndex + 1, to);
+}
+
+bool ImplicitKDTree::contains(Point point) const {
+    if (size == 0) {
+        return false;
+    }
+    return containsHelper(1, 0, point);
+}
+
+bool ImplicitKDTree::containsHelper(int node, int level, const Point &point) const {
+    while (node < size) {
+        double key = level % 2 == 0 ? point.x : point.y;
+        double split = splits[node];
+        // points equal to the split value can end up in the right subtree as well
+        if (key == split && containsHelper(2 * node + 1, level + 1, point)) {
+            return true;
+        }
+        node = 2 * node + (key > split);
+        level++;
+    }
+    return points[leafPosition(node)] == point;
+}
+
+std::list<Point> ImplicitKDTree::query(Area queryRectangle) const {
+    list<Point> result;
+    query(queryRectangle, back_inserter(result));
+    return result;
+}
+
+void ImplicitKDTree::query(Area &queryRectangle, vector<Point> &result) const {
+    query(queryRectangle, back_inserter(result));
+}
+
+int ImplicitKDTree::getHeight() const {
+    if (size == 0) {
+        return 0;
+    }
+    return std::bit_width((unsigned) deepestLevel);
+}
+
+Point *ImplicitKDTree::getPoints() {
+    return this->points;
+}
@@ -4,47 +4,105 @@
 
 #include "../include/KDBTreeEfficient.h"
 
-KDBTreeEfficient::KDBTreeEfficient(Point *points, int level, Area &area, int from, int to, int capacity) {
+template<typename T>
+T BasicKDBTreeEfficient<T>::splitValue(PointType *points, int level, int from, int to, int capacity) {
+    if (to - from < capacity) {
+        return T{};
+    }
+    return median(points, level % 2 == 0, from, to + 1, (from + to) / 2);
+}
+
+template<typename T>
+BasicKDBTreeEfficient<T>::BasicKDBTreeEfficient(PointType *points, int level, AreaType &area, int from, int to,
+                                                int capacity)
+        : BasicKDBTreeEfficient(points, level, area, from, to, capacity,
+                                splitValue(points, level, from, to, capacity)) {
+}
+
+template<typename T>
+BasicKDBTreeEfficient<T>::BasicKDBTreeEfficient(PointType *points, int level, AreaType &area, int from, int to,
+                                                int capacity, WorkStealingPool &pool)
+        : BasicKDBTreeEfficient(points, level, area, from, to, capacity,
+                                to - from < capacity ? T{}
+                                                     : parallelMedian(pool, points, level % 2 == 0, from, to + 1,
+                                                                      (from + to) / 2)) {
+}
+
+template<typename T>
+BasicKDBTreeEfficient<T>::BasicKDBTreeEfficient(PointType *points, int level, AreaType &area, int from, int to,
+                                                int capacity, NodeArena &arena)
+        : BasicKDBTreeEfficient(points, level, area, from, to, capacity) {
+    this->arena = &arena;
+}
+
+template<typename T>
+BasicKDBTreeEfficient<T>::BasicKDBTreeEfficient(PointType *points, int level, AreaType &area, int from, int to,
+                                                const CapacityProfile &profile)
+        : BasicKDBTreeEfficient(points, level, area, from, to, profile.capacityFor(to - from + 1)) {
+}
+
+template<typename T>
+BasicKDBTreeEfficient<T>::BasicKDBTreeEfficient(PointType *points, int level, AreaType &area, int from, int to,
+                                                int capacity, T medianValue) {
     this->points = points;
     this->area = area;
     this->capacity = capacity;
     this->from = from;
     this->to = to;
     if (level % 2 == 0) {
-        this->xMedian = median(points, true, from, to);
-        this->yMedian = 0.0;
+        this->xMedian = medianValue;
+        this->yMedian = T{};
     } else {
-        this->yMedian = median(points, false, from, to);
-        this->xMedian = 0.0;
+        this->yMedian = medianValue;
+        this->xMedian = T{};
     }
 }
 
-KDBTreeEfficient::~KDBTreeEfficient() {
-    delete leftChild;
-    delete rightChild;
+template<typename T>
+BasicKDBTreeEfficient<T>::~BasicKDBTreeEfficient() {
+    // nodes and aggregates of an arena are freed together with the arena
+    if (arena == nullptr) {
+        delete leftChild;
+        delete rightChild;
+        delete summary;
+    }
+    if (ownsColumns) {
+        free(xs);
+        free(ys);
+    }
 }
 
-void KDBTreeEfficient::setVerticalChildren(int level) {
+template<typename T>
+void BasicKDBTreeEfficient<T>::setVerticalChildren(int level) {
     int midIndex = (from + to) / 2;
-    Area leftArea = Area{this->area.xMin, this->xMedian, this->area.yMin, this->area.yMax};
-    Area rightArea = Area{this->xMedian, this->area.xMax, this->area.yMin, this->area.yMax};
-    this->leftChild = new KDBTreeEfficient(this->points, level + 1, leftArea, from, midIndex, capacity);
-    this->rightChild = new KDBTreeEfficient(this->points, level + 1, rightArea, midIndex + 1, to, capacity);
+    AreaType leftArea = AreaType{this->area.xMin, this->xMedian, this->area.yMin, this->area.yMax};
+    AreaType rightArea = AreaType{this->xMedian, this->area.xMax, this->area.yMin, this->area.yMax};
+    this->leftChild = new(arena) BasicKDBTreeEfficient(this->points, level + 1, leftArea, from, midIndex,
+                                                       capacity);
+    this->rightChild = new(arena) BasicKDBTreeEfficient(this->points, level + 1, rightArea, midIndex + 1, to,
+                                                        capacity);
+    this->leftChild->arena = this->rightChild->arena = arena;
 }
 
-void KDBTreeEfficient::setHorizontalChildren(int level) {
+template<typename T>
+void BasicKDBTreeEfficient<T>::setHorizontalChildren(int level) {
     int midIndex = (from + to) / 2;
-    Area lowerArea = Area{this->area.xMin, this->area.xMax, this->area.yMin, this->yMedian};
-    Area higherArea = Area{this->area.xMin, this->area.xMax, this->yMedian, this->area.yMax};
-    this->leftChild = new KDBTreeEfficient(this->points, level + 1, lowerArea, from, midIndex, capacity);
-    this->rightChild = new KDBTreeEfficient(this->points, level + 1, higherArea, midIndex + 1, to, capacity);
+    AreaType lowerArea = AreaType{this->area.xMin, this->area.xMax, this->area.yMin, this->yMedian};
+    AreaType higherArea = AreaType{this->area.xMin, this->area.xMax, this->yMedian, this->area.yMax};
+    this->leftChild = new(arena) BasicKDBTreeEfficient(this->points, level + 1, lowerArea, from, midIndex,
+                                                       capacity);
+    this->rightChild = new(arena) BasicKDBTreeEfficient(this->points, level + 1, higherArea, midIndex + 1, to,
+                                                        capacity);
+    this->leftChild->arena = this->rightChild->arena = arena;
 }
 
-void KDBTreeEfficient::buildTree() {
+template<typename T>
+void BasicKDBTreeEfficient<T>::buildTree() {
     buildTree(0);
 }
 
-void KDBTreeEfficient::buildTree(int level) {
+template<typename T>
+void BasicKDBTreeEfficient<T>::buildTree(int level) {
     if (this->to - this->from >= capacity) {
         if (level % 2 == 0) {
             // vertical split
@@ -58,18 +116,89 @@ void KDBTreeEfficient::buildTree(int level) {
     }
 }
 
-bool KDBTreeEfficient::contains(Point point) {
-    double pointX = point.x;
-    double pointY = point.y;
-    KDBTreeEfficient *current = this;
-    int level = 0;
+template<typename T>
+void BasicKDBTreeEfficient<T>::buildTree(WorkStealingPool &pool) {
+    buildTree(0, pool);
+}
+
+template<typename T>
+void BasicKDBTreeEfficient<T>::buildTree(int level, WorkStealingPool &pool) {
+    // an arena is not thread safe
+    if (this->to - this->from < max(PARALLEL_BUILD_GRAIN, capacity) || arena != nullptr) {
+        buildTree(level);
+        return;
+    }
+    this->setChildren(level, pool);
+    WorkStealingPool::TaskGroup group;
+    pool.spawn(group, [this, level, &pool] { this->leftChild->buildTree(level + 1, pool); });
+    this->rightChild->buildTree(level + 1, pool);
+    pool.wait(group);
+}
+
+template<typename T>
+void BasicKDBTreeEfficient<T>::setChildren(int level, WorkStealingPool &pool) {
+    int midIndex = (from + to) / 2;
+    AreaType leftArea{}, rightArea{};
+    if (level % 2 == 0) {
+        leftArea = AreaType{this->area.xMin, this->xMedian, this->area.yMin, this->area.yMax};
+        rightArea = AreaType{this->xMedian, this->area.xMax, this->area.yMin, this->area.yMax};
+    } else {
+        leftArea = AreaType{this->area.xMin, this->area.xMax, this->area.yMin, this->yMedian};
+        rightArea = AreaType{this->area.xMin, this->area.xMax, this->yMedian, this->area.yMax};
+    }
+    if (midIndex - from > PARALLEL_PARTITION_THRESHOLD) {
+        // both halves are disjoint, so their selections can run at the same time
+        bool x = (level + 1) % 2 == 0;
+        T leftMedian, rightMedian;
+        WorkStealingPool::TaskGroup group;
+        pool.spawn(group, [&] {
+            leftMedian = parallelMedian(pool, points, x, from, midIndex + 1, (from + midIndex) / 2);
+        });
+        rightMedian = parallelMedian(pool, points, x, midIndex + 1, to + 1, (midIndex + 1 + to) / 2);
+        pool.wait(group);
+        this->leftChild = new BasicKDBTreeEfficient(this->points, level + 1, leftArea, from, midIndex, capacity,
+                                                    leftMedian);
+        this->rightChild = new BasicKDBTreeEfficient(this->points, level + 1, rightArea, midIndex + 1, to, capacity,
+                                                     rightMedian);
+    } else {
+        this->leftChild = new BasicKDBTreeEfficient(this->points, level + 1, leftArea, from, midIndex, capacity);
+        this->rightChild = new BasicKDBTreeEfficient(this->points, level + 1, rightArea, midIndex + 1, to,
+                                                     capacity);
+    }
+}
+
+template<typename T>
+bool BasicKDBTreeEfficient<T>::contains(PointType point) {
+    return containsHelper(point, 0);
+}
+
+template<typename T>
+bool BasicKDBTreeEfficient<T>::containsHelper(const PointType &point, int level) {
+    BasicKDBTreeEfficient *current = this;
     while (!current->isLeaf()) {
-        if (level % 2 == 0) {
-            current = current->xMedian >= pointX ? current->leftChild : current->rightChild;
+        T coordinate = level % 2 == 0 ? point.x : point.y;
+        T medianValue = level % 2 == 0 ? current->xMedian : current->yMedian;
+        level++;
+        if (coordinate == medianValue) {
+            // points equal to the median may lie in both children
+            if (current->leftChild->containsHelper(point, level)) {
+                return true;
+            }
+            current = current->rightChild;
         } else {
-            current = current->yMedian >= pointY ? current->leftChild : current->rightChild;
+            current = coordinate < medianValue ? current->leftChild : current->rightChild;
+        }
+    }
+    if constexpr (LEAF_SCAN) {
+        if (current->xs != nullptr) {
+            for (int start = current->from; start <= current->to; start += LEAF_SCAN_BLOCK) {
+                int count = min(LEAF_SCAN_BLOCK, current->to - start + 1);
+                if (leafEqualMask(current->xs + start, current->ys + start, count, point.x, point.y) != 0) {
+                    return true;
+                }
+            }
+            return false;
         }
-        level++;
     }
     for (int i = current->from; i <= current->to; i++) {
         if (current->points[i] == point) return true;
@@ -77,11 +206,27 @@ bool KDBTreeEfficient::contains(Point point) {
     return false;
 }
 
-bool KDBTreeEfficient::isLeaf() const {
+template<typename T>
+FrozenKDTree BasicKDBTreeEfficient<T>::freeze() const {
+    if constexpr (std::is_same_v<T, double>) {
+        return FrozenKDTree(this->points + this->from, this->to - this->from + 1, this->capacity);
+    } else {
+        vector<Point> converted;
+        converted.reserve(this->to - this->from + 1);
+        for (int i = this->from; i <= this->to; i++) {
+            converted.push_back(Point{(double) this->points[i].x, (double) this->points[i].y});
+        }
+        return FrozenKDTree(converted.data(), (int) converted.size(), this->capacity);
+    }
+}
+
+template<typename T>
+bool BasicKDBTreeEfficient<T>::isLeaf() const {
     return this->to - this->from < this->capacity;
 }
 
-int KDBTreeEfficient::getHeight() {
+template<typename T>
+int BasicKDBTreeEfficient<T>::getHeight() {
     if (this->isLeaf()) {
         return 1;
     }
@@ -97,93 +242,220 @@ int KDBTreeEfficient::getHeight() {
     }
 }
 
-std::list<Point> KDBTreeEfficient::query(Area queryRectangle) {
-    list<Point> result;
-    if (this->isLeaf()) {
-        if (containsPoint(queryRectangle, this->points[from])) {
-            for (int i = this->from; i <= this->to; i++) {
-                if (containsPoint(queryRectangle, this->points[i])) {
-                    result.push_back(this->points[i]);
+template<typename T>
+std::list<BasicPoint<T>> BasicKDBTreeEfficient<T>::query(AreaType queryRectangle) {
+    list<PointType> result;
+    query(queryRectangle, back_inserter(result));
+    return result;
+}
+
+template<typename T>
+void BasicKDBTreeEfficient<T>::query(AreaType &queryRectangle, vector<PointType> &result) {
+    query(queryRectangle, back_inserter(result));
+}
+
+template<typename T>
+long BasicKDBTreeEfficient<T>::count(AreaType &queryRectangle) {
+    if (containsArea(queryRectangle, this->area)) {
+        return to - from + 1;
+    } else if (this->isLeaf()) {
+        long result = 0;
+        if constexpr (LEAF_SCAN) {
+            if (this->xs != nullptr) {
+                for (int start = this->from; start <= this->to; start += LEAF_SCAN_BLOCK) {
+                    int count = min(LEAF_SCAN_BLOCK, this->to - start + 1);
+                    result += __builtin_popcountll(leafRangeMask(this->xs + start, this->ys + start, count,
+                                                                 queryRectangle));
                 }
+                return result;
             }
         }
-        return result;
-    } else if (containsArea(queryRectangle, this->area)) {
-        result.insert(result.end(), this->points + from, this->points + to + 1);
+        for (int i = this->from; i <= this->to; i++) {
+            result += containsPoint(queryRectangle, this->points[i]);
+        }
         return result;
     }
 
+    long result = 0;
     if (this->leftChild != nullptr && intersects(queryRectangle, this->leftChild->area)) {
-        list<Point> childResult = this->leftChild->query(queryRectangle);
-        childResult.insert(result.end(), childResult.begin(), childResult.end());
+        result += this->leftChild->count(queryRectangle);
     }
     if (this->rightChild != nullptr && intersects(queryRectangle, this->rightChild->area)) {
-        list<Point> childResult = this->rightChild->query(queryRectangle);
-        childResult.insert(result.end(), childResult.begin(), childResult.end());
+        result += this->rightChild->count(queryRectangle);
     }
     return result;
 }
 
-KDBTreeEfficient *KDBTreeEfficient::getLeftChild() {
-    return this->leftChild;
+template<typename T>
+void BasicKDBTreeEfficient<T>::buildColumns() {
+    if (!LEAF_SCAN || this->xs != nullptr) {
+        return;
+    }
+    // padded with NaN, which fails every comparison, so kernels can read whole vectors past the last point
+    size_t length = ((size_t) this->to + 1 + LEAF_SCAN_PADDING + 7) / 8 * 8;
+    auto *xColumn = (double *) aligned_alloc(64, length * sizeof(double));
+    auto *yColumn = (double *) aligned_alloc(64, length * sizeof(double));
+    std::fill(xColumn, xColumn + length, std::numeric_limits<double>::quiet_NaN());
+    std::fill(yColumn, yColumn + length, std::numeric_limits<double>::quiet_NaN());
+    for (int i = this->from; i <= this->to; i++) {
+        xColumn[i] = this->points[i].x;
+        yColumn[i] = this->points[i].y;
+    }
+    setColumns(xColumn, yColumn);
+    this->ownsColumns = true;
 }
 
-KDBTreeEfficient *KDBTreeEfficient::getRightChild() {
-    return this->rightChild;
+template<typename T>
+void BasicKDBTreeEfficient<T>::setColumns(double *xColumn, double *yColumn) {
+    this->xs = xColumn;
+    this->ys = yColumn;
+    if (this->leftChild != nullptr) {
+        this->leftChild->setColumns(xColumn, yColumn);
+    }
+    if (this->rightChild != nullptr) {
+        this->rightChild->setColumns(xColumn, yColumn);
+    }
 }
 
-Point *KDBTreeEfficient::getPoints() {
-    return this->points;
+template<typename T>
+bool BasicKDBTreeEfficient<T>::hasColumns() const {
+    return this->xs != nullptr;
 }
 
-vector<Point> KDBTreeEfficient::kNearestNeighbors(Point &queryPoint, int k) {
-    vector<Point> result;
-    result.reserve(k);
-    CompareKDBTree compareFunction(queryPoint);
-    std::priority_queue<KDBTreeEfficient *, vector<KDBTreeEfficient *>, CompareKDBTree> queue(compareFunction);
-    kNearestNeighborsHelper(this, k, queue, result, queryPoint);
+template<typename T>
+void BasicKDBTreeEfficient<T>::tightenAreas() {
+    if (this->isLeaf()) {
+        this->area = boundingBox(this->points + from, this->points + to + 1);
+        return;
+    }
+    this->leftChild->tightenAreas();
+    this->rightChild->tightenAreas();
+    this->area = enclosingArea(this->leftChild->area, this->rightChild->area);
+}
+
+template<typename T>
+long BasicKDBTreeEfficient<T>::queryVisits(AreaType &queryRectangle) {
+    // same pruning as queryHelper()
+    if (this->isLeaf() || containsArea(queryRectangle, this->area)) {
+        return 1;
+    }
+    long result = 1;
+    if (this->leftChild != nullptr && intersects(queryRectangle, this->leftChild->area)) {
+        result += this->leftChild->queryVisits(queryRectangle);
+    }
+    if (this->rightChild != nullptr && intersects(queryRectangle, this->rightChild->area)) {
+        result += this->rightChild->queryVisits(queryRectangle);
+    }
     return result;
 }
 
-void KDBTreeEfficient::kNearestNeighborsHelper(KDBTreeEfficient *node, int k,
-                                               priority_queue<KDBTreeEfficient *, std::vector<KDBTreeEfficient *>, CompareKDBTree> &queue,
-                                               vector<Point> &result, Point &queryPoint) {
-    if (node == nullptr) {
+template<typename T>
+void BasicKDBTreeEfficient<T>::buildAggregates(BasicWeightFunction<T> weightFunction) {
+    this->weight = weightFunction;
+    if (this->summary == nullptr) {
+        this->summary = new(arena) Aggregate;
+    }
+    *this->summary = Aggregate{};
+    if (this->isLeaf()) {
+        for (int i = this->from; i <= this->to; i++) {
+            this->summary->add(weightFunction(this->points[i]));
+        }
         return;
     }
+    this->leftChild->buildAggregates(weightFunction);
+    this->rightChild->buildAggregates(weightFunction);
+    this->summary->add(*this->leftChild->summary);
+    this->summary->add(*this->rightChild->summary);
+}
 
-    if (node->isLeaf()) {
-        queue.push(node);
-    } else {
-        queue.push(node->leftChild);
-        queue.push(node->rightChild);
-    }
-
-    while (!queue.empty() && result.size() < k) {
-        KDBTreeEfficient *current = queue.top();
-        queue.pop();
-        if (current->isLeaf()) {
-            std::sort(current->points + current->from, current->points + current->to,
-                      [queryPoint](const Point &A, const Point &B) {
-                          return pointDistance(queryPoint, A) < pointDistance(queryPoint, B);
-                      });
-            for (int i = current->from; i <= current->to; i++) {
-                if (result.size() < k) {
-                    result.push_back(current->points[i]);
-                }
+template<typename T>
+Aggregate BasicKDBTreeEfficient<T>::aggregate(AreaType &queryRectangle) {
+    Aggregate result;
+    aggregateHelper(queryRectangle, result);
+    return result;
+}
+
+template<typename T>
+void BasicKDBTreeEfficient<T>::aggregateHelper(AreaType &queryRectangle, Aggregate &result) {
+    if (containsArea(queryRectangle, this->area)) {
+        result.add(*this->summary);
+        return;
+    } else if (this->isLeaf()) {
+        for (int i = this->from; i <= this->to; i++) {
+            if (containsPoint(queryRectangle, this->points[i])) {
+                result.add(this->weight(this->points[i]));
             }
-        } else {
-            kNearestNeighborsHelper(current, k, queue, result, queryPoint);
         }
+        return;
     }
-}
 
+    if (intersects(queryRectangle, this->leftChild->area)) {
+        this->leftChild->aggregateHelper(queryRectangle, result);
+    }
+    if (intersects(queryRectangle, this->rightChild->area)) {
+        this->rightChild->aggregateHelper(queryRectangle, result);
+    }
+}
 
+template<typename T>
+BasicKDBTreeEfficient<T> *BasicKDBTreeEfficient<T>::getLeftChild() {
+    return this->leftChild;
+}
 
+template<typename T>
+BasicKDBTreeEfficient<T> *BasicKDBTreeEfficient<T>::getRightChild() {
+    return this->rightChild;
+}
 
+template<typename T>
+BasicPoint<T> *BasicKDBTreeEfficient<T>::getPoints() {
+    return this->points;
+}
 
+template<typename T>
+vector<BasicPoint<T>> BasicKDBTreeEfficient<T>::kNearestNeighbors(const PointType &queryPoint, int k) const {
+    vector<PointType> result;
+    Scratch scratch;
+    kNearestNeighbors(queryPoint, k, scratch, result);
+    return result;
+}
 
+template<typename T>
+void BasicKDBTreeEfficient<T>::kNearestNeighbors(const PointType &queryPoint, int k, Scratch &scratch,
+                                                 vector<PointType> &result) const {
+    scratch.reset(k);
+    kNearestNeighborsHelper(queryPoint, scratch);
+    scratch.extractSorted(result);
+}
 
+template<typename T>
+void BasicKDBTreeEfficient<T>::kNearestNeighborsHelper(const PointType &queryPoint, Scratch &scratch) const {
+    scratch.visit();
+    if (this->isLeaf()) {
+        for (int i = this->from; i <= this->to; i++) {
+            scratch.offer(this->points[i], pointDistance(this->points[i], queryPoint));
+        }
+        return;
+    }
+    // visit the closer child first, the second one is often pruned by then
+    BasicKDBTreeEfficient *nearChild = this->leftChild;
+    BasicKDBTreeEfficient *farChild = this->rightChild;
+    SquaredDistance<T> nearDistance = sqDistanceFrom(nearChild->area, queryPoint);
+    SquaredDistance<T> farDistance = sqDistanceFrom(farChild->area, queryPoint);
+    if (farDistance < nearDistance) {
+        swap(nearChild, farChild);
+        swap(nearDistance, farDistance);
+    }
+    if (nearDistance < scratch.radius()) {
+        nearChild->kNearestNeighborsHelper(queryPoint, scratch);
+    }
+    if (farDistance < scratch.radius()) {
+        farChild->kNearestNeighborsHelper(queryPoint, scratch);
+    }
+}
 
+template class BasicKDBTreeEfficient<double>;
 
+template class BasicKDBTreeEfficient<float>;
 
+template class BasicKDBTreeEfficient<int32_t>;
@@ -5,56 +5,93 @@
 #include "../include/KDTreeEfficient.h"
 
 
-KDTreeEfficient::KDTreeEfficient(Point *points, Area &area, int size) {
+template<typename T>
+BasicKDTreeEfficient<T>::BasicKDTreeEfficient(PointType *points, AreaType &area, int size) {
     this->points = points;
     this->area = area;
     this->from = 0;
-    this->to = size;
-    this->xMedian = median(points, true, from, to);
-    this->yMedian = 0.0;
+    this->to = size - 1;
+    this->xMedian = median(points, true, from, size, (size - 1) / 2);
+    this->yMedian = T{};
 }
 
-KDTreeEfficient::KDTreeEfficient(Point *points, int level, Area &area, int from, int to) {
+template<typename T>
+BasicKDTreeEfficient<T>::BasicKDTreeEfficient(PointType *points, AreaType &area, int size,
+                                              WorkStealingPool &pool) {
+    this->points = points;
+    this->area = area;
+    this->from = 0;
+    this->to = size - 1;
+    this->xMedian = parallelMedian(pool, points, true, from, size, (size - 1) / 2);
+    this->yMedian = T{};
+}
+
+template<typename T>
+BasicKDTreeEfficient<T>::BasicKDTreeEfficient(PointType *points, AreaType &area, int size, NodeArena &arena)
+        : BasicKDTreeEfficient(points, area, size) {
+    this->arena = &arena;
+}
+
+template<typename T>
+BasicKDTreeEfficient<T>::BasicKDTreeEfficient(PointType *points, int level, AreaType &area, int from, int to)
+        : BasicKDTreeEfficient(points, level, area, from, to,
+                               median(points, level % 2 == 0, from, to + 1, (from + to) / 2)) {
+}
+
+template<typename T>
+BasicKDTreeEfficient<T>::BasicKDTreeEfficient(PointType *points, int level, AreaType &area, int from, int to,
+                                              T medianValue) {
     this->points = points;
     this->area = area;
     this->from = from;
     this->to = to;
     if (level % 2 == 0) {
-        this->xMedian = median(points, true, from, to);
-        this->yMedian = 0.0;
+        this->xMedian = medianValue;
+        this->yMedian = T{};
     } else {
-        this->yMedian = median(points, false, from, to);
-        this->xMedian = 0.0;
+        this->yMedian = medianValue;
+        this->xMedian = T{};
     }
 }
 
-KDTreeEfficient::~KDTreeEfficient() {
-    delete leftChild;
-    delete rightChild;
+template<typename T>
+BasicKDTreeEfficient<T>::~BasicKDTreeEfficient() {
+    // nodes and aggregates of an arena are freed together with the arena
+    if (arena == nullptr) {
+        delete leftChild;
+        delete rightChild;
+        delete summary;
+    }
 }
 
-void KDTreeEfficient::setVerticalChildren(int level) {
+template<typename T>
+void BasicKDTreeEfficient<T>::setVerticalChildren(int level) {
     int midIndex = (from + to) / 2;
-    Area leftArea = Area{this->area.xMin, this->xMedian, this->area.yMin, this->area.yMax};
-    Area rightArea = Area{this->xMedian, this->area.xMax, this->area.yMin, this->area.yMax};
+    AreaType leftArea = AreaType{this->area.xMin, this->xMedian, this->area.yMin, this->area.yMax};
+    AreaType rightArea = AreaType{this->xMedian, this->area.xMax, this->area.yMin, this->area.yMax};
 
-    this->leftChild = new KDTreeEfficient(this->points, level + 1, leftArea, from, midIndex);
-    this->rightChild = new KDTreeEfficient(this->points, level + 1, rightArea, midIndex + 1, to);
+    this->leftChild = new(arena) BasicKDTreeEfficient(this->points, level + 1, leftArea, from, midIndex);
+    this->rightChild = new(arena) BasicKDTreeEfficient(this->points, level + 1, rightArea, midIndex + 1, to);
+    this->leftChild->arena = this->rightChild->arena = arena;
 }
 
-void KDTreeEfficient::setHorizontalChildren(int level) {
+template<typename T>
+void BasicKDTreeEfficient<T>::setHorizontalChildren(int level) {
     int midIndex = (from + to) / 2;
-    Area lowerArea = Area{this->area.xMin, this->area.xMax, this->area.yMin, this->yMedian};
-    Area higherArea = Area{this->area.xMin, this->area.xMax, this->yMedian, this->area.yMax};
-    this->leftChild = new KDTreeEfficient(this->points, level + 1, lowerArea, from, midIndex);
-    this->rightChild = new KDTreeEfficient(this->points, level + 1, higherArea, midIndex + 1, to);
+    AreaType lowerArea = AreaType{this->area.xMin, this->area.xMax, this->area.yMin, this->yMedian};
+    AreaType higherArea = AreaType{this->area.xMin, this->area.xMax, this->yMedian, this->area.yMax};
+    this->leftChild = new(arena) BasicKDTreeEfficient(this->points, level + 1, lowerArea, from, midIndex);
+    this->rightChild = new(arena) BasicKDTreeEfficient(this->points, level + 1, higherArea, midIndex + 1, to);
+    this->leftChild->arena = this->rightChild->arena = arena;
 }
 
-void KDTreeEfficient::buildTree() {
+template<typename T>
+void BasicKDTreeEfficient<T>::buildTree() {
     buildTree(0);
 }
 
-void KDTreeEfficient::buildTree(int level) {
+template<typename T>
+void BasicKDTreeEfficient<T>::buildTree(int level) {
     if (this->to - this->from > 0) {
         if (level % 2 == 0) {
             // vertical split
@@ -68,27 +105,106 @@ void KDTreeEfficient::buildTree(int level) {
     }
 }
 
-bool KDTreeEfficient::contains(Point point) {
-    double pointX = point.x;
-    double pointY = point.y;
-    KDTreeEfficient *current = this;
-    int level = 0;
+template<typename T>
+void BasicKDTreeEfficient<T>::buildTree(WorkStealingPool &pool) {
+    buildTree(0, pool);
+}
+
+template<typename T>
+void BasicKDTreeEfficient<T>::buildTree(int level, WorkStealingPool &pool) {
+    // an arena is not thread safe
+    if (this->to - this->from < PARALLEL_BUILD_GRAIN || arena != nullptr) {
+        buildTree(level);
+        return;
+    }
+    this->setChildren(level, pool);
+    WorkStealingPool::TaskGroup group;
+    pool.spawn(group, [this, level, &pool] { this->leftChild->buildTree(level + 1, pool); });
+    this->rightChild->buildTree(level + 1, pool);
+    pool.wait(group);
+}
+
+template<typename T>
+void BasicKDTreeEfficient<T>::setChildren(int level, WorkStealingPool &pool) {
+    int midIndex = (from + to) / 2;
+    AreaType leftArea{}, rightArea{};
+    if (level % 2 == 0) {
+        leftArea = AreaType{this->area.xMin, this->xMedian, this->area.yMin, this->area.yMax};
+        rightArea = AreaType{this->xMedian, this->area.xMax, this->area.yMin, this->area.yMax};
+    } else {
+        leftArea = AreaType{this->area.xMin, this->area.xMax, this->area.yMin, this->yMedian};
+        rightArea = AreaType{this->area.xMin, this->area.xMax, this->yMedian, this->area.yMax};
+    }
+    bool x = (level + 1) % 2 == 0;
+    if (midIndex - from > PARALLEL_PARTITION_THRESHOLD) {
+        // both halves are disjoint, so their selections can run at the same time
+        T leftMedian, rightMedian;
+        WorkStealingPool::TaskGroup group;
+        pool.spawn(group, [&] {
+            leftMedian = parallelMedian(pool, points, x, from, midIndex + 1, (from + midIndex) / 2);
+        });
+        rightMedian = parallelMedian(pool, points, x, midIndex + 1, to + 1, (midIndex + 1 + to) / 2);
+        pool.wait(group);
+        this->leftChild = new BasicKDTreeEfficient(this->points, level + 1, leftArea, from, midIndex, leftMedian);
+        this->rightChild = new BasicKDTreeEfficient(this->points, level + 1, rightArea, midIndex + 1, to,
+                                                    rightMedian);
+    } else {
+        this->leftChild = new BasicKDTreeEfficient(this->points, level + 1, leftArea, from, midIndex);
+        this->rightChild = new BasicKDTreeEfficient(this->points, level + 1, rightArea, midIndex + 1, to);
+    }
+}
+
+template<typename T>
+bool BasicKDTreeEfficient<T>::contains(PointType point) {
+    return containsHelper(point, 0);
+}
+
+template<typename T>
+bool BasicKDTreeEfficient<T>::containsHelper(const PointType &point, int level) {
+    BasicKDTreeEfficient *current = this;
     while (!current->isLeaf()) {
-        if (level % 2 == 0) {
-            current = current->xMedian >= pointX ? current->leftChild : current->rightChild;
+        T coordinate = level % 2 == 0 ? point.x : point.y;
+        T medianValue = level % 2 == 0 ? current->xMedian : current->yMedian;
+        level++;
+        if (coordinate == medianValue) {
+            // points equal to the median may lie in both children
+            if (current->leftChild->containsHelper(point, level)) {
+                return true;
+            }
+            current = current->rightChild;
         } else {
-            current = current->yMedian >= pointY ? current->leftChild : current->rightChild;
+            current = coordinate < medianValue ? current->leftChild : current->rightChild;
         }
-        level++;
     }
     return current->points[current->from] == point;
 }
 
-bool KDTreeEfficient::isLeaf() const {
+template<typename T>
+FrozenKDTree BasicKDTreeEfficient<T>::freeze() const {
+    if constexpr (std::is_same_v<T, double>) {
+        return FrozenKDTree(this->points + this->from, this->to - this->from + 1, 1);
+    } else {
+        vector<Point> converted;
+        converted.reserve(this->to - this->from + 1);
+        for (int i = this->from; i <= this->to; i++) {
+            converted.push_back(Point{(double) this->points[i].x, (double) this->points[i].y});
+        }
+        return FrozenKDTree(converted.data(), (int) converted.size(), 1);
+    }
+}
+
+template<typename T>
+bool BasicKDTreeEfficient<T>::isLeaf() const {
     return this->from == this->to;
 }
 
-int KDTreeEfficient::getHeight() {
+template<typename T>
+BasicPoint<T> *BasicKDTreeEfficient<T>::getPoints() {
+    return this->points;
+}
+
+template<typename T>
+int BasicKDTreeEfficient<T>::getHeight() {
     if (this->isLeaf()) {
         return 1;
     }
@@ -104,71 +220,150 @@ int KDTreeEfficient::getHeight() {
     }
 }
 
-std::list<Point> KDTreeEfficient::query(Area queryRectangle) {
-    list<Point> result;
+template<typename T>
+std::list<BasicPoint<T>> BasicKDTreeEfficient<T>::query(AreaType queryRectangle) {
+    list<PointType> result;
+    query(queryRectangle, back_inserter(result));
+    return result;
+}
+
+template<typename T>
+void BasicKDTreeEfficient<T>::query(AreaType &queryRectangle, vector<PointType> &result) {
+    query(queryRectangle, back_inserter(result));
+}
+
+template<typename T>
+long BasicKDTreeEfficient<T>::count(AreaType &queryRectangle) {
     if (this->isLeaf()) {
-        if (containsPoint(queryRectangle, this->points[from])) {
-            result.push_back(this->points[from]);
-        }
-        return result;
+        return containsPoint(queryRectangle, this->points[from]) ? 1 : 0;
     } else if (containsArea(queryRectangle, this->area)) {
-        result.insert(result.end(), this->points + from, this->points + to + 1);
-        return result;
+        return to - from + 1;
     }
 
+    long result = 0;
     if (this->leftChild != nullptr && intersects(queryRectangle, this->leftChild->area)) {
-        list<Point> childResult = this->leftChild->query(queryRectangle);
-        childResult.insert(result.end(), childResult.begin(), childResult.end());
+        result += this->leftChild->count(queryRectangle);
     }
     if (this->rightChild != nullptr && intersects(queryRectangle, this->rightChild->area)) {
-        list<Point> childResult = this->rightChild->query(queryRectangle);
-        childResult.insert(result.end(), childResult.begin(), childResult.end());
+        result += this->rightChild->count(queryRectangle);
     }
     return result;
 }
 
-vector<Point> KDTreeEfficient::kNearestNeighbors(Point &queryPoint, int k) {
-    vector<Point> result;
-    result.reserve(k);
-    CompareKDETree compareFunction(queryPoint);
-    std::priority_queue<KDTreeEfficient *, vector<KDTreeEfficient *>, CompareKDETree> queue(compareFunction);
-    kNearestNeighborsHelper(this, k, queue, result);
-    return result;
-}
-
-void KDTreeEfficient::kNearestNeighborsHelper(KDTreeEfficient *node, int k,
-                                              priority_queue<KDTreeEfficient *, std::vector<KDTreeEfficient *>, CompareKDETree> &queue,
-                                              vector<Point> &result) {
-    if (node == nullptr) {
+template<typename T>
+void BasicKDTreeEfficient<T>::tightenAreas() {
+    if (this->isLeaf()) {
+        PointType &point = this->points[from];
+        this->area = AreaType{point.x, point.x, point.y, point.y};
         return;
     }
+    this->leftChild->tightenAreas();
+    this->rightChild->tightenAreas();
+    this->area = enclosingArea(this->leftChild->area, this->rightChild->area);
+}
 
-    if (node->isLeaf()) {
-        queue.push(node);
-    } else {
-        queue.push(node->leftChild);
-        queue.push(node->rightChild);
+template<typename T>
+long BasicKDTreeEfficient<T>::queryVisits(AreaType &queryRectangle) {
+    // same pruning as queryHelper()
+    if (this->isLeaf() || containsArea(queryRectangle, this->area)) {
+        return 1;
     }
-
-    while (!queue.empty() && result.size() < k) {
-        KDTreeEfficient *current = queue.top();
-        queue.pop();
-
-        if (current->isLeaf()) {
-            result.push_back(current->points[current->from]);
-        } else {
-            kNearestNeighborsHelper(current, k, queue, result);
-        }
+    long result = 1;
+    if (this->leftChild != nullptr && intersects(queryRectangle, this->leftChild->area)) {
+        result += this->leftChild->queryVisits(queryRectangle);
     }
+    if (this->rightChild != nullptr && intersects(queryRectangle, this->rightChild->area)) {
+        result += this->rightChild->queryVisits(queryRectangle);
+    }
+    return result;
 }
 
+template<typename T>
+void BasicKDTreeEfficient<T>::buildAggregates(BasicWeightFunction<T> weightFunction) {
+    this->weight = weightFunction;
+    if (this->summary == nullptr) {
+        this->summary = new(arena) Aggregate;
+    }
+    *this->summary = Aggregate{};
+    if (this->isLeaf()) {
+        this->summary->add(weightFunction(this->points[from]));
+        return;
+    }
+    this->leftChild->buildAggregates(weightFunction);
+    this->rightChild->buildAggregates(weightFunction);
+    this->summary->add(*this->leftChild->summary);
+    this->summary->add(*this->rightChild->summary);
+}
 
+template<typename T>
+Aggregate BasicKDTreeEfficient<T>::aggregate(AreaType &queryRectangle) {
+    Aggregate result;
+    aggregateHelper(queryRectangle, result);
+    return result;
+}
 
+template<typename T>
+void BasicKDTreeEfficient<T>::aggregateHelper(AreaType &queryRectangle, Aggregate &result) {
+    if (containsArea(queryRectangle, this->area)) {
+        result.add(*this->summary);
+        return;
+    } else if (this->isLeaf()) {
+        if (containsPoint(queryRectangle, this->points[from])) {
+            result.add(this->weight(this->points[from]));
+        }
+        return;
+    }
 
+    if (intersects(queryRectangle, this->leftChild->area)) {
+        this->leftChild->aggregateHelper(queryRectangle, result);
+    }
+    if (intersects(queryRectangle, this->rightChild->area)) {
+        this->rightChild->aggregateHelper(queryRectangle, result);
+    }
+}
 
+template<typename T>
+vector<BasicPoint<T>> BasicKDTreeEfficient<T>::kNearestNeighbors(const PointType &queryPoint, int k) const {
+    vector<PointType> result;
+    Scratch scratch;
+    kNearestNeighbors(queryPoint, k, scratch, result);
+    return result;
+}
 
+template<typename T>
+void BasicKDTreeEfficient<T>::kNearestNeighbors(const PointType &queryPoint, int k, Scratch &scratch,
+                                             vector<PointType> &result) const {
+    scratch.reset(k);
+    kNearestNeighborsHelper(queryPoint, scratch);
+    scratch.extractSorted(result);
+}
 
+template<typename T>
+void BasicKDTreeEfficient<T>::kNearestNeighborsHelper(const PointType &queryPoint, Scratch &scratch) const {
+    scratch.visit();
+    if (this->isLeaf()) {
+        scratch.offer(this->points[from], pointDistance(this->points[from], queryPoint));
+        return;
+    }
+    // visit the closer child first, the second one is often pruned by then
+    BasicKDTreeEfficient *nearChild = this->leftChild;
+    BasicKDTreeEfficient *farChild = this->rightChild;
+    SquaredDistance<T> nearDistance = sqDistanceFrom(nearChild->area, queryPoint);
+    SquaredDistance<T> farDistance = sqDistanceFrom(farChild->area, queryPoint);
+    if (farDistance < nearDistance) {
+        swap(nearChild, farChild);
+        swap(nearDistance, farDistance);
+    }
+    if (nearDistance < scratch.radius()) {
+        nearChild->kNearestNeighborsHelper(queryPoint, scratch);
+    }
+    if (farDistance < scratch.radius()) {
+        farChild->kNearestNeighborsHelper(queryPoint, scratch);
+    }
+}
 
+template class BasicKDTreeEfficient<double>;
 
+template class BasicKDTreeEfficient<float>;
 
-
+template class BasicKDTreeEfficient<int32_t>;
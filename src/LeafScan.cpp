@@ -0,0 +1,162 @@
+//
+// Created by omarc on 12/01/2024.
+//
+
+#include "../include/LeafScan.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LEAF_SCAN_X86
+#endif
+
+/**
+ * @param count number of points of a block
+ * @return mask with the lowest count bits set
+ */
+static inline uint64_t blockMask(int count) {
+    return count >= 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << count) - 1;
+}
+
+static uint64_t rangeMaskScalar(const double *xs, const double *ys, int count, const Area &area) {
+    uint64_t mask = 0;
+    for (int i = 0; i < count; i++) {
+        bool inside = xs[i] >= area.xMin && ys[i] >= area.yMin && xs[i] <= area.xMax && ys[i] <= area.yMax;
+        mask |= (uint64_t) inside << i;
+    }
+    return mask;
+}
+
+static uint64_t equalMaskScalar(const double *xs, const double *ys, int count, double x, double y) {
+    uint64_t mask = 0;
+    for (int i = 0; i < count; i++) {
+        mask |= (uint64_t) (xs[i] == x && ys[i] == y) << i;
+    }
+    return mask;
+}
+
+#ifdef LEAF_SCAN_X86
+
+__attribute__((target("avx2")))
+static uint64_t rangeMaskAVX2(const double *xs, const double *ys, int count, const Area &area) {
+    __m256d xMin = _mm256_set1_pd(area.xMin), xMax = _mm256_set1_pd(area.xMax);
+    __m256d yMin = _mm256_set1_pd(area.yMin), yMax = _mm256_set1_pd(area.yMax);
+    uint64_t mask = 0;
+    for (int i = 0; i < count; i += 4) {
+        __m256d x = _mm256_loadu_pd(xs + i);
+        __m256d y = _mm256_loadu_pd(ys + i);
+        __m256d inside = _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(x, xMin, _CMP_GE_OQ),
+                                                     _mm256_cmp_pd(x, xMax, _CMP_LE_OQ)),
+                                       _mm256_and_pd(_mm256_cmp_pd(y, yMin, _CMP_GE_OQ),
+                                                     _mm256_cmp_pd(y, yMax, _CMP_LE_OQ)));
+        mask |= (uint64_t) _mm256_movemask_pd(inside) << i;
+    }
+    return mask & blockMask(count);
+}
+
+__attribute__((target("avx2")))
+static uint64_t equalMaskAVX2(const double *xs, const double *ys, int count, double x, double y) {
+    __m256d px = _mm256_set1_pd(x), py = _mm256_set1_pd(y);
+    uint64_t mask = 0;
+    for (int i = 0; i < count; i += 4) {
+        __m256d equal = _mm256_and_pd(_mm256_cmp_pd(_mm256_loadu_pd(xs + i), px, _CMP_EQ_OQ),
+                                      _mm256_cmp_pd(_mm256_loadu_pd(ys + i), py, _CMP_EQ_OQ));
+        mask |= (uint64_t) _mm256_movemask_pd(equal) << i;
+    }
+    return mask & blockMask(count);
+}
+
+__attribute__((target("avx512f")))
+static uint64_t rangeMaskAVX512(const double *xs, const double *ys, int count, const Area &area) {
+    __m512d xMin = _mm512_set1_pd(area.xMin), xMax = _mm512_set1_pd(area.xMax);
+    __m512d yMin = _mm512_set1_pd(area.yMin), yMax = _mm512_set1_pd(area.yMax);
+    uint64_t mask = 0;
+    for (int i = 0; i < count; i += 8) {
+        __m512d x = _mm512_loadu_pd(xs + i);
+        __m512d y = _mm512_loadu_pd(ys + i);
+        // each comparison only tests the lanes that passed the previous ones
+        __mmask8 inside = _mm512_cmp_pd_mask(x, xMin, _CMP_GE_OQ);
+        inside = _mm512_mask_cmp_pd_mask(inside, x, xMax, _CMP_LE_OQ);
+        inside = _mm512_mask_cmp_pd_mask(inside, y, yMin, _CMP_GE_OQ);
+        inside = _mm512_mask_cmp_pd_mask(inside, y, yMax, _CMP_LE_OQ);
+        mask |= (uint64_t) inside << i;
+    }
+    return mask & blockMask(count);
+}
+
+__attribute__((target("avx512f")))
+static uint64_t equalMaskAVX512(const double *xs, const double *ys, int count, double x, double y) {
+    __m512d px = _mm512_set1_pd(x), py = _mm512_set1_pd(y);
+    uint64_t mask = 0;
+    for (int i = 0; i < count; i += 8) {
+        __mmask8 equal = _mm512_cmp_pd_mask(_mm512_loadu_pd(xs + i), px, _CMP_EQ_OQ);
+        equal = _mm512_mask_cmp_pd_mask(equal, _mm512_loadu_pd(ys + i), py, _CMP_EQ_OQ);
+        mask |= (uint64_t) equal << i;
+    }
+    return mask & blockMask(count);
+}
+
+#endif
+
+/**
+ * @brief Kernel functions used by leafRangeMask() and leafEqualMask()
+ */
+struct LeafScanFunctions {
+    LeafScanKernel kernel;
+    uint64_t (*rangeMask)(const double *, const double *, int, const Area &);
+    uint64_t (*equalMask)(const double *, const double *, int, double, double);
+};
+
+static LeafScanFunctions functionsOf(LeafScanKernel kernel) {
+#ifdef LEAF_SCAN_X86
+    if (kernel == AVX512_KERNEL) {
+        return LeafScanFunctions{kernel, rangeMaskAVX512, equalMaskAVX512};
+    } else if (kernel == AVX2_KERNEL) {
+        return LeafScanFunctions{kernel, rangeMaskAVX2, equalMaskAVX2};
+    }
+#endif
+    return LeafScanFunctions{SCALAR_KERNEL, rangeMaskScalar, equalMaskScalar};
+}
+
+static bool isSupported(LeafScanKernel kernel) {
+#ifdef LEAF_SCAN_X86
+    // may run during static initialization, before the CPU model of libgcc is set up
+    __builtin_cpu_init();
+    if (kernel == AVX512_KERNEL) {
+        return __builtin_cpu_supports("avx512f");
+    } else if (kernel == AVX2_KERNEL) {
+        return __builtin_cpu_supports("avx2");
+    }
+#endif
+    return kernel == SCALAR_KERNEL;
+}
+
+LeafScanKernel bestLeafScanKernel() {
+    if (isSupported(AVX512_KERNEL)) {
+        return AVX512_KERNEL;
+    } else if (isSupported(AVX2_KERNEL)) {
+        return AVX2_KERNEL;
+    }
+    return SCALAR_KERNEL;
+}
+
+static LeafScanFunctions leafScanFunctions = functionsOf(bestLeafScanKernel());
+
+bool selectLeafScanKernel(LeafScanKernel kernel) {
+    if (!isSupported(kernel)) {
+        return false;
+    }
+    leafScanFunctions = functionsOf(kernel);
+    return true;
+}
+
+LeafScanKernel currentLeafScanKernel() {
+    return leafScanFunctions.kernel;
+}
+
+uint64_t leafRangeMask(const double *xs, const double *ys, int count, const Area &area) {
+    return leafScanFunctions.rangeMask(xs, ys, count, area);
+}
+
+uint64_t leafEqualMask(const double *xs, const double *ys, int count, double x, double y) {
+    return leafScanFunctions.equalMask(xs, ys, count, x, y);
+}
@@ -0,0 +1,178 @@
+//
+// Created by omarc on 12/01/2024.
+//
+
+#include "../include/LinearQuadTree.h"
+
+static constexpr uint64_t X_BITS = 0x5555555555555555ULL;  // even bit positions
+static constexpr uint64_t Y_BITS = 0xAAAAAAAAAAAAAAAAULL;  // odd bit positions
+
+LinearQuadTree::LinearQuadTree(Point *points, Area &area, int size) {
+    this->points = points;
+    this->area = area;
+    this->size = size;
+}
+
+uint32_t LinearQuadTree::quantize(double value, double min, double max) {
+    double relative = (value - min) / (max - min);
+    if (!(relative > 0.0)) {
+        return 0;
+    }
+    return (uint32_t) std::min((uint64_t) (relative * 4294967296.0), (uint64_t) UINT32_MAX);
+}
+
+uint64_t LinearQuadTree::spreadBits(uint32_t value) {
+    uint64_t x = value;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+    x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    x = (x | (x << 2)) & 0x3333333333333333ULL;
+    x = (x | (x << 1)) & 0x5555555555555555ULL;
+    return x;
+}
+
+uint64_t LinearQuadTree::mortonCode(const Point &point) const {
+    uint32_t x = quantize(point.x, area.xMin, area.xMax);
+    uint32_t y = quantize(point.y, area.yMin, area.yMax);
+    return spreadBits(x) | (spreadBits(y) << 1);
+}
+
+void LinearQuadTree::buildTree() {
+    vector<pair<uint64_t, Point>> sorted;
+    sorted.reserve(size);
+    for (int i = 0; i < size; i++) {
+        sorted.emplace_back(mortonCode(points[i]), points[i]);
+    }
+    sort(sorted.begin(), sorted.end(), [](const pair<uint64_t, Point> &a, const pair<uint64_t, Point> &b) {
+        return a.first < b.first;
+    });
+    codes.resize(size);
+    for (int i = 0; i < size; i++) {
+        codes[i] = sorted[i].first;
+        points[i] = sorted[i].second;
+    }
+}
+
+bool LinearQuadTree::contains(Point &point) const {
+    uint64_t code = mortonCode(point);
+    auto current = lower_bound(codes.begin(), codes.end(), code);
+    for (; current != codes.end() && *current == code; ++current) {
+        if (points[current - codes.begin()] == point) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LinearQuadTree::insideRectangle(uint64_t code, uint64_t zMin, uint64_t zMax) {
+    // the bits of one dimension compare in the same order as the coordinate itself
+    return (code & X_BITS) >= (zMin & X_BITS) && (code & X_BITS) <= (zMax & X_BITS)
+           && (code & Y_BITS) >= (zMin & Y_BITS) && (code & Y_BITS) <= (zMax & Y_BITS);
+}
+
+uint64_t LinearQuadTree::bigMin(uint64_t code, uint64_t zMin, uint64_t zMax) {
+    uint64_t result = 0;
+    for (int bit = 63; bit >= 0; bit--) {
+        uint64_t mask = 1ULL << bit;
+        // lower bits that belong to the same dimension as bit
+        uint64_t lowerBits = (bit % 2 == 0 ? X_BITS : Y_BITS) & (mask - 1);
+        int state = ((code & mask) ? 4 : 0) | ((zMin & mask) ? 2 : 0) | ((zMax & mask) ? 1 : 0);
+        switch (state) {
+            case 0b001:
+                // the rectangle is split here, continue in its lower half and remember the upper half
+                result = (zMin | mask) & ~lowerBits;
+                zMax = (zMax & ~mask) | lowerBits;
+                break;
+            case 0b011:
+                return zMin;
+            case 0b100:
+                return result;
+            case 0b101:
+                zMin = (zMin | mask) & ~lowerBits;
+                break;
+            default:
+                // 0b000 and 0b111: all codes agree on this bit
+                break;
+        }
+    }
+    return result;
+}
+
+std::list<Point> LinearQuadTree::query(Area &queryRectangle) const {
+    list<Point> result;
+    query(queryRectangle, back_inserter(result));
+    return result;
+}
+
+void LinearQuadTree::query(Area &queryRectangle, vector<Point> &result) const {
+    query(queryRectangle, back_inserter(result));
+}
+
+void LinearQuadTree::kNearestNeighborsHelper(const Point &queryPoint, KNNScratch &scratch, Area cell, int level,
+                                             uint64_t firstCode, int from, int to) const {
+    if (to - from <= LINEAR_QUADTREE_LEAF_CAPACITY || level == 32) {
+        for (int i = from; i < to; i++) {
+            scratch.offer(points[i], pointDistance(points[i], queryPoint));
+        }
+        return;
+    }
+    // the 4 children are consecutive quarters of the code interval of the cell
+    uint64_t quarter = 1ULL << (2 * (31 - level));
+    double xMid = (cell.xMin + cell.xMax) / 2.0;
+    double yMid = (cell.yMin + cell.yMax) / 2.0;
+    int bounds[5];
+    bounds[0] = from;
+    bounds[4] = to;
+    for (int i = 1; i < 4; i++) {
+        bounds[i] = (int) (lower_bound(codes.begin() + bounds[i - 1], codes.begin() + to, firstCode + i * quarter)
+                           - codes.begin());
+    }
+
+    // order the non-empty children by proximity of their cells to queryPoint
+    int order[4];
+    Area cells[4];
+    double distances[4];
+    int childCount = 0;
+    for (int child = 0; child < 4; child++) {
+        if (bounds[child] == bounds[child + 1]) {
+            continue;
+        }
+        Area childCell{(child & 1) ? xMid : cell.xMin, (child & 1) ? cell.xMax : xMid,
+                       (child & 2) ? yMid : cell.yMin, (child & 2) ? cell.yMax : yMid};
+        double distance = sqDistanceFrom(childCell, queryPoint);
+        int j = childCount++;
+        for (; j > 0 && distances[j - 1] > distance; j--) {
+            order[j] = order[j - 1];
+            cells[j] = cells[j - 1];
+            distances[j] = distances[j - 1];
+        }
+        order[j] = child;
+        cells[j] = childCell;
+        distances[j] = distance;
+    }
+    for (int i = 0; i < childCount; i++) {
+        if (distances[i] >= scratch.radius()) {
+            break;
+        }
+        int child = order[i];
+        kNearestNeighborsHelper(queryPoint, scratch, cells[i], level + 1, firstCode + child * quarter,
+                                bounds[child], bounds[child + 1]);
+    }
+}
+
+vector<Point> LinearQuadTree::kNearestNeighbors(Point &queryPoint, int k) const {
+    vector<Point> result;
+    KNNScratch scratch;
+    kNearestNeighbors(queryPoint, k, scratch, result);
+    return result;
+}
+
+void LinearQuadTree::kNearestNeighbors(Point &queryPoint, int k, KNNScratch &scratch, vector<Point> &result) const {
+    scratch.reset(k);
+    kNearestNeighborsHelper(queryPoint, scratch, this->area, 0, 0, 0, size);
+    scratch.extractSorted(result);
+}
+
+Point *LinearQuadTree::getPoints() {
+    return this->points;
+}
@@ -0,0 +1,59 @@
+//
+// Created by omarc on 12/01/2024.
+//
+
+#include "../include/NodeArena.h"
+#include <sys/mman.h>
+
+NodeArena::NodeArena(size_t blockSize, bool hugePages) {
+    this->blockSize = std::max(blockSize, (size_t) 4096);
+    this->hugePages = hugePages;
+}
+
+NodeArena::~NodeArena() {
+    release();
+}
+
+void NodeArena::release() {
+    while (blocks != nullptr) {
+        Block *previous = blocks->previous;
+        munmap(blocks, blocks->size);
+        blocks = previous;
+    }
+    current = nullptr;
+    end = nullptr;
+    used = 0;
+    reserved = 0;
+}
+
+size_t NodeArena::bytesUsed() const {
+    return used;
+}
+
+size_t NodeArena::bytesReserved() const {
+    return reserved;
+}
+
+void NodeArena::grow(size_t bytes, size_t alignment) {
+    // huge pages are 2 MiB, blocks are rounded up to a multiple of them
+    size_t granularity = hugePages ? (size_t) 1 << 21 : (size_t) 4096;
+    size_t size = std::max(blockSize, sizeof(Block) + bytes + alignment);
+    size = (size + granularity - 1) / granularity * granularity;
+
+    void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+#ifdef MADV_HUGEPAGE
+    if (hugePages) {
+        madvise(memory, size, MADV_HUGEPAGE);
+    }
+#endif
+    auto *block = static_cast<Block *>(memory);
+    block->previous = blocks;
+    block->size = size;
+    blocks = block;
+    reserved += size;
+    current = reinterpret_cast<char *>(block + 1);
+    end = reinterpret_cast<char *>(block) + size;
+}
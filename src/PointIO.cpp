@@ -0,0 +1,273 @@
+//
+// Created by omarc on 12/01/2024.
+//
+
+#include "../include/PointIO.h"
+#include <charconv>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Read-only mapping of a whole file, unmapped on destruction
+ */
+struct FileMapping {
+    void *data = nullptr;
+    size_t size = 0;
+
+    explicit FileMapping(const std::string &path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("cannot open " + path);
+        }
+        struct stat status{};
+        if (fstat(fd, &status) != 0) {
+            close(fd);
+            throw std::runtime_error("cannot stat " + path);
+        }
+        this->size = (size_t) status.st_size;
+        if (this->size > 0) {
+            this->data = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        close(fd);
+        if (this->data == MAP_FAILED) {
+            this->data = nullptr;
+            throw std::runtime_error("cannot map " + path);
+        }
+    }
+
+    FileMapping(const FileMapping &) = delete;
+
+    ~FileMapping() {
+        if (this->data != nullptr) {
+            munmap(this->data, this->size);
+        }
+    }
+};
+
+static bool isSeparator(char c) {
+    return c == ',' || c == ';' || c == ' ' || c == '\t' || c == '\r';
+}
+
+/**
+ * @brief Parses all lines starting in [begin, end)
+ * @param begin start of a line
+ * @param end end of the part, lines may continue until fileEnd
+ * @param fileEnd end of the file
+ * @param result the parsed points are appended to result
+ */
+static void parseLines(const char *begin, const char *end, const char *fileEnd, vector<Point> &result) {
+    const char *position = begin;
+    while (position < end) {
+        const char *lineEnd = static_cast<const char *>(memchr(position, '\n', fileEnd - position));
+        if (lineEnd == nullptr) {
+            lineEnd = fileEnd;
+        }
+        while (position < lineEnd && isSeparator(*position)) {
+            position++;
+        }
+        Point point{};
+        auto [xEnd, xError] = std::from_chars(position, lineEnd, point.x);
+        if (xError == std::errc()) {
+            position = xEnd;
+            while (position < lineEnd && isSeparator(*position)) {
+                position++;
+            }
+            auto [yEnd, yError] = std::from_chars(position, lineEnd, point.y);
+            if (yError == std::errc()) {
+                result.push_back(point);
+            }
+        }
+        position = lineEnd + 1;
+    }
+}
+
+vector<Point> loadPointsText(const std::string &path, int threads) {
+    FileMapping file(path);
+    if (file.size == 0) {
+        return {};
+    }
+    const char *text = static_cast<const char *>(file.data);
+    const char *textEnd = text + file.size;
+    madvise(file.data, file.size, MADV_SEQUENTIAL);
+
+    // small files are not worth a thread, every part gets at least 1 MiB
+    size_t maxParts = std::max<size_t>(file.size >> 20, 1);
+    size_t parts = threads > 0 ? threads : std::max(std::thread::hardware_concurrency(), 1u);
+    parts = std::min(parts, maxParts);
+
+    // parts start at the beginning of a line, a part may be empty if one line spans it completely
+    vector<const char *> starts(parts + 1, textEnd);
+    starts[0] = text;
+    for (size_t i = 1; i < parts; i++) {
+        const char *start = text + file.size / parts * i;
+        start = std::max(start, starts[i - 1]);
+        if (start < textEnd && start[-1] != '\n') {
+            auto *newline = static_cast<const char *>(memchr(start, '\n', textEnd - start));
+            start = newline == nullptr ? textEnd : newline + 1;
+        }
+        starts[i] = start;
+    }
+
+    vector<vector<Point>> results(parts);
+    vector<std::thread> workers;
+    for (size_t i = 1; i < parts; i++) {
+        workers.emplace_back([&, i]() {
+            results[i].reserve((starts[i + 1] - starts[i]) / 32);
+            parseLines(starts[i], starts[i + 1], textEnd, results[i]);
+        });
+    }
+    results[0].reserve((starts[1] - starts[0]) / 32);
+    parseLines(starts[0], starts[1], textEnd, results[0]);
+    for (auto &worker: workers) {
+        worker.join();
+    }
+
+    vector<Point> points = std::move(results[0]);
+    size_t total = 0;
+    for (auto &result: results) {
+        total += result.size();
+    }
+    points.reserve(total);
+    for (size_t i = 1; i < parts; i++) {
+        points.insert(points.end(), results[i].begin(), results[i].end());
+    }
+    return points;
+}
+
+void savePointsBinary(const std::string &path, const Point *points, long pointNumber, CoordinateType type) {
+    PointFileHeader header{};
+    memcpy(header.magic, POINT_FILE_MAGIC, sizeof(header.magic));
+    header.version = POINT_FILE_VERSION;
+    header.coordinateType = type;
+    header.pointNumber = pointNumber;
+    Area bounds = pointNumber > 0 ? boundingBox(points, points + pointNumber) : Area{0, 0, 0, 0};
+    header.xMin = bounds.xMin;
+    header.xMax = bounds.xMax;
+    header.yMin = bounds.yMin;
+    header.yMax = bounds.yMax;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("cannot write " + path);
+    }
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    if (type == FLOAT64_COORDINATES) {
+        file.write(reinterpret_cast<const char *>(points), (std::streamsize) (pointNumber * sizeof(Point)));
+    } else {
+        vector<float> buffer;
+        buffer.reserve(2 * std::min(pointNumber, 1L << 16));
+        for (long i = 0; i < pointNumber; i += 1 << 16) {
+            buffer.clear();
+            for (long j = i; j < std::min(pointNumber, i + (1 << 16)); j++) {
+                buffer.push_back((float) points[j].x);
+                buffer.push_back((float) points[j].y);
+            }
+            file.write(reinterpret_cast<const char *>(buffer.data()), (std::streamsize) (buffer.size() * sizeof(float)));
+        }
+    }
+    if (!file) {
+        throw std::runtime_error("cannot write " + path);
+    }
+}
+
+MappedPointFile::MappedPointFile(const std::string &path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open " + path);
+    }
+    struct stat status{};
+    if (fstat(fd, &status) != 0 || (size_t) status.st_size < sizeof(PointFileHeader)) {
+        close(fd);
+        throw std::runtime_error(path + " is no point file");
+    }
+    // private and writable, trees reorder the points in place without changing the file
+    this->mappingSize = (size_t) status.st_size;
+    this->mapping = mmap(nullptr, this->mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (this->mapping == MAP_FAILED) {
+        this->mapping = nullptr;
+        throw std::runtime_error("cannot map " + path);
+    }
+    memcpy(&this->header, this->mapping, sizeof(PointFileHeader));
+
+    size_t coordinateSize = this->header.coordinateType == FLOAT64_COORDINATES ? sizeof(double) : sizeof(float);
+    bool valid = memcmp(this->header.magic, POINT_FILE_MAGIC, sizeof(this->header.magic)) == 0
+                 && this->header.version == POINT_FILE_VERSION
+                 && this->header.coordinateType <= FLOAT32_COORDINATES
+                 && this->header.pointNumber <= (this->mappingSize - sizeof(PointFileHeader)) / (2 * coordinateSize);
+    if (!valid) {
+        release();
+        throw std::runtime_error(path + " is no point file");
+    }
+
+    char *body = static_cast<char *>(this->mapping) + sizeof(PointFileHeader);
+    madvise(this->mapping, this->mappingSize, MADV_WILLNEED);
+    if (this->header.coordinateType == FLOAT64_COORDINATES) {
+        this->points = reinterpret_cast<Point *>(body);
+        return;
+    }
+    auto *floats = reinterpret_cast<float *>(body);
+    long n = size();
+    this->points = static_cast<Point *>(malloc(std::max(n, 1L) * sizeof(Point)));
+    for (long i = 0; i < n; i++) {
+        this->points[i] = Point{floats[2 * i], floats[2 * i + 1]};
+    }
+    this->converted = true;
+    munmap(this->mapping, this->mappingSize);
+    this->mapping = nullptr;
+}
+
+void MappedPointFile::release() {
+    if (this->converted) {
+        free(this->points);
+    }
+    if (this->mapping != nullptr) {
+        munmap(this->mapping, this->mappingSize);
+    }
+    this->mapping = nullptr;
+    this->points = nullptr;
+    this->converted = false;
+}
+
+MappedPointFile::MappedPointFile(MappedPointFile &&other) noexcept {
+    *this = std::move(other);
+}
+
+MappedPointFile &MappedPointFile::operator=(MappedPointFile &&other) noexcept {
+    if (this != &other) {
+        release();
+        this->mapping = std::exchange(other.mapping, nullptr);
+        this->mappingSize = other.mappingSize;
+        this->points = std::exchange(other.points, nullptr);
+        this->converted = std::exchange(other.converted, false);
+        this->header = std::exchange(other.header, PointFileHeader{});
+    }
+    return *this;
+}
+
+MappedPointFile::~MappedPointFile() {
+    release();
+}
+
+Point *MappedPointFile::data() {
+    return this->points;
+}
+
+long MappedPointFile::size() const {
+    return (long) this->header.pointNumber;
+}
+
+Area MappedPointFile::bounds() const {
+    return Area{this->header.xMin, this->header.xMax, this->header.yMin, this->header.yMax};
+}
+
+CoordinateType MappedPointFile::coordinateType() const {
+    return (CoordinateType) this->header.coordinateType;
+}
+
+bool MappedPointFile::isZeroCopy() const {
+    return !this->converted;
+}
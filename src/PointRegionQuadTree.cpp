@@ -4,22 +4,55 @@
 
 #include "../include/PointRegionQuadTree.h"
 #include "functional"
-#include <queue>
 
-PointRegionQuadTree::PointRegionQuadTree(Area square, vector<Point> &elements, int capacity) {
+template<typename T>
+BasicPointRegionQuadTree<T>::BasicPointRegionQuadTree(AreaType square, vector<PointType> &elements, int capacity)
+        : elements(elements.begin(), elements.end()) {
     this->square = square;
-    this->elements = elements;
     this->capacity = capacity;
+    this->size = (long) this->elements.size();
 }
 
-PointRegionQuadTree::~PointRegionQuadTree() {
+template<typename T>
+BasicPointRegionQuadTree<T>::BasicPointRegionQuadTree(AreaType square, vector<PointType> &elements,
+                                                      const CapacityProfile &profile)
+        : BasicPointRegionQuadTree(square, elements, profile.capacityFor((long) elements.size())) {
+}
+
+template<typename T>
+BasicPointRegionQuadTree<T>::BasicPointRegionQuadTree(AreaType square, vector<PointType> &elements, int capacity,
+                                                      NodeArena &arena)
+        : elements(elements.begin(), elements.end(), &arena) {
+    this->square = square;
+    this->capacity = capacity;
+    this->size = (long) this->elements.size();
+    this->arena = &arena;
+}
+
+template<typename T>
+BasicPointRegionQuadTree<T>::BasicPointRegionQuadTree(AreaType square, std::pmr::vector<PointType> &&elements,
+                                                      int capacity, NodeArena *arena)
+        : elements(std::move(elements)) {
+    this->square = square;
+    this->capacity = capacity;
+    this->size = (long) this->elements.size();
+    this->arena = arena;
+}
+
+template<typename T>
+BasicPointRegionQuadTree<T>::~BasicPointRegionQuadTree() {
     this->elements.clear();
-    for (auto &i: children) {
-        delete i;
+    // nodes and aggregates of an arena are freed together with the arena
+    if (this->arena == nullptr) {
+        for (auto &i: children) {
+            delete i;
+        }
+        delete summary;
     }
 }
 
-int PointRegionQuadTree::getHeight() {
+template<typename T>
+int BasicPointRegionQuadTree<T>::getHeight() {
     if (isNodeLeaf()) {
         return 1;
     }
@@ -31,12 +64,14 @@ int PointRegionQuadTree::getHeight() {
     return maxHeight + 1;
 }
 
-bool PointRegionQuadTree::isNodeLeaf() {
+template<typename T>
+bool BasicPointRegionQuadTree<T>::isNodeLeaf() const {
     return this->children[0] == nullptr;
 }
 
-void PointRegionQuadTree::buildTree() {
-    if (this->elements.size() > capacity) {
+template<typename T>
+void BasicPointRegionQuadTree<T>::buildTree() {
+    if ((long) this->elements.size() > capacity && canSubdivide()) {
         subdivide();
         children[NORTH_EAST]->buildTree();
         children[NORTH_WEST]->buildTree();
@@ -45,150 +80,341 @@ void PointRegionQuadTree::buildTree() {
     }
 }
 
-void PointRegionQuadTree::subdivide() {
-    double xMid = (this->square.xMin + this->square.xMax) / 2.0;
-    double yMid = (this->square.yMin + this->square.yMax) / 2.0;
-    Area *quadrants = splitArea(this->square, xMid, yMid);
-    vector<Point> childrenElements[4];
+template<typename T>
+bool BasicPointRegionQuadTree<T>::canSubdivide() const {
+    // equal points always share a quadrant, splitting them would create children until the square cannot be halved
+    if (std::all_of(this->elements.begin(), this->elements.end(), [this](const PointType &point) {
+        return point == this->elements.front();
+    })) {
+        return false;
+    }
+    T xMid = centerCoordinate(this->square.xMin, this->square.xMax);
+    T yMid = centerCoordinate(this->square.yMin, this->square.yMax);
+    // the center of a square of adjacent coordinates is one of its borders, halving it would not separate any points
+    bool xSplits = xMid != this->square.xMin && xMid != this->square.xMax;
+    bool ySplits = yMid != this->square.yMin && yMid != this->square.yMax;
+    return xSplits || ySplits;
+}
+
+template<typename T>
+void BasicPointRegionQuadTree<T>::subdivide() {
+    T xMid = centerCoordinate(this->square.xMin, this->square.xMax);
+    T yMid = centerCoordinate(this->square.yMin, this->square.yMax);
+    AreaType quadrants[4];
+    splitArea(this->square, xMid, yMid, quadrants);
+    std::pmr::memory_resource *resource = nodeResource(arena);
+    std::pmr::vector<PointType> childrenElements[4]{
+            std::pmr::vector<PointType>(resource), std::pmr::vector<PointType>(resource),
+            std::pmr::vector<PointType>(resource), std::pmr::vector<PointType>(resource)};
 
     for (auto point: elements) {
-        int quadrant = 0B00;           // lsb W/E msb msb S/N
-        if (point.x > xMid) {          // is East
-            quadrant |= 0B01;
+        childrenElements[quadrantOf(point, xMid, yMid)].push_back(point);
+    }
+    //elements.clear();
+
+    for (int i = 0; i < 4; i++) {
+        children[i] = new(arena) BasicPointRegionQuadTree(quadrants[i], std::move(childrenElements[i]), capacity,
+                                                          arena);
+    }
+}
+
+template<typename T>
+void BasicPointRegionQuadTree<T>::buildTree(WorkStealingPool &pool) {
+    buildTree(0, pool);
+}
+
+template<typename T>
+void BasicPointRegionQuadTree<T>::buildTree(int depth, WorkStealingPool &pool) {
+    // small subtrees are not worth a task, an arena is not thread safe
+    if (depth >= PARALLEL_BUILD_DEPTH || (long) this->elements.size() <= max(PARALLEL_BUILD_GRAIN, capacity)
+        || arena != nullptr) {
+        buildTree();
+        return;
+    } else if (!canSubdivide()) {
+        return;
+    }
+    subdivide(pool);
+    // the 4 quadrants are disjoint, so their subtrees are built independently
+    WorkStealingPool::TaskGroup group;
+    for (int i = 0; i < 3; i++) {
+        pool.spawn(group, [this, i, depth, &pool] { this->children[i]->buildTree(depth + 1, pool); });
+    }
+    children[3]->buildTree(depth + 1, pool);
+    pool.wait(group);
+}
+
+template<typename T>
+void BasicPointRegionQuadTree<T>::subdivide(WorkStealingPool &pool) {
+    if (this->elements.size() <= PARALLEL_PARTITION_THRESHOLD) {
+        subdivide();
+        return;
+    }
+    T xMid = centerCoordinate(this->square.xMin, this->square.xMax);
+    T yMid = centerCoordinate(this->square.yMin, this->square.yMax);
+    AreaType quadrants[4];
+    splitArea(this->square, xMid, yMid, quadrants);
+    std::pmr::memory_resource *resource = nodeResource(arena);
+    std::pmr::vector<PointType> childrenElements[4]{
+            std::pmr::vector<PointType>(resource), std::pmr::vector<PointType>(resource),
+            std::pmr::vector<PointType>(resource), std::pmr::vector<PointType>(resource)};
+    parallelQuadrantSplit(pool, this->elements.data(), (int) this->elements.size(), xMid, yMid, childrenElements);
+    for (int i = 0; i < 4; i++) {
+        children[i] = new(arena) BasicPointRegionQuadTree(quadrants[i], std::move(childrenElements[i]), capacity,
+                                                          arena);
+    }
+}
+
+template<typename T>
+std::list<BasicPoint<T>> BasicPointRegionQuadTree<T>::query(AreaType &queryRectangle) {
+    list<PointType> result;
+    query(queryRectangle, back_inserter(result));
+    return result;
+}
+
+template<typename T>
+void BasicPointRegionQuadTree<T>::query(AreaType &queryRectangle, vector<PointType> &result) {
+    query(queryRectangle, back_inserter(result));
+}
+
+template<typename T>
+long BasicPointRegionQuadTree<T>::count(AreaType &queryRectangle) {
+    if (containsArea(queryRectangle, this->square)) {
+        return this->size;
+    } else if (this->isNodeLeaf()) {
+        long result = 0;
+        for (auto &point: this->elements) {
+            result += containsPoint(queryRectangle, point);
         }
+        return result;
+    }
 
-        if (point.y <= yMid) {         // is South
-            quadrant |= 0B10;
+    long result = 0;
+    for (auto child: this->children) {
+        if (intersects(queryRectangle, child->square)) {
+            result += child->count(queryRectangle);
         }
-        childrenElements[quadrant].push_back(point);
     }
-    //elements.clear();
+    return result;
+}
 
-    for (int i = 0; i < 4; i++) {
-        children[i] = new PointRegionQuadTree(quadrants[i], childrenElements[i], capacity);
+template<typename T>
+void BasicPointRegionQuadTree<T>::buildAggregates(BasicWeightFunction<T> weightFunction) {
+    this->weight = weightFunction;
+    if (this->summary == nullptr) {
+        this->summary = new(arena) Aggregate;
+    }
+    *this->summary = Aggregate{};
+    if (this->isNodeLeaf()) {
+        for (auto &point: this->elements) {
+            this->summary->add(weightFunction(point));
+        }
+        return;
+    }
+    for (auto child: this->children) {
+        child->buildAggregates(weightFunction);
+        this->summary->add(*child->summary);
     }
-    free(quadrants);
 }
 
-std::list<Point> PointRegionQuadTree::query(Area &queryRectangle) {
-    list<Point> result;
-    if (this->isPointLeaf()) {
-        for (auto point: this->elements) {
+template<typename T>
+Aggregate BasicPointRegionQuadTree<T>::aggregate(AreaType &queryRectangle) {
+    Aggregate result;
+    aggregateHelper(queryRectangle, result);
+    return result;
+}
+
+template<typename T>
+void BasicPointRegionQuadTree<T>::aggregateHelper(AreaType &queryRectangle, Aggregate &result) {
+    if (containsArea(queryRectangle, this->square)) {
+        result.add(*this->summary);
+        return;
+    } else if (this->isNodeLeaf()) {
+        for (auto &point: this->elements) {
             if (containsPoint(queryRectangle, point)) {
-                result.push_back(point);
+                result.add(this->weight(point));
             }
         }
-        return result;
-    } else if (containsArea(queryRectangle, this->square)) {
-        result.insert(result.end(), this->elements.begin(), this->elements.end());
-        return result;
+        return;
     }
 
     for (auto child: this->children) {
-        if (child != nullptr && intersects(queryRectangle, child->square)) {
-            list<Point> childResult = child->query(queryRectangle);
-            childResult.insert(result.end(), childResult.begin(), childResult.end());
+        if (intersects(queryRectangle, child->square)) {
+            child->aggregateHelper(queryRectangle, result);
         }
     }
-    return result;
 }
 
-bool PointRegionQuadTree::isPointLeaf() {
-    return !this->elements.empty() && this->elements.size() <= capacity;
+template<typename T>
+bool BasicPointRegionQuadTree<T>::isPointLeaf() {
+    return !this->elements.empty() && (long) this->elements.size() <= capacity;
 }
 
-bool PointRegionQuadTree::contains(Point &point) {
-    PointRegionQuadTree *current = this;
+template<typename T>
+bool BasicPointRegionQuadTree<T>::contains(PointType &point) {
+    BasicPointRegionQuadTree *current = this;
     while (!current->isNodeLeaf()) {
-        current = locateQuadrant(point.x, point.y, current);
+        current = locateQuadrant(point, current);
     }
     return !current->elements.empty()
            && find(current->elements.begin(), current->elements.end(), point) != current->elements.end();
 }
 
-PointRegionQuadTree *PointRegionQuadTree::locateQuadrant(double pointX, double pointY, PointRegionQuadTree *current) {
-    double centerX = (current->square.xMin + current->square.xMax) / 2.0;
-    double centerY = (current->square.yMin + current->square.yMax) / 2.0;
-
-    int quadrant = 0B00;           // lsb W/E msb msb S/N
-    if (pointX > centerX) {          // is East
-        quadrant |= 0B01;
-    }
-    if (pointY <= centerY) {         // is South
-        quadrant |= 0B10;
-    }
-
-    return current->children[quadrant];
+template<typename T>
+BasicPointRegionQuadTree<T> *BasicPointRegionQuadTree<T>::locateQuadrant(const PointType &point,
+                                                                          BasicPointRegionQuadTree *current) {
+    T centerX = centerCoordinate(current->square.xMin, current->square.xMax);
+    T centerY = centerCoordinate(current->square.yMin, current->square.yMax);
+    return current->children[quadrantOf(point, centerX, centerY)];
 }
 
-bool PointRegionQuadTree::isEmpty() {
-    return this->elements.empty();
+template<typename T>
+bool BasicPointRegionQuadTree<T>::isEmpty() {
+    return this->size == 0;
 }
 
-void PointRegionQuadTree::add(Point &point) {
-    PointRegionQuadTree *current = this;
+template<typename T>
+void BasicPointRegionQuadTree<T>::add(PointType &point) {
+    BasicPointRegionQuadTree *current = this;
     if (current->isEmpty()) {
         current->elements.push_back(point);
+        current->size++;
+        if (current->summary != nullptr) {
+            current->summary->add(current->weight(point));
+        }
         return;
     }
 
+    // interior nodes keep the points of their subtree for query() unless remove() has dropped them
     while (!current->isNodeLeaf()) {
-        current = locateQuadrant(point.x, point.y, current);
+        if ((long) current->elements.size() == current->size) {
+            current->elements.push_back(point);
+        }
+        current->size++;
+        if (current->summary != nullptr) {
+            current->summary->add(current->weight(point));
+        }
+        current = locateQuadrant(point, current);
     }
     current->elements.push_back(point);
+    current->size++;
 
-    if (current->elements.size() > capacity) {
-        current->subdivide();
+    // all points of the leaf may fall into one quadrant, buildTree() splits until they are separated
+    current->buildTree();
+    if (current->summary == nullptr) {
+        return;
+    } else if (current->isNodeLeaf()) {
+        current->summary->add(current->weight(point));
+    } else {
+        current->buildAggregates(current->weight);
     }
 }
 
-void PointRegionQuadTree::kNearestNeighborsHelper(PointRegionQuadTree *node, int k,
-                                                  std::priority_queue<PointRegionQuadTree *, std::vector<PointRegionQuadTree *>, ComparePointRegionQuadTree> &queue,
-                                                  std::vector<Point> &result, Point &queryPoint) {
-    if (node == nullptr) {
-        return;
+template<typename T>
+bool BasicPointRegionQuadTree<T>::remove(PointType &point) {
+    if (!contains(point)) {
+        return false;
     }
-
-    if (node->isPointLeaf()) {
-        queue.push(node);
-    } else {
-        for (auto child: node->children) {
-            if (child != nullptr)
-                queue.push(child);
+    // remember the path, it is collapsed bottom up
+    vector<BasicPointRegionQuadTree *> path;
+    BasicPointRegionQuadTree *current = this;
+    while (!current->isNodeLeaf()) {
+        path.push_back(current);
+        current = locateQuadrant(point, current);
+    }
+    current->elements.erase(find(current->elements.begin(), current->elements.end(), point));
+    current->size--;
+    current->updateAggregate();
+
+    for (auto node = path.rbegin(); node != path.rend(); ++node) {
+        BasicPointRegionQuadTree *parent = *node;
+        parent->size--;
+        // searching the copy would cost O(size), dropping it keeps removal proportional to the height
+        std::pmr::vector<PointType>(parent->elements.get_allocator()).swap(parent->elements);
+        if (parent->size <= parent->capacity) {
+            parent->collapse();
         }
+        parent->updateAggregate();
     }
+    return true;
+}
 
-    while (!queue.empty() && result.size() < k) {
-        PointRegionQuadTree *current = queue.top();
-        queue.pop();
-        if (current->isPointLeaf()) {
-            std::sort(current->elements.begin(), current->elements.end(), [queryPoint](const Point &A, const Point &B) {
-                return pointDistance(queryPoint, A) < pointDistance(queryPoint, B);
-            });
-            for (auto leafPoint: current->elements) {
-                if (result.size() < k) {
-                    result.push_back(leafPoint);
-                }
-            }
-        } else {
-            kNearestNeighborsHelper(current, k, queue, result, queryPoint);
+template<typename T>
+void BasicPointRegionQuadTree<T>::collapse() {
+    // interior nodes hold more than capacity points, so all children of this node are leaves
+    for (auto &child: this->children) {
+        this->elements.insert(this->elements.end(), child->elements.begin(), child->elements.end());
+        if (this->arena == nullptr) {
+            delete child;
         }
+        child = nullptr;
     }
 }
 
-std::vector<Point> PointRegionQuadTree::kNearestNeighbors(Point &queryPoint, int k) {
-    vector<Point> result;
-    result.reserve(k);
-    ComparePointRegionQuadTree compareFunction(queryPoint);
-    std::priority_queue<PointRegionQuadTree *, vector<PointRegionQuadTree *>, ComparePointRegionQuadTree> queue(
-            compareFunction);
-    kNearestNeighborsHelper(this, k, queue, result, queryPoint);
-    return result;
+template<typename T>
+void BasicPointRegionQuadTree<T>::updateAggregate() {
+    if (this->summary == nullptr) {
+        return;
+    }
+    *this->summary = Aggregate{};
+    if (this->isNodeLeaf()) {
+        for (auto &point: this->elements) {
+            this->summary->add(this->weight(point));
+        }
+        return;
+    }
+    for (auto child: this->children) {
+        this->summary->add(*child->summary);
+    }
 }
 
+template<typename T>
+void BasicPointRegionQuadTree<T>::kNearestNeighborsHelper(const PointType &queryPoint, Scratch &scratch) const {
+    if (this->isNodeLeaf()) {
+        for (auto &point: this->elements) {
+            scratch.offer(point, pointDistance(point, queryPoint));
+        }
+        return;
+    }
+    // order the 4 children by proximity of their squares to queryPoint
+    BasicPointRegionQuadTree *order[4];
+    SquaredDistance<T> distances[4];
+    for (int i = 0; i < 4; i++) {
+        BasicPointRegionQuadTree *child = this->children[i];
+        SquaredDistance<T> distance = sqDistanceFrom(child->square, queryPoint);
+        int j = i;
+        for (; j > 0 && distances[j - 1] > distance; j--) {
+            order[j] = order[j - 1];
+            distances[j] = distances[j - 1];
+        }
+        order[j] = child;
+        distances[j] = distance;
+    }
+    for (int i = 0; i < 4; i++) {
+        if (distances[i] >= scratch.radius()) {
+            break;
+        }
+        order[i]->kNearestNeighborsHelper(queryPoint, scratch);
+    }
+}
 
+template<typename T>
+std::vector<BasicPoint<T>> BasicPointRegionQuadTree<T>::kNearestNeighbors(const PointType &queryPoint, int k) const {
+    vector<PointType> result;
+    Scratch scratch;
+    kNearestNeighbors(queryPoint, k, scratch, result);
+    return result;
+}
 
+template<typename T>
+void BasicPointRegionQuadTree<T>::kNearestNeighbors(const PointType &queryPoint, int k, Scratch &scratch,
+                                                    vector<PointType> &result) const {
+    scratch.reset(k);
+    kNearestNeighborsHelper(queryPoint, scratch);
+    scratch.extractSorted(result);
+}
 
+template class BasicPointRegionQuadTree<double>;
 
+template class BasicPointRegionQuadTree<float>;
 
-
+template class BasicPointRegionQuadTree<int32_t>;
@@ -9,23 +9,45 @@
 
 #include "../include/QuadTree.h"
 #include "functional"
-#include <queue>
 
-QuadTree::QuadTree(Area square, vector<Point> &elements) {
+template<typename T>
+BasicQuadTree<T>::BasicQuadTree(AreaType square, vector<PointType> &elements)
+        : elements(elements.begin(), elements.end()) {
     this->square = square;
-    this->elements = elements;
+    this->size = (long) elements.size();
 }
 
+template<typename T>
+BasicQuadTree<T>::BasicQuadTree(AreaType square, vector<PointType> &elements, NodeArena &arena)
+        : elements(elements.begin(), elements.end(), &arena) {
+    this->square = square;
+    this->size = (long) elements.size();
+    this->arena = &arena;
+}
 
-QuadTree::~QuadTree() {
+template<typename T>
+BasicQuadTree<T>::BasicQuadTree(AreaType square, std::pmr::vector<PointType> &&elements, NodeArena *arena)
+        : elements(std::move(elements)) {
+    this->square = square;
+    this->size = (long) this->elements.size();
+    this->arena = arena;
+}
+
+
+template<typename T>
+BasicQuadTree<T>::~BasicQuadTree() {
     this->elements.clear();
-    for (auto &i: children) {
-        delete i;
+    // nodes of an arena are freed together with the arena
+    if (this->arena == nullptr) {
+        for (auto &i: children) {
+            delete i;
+        }
     }
 }
 
 
-int QuadTree::getHeight() {
+template<typename T>
+int BasicQuadTree<T>::getHeight() {
     // Leaf has height one
     if (isNodeLeaf()) {
         return 1;
@@ -41,14 +63,16 @@ int QuadTree::getHeight() {
 }
 
 
-bool QuadTree::isNodeLeaf() {
+template<typename T>
+bool BasicQuadTree<T>::isNodeLeaf() const {
     return this->children[0] == nullptr;
 }
 
 
-void QuadTree::buildTree() {
-    // Subdivide node if it contains more than one point
-    if (this->elements.size() > 1) {
+template<typename T>
+void BasicQuadTree<T>::buildTree() {
+    // Subdivide node if it contains more than one point, a square that cannot be halved anymore keeps its points
+    if (this->elements.size() > 1 && canSubdivide()) {
         // Subdivides points and quadrants into four quadrants
         subdivide();
         // Recursively build the 4 children
@@ -60,14 +84,19 @@ void QuadTree::buildTree() {
 }
 
 
-void QuadTree::subdivide() {
+template<typename T>
+void BasicQuadTree<T>::subdivide() {
     // calculate vertical and horizontal split coordinates of the square
-    double xMid = (this->square.xMin + this->square.xMax) / 2.0;
-    double yMid = (this->square.yMin + this->square.yMax) / 2.0;
+    T xMid = centerCoordinate(this->square.xMin, this->square.xMax);
+    T yMid = centerCoordinate(this->square.yMin, this->square.yMax);
     // create the 4 quadrants by splitting the square
-    Area *quadrants = splitArea(this->square, xMid, yMid);
+    AreaType quadrants[4];
+    splitArea(this->square, xMid, yMid, quadrants);
     // create 4 vectors for each quadrant
-    vector<Point> childrenElements[4];
+    std::pmr::memory_resource *resource = nodeResource(arena);
+    std::pmr::vector<PointType> childrenElements[4]{
+            std::pmr::vector<PointType>(resource), std::pmr::vector<PointType>(resource),
+            std::pmr::vector<PointType>(resource), std::pmr::vector<PointType>(resource)};
     // push points of Quadtree node to the corresponding lists
     for (const auto &point: elements) {
         int quadrant = determineQuadrant(point, xMid, yMid);
@@ -75,143 +104,231 @@ void QuadTree::subdivide() {
     }
     // Create the 4 children with the corresponding squares and elements
     for (int i = 0; i < 4; i++) {
-        children[i] = new QuadTree(quadrants[i], childrenElements[i]);
+        children[i] = new(arena) BasicQuadTree(quadrants[i], std::move(childrenElements[i]), arena);
+    }
+}
+
+template<typename T>
+void BasicQuadTree<T>::buildTree(WorkStealingPool &pool) {
+    buildTree(0, pool);
+}
+
+template<typename T>
+void BasicQuadTree<T>::buildTree(int depth, WorkStealingPool &pool) {
+    // small subtrees are not worth a task, an arena is not thread safe
+    if (depth >= PARALLEL_BUILD_DEPTH || this->elements.size() <= PARALLEL_BUILD_GRAIN || arena != nullptr) {
+        buildTree();
+        return;
+    }
+    subdivide(pool);
+    // the 4 quadrants are disjoint, so their subtrees are built independently
+    WorkStealingPool::TaskGroup group;
+    for (int i = 0; i < 3; i++) {
+        pool.spawn(group, [this, i, depth, &pool] { this->children[i]->buildTree(depth + 1, pool); });
     }
-    free(quadrants);
+    children[3]->buildTree(depth + 1, pool);
+    pool.wait(group);
 }
 
-QuadTree *QuadTree::locateQuadrant(Point &point, QuadTree *current) {
-    double centerX = (current->square.xMin + current->square.xMax) / 2.0;
-    double centerY = (current->square.yMin + current->square.yMax) / 2.0;
+template<typename T>
+void BasicQuadTree<T>::subdivide(WorkStealingPool &pool) {
+    if (this->elements.size() <= PARALLEL_PARTITION_THRESHOLD) {
+        subdivide();
+        return;
+    }
+    T xMid = centerCoordinate(this->square.xMin, this->square.xMax);
+    T yMid = centerCoordinate(this->square.yMin, this->square.yMax);
+    AreaType quadrants[4];
+    splitArea(this->square, xMid, yMid, quadrants);
+    std::pmr::memory_resource *resource = nodeResource(arena);
+    std::pmr::vector<PointType> childrenElements[4]{
+            std::pmr::vector<PointType>(resource), std::pmr::vector<PointType>(resource),
+            std::pmr::vector<PointType>(resource), std::pmr::vector<PointType>(resource)};
+    parallelQuadrantSplit(pool, this->elements.data(), (int) this->elements.size(), xMid, yMid, childrenElements);
+    for (int i = 0; i < 4; i++) {
+        children[i] = new(arena) BasicQuadTree(quadrants[i], std::move(childrenElements[i]), arena);
+    }
+}
+
+template<typename T>
+BasicQuadTree<T> *BasicQuadTree<T>::locateQuadrant(PointType &point, BasicQuadTree *current) {
+    T centerX = centerCoordinate(current->square.xMin, current->square.xMax);
+    T centerY = centerCoordinate(current->square.yMin, current->square.yMax);
     int quadrant = determineQuadrant(point, centerX, centerY);
     return current->children[quadrant];
 }
 
 
-std::list<Point> QuadTree::query(Area &queryRectangle) {
-    list<Point> result;
-    // if Quadtree is a non-empty leaf, add its point if it is contained by queryRectangle
-    if (this->isPointLeaf()) {
-        if (containsPoint(queryRectangle, this->elements.front())) {
-            result.push_back(this->elements.front());
-        }
-        return result;
-        // if queryRectangle contains the Quadtree square, all its elements are inside queryRectangle
-    } else if (containsArea(queryRectangle, this->square)) {
-        result.insert(result.end(), this->elements.begin(), this->elements.end());
-        return result;
-    }
-    // For each child: check if its area intersects queryRectangle. If yes, recursively call query on them
-    for (auto child: this->children) {
-        if (child != nullptr && intersects(queryRectangle, child->square)) {
-            list<Point> childResult = child->query(queryRectangle);
-            childResult.insert(result.end(), childResult.begin(), childResult.end());
-        }
-    }
+template<typename T>
+std::list<BasicPoint<T>> BasicQuadTree<T>::query(AreaType &queryRectangle) {
+    list<PointType> result;
+    query(queryRectangle, back_inserter(result));
     return result;
 }
 
-bool QuadTree::isPointLeaf() {
+template<typename T>
+void BasicQuadTree<T>::query(AreaType &queryRectangle, vector<PointType> &result) {
+    query(queryRectangle, back_inserter(result));
+}
+
+template<typename T>
+bool BasicQuadTree<T>::isPointLeaf() {
     return this->elements.size() == 1;
 }
 
-bool QuadTree::contains(Point &point) {
+template<typename T>
+bool BasicQuadTree<T>::canSubdivide() const {
+    T xMid = centerCoordinate(this->square.xMin, this->square.xMax);
+    T yMid = centerCoordinate(this->square.yMin, this->square.yMax);
+    // the center of a square of adjacent coordinates is one of its borders, halving it would not separate any points
+    bool xSplits = xMid != this->square.xMin && xMid != this->square.xMax;
+    bool ySplits = yMid != this->square.yMin && yMid != this->square.yMax;
+    return xSplits || ySplits;
+}
+
+template<typename T>
+bool BasicQuadTree<T>::contains(PointType &point) {
     // Traverses the tree from root to leaf by comparing point with coordinates of quadrants
-    QuadTree *current = this;
+    BasicQuadTree *current = this;
     while (!current->isNodeLeaf()) {
         current = locateQuadrant(point, current);
     }
-    // return true iff point of leaf is equal to point
-    return !current->elements.empty() && current->elements[0] == point;
+    // a leaf may hold several equal points or points of a square that cannot be halved
+    return std::find(current->elements.begin(), current->elements.end(), point) != current->elements.end();
 }
 
 
-int QuadTree::determineQuadrant(const Point &point, double xMid, double yMid) {
-    // Determines quadrant fast via enum indices
-    int quadrant = 0b00;  // LSB: W/E. MSB: S/N
-    if (point.x > xMid) {
-        quadrant |= 0b01;  // East
-    }
-    if (point.y <= yMid) {
-        quadrant |= 0b10;  // South
-    }
-    return quadrant;
+template<typename T>
+int BasicQuadTree<T>::determineQuadrant(const PointType &point, T xMid, T yMid) {
+    // LSB: W/E. MSB: S/N, see quadrantOf()
+    return quadrantOf(point, xMid, yMid);
 }
 
-bool QuadTree::isEmpty() {
-    return this->elements.empty();
+template<typename T>
+bool BasicQuadTree<T>::isEmpty() {
+    return this->size == 0;
 }
 
 
-void QuadTree::add(Point &point) {
-    QuadTree *current = this;
+template<typename T>
+void BasicQuadTree<T>::add(PointType &point) {
+    BasicQuadTree *current = this;
     // push point to root elements if empty
     if (current->isEmpty()) {
         current->elements.push_back(point);
+        current->size++;
         return;
     }
 
-    // traverse to the correct location
+    // traverse to the correct location, interior nodes that still hold a copy of their subtree points extend it
     while (!current->isNodeLeaf()) {
+        if ((long) current->elements.size() == current->size) {
+            current->elements.push_back(point);
+        }
+        current->size++;
         current = locateQuadrant(point, current);
     }
     current->elements.push_back(point);
+    current->size++;
 
-    // if current has too many elements, subdivide
-    if (current->elements.size() > 1) {
+    // subdivide until the new point is separated from all other points of the leaf, equal points stay together
+    auto differs = [&point](const PointType &other) { return !(other == point); };
+    while (std::any_of(current->elements.begin(), current->elements.end(), differs) && current->canSubdivide()) {
         current->subdivide();
+        current = locateQuadrant(point, current);
     }
 }
 
-void QuadTree::kNearestNeighborsHelper(QuadTree *node, int k,
-                                       std::priority_queue<QuadTree *, std::vector<QuadTree *>, CompareQuadTree> &queue,
-                                       std::vector<Point> &result) {
-    // Base case, abort if node is null
-    if (node == nullptr) {
-        return;
+template<typename T>
+bool BasicQuadTree<T>::remove(PointType &point) {
+    if (!contains(point)) {
+        return false;
     }
+    // remember the path, it is collapsed bottom up
+    vector<BasicQuadTree *> path;
+    BasicQuadTree *current = this;
+    while (!current->isNodeLeaf()) {
+        path.push_back(current);
+        current = locateQuadrant(point, current);
+    }
+    current->elements.erase(find(current->elements.begin(), current->elements.end(), point));
+    current->size--;
+
+    for (auto node = path.rbegin(); node != path.rend(); ++node) {
+        BasicQuadTree *parent = *node;
+        parent->size--;
+        // searching the copy would cost O(size), dropping it keeps removal proportional to the height
+        std::pmr::vector<PointType>(parent->elements.get_allocator()).swap(parent->elements);
+        if (parent->size <= 1) {
+            parent->collapse();
+        }
+    }
+    return true;
+}
 
-    // in case of leaf with single node, push to queue
-    if (node->isPointLeaf()) {
-        queue.push(node);
-    } else {
-        // if node is not a leaf, push its children prioritizing proximity of their squares to queryPoint
-        for (auto child: node->children) {
-            if (child != nullptr) queue.push(child);
+template<typename T>
+void BasicQuadTree<T>::collapse() {
+    // interior nodes hold more than one point, so all children of this node are leaves
+    for (auto &child: this->children) {
+        this->elements.insert(this->elements.end(), child->elements.begin(), child->elements.end());
+        if (this->arena == nullptr) {
+            delete child;
         }
+        child = nullptr;
     }
+}
 
-    // Process nodes until either queue is empty or result list has reached k elements
-    while (!queue.empty() && result.size() < k) {
-        QuadTree *current = queue.top();
-        queue.pop();
-        // push point if node is leaf containing point
-        if (current->isPointLeaf()) {
-            result.push_back(current->elements[0]);
-            // recursively call nns-helper on highest priority non-point leaf
-        } else {
-            kNearestNeighborsHelper(current, k, queue, result);
+template<typename T>
+void BasicQuadTree<T>::kNearestNeighborsHelper(const PointType &queryPoint, Scratch &scratch) const {
+    // a leaf offers its points to the candidate heap
+    if (this->isNodeLeaf()) {
+        for (auto &point: this->elements) {
+            scratch.offer(point, pointDistance(point, queryPoint));
         }
+        return;
+    }
+    // order the 4 children by proximity of their squares to queryPoint (insertion sort)
+    BasicQuadTree *order[4];
+    SquaredDistance<T> distances[4];
+    for (int i = 0; i < 4; i++) {
+        BasicQuadTree *child = this->children[i];
+        SquaredDistance<T> distance = sqDistanceFrom(child->square, queryPoint);
+        int j = i;
+        for (; j > 0 && distances[j - 1] > distance; j--) {
+            order[j] = order[j - 1];
+            distances[j] = distances[j - 1];
+        }
+        order[j] = child;
+        distances[j] = distance;
+    }
+    // visit closest child first, skip children that cannot contain a closer point
+    for (int i = 0; i < 4; i++) {
+        if (distances[i] >= scratch.radius()) {
+            break;
+        }
+        order[i]->kNearestNeighborsHelper(queryPoint, scratch);
     }
 }
 
 
-std::vector<Point> QuadTree::kNearestNeighbors(Point &queryPoint, int k) {
-    vector<Point> result;
-    result.reserve(k);
-    // comparator that prioritizes proximity of a node to the queryPoint
-    CompareQuadTree compareFunction(queryPoint);
-    std::priority_queue<QuadTree *, vector<QuadTree *>, CompareQuadTree> queue(compareFunction);
-    // call to helper function to fill result vector with k-nearest-neighbors
-    kNearestNeighborsHelper(this, k, queue, result);
+template<typename T>
+std::vector<BasicPoint<T>> BasicQuadTree<T>::kNearestNeighbors(const PointType &queryPoint, int k) const {
+    vector<PointType> result;
+    Scratch scratch;
+    kNearestNeighbors(queryPoint, k, scratch, result);
     return result;
 }
 
+template<typename T>
+void BasicQuadTree<T>::kNearestNeighbors(const PointType &queryPoint, int k, Scratch &scratch,
+                                         vector<PointType> &result) const {
+    scratch.reset(k);
+    kNearestNeighborsHelper(queryPoint, scratch);
+    scratch.extractSorted(result);
+}
 
+template class BasicQuadTree<double>;
 
+template class BasicQuadTree<float>;
 
-
-
-
-
-
+template class BasicQuadTree<int32_t>;
@@ -0,0 +1,164 @@
+//
+// Created by omarc on 12/01/2024.
+//
+
+#include "../include/QuadTreeEfficient.h"
+
+QuadTreeEfficient::QuadTreeEfficient(Point *points, Area &square, int size)
+        : QuadTreeEfficient(points, square, 0, size - 1) {
+}
+
+QuadTreeEfficient::QuadTreeEfficient(Point *points, Area square, int from, int to) {
+    this->points = points;
+    this->square = square;
+    this->from = from;
+    this->to = to;
+}
+
+QuadTreeEfficient::~QuadTreeEfficient() {
+    for (auto &child: children) {
+        delete child;
+    }
+}
+
+bool QuadTreeEfficient::isNodeLeaf() const {
+    return this->children[0] == nullptr;
+}
+
+void QuadTreeEfficient::buildTree() {
+    double xMid = (this->square.xMin + this->square.xMax) / 2.0;
+    double yMid = (this->square.yMin + this->square.yMax) / 2.0;
+    // stop if the square is too small to be split, only happens for equal points
+    bool splittable = xMid > this->square.xMin && xMid < this->square.xMax
+                      && yMid > this->square.yMin && yMid < this->square.yMax;
+    if (this->to - this->from > 0 && splittable) {
+        subdivide();
+        for (auto child: children) {
+            child->buildTree();
+        }
+    }
+}
+
+void QuadTreeEfficient::subdivide() {
+    double xMid = (this->square.xMin + this->square.xMax) / 2.0;
+    double yMid = (this->square.yMin + this->square.yMax) / 2.0;
+    Area quadrants[4];
+    splitArea(this->square, xMid, yMid, quadrants);
+
+    // north before south, then west before east within both halves (same order as the Quadrant enum)
+    Point *begin = this->points + from;
+    Point *end = this->points + to + 1;
+    Point *southBegin = std::partition(begin, end, [yMid](const Point &p) { return p.y > yMid; });
+    Point *northEastBegin = std::partition(begin, southBegin, [xMid](const Point &p) { return p.x <= xMid; });
+    Point *southEastBegin = std::partition(southBegin, end, [xMid](const Point &p) { return p.x <= xMid; });
+
+    int bounds[5] = {from, (int) (northEastBegin - points), (int) (southBegin - points),
+                     (int) (southEastBegin - points), to + 1};
+    for (int i = 0; i < 4; i++) {
+        children[i] = new QuadTreeEfficient(this->points, quadrants[i], bounds[i], bounds[i + 1] - 1);
+    }
+}
+
+int QuadTreeEfficient::getHeight() {
+    if (isNodeLeaf()) {
+        return 1;
+    }
+    int maxHeight = 0;
+    for (auto child: children) {
+        maxHeight = max(maxHeight, child->getHeight());
+    }
+    return maxHeight + 1;
+}
+
+bool QuadTreeEfficient::contains(Point &point) {
+    QuadTreeEfficient *current = this;
+    while (!current->isNodeLeaf()) {
+        double xMid = (current->square.xMin + current->square.xMax) / 2.0;
+        double yMid = (current->square.yMin + current->square.yMax) / 2.0;
+        current = current->children[quadrantOf(point, xMid, yMid)];
+    }
+    for (int i = current->from; i <= current->to; i++) {
+        if (current->points[i] == point) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::list<Point> QuadTreeEfficient::query(Area &queryRectangle) {
+    list<Point> result;
+    query(queryRectangle, back_inserter(result));
+    return result;
+}
+
+void QuadTreeEfficient::query(Area &queryRectangle, vector<Point> &result) {
+    query(queryRectangle, back_inserter(result));
+}
+
+long QuadTreeEfficient::count(Area &queryRectangle) {
+    if (containsArea(queryRectangle, this->square)) {
+        return to - from + 1;
+    } else if (this->isNodeLeaf()) {
+        long result = 0;
+        for (int i = from; i <= to; i++) {
+            result += containsPoint(queryRectangle, this->points[i]);
+        }
+        return result;
+    }
+    long result = 0;
+    for (auto child: this->children) {
+        if (child->from <= child->to && intersects(queryRectangle, child->square)) {
+            result += child->count(queryRectangle);
+        }
+    }
+    return result;
+}
+
+void QuadTreeEfficient::kNearestNeighborsHelper(const Point &queryPoint, KNNScratch &scratch) {
+    if (this->isNodeLeaf()) {
+        for (int i = from; i <= to; i++) {
+            scratch.offer(this->points[i], pointDistance(this->points[i], queryPoint));
+        }
+        return;
+    }
+    // order the non-empty children by proximity of their squares to queryPoint
+    QuadTreeEfficient *order[4];
+    double distances[4];
+    int childCount = 0;
+    for (auto child: this->children) {
+        if (child->from > child->to) {
+            continue;
+        }
+        double distance = sqDistanceFrom(child->square, queryPoint);
+        int j = childCount++;
+        for (; j > 0 && distances[j - 1] > distance; j--) {
+            order[j] = order[j - 1];
+            distances[j] = distances[j - 1];
+        }
+        order[j] = child;
+        distances[j] = distance;
+    }
+    for (int i = 0; i < childCount; i++) {
+        if (distances[i] >= scratch.radius()) {
+            break;
+        }
+        order[i]->kNearestNeighborsHelper(queryPoint, scratch);
+    }
+}
+
+std::vector<Point> QuadTreeEfficient::kNearestNeighbors(Point &queryPoint, int k) {
+    vector<Point> result;
+    KNNScratch scratch;
+    kNearestNeighbors(queryPoint, k, scratch, result);
+    return result;
+}
+
+void QuadTreeEfficient::kNearestNeighbors(Point &queryPoint, int k, KNNScratch &scratch, vector<Point> &result) {
+    scratch.reset(k);
+    kNearestNeighborsHelper(queryPoint, scratch);
+    scratch.extractSorted(result);
+}
+
+Point *QuadTreeEfficient::getPoints() {
+    return this->points;
+}
@@ -4,34 +4,68 @@
 
 #include "../include/SortKDTree.h"
 
-SortKDTree::SortKDTree(vector<Point> &points, Area &area) : SortKDTree(points, area, 0) {
+template<typename T>
+BasicSortKDTree<T>::BasicSortKDTree(vector<PointType> &points, AreaType &area) : BasicSortKDTree(points, area, 0) {
 
 }
 
-SortKDTree::SortKDTree(vector<Point> &points, Area &area, int level) {
-    this->points = points;
+template<typename T>
+BasicSortKDTree<T>::BasicSortKDTree(vector<PointType> &points, AreaType &area, NodeArena &arena)
+        : points(points.begin(), points.end(), &arena) {
+    this->area = area;
+    this->level = 0;
+    this->arena = &arena;
+    this->size = (long) this->points.size();
+    sortPoints();
+}
+
+template<typename T>
+BasicSortKDTree<T>::BasicSortKDTree(vector<PointType> &points, AreaType &area, int level)
+        : points(points.begin(), points.end()) {
+    this->area = area;
+    this->level = level;
+    this->size = (long) this->points.size();
+    sortPoints();
+}
+
+template<typename T>
+BasicSortKDTree<T>::BasicSortKDTree(std::pmr::vector<PointType> &&points, AreaType &area, int level, NodeArena *arena)
+        : points(std::move(points)) {
     this->area = area;
     this->level = level;
+    this->arena = arena;
+    this->size = (long) this->points.size();
+    sortPoints();
+}
+
+template<typename T>
+void BasicSortKDTree<T>::sortPoints() {
+    // ties are broken by the other coordinate, so buildTree() and buildTreePresorted() create the same tree
     if (level % 2 == 0) {
-        sort(this->points.begin(), this->points.end(), [](const Point &a, const Point &b) {
-            return a.x < b.x;
+        sort(this->points.begin(), this->points.end(), [](const PointType &a, const PointType &b) {
+            return a.x < b.x || (a.x == b.x && a.y < b.y);
         });
     } else {
-        sort(this->points.begin(), this->points.end(), [](const Point &a, const Point &b) {
-            return a.y < b.y;
+        sort(this->points.begin(), this->points.end(), [](const PointType &a, const PointType &b) {
+            return a.y < b.y || (a.y == b.y && a.x < b.x);
         });
     }
 }
 
 
-SortKDTree::~SortKDTree() {
+template<typename T>
+BasicSortKDTree<T>::~BasicSortKDTree() {
     this->points.clear();
-    delete this->leftChild;
-    delete this->rightChild;
+    // nodes of an arena are freed together with the arena
+    if (this->arena == nullptr) {
+        delete this->leftChild;
+        delete this->rightChild;
+    }
 }
 
 
-void SortKDTree::buildTree(int lev) {
+template<typename T>
+void BasicSortKDTree<T>::buildTree(int lev) {
     if (this->points.size() > 1) {
         // vertical split
         if (lev % 2 == 0) {
@@ -45,61 +79,262 @@ void SortKDTree::buildTree(int lev) {
     }
 }
 
-void SortKDTree::buildTree() {
+template<typename T>
+void BasicSortKDTree<T>::buildTree() {
     buildTree(0);
 }
 
-void SortKDTree::setVerticalChildren(int lev) {
-    std::vector<std::vector<Point>> splitVectors = splitVector(points);
-    Area leftArea = Area{this->area.xMin, getMedian(points, true), this->area.yMin, this->area.yMax};
-    this->leftChild = new SortKDTree(splitVectors[0], leftArea, lev + 1);
-    Area rightArea = Area{getMedian(points, true), this->area.xMax, this->area.yMin, this->area.yMax};
-    this->rightChild = new SortKDTree(splitVectors[1], rightArea, lev + 1);
+template<typename T>
+void BasicSortKDTree<T>::buildTreePresorted() {
+    if (this->points.size() <= 1 || this->leftChild != nullptr) {
+        return;
+    }
+    rebuildPresorted();
 }
 
-void SortKDTree::setHorizontalChildren(int lev) {
-    std::vector<std::vector<Point>> splitVectors = splitVector(points);
-    Area lowerArea = Area{this->area.xMin, this->area.xMax, this->area.yMin, getMedian(points, false)};
-    this->leftChild = new SortKDTree(splitVectors[0], lowerArea, lev + 1);
-    Area higherArea = Area{this->area.xMin, this->area.xMax, getMedian(points, false), this->area.yMax};
-    this->rightChild = new SortKDTree(splitVectors[1], higherArea, lev + 1);
+template<typename T>
+void BasicSortKDTree<T>::rebuildPresorted() {
+    int count = (int) this->points.size();
+    // the points are sorted by the split coordinate already, their indices are the first order
+    vector<int> order(count), otherOrder(count), buffer(count);
+    iota(order.begin(), order.end(), 0);
+    iota(otherOrder.begin(), otherOrder.end(), 0);
+    const PointType *base = this->points.data();
+    bool vertical = this->level % 2 == 0;
+    sort(otherOrder.begin(), otherOrder.end(), [base, vertical](int a, int b) {
+        T otherA = vertical ? base[a].y : base[a].x, otherB = vertical ? base[b].y : base[b].x;
+        T coordinateA = vertical ? base[a].x : base[a].y, coordinateB = vertical ? base[b].x : base[b].y;
+        return otherA < otherB || (otherA == otherB && (coordinateA < coordinateB
+                                                        || (coordinateA == coordinateB && a < b)));
+    });
+    buildTreePresorted(base, order.data(), otherOrder.data(), buffer.data(), this->level);
 }
 
-bool SortKDTree::contains(Point point) {
-    SortKDTree *current = this;
-    while (!current->isLeaf()) {
-        if (current->level % 2 == 0) {
-            current = getMedian(current->points, true) >= point.x ? current->leftChild : current->rightChild;
+template<typename T>
+void BasicSortKDTree<T>::buildTreePresorted(const PointType *base, int *order, int *otherOrder, int *buffer,
+                                            int lev) {
+    int count = (int) this->points.size();
+    if (count <= 1) {
+        return;
+    }
+    int middle = count / 2;
+    int pivot = order[middle];
+    bool vertical = lev % 2 == 0;
+    // same order as sortPoints(), equal points are ordered by their index
+    auto precedesPivot = [base, pivot, vertical](int index) {
+        T a = vertical ? base[index].x : base[index].y, b = vertical ? base[pivot].x : base[pivot].y;
+        T otherA = vertical ? base[index].y : base[index].x, otherB = vertical ? base[pivot].y : base[pivot].x;
+        return a < b || (a == b && (otherA < otherB || (otherA == otherB && index < pivot)));
+    };
+    // stable partition of otherOrder, afterwards it is the sort order of both children
+    int lowerCount = 0, higherCount = 0;
+    for (int i = 0; i < count; i++) {
+        int index = otherOrder[i];
+        if (precedesPivot(index)) {
+            otherOrder[lowerCount++] = index;
         } else {
-            current = getMedian(current->points, false) >= point.y ? current->leftChild : current->rightChild;
+            buffer[higherCount++] = index;
         }
     }
-    return current->points[0] == point;
+    copy(buffer, buffer + higherCount, otherOrder + lowerCount);
+
+    T median = getMedian(this->points, vertical);
+    this->split = median;
+    AreaType lowerArea = vertical ? AreaType{this->area.xMin, median, this->area.yMin, this->area.yMax}
+                                  : AreaType{this->area.xMin, this->area.xMax, this->area.yMin, median};
+    AreaType higherArea = vertical ? AreaType{median, this->area.xMax, this->area.yMin, this->area.yMax}
+                                   : AreaType{this->area.xMin, this->area.xMax, median, this->area.yMax};
+    std::pmr::vector<PointType> lower(nodeResource(arena)), higher(nodeResource(arena));
+    lower.reserve(middle);
+    higher.reserve(count - middle);
+    for (int i = 0; i < middle; i++) {
+        lower.push_back(base[otherOrder[i]]);
+    }
+    for (int i = middle; i < count; i++) {
+        higher.push_back(base[otherOrder[i]]);
+    }
+    // the children are created unsorted and receive their points already in order
+    this->leftChild = new(arena) BasicSortKDTree(std::pmr::vector<PointType>(nodeResource(arena)), lowerArea,
+                                                 lev + 1, arena);
+    this->leftChild->points = std::move(lower);
+    this->leftChild->size = middle;
+    this->rightChild = new(arena) BasicSortKDTree(std::pmr::vector<PointType>(nodeResource(arena)), higherArea,
+                                                  lev + 1, arena);
+    this->rightChild->points = std::move(higher);
+    this->rightChild->size = count - middle;
+    this->leftChild->buildTreePresorted(base, otherOrder, order, buffer, lev + 1);
+    this->rightChild->buildTreePresorted(base, otherOrder + middle, order + middle, buffer, lev + 1);
+}
+
+template<typename T>
+void BasicSortKDTree<T>::setVerticalChildren(int lev) {
+    auto middle = points.begin() + (long long) points.size() / 2;
+    std::pmr::vector<PointType> lower(points.begin(), middle, nodeResource(arena));
+    std::pmr::vector<PointType> higher(middle, points.end(), nodeResource(arena));
+    this->split = getMedian(points, true);
+    AreaType leftArea = AreaType{this->area.xMin, getMedian(points, true), this->area.yMin, this->area.yMax};
+    this->leftChild = new(arena) BasicSortKDTree(std::move(lower), leftArea, lev + 1, arena);
+    AreaType rightArea = AreaType{getMedian(points, true), this->area.xMax, this->area.yMin, this->area.yMax};
+    this->rightChild = new(arena) BasicSortKDTree(std::move(higher), rightArea, lev + 1, arena);
+}
+
+template<typename T>
+void BasicSortKDTree<T>::setHorizontalChildren(int lev) {
+    auto middle = points.begin() + (long long) points.size() / 2;
+    std::pmr::vector<PointType> lower(points.begin(), middle, nodeResource(arena));
+    std::pmr::vector<PointType> higher(middle, points.end(), nodeResource(arena));
+    this->split = getMedian(points, false);
+    AreaType lowerArea = AreaType{this->area.xMin, this->area.xMax, this->area.yMin, getMedian(points, false)};
+    this->leftChild = new(arena) BasicSortKDTree(std::move(lower), lowerArea, lev + 1, arena);
+    AreaType higherArea = AreaType{this->area.xMin, this->area.xMax, getMedian(points, false), this->area.yMax};
+    this->rightChild = new(arena) BasicSortKDTree(std::move(higher), higherArea, lev + 1, arena);
+}
+
+template<typename T>
+void BasicSortKDTree<T>::compact() {
+    if (this->isCompact()) {
+        return;
+    }
+    this->compactNodes.reserve(2 * this->size);
+    this->leafPoints.reserve(this->size);
+    appendCompact(this);
+    // nodes of an arena are freed together with the arena
+    if (this->arena == nullptr) {
+        delete this->leftChild;
+        delete this->rightChild;
+    }
+    this->leftChild = nullptr;
+    this->rightChild = nullptr;
+    std::pmr::vector<PointType>(this->points.get_allocator()).swap(this->points);
 }
 
-list<Point> SortKDTree::query(Area &queryRectangle) {
-    list<Point> result;
-    if (this->isLeaf()) {
-        if (containsPoint(queryRectangle, this->points[0])) {
-            result.push_back(this->points[0]);
+template<typename T>
+bool BasicSortKDTree<T>::isCompact() {
+    return !this->compactNodes.empty();
+}
+
+template<typename T>
+int BasicSortKDTree<T>::appendCompact(BasicSortKDTree *node) {
+    int index = (int) this->compactNodes.size();
+    this->compactNodes.push_back(CompactNode{0, -1, (int) this->leafPoints.size(), 0});
+    if (node->isLeaf() || node->leftChild == nullptr) {
+        this->leafPoints.insert(this->leafPoints.end(), node->points.begin(), node->points.end());
+    } else {
+        appendCompact(node->leftChild);
+        int right = appendCompact(node->rightChild);
+        this->compactNodes[index].split = node->split;
+        this->compactNodes[index].right = right;
+    }
+    this->compactNodes[index].to = (int) this->leafPoints.size();
+    return index;
+}
+
+template<typename T>
+bool BasicSortKDTree<T>::compactContains(int index, int lev, PointType &point) {
+    CompactNode &node = this->compactNodes[index];
+    if (node.right < 0) {
+        for (int i = node.from; i < node.to; i++) {
+            if (this->leafPoints[i] == point) {
+                return true;
+            }
         }
-        return result;
-    } else if (containsArea(queryRectangle, this->area)) {
-        result.insert(result.end(), this->points.begin(), this->points.end());
-        return result;
+        return false;
     }
-    if (this->leftChild != nullptr && intersects(queryRectangle, this->leftChild->area)) {
-        list<Point> childResult = this->leftChild->query(queryRectangle);
-        result.insert(result.end(), childResult.begin(), childResult.end());
+    T coordinate = lev % 2 == 0 ? point.x : point.y;
+    // points equal to the median can be on both sides
+    if (coordinate < node.split) {
+        return compactContains(index + 1, lev + 1, point);
+    } else if (coordinate > node.split) {
+        return compactContains(node.right, lev + 1, point);
     }
-    if (this->rightChild != nullptr && intersects(queryRectangle, this->rightChild->area)) {
-        list<Point> childResult = this->rightChild->query(queryRectangle);
-        result.insert(result.end(), childResult.begin(), childResult.end());
+    return compactContains(index + 1, lev + 1, point) || compactContains(node.right, lev + 1, point);
+}
+
+template<typename T>
+int BasicSortKDTree<T>::compactHeight(int index) {
+    CompactNode &node = this->compactNodes[index];
+    if (node.right < 0) {
+        return 1;
+    }
+    return max(compactHeight(index + 1), compactHeight(node.right)) + 1;
+}
+
+template<typename T>
+void BasicSortKDTree<T>::compactChildAreas(int index, int lev, const AreaType &nodeArea, AreaType &lower,
+                                           AreaType &higher) {
+    T split = this->compactNodes[index].split;
+    if (lev % 2 == 0) {
+        lower = AreaType{nodeArea.xMin, split, nodeArea.yMin, nodeArea.yMax};
+        higher = AreaType{split, nodeArea.xMax, nodeArea.yMin, nodeArea.yMax};
+    } else {
+        lower = AreaType{nodeArea.xMin, nodeArea.xMax, nodeArea.yMin, split};
+        higher = AreaType{nodeArea.xMin, nodeArea.xMax, split, nodeArea.yMax};
+    }
+}
+
+template<typename T>
+void BasicSortKDTree<T>::compactKNearestNeighborsHelper(int index, int lev, const AreaType &nodeArea,
+                                                        const PointType &queryPoint, Scratch &scratch) {
+    scratch.visit();
+    CompactNode &node = this->compactNodes[index];
+    if (node.right < 0) {
+        for (int i = node.from; i < node.to; i++) {
+            scratch.offer(this->leafPoints[i], pointDistance(this->leafPoints[i], queryPoint));
+        }
+        return;
+    }
+    AreaType lower{}, higher{};
+    compactChildAreas(index, lev, nodeArea, lower, higher);
+    int nearChild = index + 1, farChild = node.right;
+    SquaredDistance<T> nearDistance = sqDistanceFrom(lower, queryPoint);
+    SquaredDistance<T> farDistance = sqDistanceFrom(higher, queryPoint);
+    if (farDistance < nearDistance) {
+        swap(nearChild, farChild);
+        swap(nearDistance, farDistance);
+        swap(lower, higher);
+    }
+    if (nearDistance < scratch.radius()) {
+        compactKNearestNeighborsHelper(nearChild, lev + 1, lower, queryPoint, scratch);
+    }
+    if (farDistance < scratch.radius()) {
+        compactKNearestNeighborsHelper(farChild, lev + 1, higher, queryPoint, scratch);
+    }
+}
+
+template<typename T>
+bool BasicSortKDTree<T>::contains(PointType point) {
+    if (this->isCompact()) {
+        return compactContains(0, this->level, point);
     }
+    BasicSortKDTree *current = this;
+    while (!current->isLeaf()) {
+        T coordinate = current->level % 2 == 0 ? point.x : point.y;
+        // points equal to the median can be on both sides
+        if (coordinate == current->split) {
+            return current->leftChild->contains(point) || current->rightChild->contains(point);
+        }
+        current = coordinate < current->split ? current->leftChild : current->rightChild;
+    }
+    return find(current->points.begin(), current->points.end(), point) != current->points.end();
+}
+
+template<typename T>
+list<BasicPoint<T>> BasicSortKDTree<T>::query(AreaType &queryRectangle) {
+    list<PointType> result;
+    query(queryRectangle, back_inserter(result));
     return result;
 }
 
-int SortKDTree::getHeight() {
+template<typename T>
+void BasicSortKDTree<T>::query(AreaType &queryRectangle, vector<PointType> &result) {
+    query(queryRectangle, back_inserter(result));
+}
+
+template<typename T>
+int BasicSortKDTree<T>::getHeight() {
+    if (this->isCompact()) {
+        return compactHeight(0);
+    }
     if (isLeaf()) {
         return 1;
     }
@@ -115,81 +350,188 @@ int SortKDTree::getHeight() {
     }
 }
 
-bool SortKDTree::isLeaf() {
-    return this->points.size() == 1;
+template<typename T>
+bool BasicSortKDTree<T>::isLeaf() {
+    return this->leftChild == nullptr;
 }
 
-void SortKDTree::add(Point &point) {
-    SortKDTree *current = this;
-    int lev = 0;
+template<typename T>
+void BasicSortKDTree<T>::add(PointType &point) {
+    // the compact form has no nodes to route the point through, it would be lost
+    if (this->isCompact()) {
+        throw std::logic_error("cannot add to a compacted BasicSortKDTree");
+    }
+    vector<BasicSortKDTree *> path;
+    BasicSortKDTree *current = this;
     while (!current->isLeaf()) {
-        if ((lev++ % 2) == 0) {
-            // check X-coordinate
-            if (point.x <= (current->area.xMin + current->area.xMax) / 2.0) {
-                current = current->leftChild;
-            } else {
-                current = current->rightChild;
-            }
-            // check y-coordinate
+        path.push_back(current);
+        current->size++;
+        if (this->tightAreas) {
+            current->area = enclosingArea(current->area, AreaType{point.x, point.x, point.y, point.y});
+        }
+        // searching the sorted copy would cost O(size), dropping it keeps the insertion proportional to the height
+        std::pmr::vector<PointType>(current->points.get_allocator()).swap(current->points);
+        T coordinate = current->level % 2 == 0 ? point.x : point.y;
+        current = coordinate <= current->split ? current->leftChild : current->rightChild;
+    }
+    current->points.push_back(point);
+    current->size++;
+    current->sortPoints();
+    if (current->points.size() > 1) {
+        if (current->level % 2 == 0) {
+            current->setVerticalChildren(current->level);
         } else {
-            if (point.y <= (current->area.yMin + current->area.yMax) / 2.0) {
-                current = current->leftChild;
-            } else {
-                current = current->rightChild;
+            current->setHorizontalChildren(current->level);
+        }
+    }
+    if (this->tightAreas) {
+        current->tightenAreas();
+    }
+
+    // rebuild the highest node whose larger child holds more than SCAPEGOAT_ALPHA of its points
+    for (auto node: path) {
+        long larger = max(node->leftChild->size, node->rightChild->size);
+        if ((double) larger > SCAPEGOAT_ALPHA * (double) node->size) {
+            node->rebuild();
+            if (this->tightAreas) {
+                node->tightenAreas();
             }
+            return;
         }
     }
-    current->appendPoint(point, lev);
-    if (lev % 2 == 0) {
-        current->setVerticalChildren(lev);
-    } else {
-        current->setHorizontalChildren(lev);
+}
+
+template<typename T>
+void BasicSortKDTree<T>::tightenAreas() {
+    this->tightAreas = true;
+    if (this->isCompact()) {
+        if (!this->leafPoints.empty()) {
+            this->area = boundingBox(this->leafPoints.data(), this->leafPoints.data() + this->leafPoints.size());
+        }
+        return;
+    } else if (this->isLeaf()) {
+        if (!this->points.empty()) {
+            this->area = boundingBox(this->points.data(), this->points.data() + this->points.size());
+        }
+        return;
     }
+    this->leftChild->tightenAreas();
+    this->rightChild->tightenAreas();
+    this->area = enclosingArea(this->leftChild->area, this->rightChild->area);
 }
 
-void SortKDTree::appendPoint(Point &point, int lev) {
-    points.push_back(point);
-    if ((lev % 2 == 0 && points[0].x > point.x) || (lev % 2 != 0 && points[0].y > point.y)) {
-        swap(points[0], point);
+template<typename T>
+long BasicSortKDTree<T>::queryVisits(AreaType &queryRectangle) {
+    if (this->isCompact()) {
+        return compactQueryVisits(0, this->level, this->area, queryRectangle);
     }
+    // same pruning as queryHelper()
+    if (this->isLeaf() || (containsArea(queryRectangle, this->area) && (long) this->points.size() == this->size)) {
+        return 1;
+    }
+    long result = 1;
+    if (this->leftChild != nullptr && intersects(queryRectangle, this->leftChild->area)) {
+        result += this->leftChild->queryVisits(queryRectangle);
+    }
+    if (this->rightChild != nullptr && intersects(queryRectangle, this->rightChild->area)) {
+        result += this->rightChild->queryVisits(queryRectangle);
+    }
+    return result;
 }
 
-void SortKDTree::kNearestNeighborsHelper(SortKDTree *node, int k,
-                                         priority_queue<SortKDTree *, std::vector<SortKDTree *>, CompareMKDTree> &queue,
-                                         vector<Point> &result) {
-    if (node == nullptr) {
-        return;
+template<typename T>
+long BasicSortKDTree<T>::compactQueryVisits(int index, int lev, AreaType nodeArea, AreaType &queryRectangle) {
+    CompactNode &node = this->compactNodes[index];
+    if (node.right < 0 || containsArea(queryRectangle, nodeArea)) {
+        return 1;
+    }
+    AreaType lower{}, higher{};
+    compactChildAreas(index, lev, nodeArea, lower, higher);
+    long result = 1;
+    if (intersects(queryRectangle, lower)) {
+        result += compactQueryVisits(index + 1, lev + 1, lower, queryRectangle);
     }
+    if (intersects(queryRectangle, higher)) {
+        result += compactQueryVisits(node.right, lev + 1, higher, queryRectangle);
+    }
+    return result;
+}
 
-    if (node->isLeaf()) {
-        queue.push(node);
-    } else {
-        queue.push(node->leftChild);
-        queue.push(node->rightChild);
+template<typename T>
+void BasicSortKDTree<T>::rebuild() {
+    std::pmr::vector<PointType> collected(nodeResource(arena));
+    collected.reserve(this->size);
+    collectPoints(collected);
+    // nodes of an arena are freed together with the arena
+    if (this->arena == nullptr) {
+        delete this->leftChild;
+        delete this->rightChild;
     }
+    this->leftChild = nullptr;
+    this->rightChild = nullptr;
+    this->points = std::move(collected);
+    sortPoints();
+    rebuildPresorted();
+}
 
-    while (!queue.empty() && result.size() < k) {
-        SortKDTree *current = queue.top();
-        queue.pop();
+template<typename T>
+void BasicSortKDTree<T>::collectPoints(std::pmr::vector<PointType> &result) {
+    if (this->isLeaf() || (long) this->points.size() == this->size) {
+        result.insert(result.end(), this->points.begin(), this->points.end());
+        return;
+    }
+    this->leftChild->collectPoints(result);
+    this->rightChild->collectPoints(result);
+}
 
-        if (current->isLeaf()) {
-            result.push_back(current->points[0]);
-        } else {
-            kNearestNeighborsHelper(current, k, queue, result);
+template<typename T>
+void BasicSortKDTree<T>::kNearestNeighborsHelper(const PointType &queryPoint, Scratch &scratch) {
+    scratch.visit();
+    if (this->isLeaf() || this->leftChild == nullptr) {
+        for (auto &point: this->points) {
+            scratch.offer(point, pointDistance(point, queryPoint));
         }
+        return;
+    }
+    // visit the closer child first, the second one is often pruned by then
+    BasicSortKDTree *nearChild = this->leftChild;
+    BasicSortKDTree *farChild = this->rightChild;
+    SquaredDistance<T> nearDistance = sqDistanceFrom(nearChild->area, queryPoint);
+    SquaredDistance<T> farDistance = sqDistanceFrom(farChild->area, queryPoint);
+    if (farDistance < nearDistance) {
+        swap(nearChild, farChild);
+        swap(nearDistance, farDistance);
+    }
+    if (nearDistance < scratch.radius()) {
+        nearChild->kNearestNeighborsHelper(queryPoint, scratch);
+    }
+    if (farDistance < scratch.radius()) {
+        farChild->kNearestNeighborsHelper(queryPoint, scratch);
     }
 }
 
-vector<Point> SortKDTree::kNearestNeighbors(Point &queryPoint, int k) {
-    vector<Point> result;
-    result.reserve(k);
-    CompareMKDTree compareFunction(queryPoint);
-    std::priority_queue<SortKDTree *, vector<SortKDTree *>, CompareMKDTree> queue(compareFunction);
-    kNearestNeighborsHelper(this, k, queue, result);
+template<typename T>
+vector<BasicPoint<T>> BasicSortKDTree<T>::kNearestNeighbors(PointType &queryPoint, int k) {
+    vector<PointType> result;
+    Scratch scratch;
+    kNearestNeighbors(queryPoint, k, scratch, result);
     return result;
 }
 
+template<typename T>
+void BasicSortKDTree<T>::kNearestNeighbors(PointType &queryPoint, int k, Scratch &scratch,
+                                           vector<PointType> &result) {
+    scratch.reset(k);
+    if (this->isCompact()) {
+        compactKNearestNeighborsHelper(0, this->level, this->area, queryPoint, scratch);
+    } else {
+        kNearestNeighborsHelper(queryPoint, scratch);
+    }
+    scratch.extractSorted(result);
+}
 
+template class BasicSortKDTree<double>;
 
+template class BasicSortKDTree<float>;
 
-
+template class BasicSortKDTree<int32_t>;
@@ -0,0 +1,234 @@
+//
+// Created by omarc on 12/01/2024.
+//
+
+#include "../include/WorkStealingPool.h"
+#include <array>
+
+thread_local WorkStealingPool *WorkStealingPool::currentPool = nullptr;
+thread_local int WorkStealingPool::currentQueue = 0;
+
+WorkStealingPool::WorkStealingPool(unsigned threadCount) {
+    threadCount = std::max(threadCount, 1u);
+    for (unsigned i = 0; i < threadCount; i++) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    // the thread calling wait() is the remaining worker
+    for (unsigned i = 1; i < threadCount; i++) {
+        workers.emplace_back([this, i] { workerLoop((int) i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    stopping.store(true);
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        wakeUp.notify_all();
+    }
+    for (auto &worker: workers) {
+        worker.join();
+    }
+}
+
+unsigned WorkStealingPool::threadCount() const {
+    return (unsigned) queues.size();
+}
+
+int WorkStealingPool::queueIndex() const {
+    return currentPool == this ? currentQueue : 0;
+}
+
+void WorkStealingPool::push(Task task) {
+    WorkQueue &queue = *queues[queueIndex()];
+    {
+        std::lock_guard<std::mutex> guard(queue.lock);
+        queue.tasks.push_back(std::move(task));
+    }
+    queued.fetch_add(1, std::memory_order_release);
+    wakeUp.notify_one();
+}
+
+bool WorkStealingPool::runOne(int self) {
+    Task task;
+    bool found = false;
+    int queueCount = (int) queues.size();
+    for (int i = 0; i < queueCount && !found; i++) {
+        WorkQueue &queue = *queues[(self + i) % queueCount];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        // own queue: newest task first, other queues: steal the oldest (largest) task
+        if (i == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        found = true;
+    }
+    if (!found) {
+        return false;
+    }
+    queued.fetch_sub(1, std::memory_order_relaxed);
+    task.function();
+    task.group->pending.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+void WorkStealingPool::wait(TaskGroup &group) {
+    int self = queueIndex();
+    while (group.pending.load(std::memory_order_acquire) > 0) {
+        if (!runOne(self)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void WorkStealingPool::workerLoop(int self) {
+    currentPool = this;
+    currentQueue = self;
+    while (!stopping.load()) {
+        if (!runOne(self)) {
+            std::unique_lock<std::mutex> lock(sleepLock);
+            wakeUp.wait_for(lock, std::chrono::milliseconds(1), [this] {
+                return stopping.load() || queued.load(std::memory_order_acquire) > 0;
+            });
+        }
+    }
+}
+
+template<typename T>
+T parallelMedian(WorkStealingPool &pool, BasicPoint<T> *points, bool x, int left, int right, int pos) {
+    auto key = [x](const BasicPoint<T> &point) { return x ? point.x : point.y; };
+    vector<BasicPoint<T>> buffer;
+
+    while (right - left > PARALLEL_PARTITION_THRESHOLD && pool.threadCount() > 1) {
+        int size = right - left;
+        // pivot is the median of an evenly spaced sample
+        T sample[127];
+        for (int i = 0; i < 127; i++) {
+            sample[i] = key(points[left + (int) ((long long) size * i / 127)]);
+        }
+        std::nth_element(sample, sample + 63, sample + 127);
+        T pivot = sample[63];
+
+        // count elements lower than, equal to and greater than the pivot per chunk
+        int chunkCount = (int) pool.threadCount() * 4;
+        int chunk = (size + chunkCount - 1) / chunkCount;
+        vector<array<int, 3>> counts(chunkCount, {0, 0, 0});
+        pool.parallelFor(0, chunkCount, 1, [&](int lo, int hi) {
+            for (int c = lo; c < hi; c++) {
+                int end = std::min(right, left + (c + 1) * chunk);
+                for (int i = left + c * chunk; i < end; i++) {
+                    T value = key(points[i]);
+                    counts[c][value < pivot ? 0 : (value == pivot ? 1 : 2)]++;
+                }
+            }
+        });
+
+        // turn the counts into write offsets of each chunk
+        int totals[3] = {0, 0, 0};
+        for (auto &count: counts) {
+            for (int k = 0; k < 3; k++) {
+                int current = count[k];
+                count[k] = totals[k];
+                totals[k] += current;
+            }
+        }
+        for (auto &count: counts) {
+            count[1] += totals[0];
+            count[2] += totals[0] + totals[1];
+        }
+
+        buffer.resize(size);
+        pool.parallelFor(0, chunkCount, 1, [&](int lo, int hi) {
+            for (int c = lo; c < hi; c++) {
+                int end = std::min(right, left + (c + 1) * chunk);
+                array<int, 3> offset = counts[c];
+                for (int i = left + c * chunk; i < end; i++) {
+                    T value = key(points[i]);
+                    buffer[offset[value < pivot ? 0 : (value == pivot ? 1 : 2)]++] = points[i];
+                }
+            }
+        });
+        pool.parallelFor(0, size, 1 << 16, [&](int lo, int hi) {
+            std::copy(buffer.begin() + lo, buffer.begin() + hi, points + left + lo);
+        });
+
+        int lowerEnd = left + totals[0];
+        int equalEnd = lowerEnd + totals[1];
+        if (pos < lowerEnd) {
+            right = lowerEnd;
+        } else if (pos >= equalEnd) {
+            left = equalEnd;
+        } else {
+            return pivot;
+        }
+    }
+    return median(points, x, left, right, pos);
+}
+
+template<typename T>
+T parallelMedian(WorkStealingPool &pool, BasicPoint<T> *points, bool x, int left, int right) {
+    int size = right - left;
+    return parallelMedian(pool, points, x, left, right, left + size / 2);
+}
+
+template<typename T>
+void parallelQuadrantSplit(WorkStealingPool &pool, const BasicPoint<T> *points, int size, T xMid, T yMid,
+                           std::pmr::vector<BasicPoint<T>> *quadrants) {
+    // count the points of every quadrant per chunk
+    int chunkCount = (int) pool.threadCount() * 4;
+    int chunk = (size + chunkCount - 1) / chunkCount;
+    vector<array<int, 4>> counts(chunkCount, {0, 0, 0, 0});
+    pool.parallelFor(0, chunkCount, 1, [&](int lo, int hi) {
+        for (int c = lo; c < hi; c++) {
+            int end = std::min(size, (c + 1) * chunk);
+            for (int i = c * chunk; i < end; i++) {
+                counts[c][quadrantOf(points[i], xMid, yMid)]++;
+            }
+        }
+    });
+
+    // turn the counts into write offsets of each chunk
+    int totals[4] = {0, 0, 0, 0};
+    for (auto &count: counts) {
+        for (int q = 0; q < 4; q++) {
+            int current = count[q];
+            count[q] = totals[q];
+            totals[q] += current;
+        }
+    }
+    for (int q = 0; q < 4; q++) {
+        quadrants[q].resize(totals[q]);
+    }
+
+    pool.parallelFor(0, chunkCount, 1, [&](int lo, int hi) {
+        for (int c = lo; c < hi; c++) {
+            int end = std::min(size, (c + 1) * chunk);
+            array<int, 4> offset = counts[c];
+            for (int i = c * chunk; i < end; i++) {
+                int quadrant = quadrantOf(points[i], xMid, yMid);
+                quadrants[quadrant][offset[quadrant]++] = points[i];
+            }
+        }
+    });
+}
+
+template double parallelMedian(WorkStealingPool &, Point *, bool, int, int, int);
+
+template float parallelMedian(WorkStealingPool &, BasicPoint<float> *, bool, int, int, int);
+
+template int32_t parallelMedian(WorkStealingPool &, BasicPoint<int32_t> *, bool, int, int, int);
+
+template double parallelMedian(WorkStealingPool &, Point *, bool, int, int);
+
+template void parallelQuadrantSplit(WorkStealingPool &, const Point *, int, double, double, std::pmr::vector<Point> *);
+
+template void parallelQuadrantSplit(WorkStealingPool &, const BasicPoint<float> *, int, float, float,
+                                    std::pmr::vector<BasicPoint<float>> *);
+
+template void parallelQuadrantSplit(WorkStealingPool &, const BasicPoint<int32_t> *, int, int32_t, int32_t,
+                                    std::pmr::vector<BasicPoint<int32_t>> *);
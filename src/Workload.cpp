@@ -0,0 +1,271 @@
+//
+// Created by omarc on 12/01/2024.
+//
+
+#include "../include/Workload.h"
+#include <thread>
+
+/**
+ * @brief Mixes the bits of x, used to derive independent seeds from a seed and an index
+ */
+static uint64_t splitMix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Random numbers that are equal on every platform for equal seeds
+ */
+struct WorkloadRandom {
+    std::mt19937_64 engine;
+
+    explicit WorkloadRandom(uint64_t seed) : engine(splitMix(seed)) {
+    }
+
+    /**
+     * @return uniform number in [0, 1)
+     */
+    double unit() {
+        return (double) (engine() >> 11) * 0x1.0p-53;
+    }
+
+    /**
+     * @return uniform number in [low, high)
+     */
+    double uniform(double low, double high) {
+        return low + (high - low) * unit();
+    }
+
+    /**
+     * @return uniform index in [0, n)
+     */
+    int index(int n) {
+        return min((int) (unit() * n), n - 1);
+    }
+
+    /**
+     * @return normally distributed number with mean 0, Box-Muller transform
+     */
+    double normal(double deviation) {
+        double u = 1.0 - unit();
+        return deviation * sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * unit());
+    }
+};
+
+/**
+ * @brief Parameters of a distribution shared by all chunks, drawn once from the seed
+ */
+struct DistributionModel {
+    PointDistribution distribution;
+    double bounds;                    /**< Side length of the area */
+    std::vector<Point> centers;       /**< Cluster centers, hotspots or duplicate locations */
+    std::vector<double> cumulative;   /**< Cumulative Zipf weights of the hotspots */
+    double deviation = 0;             /**< Spread around a center or curve */
+    int gridSide = 0;                 /**< Cells per row of JITTERED_GRID */
+};
+
+static constexpr int HOTSPOT_NUMBER = 64;
+static constexpr double ZIPF_EXPONENT = 1.2;
+static constexpr int CURVE_NUMBER = 8;
+
+static DistributionModel createModel(int pointNumber, PointDistribution distribution, uint64_t seed) {
+    DistributionModel model;
+    model.distribution = distribution;
+    model.bounds = distribution == DENSE ? 1000.0 : (double) pointNumber;
+    WorkloadRandom random(seed);
+    double bounds = model.bounds;
+    if (distribution == CLUSTERED) {
+        int clusterNumber = max(pointNumber / 4096, 4);
+        for (int i = 0; i < clusterNumber; i++) {
+            model.centers.push_back(Point{random.uniform(0.1 * bounds, 0.9 * bounds),
+                                          random.uniform(0.1 * bounds, 0.9 * bounds)});
+        }
+        // the clusters rarely overlap
+        model.deviation = bounds / (8.0 * sqrt((double) clusterNumber));
+    } else if (distribution == ZIPF_HOTSPOTS) {
+        double sum = 0;
+        for (int i = 0; i < HOTSPOT_NUMBER; i++) {
+            model.centers.push_back(Point{random.uniform(0, bounds), random.uniform(0, bounds)});
+            sum += 1.0 / pow(i + 1, ZIPF_EXPONENT);
+            model.cumulative.push_back(sum);
+        }
+        for (auto &weight: model.cumulative) {
+            weight /= sum;
+        }
+        model.deviation = 0.002 * bounds;
+    } else if (distribution == CURVES) {
+        // lines from centers[2i] to centers[2i + 1], sine curves use centers[2i] as (phase, amplitude)
+        for (int i = 0; i < CURVE_NUMBER; i++) {
+            model.centers.push_back(Point{random.uniform(0, bounds), random.uniform(0, bounds)});
+            model.centers.push_back(Point{random.uniform(0, bounds), random.uniform(0, bounds)});
+        }
+        model.deviation = 1e-4 * bounds;
+    } else if (distribution == JITTERED_GRID) {
+        model.gridSide = max((int) ceil(sqrt((double) pointNumber)), 1);
+    } else if (distribution == DUPLICATES) {
+        int distinct = max(pointNumber / 16, 1);
+        for (int i = 0; i < distinct; i++) {
+            model.centers.push_back(i % 2 == 0 ? Point{random.uniform(0, bounds), random.uniform(0, bounds)}
+                                               : Point{random.uniform(0.5 * bounds, 0.5 * bounds + 1),
+                                                       random.uniform(0.5 * bounds, 0.5 * bounds + 1)});
+        }
+    }
+    return model;
+}
+
+/**
+ * @brief Generates point index of model
+ */
+static Point generatePoint(const DistributionModel &model, int index, WorkloadRandom &random) {
+    double bounds = model.bounds;
+    switch (model.distribution) {
+        case UNIFORM:
+        case DENSE:
+            break;
+        case CLUSTERED: {
+            const Point &center = model.centers[index % model.centers.size()];
+            return Point{clamp(center.x + random.normal(model.deviation), 0.0, bounds),
+                         clamp(center.y + random.normal(model.deviation), 0.0, bounds)};
+        }
+        case ZIPF_HOTSPOTS: {
+            double pick = random.unit();
+            if (pick < 0.05) {
+                break;
+            }
+            auto hotspot = lower_bound(model.cumulative.begin(), model.cumulative.end(), random.unit());
+            const Point &center = model.centers[min((size_t) (hotspot - model.cumulative.begin()),
+                                                    model.centers.size() - 1)];
+            return Point{clamp(center.x + random.normal(model.deviation), 0.0, bounds),
+                         clamp(center.y + random.normal(model.deviation), 0.0, bounds)};
+        }
+        case CURVES: {
+            int curve = index % CURVE_NUMBER;
+            double t = random.unit();
+            const Point &a = model.centers[2 * curve], &b = model.centers[2 * curve + 1];
+            Point onCurve = curve % 2 == 0
+                            ? Point{a.x + t * (b.x - a.x), a.y + t * (b.y - a.y)}
+                            : Point{t * bounds, b.y + 0.25 * (a.y - 0.5 * bounds)
+                                                      * sin(2.0 * M_PI * (2.0 * t + a.x / bounds))};
+            return Point{clamp(onCurve.x + random.normal(model.deviation), 0.0, bounds),
+                         clamp(onCurve.y + random.normal(model.deviation), 0.0, bounds)};
+        }
+        case JITTERED_GRID: {
+            double cell = bounds / model.gridSide;
+            double x = (index % model.gridSide + 0.5 + random.uniform(-0.25, 0.25)) * cell;
+            double y = (index / model.gridSide + 0.5 + random.uniform(-0.25, 0.25)) * cell;
+            return Point{x, y};
+        }
+        case DUPLICATES:
+            return model.centers[random.index((int) model.centers.size())];
+    }
+    return Point{random.uniform(0, bounds), random.uniform(0, bounds)};
+}
+
+std::string distributionName(PointDistribution distribution) {
+    switch (distribution) {
+        case UNIFORM:
+            return "uniform";
+        case DENSE:
+            return "dense";
+        case CLUSTERED:
+            return "clustered";
+        case ZIPF_HOTSPOTS:
+            return "zipf-hotspots";
+        case CURVES:
+            return "curves";
+        case JITTERED_GRID:
+            return "jittered-grid";
+        case DUPLICATES:
+            return "duplicates";
+    }
+    return "unknown";
+}
+
+Area workloadArea(int pointNumber, PointDistribution distribution) {
+    double bounds = distribution == DENSE ? 1000.0 : (double) pointNumber;
+    return Area{0, bounds, 0, bounds};
+}
+
+/**
+ * @brief Fills points[0, pointNumber) in parallel, chunk c uses an engine seeded with seed and c
+ */
+static void generateInto(Point *points, int pointNumber, PointDistribution distribution, uint64_t seed) {
+    DistributionModel model = createModel(pointNumber, distribution, seed);
+    int chunks = (pointNumber + WORKLOAD_CHUNK - 1) / WORKLOAD_CHUNK;
+    auto generateChunks = [&](int first, int step) {
+        for (int chunk = first; chunk < chunks; chunk += step) {
+            WorkloadRandom random(seed ^ splitMix((uint64_t) chunk + 1));
+            int end = min(pointNumber, (chunk + 1) * WORKLOAD_CHUNK);
+            for (int i = chunk * WORKLOAD_CHUNK; i < end; i++) {
+                points[i] = generatePoint(model, i, random);
+            }
+        }
+    };
+    int threadCount = min(chunks, (int) max(std::thread::hardware_concurrency(), 1u));
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threadCount; t++) {
+        workers.emplace_back(generateChunks, t, threadCount);
+    }
+    generateChunks(0, max(threadCount, 1));
+    for (auto &worker: workers) {
+        worker.join();
+    }
+}
+
+std::vector<Point> generatePoints(int pointNumber, PointDistribution distribution, uint64_t seed) {
+    std::vector<Point> points(max(pointNumber, 0));
+    generateInto(points.data(), (int) points.size(), distribution, seed);
+    return points;
+}
+
+Point *generatePointsArray(int pointNumber, PointDistribution distribution, uint64_t seed) {
+    auto *points = (Point *) malloc(max(pointNumber, 1) * sizeof(Point));
+    generateInto(points, max(pointNumber, 0), distribution, seed);
+    return points;
+}
+
+std::vector<Area> generateQueryAreas(std::vector<Point> &points, Area &area, int number, double selectivity,
+                                     uint64_t seed) {
+    WorkloadRandom random(seed ^ 0x51ed27d3ULL);
+    double width = (area.xMax - area.xMin) * sqrt(selectivity);
+    double height = (area.yMax - area.yMin) * sqrt(selectivity);
+    std::vector<Area> areas;
+    areas.reserve(number);
+    for (int i = 0; i < number && !points.empty(); i++) {
+        Point &center = points[random.index((int) points.size())];
+        areas.push_back(Area{center.x - width / 2, center.x + width / 2, center.y - height / 2,
+                             center.y + height / 2});
+    }
+    return areas;
+}
+
+std::vector<int> generateQueryIndices(int pointNumber, int number, uint64_t seed) {
+    WorkloadRandom random(seed ^ 0x7f4a7c15ULL);
+    std::vector<int> indices;
+    indices.reserve(number);
+    for (int i = 0; i < number && pointNumber > 0; i++) {
+        indices.push_back(random.index(pointNumber));
+    }
+    return indices;
+}
+
+std::vector<Point> generateQueryPoints(std::vector<Point> &points, int number, uint64_t seed) {
+    std::vector<Point> queryPoints;
+    queryPoints.reserve(number);
+    for (int index: generateQueryIndices((int) points.size(), number, seed)) {
+        queryPoints.push_back(points[index]);
+    }
+    return queryPoints;
+}
+
+std::vector<Point> generateQueryPoints(Area &area, int number, uint64_t seed) {
+    WorkloadRandom random(seed ^ 0x2545f491ULL);
+    std::vector<Point> queryPoints;
+    queryPoints.reserve(number);
+    for (int i = 0; i < number; i++) {
+        queryPoints.push_back(Point{random.uniform(area.xMin, area.xMax), random.uniform(area.yMin, area.yMax)});
+    }
+    return queryPoints;
+}
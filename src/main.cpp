@@ -1,6 +1,8 @@
 #include <iostream>
 #include "../include/KDTreeEfficient.h"
 #include "../include/TreeHelper.h"
+#include "../include/CapacityTuner.h"
+#include "../include/PointIO.h"
 #include "spacer/spacer.hpp"
 
 #define FAST_IO() ios_base::sync_with_stdio(false); cin.tie(NULL)
@@ -11,9 +13,38 @@ using namespace util;
 #include <chrono>
 #include <thread>
 
+/**
+ * @brief Tunes the leaf capacity of KDB-Tree and PR-Quadtree for every workload and distribution
+ *
+ * Writes one profile per tree, workload and distribution, e.g. kdb-range-small-uniform.profile
+ * @param directory directory of the profiles
+ */
+void writeCapacityProfiles(const string &directory) {
+    for (auto workload: {BUILD, RANGE_QUERY_SMALL, RANGE_QUERY_MEDIUM, RANGE_QUERY_LARGE, CONTAINS, KNN}) {
+        for (auto distribution: {UNIFORM, DENSE, CLUSTERED}) {
+            string suffix = "-" + workloadName(workload) + "-" + distributionName(distribution) + ".profile";
+            ofstream kdbFile(directory + "/kdb" + suffix);
+            tuneKDBTreeCapacity(workload, distribution).save(kdbFile);
+            ofstream prFile(directory + "/pr" + suffix);
+            tunePRQuadTreeCapacity(workload, distribution).save(prFile);
+            cout << "tuned" << suffix << endl;
+        }
+    }
+}
+
 int main(int argc, char *argv[]) {
     FAST_IO();
-    Point *points = getRandomPointsArray(100000);
+    if (argc == 3 && string(argv[1]) == "--tune") {
+        writeCapacityProfiles(argv[2]);
+        return 0;
+    }
+    if (argc == 4 && string(argv[1]) == "--convert") {
+        vector<Point> converted = loadPointsText(argv[2]);
+        savePointsBinary(argv[3], converted.data(), (long) converted.size());
+        cout << "converted " << converted.size() << " points" << endl;
+        return 0;
+    }
+    Point *points = generatePointsArray(100000, UNIFORM);
     Area area{0, 100000, 0, 100000};
     auto *kdTreeEfficient = new KDTreeEfficient(points, area, 100000);
     kdTreeEfficient->buildTree();
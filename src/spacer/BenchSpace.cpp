@@ -65,7 +65,7 @@ static int64_t queryMYKDTree(int pointNumber, spacer &spacer) {
 
 static int64_t queryNaive(int pointNumber, spacer &spacer) {
     int size = pointNumber;
-    vector<Point> points = getRandomPoints(pointNumber);
+    vector<Point> points = generatePoints(pointNumber, UNIFORM);
     Area bigArea{0.3 * size, 0.5 * size, 0.54 * size, 0.64 * size};
     spacer.reset();
     std::list result = getQueryNaive(points, bigArea);
@@ -77,7 +77,7 @@ static int64_t queryNaive(int pointNumber, spacer &spacer) {
 static int64_t quadTree_contains(int pointNumber, spacer &spacer) {
     int size = pointNumber;
     QuadTree *quadTree = buildQuadTreeRandom(size);
-    std::vector<Point> points = getRandomPoints(size);
+    std::vector<Point> points = generatePoints(size, UNIFORM);
     std::vector<Point> searchPoints;
     searchPoints.reserve(size / 100);
     int step = size / 100;
@@ -94,7 +94,7 @@ static int64_t quadTree_contains(int pointNumber, spacer &spacer) {
 static int64_t prQuadTree_contains(int pointNumber, spacer &spacer) {
     int size = pointNumber;
     PointRegionQuadTree *quadTree = buildPRQuadTreeRandom(size);
-    std::vector<Point> points = getRandomPoints(size);
+    std::vector<Point> points = generatePoints(size, UNIFORM);
     std::vector<Point> searchPoints;
     searchPoints.reserve(size / 100);
     int step = size / 100;
@@ -111,7 +111,7 @@ static int64_t prQuadTree_contains(int pointNumber, spacer &spacer) {
 static int64_t kDTreeEfficient_Contains(int pointNumber, spacer &spacer) {
     int size = pointNumber;
     KDTreeEfficient *tree = buildEKD_Random(size);
-    std::vector<Point> points = getRandomPoints(size);
+    std::vector<Point> points = generatePoints(size, UNIFORM);
     std::vector<Point> searchPoints;
     int step = size / 100;
     for (int i = 0; i < pointNumber; i += step) {
@@ -127,7 +127,7 @@ static int64_t kDTreeEfficient_Contains(int pointNumber, spacer &spacer) {
 static int64_t myKDTree_Contains(int pointNumber, spacer &spacer) {
     int size = pointNumber;
     SortKDTree *tree = buildSortKDTreeRandom(size);
-    std::vector<Point> points = getRandomPoints(size);
+    std::vector<Point> points = generatePoints(size, UNIFORM);
     std::vector<Point> searchPoints;
     int step = size / 100;
     for (int i = 0; i < pointNumber; i += step) {
@@ -142,7 +142,7 @@ static int64_t myKDTree_Contains(int pointNumber, spacer &spacer) {
 
 static int64_t naive_Contains(int pointNumber, spacer &spacer) {
     int size = pointNumber;
-    std::vector<Point> points = getRandomPoints(size);
+    std::vector<Point> points = generatePoints(size, UNIFORM);
     std::vector<Point> searchPoints;
     int step = size / 100;
     for (int i = 0; i < pointNumber; i += step) {
@@ -157,7 +157,7 @@ static int64_t naive_Contains(int pointNumber, spacer &spacer) {
 static int64_t quadTree_NNS(int pointNumber, spacer &spacer) {
     int size = pointNumber;
     QuadTree *quadTree = buildQuadTreeRandom(size);
-    std::vector<Point> points = getRandomPoints(size);
+    std::vector<Point> points = generatePoints(size, UNIFORM);
     std::vector<Point> searchPoints;
     searchPoints.reserve(size / 100);
     int step = size / 100;
@@ -176,7 +176,7 @@ static int64_t quadTree_NNS(int pointNumber, spacer &spacer) {
 static int64_t kDTreeEfficient_NNS(int pointNumber, spacer &spacer) {
     int size = pointNumber;
     KDTreeEfficient *tree = buildEKD_Random(size);
-    std::vector<Point> points = getRandomPoints(size);
+    std::vector<Point> points = generatePoints(size, UNIFORM);
     std::vector<Point> searchPoints;
     int step = size / 100;
     for (int i = 0; i < pointNumber; i += step) {
@@ -193,7 +193,7 @@ static int64_t kDTreeEfficient_NNS(int pointNumber, spacer &spacer) {
 static int64_t myKDTree_NNS(int pointNumber, spacer &spacer) {
     int size = pointNumber;
     auto tree = buildSortKDTreeRandom(size);
-    std::vector<Point> points = getRandomPoints(size);
+    std::vector<Point> points = generatePoints(size, UNIFORM);
     std::vector<Point> searchPoints;
     int step = size / 100;
     for (int i = 0; i < pointNumber; i += step) {
@@ -209,7 +209,7 @@ static int64_t myKDTree_NNS(int pointNumber, spacer &spacer) {
 
 static int64_t naive_NNS(int pointNumber, spacer &spacer) {
     int size = pointNumber;
-    std::vector<Point> points = getRandomPoints(size);
+    std::vector<Point> points = generatePoints(size, UNIFORM);
     std::vector<Point> searchPoints;
     int step = size / 100;
     for (int i = 0; i < pointNumber; i += step) {
@@ -229,7 +229,7 @@ static void startBuildBenchmarks() {
     cout << "Build results in kBytes" << endl;
 
     for (int i = START; i < END; i *= 2) {
-        vector<Point> pointVector = getRandomPoints(i);
+        vector<Point> pointVector = generatePoints(i, UNIFORM);
         double bounds = i;
         Area area{0, bounds, 0, bounds};
 
@@ -247,12 +247,64 @@ static void startBuildBenchmarks() {
     results.emplace_back("----------------------------------------------------------------");
     spacer.reset();
 
+    for (int i = START; i < END; i *= 2) {
+        auto *pointVector = generatePointsArray(i, UNIFORM);
+        double bounds = i;
+        Area area{0, bounds, 0, bounds};
+        spacer.reset();
+        auto quadTree = new QuadTreeEfficient(pointVector, area, i);
+        quadTree->buildTree();
+        int64_t space_in_bytes = spacer.space_used();
+
+        int64_t memory = space_in_bytes / 1024;
+        cout << "Build-Quadtree-Efficient/" + to_string(i) + ": " + to_string(memory) + " kB" + " H: " +
+                to_string(quadTree->getHeight()) << "\n";
+        delete quadTree;
+        free(pointVector);
+    }
+    results.emplace_back("----------------------------------------------------------------");
+    spacer.reset();
+
+    for (int i = START; i < END; i *= 2) {
+        auto *pointVector = generatePointsArray(i, UNIFORM);
+        double bounds = i;
+        Area area{0, bounds, 0, bounds};
+        spacer.reset();
+        auto quadTree = new LinearQuadTree(pointVector, area, i);
+        quadTree->buildTree();
+        int64_t space_in_bytes = spacer.space_used();
+
+        int64_t memory = space_in_bytes / 1024;
+        cout << "Build-Linear-Quadtree/" + to_string(i) + ": " + to_string(memory) + " kB" << "\n";
+        delete quadTree;
+        free(pointVector);
+    }
+    results.emplace_back("----------------------------------------------------------------");
+    spacer.reset();
+
+    for (int i = START; i < END; i *= 2) {
+        vector<Point> pointVector = generatePoints(i, DUPLICATES);
+        double bounds = i;
+        Area area{0, bounds, 0, bounds};
+        spacer.reset();
+        auto quadTree = new CompressedQuadTree(area, pointVector);
+        quadTree->buildTree();
+        int64_t space_in_bytes = spacer.space_used();
+
+        int64_t memory = space_in_bytes / 1024;
+        cout << "Build-Compressed-Quadtree-Duplicates/" + to_string(i) + ": " + to_string(memory) + " kB" + " H: " +
+                to_string(quadTree->getHeight()) << "\n";
+        delete quadTree;
+    }
+    results.emplace_back("----------------------------------------------------------------");
+    spacer.reset();
+
 
     for (int i = START; i < END; i *= 2) {
-        vector<Point> pointVector = getRandomPoints(i);
+        vector<Point> pointVector = generatePoints(i, UNIFORM);
         double bounds = i;
         Area area{0, bounds, 0, bounds};
-        int capacity = (int) max(log10(i), 4.0);
+        int capacity = defaultLeafCapacity(i);
         spacer.reset();
         auto prQuadTree = new PointRegionQuadTree(area, pointVector, capacity);
         prQuadTree->buildTree();
@@ -268,7 +320,7 @@ static void startBuildBenchmarks() {
     spacer.reset();
 
     for (int i = START; i < END; i *= 2) {
-        auto *pointVector = getRandomPointsArray(i);
+        auto *pointVector = generatePointsArray(i, UNIFORM);
         double bounds = i;
         Area area{0, bounds, 0, bounds};
         spacer.reset();
@@ -285,7 +337,25 @@ static void startBuildBenchmarks() {
     spacer.reset();
 
     for (int i = START; i < END; i *= 2) {
-        vector<Point> pointVector = getRandomPoints(i);
+        auto *pointVector = generatePointsArray(i, UNIFORM);
+        double bounds = i;
+        Area area{0, bounds, 0, bounds};
+        spacer.reset();
+        auto implicitKDTree = new ImplicitKDTree(pointVector, area, i);
+        implicitKDTree->buildTree();
+        int64_t space_in_bytes = spacer.space_used();
+        int64_t memory = space_in_bytes / 1024;
+        results.push_back("Build-Implicit-KD/" + to_string(i) + ": " + to_string(memory) + " kB" + " H: " +
+                          to_string(implicitKDTree->getHeight()));
+        delete implicitKDTree;
+        free(pointVector);
+    }
+
+    results.emplace_back("----------------------------------------------------------------");
+    spacer.reset();
+
+    for (int i = START; i < END; i *= 2) {
+        vector<Point> pointVector = generatePoints(i, UNIFORM);
         double bounds = i;
         Area area{0, bounds, 0, bounds};
         spacer.reset();
@@ -298,6 +368,92 @@ static void startBuildBenchmarks() {
         delete myKdTree;
     }
 
+    results.emplace_back("----------------------------------------------------------------");
+    spacer.reset();
+
+    for (int i = START; i < END; i *= 2) {
+        vector<Point> pointVector = generatePoints(i, UNIFORM);
+        double bounds = i;
+        Area area{0, bounds, 0, bounds};
+        spacer.reset();
+        auto myKdTree = new SortKDTree(pointVector, area);
+        myKdTree->buildTreePresorted();
+        myKdTree->compact();
+        int64_t space_in_bytes = spacer.space_used();
+        int64_t memory = space_in_bytes / 1024;
+        results.push_back("Build-My-KDTree-Compact/" + to_string(i) + ": " + to_string(memory) + " kB. " + " H: " +
+                          to_string(myKdTree->getHeight()));
+        delete myKdTree;
+    }
+
+    // arena blocks are mapped directly and not seen by malloc_count, so the bytes handed out by the arena are added
+    results.emplace_back("----------------------------------------------------------------");
+    NodeArena arena;
+    for (int i = START; i < END; i *= 2) {
+        vector<Point> pointVector = generatePoints(i, UNIFORM);
+        double bounds = i;
+        Area area{0, bounds, 0, bounds};
+        spacer.reset();
+        auto quadTree = new QuadTree(area, pointVector, arena);
+        quadTree->buildTree();
+        int64_t space_in_bytes = spacer.space_used() + (int64_t) arena.bytesUsed();
+        int64_t memory = space_in_bytes / 1024;
+        results.push_back("Build-Quadtree-Arena/" + to_string(i) + ": " + to_string(memory) + " kB" + " H: " +
+                          to_string(quadTree->getHeight()));
+        delete quadTree;
+        arena.release();
+    }
+
+    results.emplace_back("----------------------------------------------------------------");
+    for (int i = START; i < END; i *= 2) {
+        vector<Point> pointVector = generatePoints(i, UNIFORM);
+        double bounds = i;
+        Area area{0, bounds, 0, bounds};
+        int capacity = defaultLeafCapacity(i);
+        spacer.reset();
+        auto prQuadTree = new PointRegionQuadTree(area, pointVector, capacity, arena);
+        prQuadTree->buildTree();
+        int64_t space_in_bytes = spacer.space_used() + (int64_t) arena.bytesUsed();
+        int64_t memory = space_in_bytes / 1024;
+        results.push_back("Build-PR-Quadtree-Arena/" + to_string(i) + ": " + to_string(memory) + " kB" + " H: " +
+                          to_string(prQuadTree->getHeight()));
+        delete prQuadTree;
+        arena.release();
+    }
+
+    results.emplace_back("----------------------------------------------------------------");
+    for (int i = START; i < END; i *= 2) {
+        auto *pointVector = generatePointsArray(i, UNIFORM);
+        double bounds = i;
+        Area area{0, bounds, 0, bounds};
+        spacer.reset();
+        auto kdTreeEfficient = new KDTreeEfficient(pointVector, area, i, arena);
+        kdTreeEfficient->buildTree();
+        int64_t space_in_bytes = spacer.space_used() + (int64_t) arena.bytesUsed();
+        int64_t memory = space_in_bytes / 1024;
+        results.push_back("Build-KD-Efficient-Arena/" + to_string(i) + ": " + to_string(memory) + " kB" + " H: " +
+                          to_string(kdTreeEfficient->getHeight()));
+        delete kdTreeEfficient;
+        arena.release();
+        free(pointVector);
+    }
+
+    results.emplace_back("----------------------------------------------------------------");
+    for (int i = START; i < END; i *= 2) {
+        vector<Point> pointVector = generatePoints(i, UNIFORM);
+        double bounds = i;
+        Area area{0, bounds, 0, bounds};
+        spacer.reset();
+        auto myKdTree = new SortKDTree(pointVector, area, arena);
+        myKdTree->buildTree();
+        int64_t space_in_bytes = spacer.space_used() + (int64_t) arena.bytesUsed();
+        int64_t memory = space_in_bytes / 1024;
+        results.push_back("Build-My-KDTree-Arena/" + to_string(i) + ": " + to_string(memory) + " kB. " + " H: " +
+                          to_string(myKdTree->getHeight()));
+        delete myKdTree;
+        arena.release();
+    }
+
     for (const auto &record: results) {
         cout << record << "\n";
     }
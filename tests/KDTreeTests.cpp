@@ -4,6 +4,19 @@
 
 #include "../include/KDTreeEfficient.h"
 #include "../include/SortKDTree.h"
+#include "../include/DynamicKDBTree.h"
+#include "../include/ImplicitKDTree.h"
+#include "../include/KDBTreeEfficient.h"
+#include "../include/WorkStealingPool.h"
+#include "../include/NodeArena.h"
+#include "../include/CapacityTuner.h"
+#include "../include/LeafScan.h"
+#include "../include/PointRegionQuadTree.h"
+#include "../include/KDBTreeND.h"
+#include "../include/OrthTree.h"
+#include "../include/FrozenKDTree.h"
+#include "../include/TreeHelper.h"
+#include "TestHelper.h"
 
 namespace KDTreeTests {
 
@@ -18,27 +31,40 @@ namespace KDTreeTests {
         return result;
     }
 
+    std::vector<Point> sortedPoints(std::list<Point> points) {
+        std::vector<Point> v(points.begin(), points.end());
+        std::sort(v.begin(), v.end(), [](const Point &a, const Point &b) {
+            return a.x < b.x || (a.x == b.x && a.y < b.y);
+        });
+        return v;
+    }
+
     void testQuery() {
         Area area{0, 10000, 0, 10000};
         std::vector<Point> points1;
         points1.reserve(10000);
-        auto *points = (Point *) (malloc(10000 * sizeof(Point)));
         for (int i = 0; i < 10000; ++i) {
             Point p{static_cast<double>(std::rand() % 10000), static_cast<double>(std::rand() % 10000)};
-            if (find(points1.begin(), points1.end(), p) != points1.end()) {
+            if (find(points1.begin(), points1.end(), p) == points1.end()) {
                 points1.push_back(p);
-                points[i] = p;
             }
         }
+        int size = (int) points1.size();
+        auto *points = (Point *) (malloc(size * sizeof(Point)));
+        auto *bucketPoints = (Point *) (malloc(size * sizeof(Point)));
+        std::copy(points1.begin(), points1.end(), points);
+        std::copy(points1.begin(), points1.end(), bucketPoints);
 
-        auto *pEfficient = new KDTreeEfficient(points, area, 10000);
+        auto *pEfficient = new KDTreeEfficient(points, area, size);
+        auto *kdbTree = new KDBTreeEfficient(bucketPoints, 0, area, 0, size - 1, 8);
         auto *sortKD = new SortKDTree(points1, area);
         pEfficient->buildTree();
+        kdbTree->buildTree();
         sortKD->buildTree();
 
         Area query3{500, 3939, 232, 23423};
-        assert(pEfficient->query(query3) == naiveQuery(points1, query3));
-        assert(sortKD->query(query3) == naiveQuery(points1, query3));
+        assert(sortedPoints(pEfficient->query(query3)) == sortedPoints(naiveQuery(points1, query3)));
+        assert(sortedPoints(sortKD->query(query3)) == sortedPoints(naiveQuery(points1, query3)));
 
 
         std::vector<Area> areas(10000);
@@ -51,13 +77,889 @@ namespace KDTreeTests {
             a = Area{fromX, toX, fromY, toY};
         }
 
+        std::vector<Point> buffer;
         for (auto &a: areas) {
-            std::list<Point> naive = naiveQuery(points1, a);
-            assert(pEfficient->query(a) == naive);
-            assert(sortKD->query(a) == naive);
+            std::vector<Point> naive = sortedPoints(naiveQuery(points1, a));
+            assert(sortedPoints(pEfficient->query(a)) == naive);
+            assert(sortedPoints(kdbTree->query(a)) == naive);
+            assert(sortedPoints(sortKD->query(a)) == naive);
+
+            buffer.clear();
+            pEfficient->query(a, buffer);
+            assert(sortedPoints({buffer.begin(), buffer.end()}) == naive);
+            size_t count = 0;
+            kdbTree->query(a, [&count](const Point &) { count++; });
+            assert(count == naive.size());
         }
         delete pEfficient;
+        delete kdbTree;
         delete sortKD;
+        free(points);
+        free(bucketPoints);
+    }
+
+    void testImplicitKDTree() {
+        Area area{0, 1000, 0, 1000};
+        std::vector<Point> points1;
+        points1.reserve(10000);
+        for (int i = 0; i < 10000; ++i) {
+            points1.push_back(Point{static_cast<double>(std::rand() % 1000), static_cast<double>(std::rand() % 1000)});
+        }
+        auto *points = (Point *) (malloc(points1.size() * sizeof(Point)));
+        std::copy(points1.begin(), points1.end(), points);
+
+        auto *implicitKD = new ImplicitKDTree(points, area, (int) points1.size());
+        implicitKD->buildTree();
+
+        for (auto &p: points1) {
+            assert(implicitKD->contains(p));
+        }
+        assert(!implicitKD->contains(Point{0.5, 0.5}));
+        assert(!implicitKD->contains(Point{1001, 3}));
+
+        for (int i = 0; i < 1000; i++) {
+            double fromX = std::rand() % 800;
+            double toX = fromX + std::rand() % 500;
+            double fromY = std::rand() % 800;
+            double toY = fromY + std::rand() % 500;
+            Area a{fromX, toX, fromY, toY};
+            assert(sortedPoints(implicitKD->query(a)) == sortedPoints(naiveQuery(points1, a)));
+        }
+        delete implicitKD;
+        free(points);
+    }
+
+    void testParallelBuild() {
+        int size = 3 * PARALLEL_PARTITION_THRESHOLD;
+        Area area{0, (double) size, 0, (double) size};
+        Point *points = getRandomPointsArray(size);
+        auto *parallelPoints = (Point *) malloc(size * sizeof(Point));
+        std::copy(points, points + size, parallelPoints);
+
+        WorkStealingPool pool(4);
+        double splitValue = parallelMedian(pool, parallelPoints, true, 0, size);
+        assert(splitValue == median(points, true, 0, size));
+        for (int i = 0; i < size; i++) {
+            assert(i <= size / 2 ? parallelPoints[i].x <= splitValue : parallelPoints[i].x >= splitValue);
+        }
+
+        auto *serialTree = new KDBTreeEfficient(points, 0, area, 0, size - 1, 8);
+        auto *parallelTree = new KDBTreeEfficient(parallelPoints, 0, area, 0, size - 1, 8, pool);
+        serialTree->buildTree();
+        parallelTree->buildTree(pool);
+        assert(serialTree->getHeight() == parallelTree->getHeight());
+        for (int i = 0; i < size; i += 97) {
+            assert(parallelTree->contains(points[i]) && serialTree->contains(points[i]));
+        }
+        Area queryArea{0.2 * size, 0.4 * size, 0.3 * size, 0.35 * size};
+        assert(parallelTree->query(queryArea).size() == serialTree->query(queryArea).size());
+
+        delete serialTree;
+        delete parallelTree;
+        free(points);
+        free(parallelPoints);
+    }
+
+    void testKNearestNeighbors() {
+        int size = 20000;
+        Area area{0, (double) size, 0, (double) size};
+        std::vector<Point> points1 = getRandomPoints(size);
+        auto *points = (Point *) (malloc(size * sizeof(Point)));
+        auto *bucketPoints = (Point *) (malloc(size * sizeof(Point)));
+        std::copy(points1.begin(), points1.end(), points);
+        std::copy(points1.begin(), points1.end(), bucketPoints);
+
+        auto *pEfficient = new KDTreeEfficient(points, area, size);
+        auto *kdbTree = new KDBTreeEfficient(bucketPoints, 0, area, 0, size - 1, 16);
+        auto *sortKD = new SortKDTree(points1, area);
+        pEfficient->buildTree();
+        kdbTree->buildTree();
+        sortKD->buildTree();
+
+        KNNScratch scratch;
+        std::vector<Point> result;
+        for (int k: {1, 10, 100, 1000, size + 5}) {
+            for (int i = 0; i < 20; i++) {
+                Point queryPoint = getRandomPoint(size + 1000);
+                std::vector<Point> naive = points1;
+                std::sort(naive.begin(), naive.end(), [&queryPoint](const Point &a, const Point &b) {
+                    return pointDistance(a, queryPoint) < pointDistance(b, queryPoint);
+                });
+                naive.resize(std::min(k, size));
+                std::vector<double> expected = neighborDistances(naive, queryPoint);
+
+                assert(neighborDistances(pEfficient->kNearestNeighbors(queryPoint, k), queryPoint) == expected);
+                assert(neighborDistances(sortKD->kNearestNeighbors(queryPoint, k), queryPoint) == expected);
+                kdbTree->kNearestNeighbors(queryPoint, k, scratch, result);
+                assert(neighborDistances(result, queryPoint) == expected);
+            }
+        }
+        delete pEfficient;
+        delete kdbTree;
+        delete sortKD;
+        free(points);
+        free(bucketPoints);
+    }
+
+    void testCount() {
+        int size = 20000;
+        Area area{0, (double) size, 0, (double) size};
+        std::vector<Point> points1 = getRandomPoints(size);
+        auto *points = (Point *) (malloc(size * sizeof(Point)));
+        auto *bucketPoints = (Point *) (malloc(size * sizeof(Point)));
+        std::copy(points1.begin(), points1.end(), points);
+        std::copy(points1.begin(), points1.end(), bucketPoints);
+
+        auto *pEfficient = new KDTreeEfficient(points, area, size);
+        auto *kdbTree = new KDBTreeEfficient(bucketPoints, 0, area, 0, size - 1, 16);
+        pEfficient->buildTree();
+        kdbTree->buildTree();
+        WeightFunction weight = [](const Point &p) { return p.x - p.y; };
+        pEfficient->buildAggregates(weight);
+        kdbTree->buildAggregates(weight);
+
+        for (int i = 0; i < 1000; i++) {
+            double fromX = std::rand() % size;
+            double toX = fromX + std::rand() % (size / 2);
+            double fromY = std::rand() % size;
+            double toY = fromY + std::rand() % (size / 2);
+            Area a{fromX, toX, fromY, toY};
+
+            Aggregate expected;
+            for (auto &p: naiveQuery(points1, a)) {
+                expected.add(weight(p));
+            }
+            assert(pEfficient->count(a) == expected.count);
+            assert(kdbTree->count(a) == expected.count);
+            for (Aggregate result: {pEfficient->aggregate(a), kdbTree->aggregate(a)}) {
+                assert(result.count == expected.count);
+                assert(std::abs(result.sum - expected.sum) <= 1e-6 * std::max(1.0, std::abs(expected.sum)));
+                assert(result.min == expected.min && result.max == expected.max);
+            }
+        }
+        delete pEfficient;
+        delete kdbTree;
+        free(points);
+        free(bucketPoints);
+    }
+
+    void testArena() {
+        int size = 20000;
+        Area area{0, (double) size, 0, (double) size};
+        std::vector<Point> points1 = getRandomPoints(size);
+        auto *points = (Point *) (malloc(size * sizeof(Point)));
+        auto *bucketPoints = (Point *) (malloc(size * sizeof(Point)));
+        std::copy(points1.begin(), points1.end(), points);
+        std::copy(points1.begin(), points1.end(), bucketPoints);
+
+        // small blocks, so the trees span many of them
+        NodeArena arena(1 << 16);
+        auto *pEfficient = new KDTreeEfficient(points, area, size, arena);
+        auto *kdbTree = new KDBTreeEfficient(bucketPoints, 0, area, 0, size - 1, 16, arena);
+        auto *sortKDTree = new SortKDTree(points1, area, arena);
+        pEfficient->buildTree();
+        kdbTree->buildTree();
+        sortKDTree->buildTree();
+        WeightFunction weight = [](const Point &p) { return p.x; };
+        pEfficient->buildAggregates(weight);
+        assert(arena.bytesUsed() > 0 && arena.bytesUsed() <= arena.bytesReserved());
+
+        for (auto &p: points1) {
+            assert(pEfficient->contains(p) && kdbTree->contains(p));
+        }
+        for (int i = 0; i < 200; i++) {
+            double fromX = std::rand() % size;
+            double toX = fromX + std::rand() % (size / 2);
+            double fromY = std::rand() % size;
+            double toY = fromY + std::rand() % (size / 2);
+            Area a{fromX, toX, fromY, toY};
+            std::vector<Point> naive = sortedPoints(naiveQuery(points1, a));
+            assert(sortedPoints(pEfficient->query(a)) == naive);
+            assert(sortedPoints(kdbTree->query(a)) == naive);
+            assert(sortedPoints(sortKDTree->query(a)) == naive);
+            assert(pEfficient->aggregate(a).count == (long) naive.size());
+        }
+
+        // the trees only free their roots, the nodes are released with the arena
+        delete pEfficient;
+        delete kdbTree;
+        delete sortKDTree;
+        arena.release();
+        assert(arena.bytesUsed() == 0 && arena.bytesReserved() == 0);
+        free(points);
+        free(bucketPoints);
+    }
+
+    void testPresortedBuild() {
+        int size = 20000;
+        Area area{0, (double) size, 0, (double) size};
+        std::vector<Point> points = getRandomPoints(size);
+        // coordinate ties and equal points have to be split the same way by both builds
+        for (int i = 0; i < 500; i++) {
+            points.push_back(Point{points[i].x, (double) (std::rand() % size)});
+            points.push_back(points[i + 1000]);
+        }
+        auto *sortKD = new SortKDTree(points, area);
+        auto *presorted = new SortKDTree(points, area);
+        sortKD->buildTree();
+        presorted->buildTreePresorted();
+        assert(sortKD->getHeight() == presorted->getHeight());
+        for (int i = 0; i < 1000; i++) {
+            double fromX = std::rand() % size;
+            double toX = fromX + std::rand() % (size / 4);
+            double fromY = std::rand() % size;
+            double toY = fromY + std::rand() % (size / 4);
+            Area a{fromX, toX, fromY, toY};
+            // same tree, so the points are even reported in the same order
+            std::list<Point> expected = sortKD->query(a);
+            assert(presorted->query(a) == expected);
+            assert(sortedPoints(expected) == sortedPoints(naiveQuery(points, a)));
+        }
+        Point queryPoint{size / 2.0, size / 3.0};
+        assert(presorted->kNearestNeighbors(queryPoint, 20) == sortKD->kNearestNeighbors(queryPoint, 20));
+
+        NodeArena arena;
+        auto *arenaTree = new SortKDTree(points, area, arena);
+        arenaTree->buildTreePresorted();
+        Area all{0, (double) size, 0, (double) size};
+        assert(arenaTree->query(all) == sortKD->query(all));
+        delete arenaTree;
+        delete sortKD;
+        delete presorted;
+    }
+
+    void testCompact() {
+        int size = 20001;
+        Area area{0, (double) size, 0, (double) size};
+        std::vector<Point> points = getRandomPoints(size);
+        for (int i = 0; i < 500; i++) {
+            points.push_back(Point{points[i].x, (double) (std::rand() % size)});
+            points.push_back(points[i + 1000]);
+        }
+        auto *sortKD = new SortKDTree(points, area);
+        auto *compactTree = new SortKDTree(points, area);
+        sortKD->buildTree();
+        compactTree->buildTree();
+        compactTree->compact();
+        assert(compactTree->isCompact() && !sortKD->isCompact());
+        assert(compactTree->getHeight() == sortKD->getHeight());
+        // points equal to a median are found on both sides of the split
+        for (auto &p: points) {
+            assert(compactTree->contains(p));
+        }
+        Point missing{-1, -1};
+        assert(!compactTree->contains(missing));
+        // the compact form cannot grow
+        bool rejected = false;
+        try {
+            compactTree->add(missing);
+        } catch (const std::logic_error &) {
+            rejected = true;
+        }
+        assert(rejected && !compactTree->contains(missing));
+        for (int i = 0; i < 1000; i++) {
+            double fromX = std::rand() % size;
+            double toX = fromX + std::rand() % (size / 4);
+            double fromY = std::rand() % size;
+            double toY = fromY + std::rand() % (size / 4);
+            Area a{fromX, toX, fromY, toY};
+            assert(sortedPoints(compactTree->query(a)) == sortedPoints(naiveQuery(points, a)));
+        }
+        for (int k: {1, 10, 100}) {
+            Point queryPoint{(double) (std::rand() % size), (double) (std::rand() % size)};
+            std::vector<Point> expected = sortKD->kNearestNeighbors(queryPoint, k);
+            std::vector<Point> result = compactTree->kNearestNeighbors(queryPoint, k);
+            assert(result.size() == expected.size());
+            for (size_t i = 0; i < result.size(); i++) {
+                assert(pointDistance(result[i], queryPoint) == pointDistance(expected[i], queryPoint));
+            }
+        }
+        delete sortKD;
+        delete compactTree;
+    }
+
+    void testBalancedAdd() {
+        int size = 20000;
+        Area area{0, (double) size, 0, (double) size};
+        std::vector<Point> points = getRandomPoints(size);
+        // sorted insertion order unbalances a tree without rebuilds
+        std::vector<Point> sortedByX(points);
+        std::sort(sortedByX.begin(), sortedByX.end(), [](const Point &a, const Point &b) { return a.x < b.x; });
+        std::vector<Point> empty;
+        auto *sortKD = new SortKDTree(empty, area);
+        for (auto &p: sortedByX) {
+            sortKD->add(p);
+        }
+        // a weight balanced tree with alpha 0.7 has height below log(n) / log(1 / alpha)
+        int maxHeight = (int) std::ceil(std::log((double) size) / std::log(1 / SCAPEGOAT_ALPHA)) + 2;
+        assert(sortKD->getHeight() <= maxHeight);
+        for (auto &p: points) {
+            assert(sortKD->contains(p));
+        }
+        Point missing{-1, -1};
+        assert(!sortKD->contains(missing));
+        for (int i = 0; i < 1000; i++) {
+            double fromX = std::rand() % size;
+            double toX = fromX + std::rand() % (size / 4);
+            double fromY = std::rand() % size;
+            double toY = fromY + std::rand() % (size / 4);
+            Area a{fromX, toX, fromY, toY};
+            assert(sortedPoints(sortKD->query(a)) == sortedPoints(naiveQuery(points, a)));
+        }
+        Area all{0, (double) size, 0, (double) size};
+        assert((long) sortKD->query(all).size() == size);
+
+        // points added to a built tree
+        std::vector<Point> initial(points.begin(), points.begin() + size / 2);
+        auto *grown = new SortKDTree(initial, area);
+        grown->buildTreePresorted();
+        for (int i = size / 2; i < size; i++) {
+            grown->add(points[i]);
+        }
+        assert(grown->getHeight() <= maxHeight);
+        for (auto &p: points) {
+            assert(grown->contains(p));
+        }
+        Point queryPoint{size / 2.0, size / 4.0};
+        std::vector<Point> nearest = grown->kNearestNeighbors(queryPoint, 10);
+        std::vector<Point> expected = sortKD->kNearestNeighbors(queryPoint, 10);
+        for (int i = 0; i < 10; i++) {
+            assert(pointDistance(nearest[i], queryPoint) == pointDistance(expected[i], queryPoint));
+        }
+        grown->compact();
+        for (auto &p: points) {
+            assert(grown->contains(p));
+        }
+        delete sortKD;
+        delete grown;
+    }
+
+    void testDynamicKDBTree() {
+        int size = 20000;
+        Area area{0, (double) size, 0, (double) size};
+        std::vector<Point> points = getRandomPoints(size);
+        auto *tree = new DynamicKDBTree(area, 64, 8);
+        std::vector<Point> inserted;
+        for (auto &p: points) {
+            tree->add(p);
+            inserted.push_back(p);
+            // check while points are spread over the buffer and several trees
+            if (inserted.size() % 4999 == 0) {
+                Area a{0.1 * size, 0.6 * size, 0.2 * size, 0.5 * size};
+                assert(sortedPoints(tree->query(a)) == sortedPoints(naiveQuery(inserted, a)));
+                assert(tree->count(a) == (long) naiveQuery(inserted, a).size());
+            }
+        }
+        assert(tree->getSize() == size);
+        // 20000 = 312 * 64 + 32, one tree per set bit of 312
+        assert(tree->getTreeCount() == (long) std::bitset<32>(size / 64).count());
+        for (auto &p: points) {
+            assert(tree->contains(p));
+        }
+        Point missing{-1, -1};
+        assert(!tree->contains(missing));
+        for (int i = 0; i < 200; i++) {
+            double fromX = std::rand() % size;
+            double toX = fromX + std::rand() % (size / 4);
+            double fromY = std::rand() % size;
+            double toY = fromY + std::rand() % (size / 4);
+            Area a{fromX, toX, fromY, toY};
+            assert(sortedPoints(tree->query(a)) == sortedPoints(naiveQuery(points, a)));
+        }
+        for (int k: {1, 10, 100}) {
+            Point queryPoint{(double) (std::rand() % size), (double) (std::rand() % size)};
+            std::vector<Point> result = tree->kNearestNeighbors(queryPoint, k);
+            std::vector<Point> byDistance(points);
+            std::sort(byDistance.begin(), byDistance.end(), [&](const Point &a, const Point &b) {
+                return pointDistance(a, queryPoint) < pointDistance(b, queryPoint);
+            });
+            assert(result.size() == (size_t) k);
+            for (int i = 0; i < k; i++) {
+                assert(pointDistance(result[i], queryPoint) == pointDistance(byDistance[i], queryPoint));
+            }
+        }
+        delete tree;
+    }
+
+    void testConcurrentKNearestNeighbors() {
+        int size = 50000;
+        int threadCount = 8;
+        Area area{0, (double) size, 0, (double) size};
+        Point *points = getRandomPointsArray(size);
+        auto *kdbTree = new KDBTreeEfficient(points, 0, area, 0, size - 1, 8);
+        kdbTree->buildTree();
+        const KDBTreeEfficient *tree = kdbTree;
+        std::vector<Point> layout(points, points + size);
+        std::vector<Point> queryPoints = getRandomPoints(threadCount * 200);
+        std::vector<std::vector<Point>> expected;
+        for (auto &q: queryPoints) {
+            expected.push_back(tree->kNearestNeighbors(q, 20));
+        }
+
+        // the searches only read the tree, so they run in parallel and see the same results
+        std::vector<std::thread> readers;
+        std::atomic<int> mismatches{0};
+        for (int t = 0; t < threadCount; t++) {
+            readers.emplace_back([&, t] {
+                KNNScratch scratch;
+                std::vector<Point> result;
+                for (int i = t; i < (int) queryPoints.size(); i += threadCount) {
+                    tree->kNearestNeighbors(queryPoints[i], 20, scratch, result);
+                    if (result != expected[i]) {
+                        mismatches++;
+                    }
+                }
+            });
+        }
+        for (auto &reader: readers) {
+            reader.join();
+        }
+        assert(mismatches == 0);
+        assert(std::equal(layout.begin(), layout.end(), points));
+        delete kdbTree;
+        free(points);
+    }
+
+    void testCapacityProfile() {
+        CapacityProfile empty;
+        assert(empty.empty());
+        assert(empty.capacityFor(10000000) == defaultLeafCapacity(10000000));
+
+        // the closest recorded size class is used
+        CapacityProfile profile;
+        profile.record(1 << 10, 16);
+        profile.record(1 << 20, 64);
+        assert(profile.capacityFor(1 << 10) == 16);
+        assert(profile.capacityFor(1 << 12) == 16);
+        assert(profile.capacityFor(1 << 18) == 64);
+        assert(profile.capacityFor(1 << 24) == 64);
+        assert(profile.capacityFor(1) == 16);
+
+        std::stringstream file;
+        profile.save(file);
+        CapacityProfile loaded = CapacityProfile::load(file);
+        assert(loaded.capacityFor(1 << 12) == 16 && loaded.capacityFor(1 << 18) == 64);
+
+        TuningOptions options;
+        options.sizes = {4096};
+        options.capacities = {4, 32, 128};
+        options.repetitions = 1;
+        options.operations = 50;
+        for (auto distribution: {UNIFORM, DENSE, CLUSTERED, DUPLICATES}) {
+            CapacityProfile kdbProfile = tuneKDBTreeCapacity(RANGE_QUERY_MEDIUM, distribution, options);
+            CapacityProfile prProfile = tunePRQuadTreeCapacity(KNN, distribution, options);
+            int kdbCapacity = kdbProfile.capacityFor(4096), prCapacity = prProfile.capacityFor(4096);
+            assert(kdbCapacity == 4 || kdbCapacity == 32 || kdbCapacity == 128);
+            assert(prCapacity == 4 || prCapacity == 32 || prCapacity == 128);
+        }
+
+        // trees built with a profile answer queries like the ones built with a capacity
+        int size = 20000;
+        Area area = workloadArea(size, CLUSTERED);
+        vector<Point> points = generatePoints(size, CLUSTERED);
+        CapacityProfile tuned;
+        tuned.record(size, 128);
+        auto *prTree = new PointRegionQuadTree(area, points, tuned);
+        prTree->buildTree();
+        auto *pointArray = (Point *) malloc(size * sizeof(Point));
+        std::copy(points.begin(), points.end(), pointArray);
+        auto *kdbTree = new KDBTreeEfficient(pointArray, 0, area, 0, size - 1, tuned);
+        kdbTree->buildTree();
+        for (int i = 0; i < 100; i++) {
+            Point p = points[(i * 7919) % size];
+            assert(prTree->contains(p));
+            Area queryArea{p.x - 200, p.x + 200, p.y - 200, p.y + 200};
+            vector<Point> expected;
+            for (auto &q: points) {
+                if (containsPoint(queryArea, q)) {
+                    expected.push_back(q);
+                }
+            }
+            vector<Point> prResult, kdbResult;
+            prTree->query(queryArea, prResult);
+            kdbTree->query(queryArea, kdbResult);
+            assert(prResult.size() == expected.size() && kdbResult.size() == expected.size());
+        }
+        delete prTree;
+        delete kdbTree;
+        free(pointArray);
+    }
+
+    void testLeafColumns() {
+        LeafScanKernel best = bestLeafScanKernel();
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<int> coordinate(0, 20);
+        double xs[LEAF_SCAN_BLOCK + LEAF_SCAN_PADDING], ys[LEAF_SCAN_BLOCK + LEAF_SCAN_PADDING];
+        // integer coordinates put many points on the borders of the rectangle
+        for (int i = 0; i < LEAF_SCAN_BLOCK + LEAF_SCAN_PADDING; i++) {
+            xs[i] = coordinate(gen);
+            ys[i] = coordinate(gen);
+        }
+        Area area{5, 12, 3, 15};
+        for (auto kernel: {SCALAR_KERNEL, AVX2_KERNEL, AVX512_KERNEL}) {
+            if (!selectLeafScanKernel(kernel)) {
+                continue;
+            }
+            for (int count = 0; count <= LEAF_SCAN_BLOCK; count++) {
+                uint64_t rangeMask = leafRangeMask(xs, ys, count, area);
+                uint64_t equalMask = leafEqualMask(xs, ys, count, xs[0], ys[0]);
+                for (int i = 0; i < LEAF_SCAN_BLOCK; i++) {
+                    Point p{xs[i], ys[i]};
+                    bool inside = i < count && containsPoint(area, p);
+                    bool equal = i < count && p == Point{xs[0], ys[0]};
+                    assert(((rangeMask >> i) & 1) == inside);
+                    assert(((equalMask >> i) & 1) == equal);
+                }
+            }
+        }
+        selectLeafScanKernel(best);
+
+        // dense data with large leaves, columns do not change any result
+        int size = 30000;
+        Point *points = getDensePointsArray(size);
+        Area bounds{0, 1000, 0, 1000};
+        auto *kdbTree = new KDBTreeEfficient(points, 0, bounds, 0, size - 1, 100);
+        kdbTree->buildTree();
+        vector<Point> layout(points, points + size);
+        vector<Area> queryAreas;
+        for (int i = 0; i < 50; i++) {
+            Point p = getRandomPoint(900);
+            queryAreas.push_back(Area{p.x, p.x + 10 + i, p.y, p.y + 100 - i});
+        }
+        vector<vector<Point>> expected;
+        vector<long> counts;
+        for (auto &queryArea: queryAreas) {
+            vector<Point> result;
+            kdbTree->query(queryArea, result);
+            expected.push_back(result);
+            counts.push_back(kdbTree->count(queryArea));
+        }
+        assert(!kdbTree->hasColumns());
+        kdbTree->buildColumns();
+        assert(kdbTree->hasColumns());
+        for (int i = 0; i < (int) queryAreas.size(); i++) {
+            vector<Point> result;
+            kdbTree->query(queryAreas[i], result);
+            assert(result == expected[i]);
+            assert(kdbTree->count(queryAreas[i]) == counts[i]);
+        }
+        for (int i = 0; i < size; i += 97) {
+            assert(kdbTree->contains(layout[i]));
+        }
+        assert(!kdbTree->contains(Point{-1, -1}));
+        delete kdbTree;
+        free(points);
+    }
+
+    void testTightAreas() {
+        int size = 20000;
+        Area area = workloadArea(size, CLUSTERED);
+        vector<Point> points = generatePoints(size, CLUSTERED);
+        Point *kdPoints = (Point *) malloc(size * sizeof(Point));
+        Point *kdbPoints = (Point *) malloc(size * sizeof(Point));
+        std::copy(points.begin(), points.end(), kdPoints);
+        std::copy(points.begin(), points.end(), kdbPoints);
+        auto *kdTree = new KDTreeEfficient(kdPoints, area, size);
+        kdTree->buildTree();
+        auto *kdbTree = new KDBTreeEfficient(kdbPoints, 0, area, 0, size - 1, 16);
+        kdbTree->buildTree();
+        auto *sortKDTree = new SortKDTree(points, area);
+        sortKDTree->buildTreePresorted();
+
+        vector<Area> queryAreas;
+        for (int i = 0; i < 50; i++) {
+            Point p = points[(i * 7919) % size];
+            queryAreas.push_back(Area{p.x - 300, p.x + 300, p.y - 200, p.y + 400});
+        }
+        vector<Point> queryPoints = getRandomPoints(size);
+        queryPoints.resize(50);
+
+        auto sorted = [](vector<Point> &result) {
+            return sortedPoints({result.begin(), result.end()});
+        };
+        vector<vector<Point>> expected;
+        vector<vector<double>> expectedDistances;
+        long cellVisits = 0, cellKnnVisits = 0;
+        KNNScratch scratch;
+        vector<Point> neighbors;
+        for (auto &queryArea: queryAreas) {
+            expected.push_back(sortedPoints(naiveQuery(points, queryArea)));
+            cellVisits += kdTree->queryVisits(queryArea) + kdbTree->queryVisits(queryArea)
+                          + sortKDTree->queryVisits(queryArea);
+        }
+        for (auto &queryPoint: queryPoints) {
+            vector<Point> naive = points;
+            std::sort(naive.begin(), naive.end(), [&queryPoint](const Point &a, const Point &b) {
+                return pointDistance(a, queryPoint) < pointDistance(b, queryPoint);
+            });
+            naive.resize(10);
+            expectedDistances.push_back(neighborDistances(naive, queryPoint));
+            kdbTree->kNearestNeighbors(queryPoint, 10, scratch, neighbors);
+            cellKnnVisits += scratch.getVisitedNodes();
+        }
+
+        kdTree->tightenAreas();
+        kdbTree->tightenAreas();
+        sortKDTree->tightenAreas();
+        long tightVisits = 0, tightKnnVisits = 0;
+        for (int i = 0; i < (int) queryAreas.size(); i++) {
+            vector<Point> kdResult, kdbResult, sortResult;
+            kdTree->query(queryAreas[i], kdResult);
+            kdbTree->query(queryAreas[i], kdbResult);
+            sortKDTree->query(queryAreas[i], sortResult);
+            assert(sorted(kdResult) == expected[i]);
+            assert(sorted(kdbResult) == expected[i]);
+            assert(sorted(sortResult) == expected[i]);
+            assert(kdTree->count(queryAreas[i]) == (long) expected[i].size());
+            assert(kdbTree->count(queryAreas[i]) == (long) expected[i].size());
+            tightVisits += kdTree->queryVisits(queryAreas[i]) + kdbTree->queryVisits(queryAreas[i])
+                           + sortKDTree->queryVisits(queryAreas[i]);
+        }
+        for (int i = 0; i < (int) queryPoints.size(); i++) {
+            assert(neighborDistances(kdTree->kNearestNeighbors(queryPoints[i], 10), queryPoints[i])
+                   == expectedDistances[i]);
+            assert(neighborDistances(sortKDTree->kNearestNeighbors(queryPoints[i], 10), queryPoints[i])
+                   == expectedDistances[i]);
+            kdbTree->kNearestNeighbors(queryPoints[i], 10, scratch, neighbors);
+            assert(neighborDistances(neighbors, queryPoints[i]) == expectedDistances[i]);
+            tightKnnVisits += scratch.getVisitedNodes();
+        }
+        assert(tightVisits <= cellVisits);
+        assert(tightKnnVisits <= cellKnnVisits);
+        for (int i = 0; i < size; i += 101) {
+            assert(kdTree->contains(points[i]) && sortKDTree->contains(points[i]));
+        }
+
+        // inserted points outside of the boxes grow them
+        vector<Point> added = getRandomPoints(size);
+        added.resize(2000);
+        for (auto &p: added) {
+            sortKDTree->add(p);
+            points.push_back(p);
+        }
+        for (auto &p: added) {
+            assert(sortKDTree->contains(p));
+        }
+        for (auto &queryArea: queryAreas) {
+            vector<Point> sortResult;
+            sortKDTree->query(queryArea, sortResult);
+            assert(sorted(sortResult) == sortedPoints(naiveQuery(points, queryArea)));
+        }
+        delete kdTree;
+        delete kdbTree;
+        delete sortKDTree;
+        free(kdPoints);
+        free(kdbPoints);
+    }
+
+    template<typename T, typename Tree>
+    void checkCoordinateTree(vector<BasicPoint<T>> &points, Tree &tree) {
+        int size = (int) points.size();
+        for (auto &p: points) {
+            assert(tree.contains(p));
+        }
+        auto byCoordinates = [](const BasicPoint<T> &a, const BasicPoint<T> &b) {
+            return a.x < b.x || (a.x == b.x && a.y < b.y);
+        };
+        for (int i = 0; i < 50; i++) {
+            BasicPoint<T> p = points[(i * 7919) % size];
+            BasicArea<T> queryArea{(T) (p.x - 300), (T) (p.x + 300), (T) (p.y - 200), (T) (p.y + 400)};
+            vector<BasicPoint<T>> expected, result;
+            std::copy_if(points.begin(), points.end(), back_inserter(expected), [&queryArea](auto &q) {
+                return containsPoint(queryArea, q);
+            });
+            tree.query(queryArea, result);
+            std::sort(expected.begin(), expected.end(), byCoordinates);
+            std::sort(result.begin(), result.end(), byCoordinates);
+            assert(result == expected);
+            if constexpr (requires { tree.count(queryArea); }) {
+                assert(tree.count(queryArea) == (long) expected.size());
+            }
+        }
+
+        // neighbors are compared by distance, points with equal distance may be reported in any order
+        for (int i = 0; i < 20; i++) {
+            BasicPoint<T> queryPoint = points[(i * 104729) % size];
+            queryPoint.x += 3;
+            vector<SquaredDistance<T>> expected;
+            for (auto &p: points) {
+                expected.push_back(pointDistance(p, queryPoint));
+            }
+            std::sort(expected.begin(), expected.end());
+            expected.resize(10);
+            assert(neighborDistances(tree.kNearestNeighbors(queryPoint, 10), queryPoint) == expected);
+        }
+    }
+
+    template<typename T>
+    void checkCoordinateType() {
+        int size = 20000;
+        vector<Point> generated = generatePoints(size, CLUSTERED);
+        vector<BasicPoint<T>> points = convertPoints<T>(generated);
+        vector<BasicPoint<T>> kdPoints = points, kdbPoints = points;
+        BasicArea<T> area = convertArea<T>(workloadArea(size, CLUSTERED));
+        BasicKDTreeEfficient<T> kdTree(kdPoints.data(), area, size);
+        kdTree.buildTree();
+        checkCoordinateTree(points, kdTree);
+        BasicKDBTreeEfficient<T> kdbTree(kdbPoints.data(), 0, area, 0, size - 1, 16);
+        kdbTree.buildTree();
+        checkCoordinateTree(points, kdbTree);
+        BasicSortKDTree<T> sortKDTree(points, area);
+        sortKDTree.buildTree();
+        checkCoordinateTree(points, sortKDTree);
+        BasicQuadTree<T> quadTree(area, points);
+        quadTree.buildTree();
+        checkCoordinateTree(points, quadTree);
+        BasicPointRegionQuadTree<T> prQuadTree(area, points, 16);
+        prQuadTree.buildTree();
+        checkCoordinateTree(points, prQuadTree);
+    }
+
+    void testCoordinateTypes() {
+        checkCoordinateType<double>();
+        checkCoordinateType<float>();
+        checkCoordinateType<int32_t>();
+        static_assert(sizeof(BasicPoint<float>) == 8 && sizeof(BasicPoint<int32_t>) == 8);
+
+        // squared distances of int32_t points are exact beyond the range of int32_t
+        BasicPoint<int32_t> low{-1000000000, 0}, high{1000000000, 1};
+        assert(pointDistance(low, high) == 4000000000000000001LL);
+        assert(sqDistanceFrom(BasicArea<int32_t>{0, 10, 0, 10}, BasicPoint<int32_t>{13, -4}) == 25);
+
+        // same tie breaking for every coordinate type, points on the center lines are west and south
+        assert(quadrantOf(BasicPoint<int32_t>{5, 5}, 5, 5) == SOUTH_WEST);
+        assert(quadrantOf(Point{5.5, 6}, 5.0, 5.0) == NORTH_EAST);
+        assert(centerCoordinate<int32_t>(-3, 4) == 0);
+        assert(centerCoordinate<int32_t>(2000000000, 2000000002) == 2000000001);
     }
-}
 
+    template<int D>
+    void checkDimension(PointDistribution distribution) {
+        int size = 20000;
+        vector<PointND<D>> points = generatePointsND<D>(size, distribution);
+        BoxND<D> box = workloadBoxND<D>(size, distribution);
+        vector<PointND<D>> kdbPoints = points;
+        KDBTreeND<D> kdbTree(kdbPoints.data(), 0, box, 0, size - 1, 16);
+        kdbTree.buildTree();
+        OrthTree<D> orthTree(box, points, 16);
+        orthTree.buildTree();
+
+        for (int i = 0; i < size; i += 7) {
+            assert(kdbTree.contains(points[i]) && orthTree.contains(points[i]));
+        }
+        PointND<D> outside = points[0];
+        outside[D - 1] = -1;
+        assert(!kdbTree.contains(outside) && !orthTree.contains(outside));
+
+        auto byCoordinates = [](const PointND<D> &a, const PointND<D> &b) {
+            return a.coordinates < b.coordinates;
+        };
+        for (auto &queryBox: generateQueryBoxesND<D>(points, box, 30, 0.01)) {
+            vector<PointND<D>> expected, kdbResult, orthResult;
+            std::copy_if(points.begin(), points.end(), back_inserter(expected), [&queryBox](auto &p) {
+                return containsPoint(queryBox, p);
+            });
+            kdbTree.query(queryBox, kdbResult);
+            orthTree.query(queryBox, orthResult);
+            std::sort(expected.begin(), expected.end(), byCoordinates);
+            std::sort(kdbResult.begin(), kdbResult.end(), byCoordinates);
+            std::sort(orthResult.begin(), orthResult.end(), byCoordinates);
+            assert(kdbResult == expected && orthResult == expected);
+            assert(kdbTree.count(queryBox) == (long) expected.size());
+            assert(orthTree.count(queryBox) == (long) expected.size());
+        }
+
+        for (auto queryPoint: generateQueryPointsND<D>(points, 20)) {
+            queryPoint[0] += 1.5;
+            vector<PointND<D>> naive = points;
+            std::sort(naive.begin(), naive.end(), [&queryPoint](auto &a, auto &b) {
+                return pointDistance(a, queryPoint) < pointDistance(b, queryPoint);
+            });
+            naive.resize(10);
+            vector<double> expected = neighborDistances(naive, queryPoint);
+            assert(neighborDistances(kdbTree.kNearestNeighbors(queryPoint, 10), queryPoint) == expected);
+            assert(neighborDistances(orthTree.kNearestNeighbors(queryPoint, 10), queryPoint) == expected);
+        }
+    }
+
+    void testDimensions() {
+        for (auto distribution: {UNIFORM, CLUSTERED, DUPLICATES}) {
+            checkDimension<2>(distribution);
+            checkDimension<3>(distribution);
+            checkDimension<4>(distribution);
+        }
+        // the 3D points are the 2D points with a third coordinate
+        vector<Point> plane = generatePoints(100, CLUSTERED);
+        vector<PointND<3>> points = generatePointsND<3>(100, CLUSTERED);
+        assert(points[42][0] == plane[42].x && points[42][1] == plane[42].y);
+    }
+
+    void testFrozenTree() {
+        // small sizes leave empty leaves, the grid and duplicates have many equal coordinates
+        for (int size: {0, 1, 2, 3, 17, 1000, 30000}) {
+            for (auto distribution: {UNIFORM, JITTERED_GRID, DUPLICATES}) {
+                Area area = workloadArea(size, distribution);
+                vector<Point> points = generatePoints(size, distribution);
+                vector<Point> grid;
+                for (int i = 0; i < size; i++) {
+                    grid.push_back(Point{(double) (i % 37), (double) (i / 37)});
+                }
+                for (auto *set: {&points, &grid}) {
+                    unordered_set<Point> members(set->begin(), set->end());
+                    for (int capacity: {1, 4, 16}) {
+                        FrozenKDTree frozen(set->data(), size, capacity);
+                        assert(frozen.size() == size);
+                        for (auto &p: *set) {
+                            assert(frozen.contains(p));
+                        }
+                        for (auto &p: *set) {
+                            Point shifted{p.x + 0.5, p.y};
+                            assert(frozen.contains(shifted) == (members.count(shifted) > 0));
+                            Point moved{p.x, p.y - 1};
+                            assert(frozen.contains(moved) == (members.count(moved) > 0));
+                        }
+                    }
+                }
+                if (size > 0) {
+                    auto *kdTree = buildTreeOnPoints<KDTreeEfficient>(points, area);
+                    auto *kdbTree = buildTreeOnPoints<KDBTreeEfficient>(points, area);
+                    FrozenKDTree frozenKD = kdTree->freeze();
+                    FrozenKDTree frozenKDB = kdbTree->freeze();
+                    for (auto &p: points) {
+                        assert(frozenKD.contains(p) && frozenKDB.contains(p));
+                    }
+                    assert(!frozenKD.contains(Point{-1, -1}) && !frozenKDB.contains(Point{-1, -1}));
+                    destroyTree(kdTree);
+                    destroyTree(kdbTree);
+                }
+            }
+        }
+    }
+
+    void testMedianTies() {
+        // the curves and the grid put many points on the median of their node, they may end up in either child
+        int size = 30000;
+        vector<pair<vector<Point>, Area>> sets;
+        for (auto distribution: {CURVES, JITTERED_GRID, DUPLICATES}) {
+            sets.emplace_back(generatePoints(size, distribution), workloadArea(size, distribution));
+        }
+        vector<Point> grid;
+        for (int i = 0; i < size; i++) {
+            grid.push_back(Point{(double) (i % 11), (double) (i % 7)});
+        }
+        sets.emplace_back(grid, Area{0, 10, 0, 6});
+        for (auto &[points, area]: sets) {
+            auto *kdTree = buildTreeOnPoints<KDTreeEfficient>(points, area);
+            auto *kdbTree = buildTreeOnPoints<KDBTreeEfficient>(points, area);
+            auto *dynamicTree = buildTreeOnPoints<DynamicKDBTree>(points, area);
+            for (auto &p: points) {
+                assert(kdTree->contains(p));
+                assert(kdbTree->contains(p));
+                assert(dynamicTree->contains(p));
+            }
+            destroyTree(kdTree);
+            destroyTree(kdbTree);
+            destroyTree(dynamicTree);
+        }
+    }
+}
@@ -14,8 +14,44 @@ class KDTreeTests {
 public:
     static std::list<Point> naiveQuery(std::vector<Point> &points, Area &area);
 
+    static std::vector<Point> sortedPoints(std::list<Point> points);
+
     static void testQuery();
 
+    static void testImplicitKDTree();
+
+    static void testParallelBuild();
+
+    static void testKNearestNeighbors();
+
+    static void testCount();
+
+    static void testArena();
+
+    static void testPresortedBuild();
+
+    static void testCompact();
+
+    static void testBalancedAdd();
+
+    static void testDynamicKDBTree();
+
+    static void testConcurrentKNearestNeighbors();
+
+    static void testCapacityProfile();
+
+    static void testLeafColumns();
+
+    static void testTightAreas();
+
+    static void testCoordinateTypes();
+
+    static void testDimensions();
+
+    static void testFrozenTree();
+
+    static void testMedianTies();
+
 };
 
 
@@ -4,7 +4,15 @@
 
 #include "../include/Util.h"
 #include "../include/QuadTree.h"
+#include "../include/QuadTreeEfficient.h"
+#include "../include/LinearQuadTree.h"
+#include "../include/CompressedQuadTree.h"
+#include "../include/NodeArena.h"
+#include "../include/WorkStealingPool.h"
+#include "../include/ConcurrentPRQuadTree.h"
+#include <thread>
 #include "../include/PointRegionQuadTree.h"
+#include "TestHelper.h"
 
 namespace QuadTreeTest {
     std::list<Point> naiveQuery(std::vector<Point> &points, Area &area) {
@@ -77,13 +85,21 @@ namespace QuadTreeTest {
         return pointRegionQuadtree;
     }
 
+    std::vector<Point> sortedPoints(std::list<Point> points) {
+        std::vector<Point> v(points.begin(), points.end());
+        std::sort(v.begin(), v.end(), [](const Point &a, const Point &b) {
+            return a.x < b.x || (a.x == b.x && a.y < b.y);
+        });
+        return v;
+    }
+
     void testQuery() {
         Area area{0, 10000, 0, 10000};
         std::vector<Point> points1;
         points1.reserve(10000);
         for (int i = 0; i < 10000; ++i) {
             Point p{static_cast<double>(std::rand() % 10000), static_cast<double>(std::rand() % 10000)};
-            if (find(points1.begin(), points1.end(), p) != points1.end())
+            if (find(points1.begin(), points1.end(), p) == points1.end())
                 points1.push_back(p);
         }
 
@@ -94,8 +110,8 @@ namespace QuadTreeTest {
         quadTree2->buildTree();
 
         Area query3{500, 3939, 232, 23423};
-        assert(quadTree->query(query3) == naiveQuery(points1, query3));
-        assert(quadTree2->query(query3) == naiveQuery(points1, query3));
+        assert(sortedPoints(quadTree->query(query3)) == sortedPoints(naiveQuery(points1, query3)));
+        assert(sortedPoints(quadTree2->query(query3)) == sortedPoints(naiveQuery(points1, query3)));
 
         std::vector<Area> areas(10000);
         for (auto &a: areas) {
@@ -107,12 +123,18 @@ namespace QuadTreeTest {
             a = Area{fromX, toX, fromY, toY};
         }
 
+        std::vector<Point> buffer;
         for (auto &a: areas) {
-            std::list<Point> naive = naiveQuery(points1, a);
-            assert(quadTree->query(a) == naive);
-            assert(quadTree2->query(a) == naive);
+            std::vector<Point> naive = sortedPoints(naiveQuery(points1, a));
+            assert(sortedPoints(quadTree->query(a)) == naive);
+            assert(sortedPoints(quadTree2->query(a)) == naive);
+
+            buffer.clear();
+            quadTree2->query(a, buffer);
+            assert(sortedPoints({buffer.begin(), buffer.end()}) == naive);
         }
         delete quadTree;
+        delete quadTree2;
     }
 
     void insertTest() {
@@ -133,6 +155,531 @@ namespace QuadTreeTest {
     void testContains() {
         testContainsHelper(getQuadTree(), getPRQuadTree());
     }
+
+    void testKNearestNeighbors() {
+        int size = 20000;
+        Area area{0, (double) size, 0, (double) size};
+        std::vector<Point> points = getRandomPoints(size);
+        auto *quadTree = new QuadTree(area, points);
+        auto *prQuadTree = new PointRegionQuadTree(area, points, 16);
+        quadTree->buildTree();
+        prQuadTree->buildTree();
+
+        KNNScratch scratch;
+        std::vector<Point> result;
+        for (int k: {1, 10, 100, 1000, size + 5}) {
+            for (int i = 0; i < 20; i++) {
+                Point queryPoint = getRandomPoint(size + 1000);
+                std::vector<Point> naive = points;
+                std::sort(naive.begin(), naive.end(), [&queryPoint](const Point &a, const Point &b) {
+                    return pointDistance(a, queryPoint) < pointDistance(b, queryPoint);
+                });
+                naive.resize(std::min(k, size));
+                std::vector<double> expected = neighborDistances(naive, queryPoint);
+
+                assert(neighborDistances(quadTree->kNearestNeighbors(queryPoint, k), queryPoint) == expected);
+                prQuadTree->kNearestNeighbors(queryPoint, k, scratch, result);
+                assert(neighborDistances(result, queryPoint) == expected);
+            }
+        }
+        delete quadTree;
+        delete prQuadTree;
+    }
+
+    void testCount() {
+        int size = 20000;
+        Area area{0, (double) size, 0, (double) size};
+        std::vector<Point> points = getRandomPoints(size);
+        std::vector<Point> initialPoints(points.begin(), points.begin() + size / 2);
+        auto *prQuadTree = new PointRegionQuadTree(area, initialPoints, 16);
+        prQuadTree->buildTree();
+        WeightFunction weight = [](const Point &p) { return p.x - p.y; };
+        prQuadTree->buildAggregates(weight);
+        // the second half is inserted dynamically and has to be reflected by count and aggregate
+        for (int i = size / 2; i < size; i++) {
+            prQuadTree->add(points[i]);
+        }
+
+        for (int i = 0; i < 1000; i++) {
+            double fromX = std::rand() % size;
+            double toX = fromX + std::rand() % (size / 2);
+            double fromY = std::rand() % size;
+            double toY = fromY + std::rand() % (size / 2);
+            Area a{fromX, toX, fromY, toY};
+
+            Aggregate expected;
+            for (auto &p: naiveQuery(points, a)) {
+                expected.add(weight(p));
+            }
+            assert(prQuadTree->count(a) == expected.count);
+            Aggregate result = prQuadTree->aggregate(a);
+            assert(result.count == expected.count);
+            assert(std::abs(result.sum - expected.sum) <= 1e-6 * std::max(1.0, std::abs(expected.sum)));
+            assert(result.min == expected.min && result.max == expected.max);
+        }
+        Area all{0, (double) size, 0, (double) size};
+        assert(prQuadTree->count(all) == size);
+        delete prQuadTree;
+    }
+
+    void testQuadTreeEfficient() {
+        Area area{0, 10000, 0, 10000};
+        std::vector<Point> points1;
+        points1.reserve(10000);
+        for (int i = 0; i < 10000; ++i) {
+            Point p{static_cast<double>(std::rand() % 10000), static_cast<double>(std::rand() % 10000)};
+            if (find(points1.begin(), points1.end(), p) == points1.end())
+                points1.push_back(p);
+        }
+        int size = (int) points1.size();
+        auto *points = (Point *) (malloc(size * sizeof(Point)));
+        std::copy(points1.begin(), points1.end(), points);
+
+        auto *quadTree = new QuadTree(area, points1);
+        auto *quadTreeEfficient = new QuadTreeEfficient(points, area, size);
+        quadTree->buildTree();
+        quadTreeEfficient->buildTree();
+        assert(quadTree->getHeight() == quadTreeEfficient->getHeight());
+
+        for (auto &p: points1) {
+            assert(quadTreeEfficient->contains(p));
+        }
+        Point outside{0.5, 0.5};
+        assert(!quadTreeEfficient->contains(outside));
+
+        std::vector<Point> buffer;
+        for (int i = 0; i < 1000; i++) {
+            double fromX = std::rand() % 8000;
+            double toX = fromX + std::rand() % 5000;
+            double fromY = std::rand() % 8000;
+            double toY = fromY + std::rand() % 5000;
+            Area a{fromX, toX, fromY, toY};
+            std::vector<Point> naive = sortedPoints(naiveQuery(points1, a));
+            assert(sortedPoints(quadTreeEfficient->query(a)) == naive);
+            assert(quadTreeEfficient->count(a) == (long) naive.size());
+            buffer.clear();
+            quadTreeEfficient->query(a, buffer);
+            assert(buffer.size() == naive.size());
+        }
+
+        Point queryPoint{4321, 1234};
+        std::vector<Point> neighbors = quadTreeEfficient->kNearestNeighbors(queryPoint, 50);
+        std::vector<Point> expected = quadTree->kNearestNeighbors(queryPoint, 50);
+        for (int i = 0; i < 50; i++) {
+            assert(pointDistance(neighbors[i], queryPoint) == pointDistance(expected[i], queryPoint));
+        }
+        delete quadTree;
+        delete quadTreeEfficient;
+
+        // equal points share a leaf once the square cannot be split anymore
+        std::vector<Point> duplicates(100, Point{17, 42});
+        duplicates.push_back(Point{9000, 9000});
+        auto *duplicatePoints = (Point *) (malloc(duplicates.size() * sizeof(Point)));
+        std::copy(duplicates.begin(), duplicates.end(), duplicatePoints);
+        auto *duplicateTree = new QuadTreeEfficient(duplicatePoints, area, (int) duplicates.size());
+        duplicateTree->buildTree();
+        assert(duplicateTree->contains(duplicates[0]) && duplicateTree->contains(duplicates[100]));
+        assert(duplicateTree->count(area) == 101);
+        delete duplicateTree;
+        free(points);
+        free(duplicatePoints);
+    }
+
+    void testLinearQuadTree() {
+        Area area{0, 10000, 0, 10000};
+        std::vector<Point> points1;
+        points1.reserve(10000);
+        for (int i = 0; i < 10000; ++i) {
+            Point p{static_cast<double>(std::rand() % 10000), static_cast<double>(std::rand() % 10000)};
+            if (find(points1.begin(), points1.end(), p) == points1.end())
+                points1.push_back(p);
+        }
+        int size = (int) points1.size();
+        auto *points = (Point *) (malloc(size * sizeof(Point)));
+        std::copy(points1.begin(), points1.end(), points);
+
+        auto *linearQuadTree = new LinearQuadTree(points, area, size);
+        linearQuadTree->buildTree();
+
+        for (auto &p: points1) {
+            assert(linearQuadTree->contains(p));
+        }
+        Point outside{0.5, 0.5};
+        assert(!linearQuadTree->contains(outside));
+
+        std::vector<Point> buffer;
+        for (int i = 0; i < 1000; i++) {
+            double fromX = std::rand() % 8000;
+            double toX = fromX + std::rand() % 5000;
+            double fromY = std::rand() % 8000;
+            double toY = fromY + std::rand() % 5000;
+            Area a{fromX, toX, fromY, toY};
+            std::vector<Point> naive = sortedPoints(naiveQuery(points1, a));
+            assert(sortedPoints(linearQuadTree->query(a)) == naive);
+            buffer.clear();
+            linearQuadTree->query(a, buffer);
+            assert(buffer.size() == naive.size());
+        }
+        // rectangles reaching over the area are clipped, rectangles outside of it are empty
+        Area overlapping{-500, 500, 9500, 20000};
+        assert(sortedPoints(linearQuadTree->query(overlapping)) == sortedPoints(naiveQuery(points1, overlapping)));
+        Area disjoint{20000, 30000, 0, 10000};
+        assert(linearQuadTree->query(disjoint).empty());
+
+        for (int i = 0; i < 20; i++) {
+            Point queryPoint{static_cast<double>(std::rand() % 10000), static_cast<double>(std::rand() % 10000)};
+            std::vector<Point> expected = points1;
+            std::sort(expected.begin(), expected.end(), [&queryPoint](const Point &a, const Point &b) {
+                return pointDistance(a, queryPoint) < pointDistance(b, queryPoint);
+            });
+            std::vector<Point> neighbors = linearQuadTree->kNearestNeighbors(queryPoint, 50);
+            assert(neighbors.size() == 50);
+            for (int j = 0; j < 50; j++) {
+                assert(pointDistance(neighbors[j], queryPoint) == pointDistance(expected[j], queryPoint));
+            }
+        }
+        delete linearQuadTree;
+        free(points);
+    }
+
+    void testCompressedQuadTree() {
+        Area area{0, 10000, 0, 10000};
+        std::vector<Point> points1;
+        std::vector<Point> distinct;
+        // sparse points, exact duplicates and a cluster far below the resolution of a regular Quadtree
+        for (int i = 0; i < 2000; ++i) {
+            Point p{static_cast<double>(std::rand() % 10000), static_cast<double>(std::rand() % 10000)};
+            int copies = 1 + std::rand() % 4;
+            for (int j = 0; j < copies; j++) {
+                points1.push_back(p);
+            }
+        }
+        for (int i = 0; i < 200; ++i) {
+            points1.push_back(Point{5000 + i * 1e-9, 5000 - i * 1e-9});
+            points1.push_back(Point{5000 + i * 1e-9, 5000 - i * 1e-9});
+        }
+        for (int i = 0; i < 500; ++i) {
+            points1.push_back(Point{1234.5, 6789.5});
+        }
+        for (auto &p: points1) {
+            if (find(distinct.begin(), distinct.end(), p) == distinct.end())
+                distinct.push_back(p);
+        }
+
+        auto *quadTree = new CompressedQuadTree(area, points1);
+        quadTree->buildTree();
+        // every inner node has at least two non-empty children
+        assert(quadTree->getHeight() <= (int) distinct.size());
+        assert(quadTree->count(area) == (long) points1.size());
+
+        for (auto &p: distinct) {
+            assert(quadTree->contains(p));
+            assert(quadTree->multiplicity(p) == (int) std::count(points1.begin(), points1.end(), p));
+        }
+        Point outside{0.5, 0.5};
+        assert(!quadTree->contains(outside));
+        Point hotspot{1234.5, 6789.5};
+        assert(quadTree->multiplicity(hotspot) >= 500);
+
+        std::vector<Point> buffer;
+        for (int i = 0; i < 500; i++) {
+            double fromX = std::rand() % 8000;
+            double toX = fromX + std::rand() % 5000;
+            double fromY = std::rand() % 8000;
+            double toY = fromY + std::rand() % 5000;
+            Area a{fromX, toX, fromY, toY};
+            std::vector<Point> naive = sortedPoints(naiveQuery(points1, a));
+            assert(sortedPoints(quadTree->query(a)) == naive);
+            assert(quadTree->count(a) == (long) naive.size());
+            buffer.clear();
+            quadTree->query(a, buffer);
+            assert(buffer.size() == naive.size());
+        }
+
+        std::vector<Point> queryPoints{{5000, 5000}, {1234, 6789}, {4321, 1234}};
+        for (auto &queryPoint: queryPoints) {
+            std::vector<Point> expected = points1;
+            std::sort(expected.begin(), expected.end(), [&queryPoint](const Point &a, const Point &b) {
+                return pointDistance(a, queryPoint) < pointDistance(b, queryPoint);
+            });
+            std::vector<Point> neighbors = quadTree->kNearestNeighbors(queryPoint, 600);
+            assert(neighbors.size() == 600);
+            for (int j = 0; j < 600; j++) {
+                assert(pointDistance(neighbors[j], queryPoint) == pointDistance(expected[j], queryPoint));
+            }
+        }
+        assert(quadTree->kNearestNeighbors(outside, 0).empty());
+        delete quadTree;
+    }
+
+    void testArena() {
+        Area area{0, 10000, 0, 10000};
+        std::vector<Point> points1;
+        points1.reserve(5000);
+        for (int i = 0; i < 5000; ++i) {
+            Point p{static_cast<double>(std::rand() % 10000), static_cast<double>(std::rand() % 10000)};
+            if (find(points1.begin(), points1.end(), p) == points1.end())
+                points1.push_back(p);
+        }
+
+        NodeArena arena(1 << 16, true);
+        auto *quadTree = new QuadTree(area, points1, arena);
+        auto *prQuadTree = new PointRegionQuadTree(area, points1, 4, arena);
+        auto *heapQuadTree = new QuadTree(area, points1);
+        quadTree->buildTree();
+        prQuadTree->buildTree();
+        heapQuadTree->buildTree();
+        assert(quadTree->getHeight() == heapQuadTree->getHeight());
+
+        // subdividing after a dynamic insertion also allocates from the arena
+        Point added{1.5, 1.5};
+        prQuadTree->add(added);
+        assert(prQuadTree->contains(added));
+        for (auto &p: points1) {
+            assert(quadTree->contains(p) && prQuadTree->contains(p));
+        }
+        for (int i = 0; i < 200; i++) {
+            double fromX = std::rand() % 8000;
+            double toX = fromX + std::rand() % 5000;
+            double fromY = std::rand() % 8000;
+            double toY = fromY + std::rand() % 5000;
+            Area a{fromX, toX, fromY, toY};
+            std::vector<Point> naive = sortedPoints(naiveQuery(points1, a));
+            assert(sortedPoints(quadTree->query(a)) == naive);
+            assert(sortedPoints(heapQuadTree->query(a)) == naive);
+            assert(prQuadTree->count(a) == (long) naive.size() + containsPoint(a, added));
+        }
+        delete quadTree;
+        delete prQuadTree;
+        delete heapQuadTree;
+    }
+
+    void testParallelBuild() {
+        WorkStealingPool pool(4);
+        // large enough for the chunked classification of the root
+        int size = PARALLEL_PARTITION_THRESHOLD + 100000;
+        std::vector<Point> points = getRandomPoints(size);
+        Area area{0, (double) size, 0, (double) size};
+        auto *serialTree = new PointRegionQuadTree(area, points, 8);
+        auto *parallelTree = new PointRegionQuadTree(area, points, 8);
+        serialTree->buildTree();
+        parallelTree->buildTree(pool);
+        assert(serialTree->getHeight() == parallelTree->getHeight());
+        for (int i = 0; i < size; i += 97) {
+            assert(parallelTree->contains(points[i]));
+        }
+        for (int i = 0; i < 20; i++) {
+            double fromX = std::rand() % size;
+            double fromY = std::rand() % size;
+            Area a{fromX, fromX + 0.05 * size, fromY, fromY + 0.05 * size};
+            // same traversal order and same order of points in every node
+            assert(parallelTree->query(a) == serialTree->query(a));
+        }
+        delete serialTree;
+        delete parallelTree;
+
+        size = 4 * PARALLEL_BUILD_GRAIN;
+        std::vector<Point> quadTreePoints = getRandomPoints(size);
+        Area quadTreeArea{0, (double) size, 0, (double) size};
+        auto *serialQuadTree = new QuadTree(quadTreeArea, quadTreePoints);
+        auto *parallelQuadTree = new QuadTree(quadTreeArea, quadTreePoints);
+        serialQuadTree->buildTree();
+        parallelQuadTree->buildTree(pool);
+        assert(serialQuadTree->getHeight() == parallelQuadTree->getHeight());
+        Area queryArea{0.2 * size, 0.4 * size, 0.3 * size, 0.35 * size};
+        assert(parallelQuadTree->query(queryArea) == serialQuadTree->query(queryArea));
+        for (auto &p: quadTreePoints) {
+            assert(parallelQuadTree->contains(p));
+        }
+        delete serialQuadTree;
+        delete parallelQuadTree;
+    }
+
+    void testConcurrentInsert() {
+        int size = 100000;
+        int threadCount = 8;
+        Area area{0, (double) size, 0, (double) size};
+        std::vector<Point> points = getRandomPoints(size);
+        // equal points end up in the overflow list of an unsplittable leaf
+        for (int i = 0; i < 200; i++) {
+            points.push_back(Point{42.0, 42.0});
+        }
+        auto *quadTree = new ConcurrentPRQuadTree(area, 4);
+
+        std::atomic<bool> done{false};
+        std::thread reader([&] {
+            Area a{0.2 * size, 0.6 * size, 0.3 * size, 0.5 * size};
+            size_t found = 0;
+            while (!done.load()) {
+                // the number of reported points can only grow
+                size_t current = quadTree->query(a).size();
+                assert(current >= found);
+                found = current;
+            }
+        });
+        std::vector<std::thread> producers;
+        for (int t = 0; t < threadCount; t++) {
+            producers.emplace_back([&, t] {
+                for (int i = t; i < (int) points.size(); i += threadCount) {
+                    quadTree->add(points[i]);
+                }
+            });
+        }
+        for (auto &producer: producers) {
+            producer.join();
+        }
+        done.store(true);
+        reader.join();
+
+        for (auto &p: points) {
+            assert(quadTree->contains(p));
+        }
+        Point outside{0.5, 0.5};
+        assert(!quadTree->contains(outside));
+        for (int i = 0; i < 100; i++) {
+            double fromX = std::rand() % size;
+            double fromY = std::rand() % size;
+            Area a{fromX, fromX + 0.1 * size, fromY, fromY + 0.1 * size};
+            assert(sortedPoints(quadTree->query(a)) == sortedPoints(naiveQuery(points, a)));
+        }
+        Area duplicateArea{42, 42, 42, 42};
+        assert(quadTree->query(duplicateArea).size() == naiveQuery(points, duplicateArea).size());
+        delete quadTree;
+    }
+
+    void testRemove() {
+        int size = 20000;
+        Area area{0, (double) size, 0, (double) size};
+        std::vector<Point> points = getRandomPoints(size);
+        auto *quadTree = new QuadTree(area, points);
+        quadTree->buildTree();
+        auto *prQuadTree = new PointRegionQuadTree(area, points, 8);
+        prQuadTree->buildTree();
+        WeightFunction weight = [](const Point &p) { return p.x - p.y; };
+        prQuadTree->buildAggregates(weight);
+        int initialHeight = prQuadTree->getHeight();
+
+        // remove every second point, the removed points must not be reported anymore
+        std::vector<Point> live;
+        for (int i = 0; i < size; i++) {
+            if (i % 2 == 0) {
+                assert(quadTree->remove(points[i]));
+                assert(prQuadTree->remove(points[i]));
+                assert(!quadTree->contains(points[i]) && !prQuadTree->contains(points[i]));
+            } else {
+                live.push_back(points[i]);
+            }
+        }
+        Point missing{-1, -1};
+        assert(!quadTree->remove(missing) && !prQuadTree->remove(missing));
+        for (auto &p: live) {
+            assert(quadTree->contains(p) && prQuadTree->contains(p));
+        }
+        for (int i = 0; i < 200; i++) {
+            double fromX = std::rand() % size;
+            double toX = fromX + std::rand() % (size / 2);
+            double fromY = std::rand() % size;
+            double toY = fromY + std::rand() % (size / 2);
+            Area a{fromX, toX, fromY, toY};
+            std::vector<Point> naive = sortedPoints(naiveQuery(live, a));
+            assert(sortedPoints(quadTree->query(a)) == naive);
+            assert(sortedPoints(prQuadTree->query(a)) == naive);
+
+            Aggregate expected;
+            for (auto &p: naive) {
+                expected.add(weight(p));
+            }
+            assert(prQuadTree->count(a) == expected.count);
+            Aggregate result = prQuadTree->aggregate(a);
+            assert(result.count == expected.count);
+            assert(std::abs(result.sum - expected.sum) <= 1e-6 * std::max(1.0, std::abs(expected.sum)));
+            assert(result.min == expected.min && result.max == expected.max);
+        }
+        Point queryPoint{size / 3.0, size / 3.0};
+        std::vector<Point> nearest = prQuadTree->kNearestNeighbors(queryPoint, 10);
+        std::vector<Point> byDistance(live);
+        std::sort(byDistance.begin(), byDistance.end(), [&](const Point &a, const Point &b) {
+            return pointDistance(a, queryPoint) < pointDistance(b, queryPoint);
+        });
+        for (int i = 0; i < 10; i++) {
+            assert(pointDistance(nearest[i], queryPoint) == pointDistance(byDistance[i], queryPoint));
+        }
+
+        // removed points can be added again
+        for (int i = 0; i < size; i += 2) {
+            quadTree->add(points[i]);
+            prQuadTree->add(points[i]);
+        }
+        Area all{0, (double) size, 0, (double) size};
+        assert(prQuadTree->count(all) == size);
+        assert((long) quadTree->query(all).size() == size);
+
+        // emptying the tree collapses it to a single leaf
+        for (auto &p: points) {
+            assert(quadTree->remove(p));
+            assert(prQuadTree->remove(p));
+        }
+        assert(quadTree->isEmpty() && quadTree->isNodeLeaf());
+        assert(prQuadTree->isEmpty() && prQuadTree->getHeight() == 1 && initialHeight > 1);
+        assert(prQuadTree->count(all) == 0 && prQuadTree->aggregate(all).count == 0);
+        delete quadTree;
+        delete prQuadTree;
+    }
+
+    void testAddDuplicates() {
+        Area area{0, 16, 0, 16};
+        std::vector<Point> points{{1, 1}, {12, 12}};
+        auto *quadTree = new QuadTree(area, points);
+        quadTree->buildTree();
+        Point duplicate{1, 1};
+        Point nearby{1.5, 1.5};
+        quadTree->add(duplicate);
+        // the leaf holding (1,1) twice has to split again for the new point
+        quadTree->add(nearby);
+        assert(quadTree->contains(duplicate) && quadTree->contains(nearby));
+        Area all{0, 16, 0, 16};
+        assert(quadTree->query(all).size() == 4);
+        Area corner{0, 2, 0, 2};
+        assert(quadTree->query(corner).size() == 3);
+        assert(quadTree->remove(nearby) && !quadTree->contains(nearby));
+        assert(quadTree->remove(duplicate) && quadTree->remove(duplicate) && !quadTree->contains(duplicate));
+        assert(quadTree->query(corner).empty());
+
+        // points closer than the resolution of double end in one leaf instead of subdividing forever
+        Point close1{1, 1};
+        Point close2{1, std::nextafter(1.0, 2.0)};
+        quadTree->add(close1);
+        quadTree->add(close2);
+        assert(quadTree->contains(close1) && quadTree->contains(close2));
+        assert(quadTree->query(corner).size() == 2);
+        delete quadTree;
+
+        // more equal points than a leaf holds stay in one leaf of the PR-Quadtree
+        std::vector<Point> equalPoints(100, Point{17, 42});
+        Area largeArea{0, 1024, 0, 1024};
+        auto *prQuadTree = new PointRegionQuadTree(largeArea, equalPoints, 8);
+        prQuadTree->buildTree();
+        // enough points for the parallel build to run as tasks
+        std::vector<Point> manyEqualPoints(2 * PARALLEL_BUILD_GRAIN, Point{17, 42});
+        WorkStealingPool pool(4);
+        auto *parallelTree = new PointRegionQuadTree(largeArea, manyEqualPoints, 8);
+        parallelTree->buildTree(pool);
+        assert(prQuadTree->getHeight() == 1 && parallelTree->getHeight() == 1);
+        Point equal{17, 42};
+        Point other{900, 900};
+        prQuadTree->add(equal);
+        prQuadTree->add(other);
+        assert(prQuadTree->contains(equal) && prQuadTree->contains(other));
+        Area equalArea{17, 17, 42, 42};
+        assert(prQuadTree->query(equalArea).size() == 101 && prQuadTree->count(equalArea) == 101);
+        assert(prQuadTree->query(largeArea).size() == 102 && prQuadTree->count(largeArea) == 102);
+        assert(prQuadTree->kNearestNeighbors(other, 3).size() == 3);
+        assert(prQuadTree->remove(other) && prQuadTree->remove(equal) && prQuadTree->contains(equal));
+        assert(prQuadTree->query(largeArea).size() == 100);
+        assert(parallelTree->count(equalArea) == 2 * PARALLEL_BUILD_GRAIN);
+        delete prQuadTree;
+        delete parallelTree;
+    }
 }
 
 
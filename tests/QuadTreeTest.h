@@ -23,11 +23,33 @@ private:
 public:
     std::list<Point> naiveQuery(std::vector<Point> &points, Area &area);
 
+    std::vector<Point> sortedPoints(std::list<Point> points);
+
     static void testQuery();
 
     static void insertTest();
 
     static void testContains();
+
+    static void testKNearestNeighbors();
+
+    static void testCount();
+
+    static void testQuadTreeEfficient();
+
+    static void testLinearQuadTree();
+
+    static void testCompressedQuadTree();
+
+    static void testArena();
+
+    static void testParallelBuild();
+
+    static void testConcurrentInsert();
+
+    static void testRemove();
+
+    static void testAddDuplicates();
 };
 
 
@@ -0,0 +1,30 @@
+//
+// Created by omar on 02.02.24.
+//
+
+#ifndef QUADKDBENCH_TESTHELPER_H
+#define QUADKDBENCH_TESTHELPER_H
+
+#include <vector>
+#include "../include/Util.h"
+
+/**
+ * @brief Distances of neighbors to queryPoint, kNN results are compared by distance since points with equal distance
+ * may be reported in any order
+ * @tparam PointT Point, BasicPoint or PointND
+ * @param neighbors neighbors returned by a kNN search
+ * @param queryPoint point the neighbors were searched for
+ * @return distance of every neighbor to queryPoint, in the order of neighbors
+ */
+template<typename PointT>
+std::vector<decltype(pointDistance(std::declval<PointT>(), std::declval<PointT>()))>
+neighborDistances(const std::vector<PointT> &neighbors, const PointT &queryPoint) {
+    std::vector<decltype(pointDistance(queryPoint, queryPoint))> result;
+    result.reserve(neighbors.size());
+    for (auto &p: neighbors) {
+        result.push_back(pointDistance(p, queryPoint));
+    }
+    return result;
+}
+
+#endif //QUADKDBENCH_TESTHELPER_H
@@ -11,8 +11,35 @@ int main() {
     QuadTreeTest::testContains();
     QuadTreeTest::testQuery();
     QuadTreeTest::insertTest();
+    QuadTreeTest::testKNearestNeighbors();
+    QuadTreeTest::testCount();
+    QuadTreeTest::testQuadTreeEfficient();
+    QuadTreeTest::testLinearQuadTree();
+    QuadTreeTest::testCompressedQuadTree();
+    QuadTreeTest::testArena();
+    QuadTreeTest::testParallelBuild();
+    QuadTreeTest::testConcurrentInsert();
+    QuadTreeTest::testRemove();
+    QuadTreeTest::testAddDuplicates();
 
     KDTreeTests::testQuery();
+    KDTreeTests::testImplicitKDTree();
+    KDTreeTests::testParallelBuild();
+    KDTreeTests::testKNearestNeighbors();
+    KDTreeTests::testCount();
+    KDTreeTests::testArena();
+    KDTreeTests::testPresortedBuild();
+    KDTreeTests::testCompact();
+    KDTreeTests::testBalancedAdd();
+    KDTreeTests::testDynamicKDBTree();
+    KDTreeTests::testConcurrentKNearestNeighbors();
+    KDTreeTests::testCapacityProfile();
+    KDTreeTests::testLeafColumns();
+    KDTreeTests::testTightAreas();
+    KDTreeTests::testCoordinateTypes();
+    KDTreeTests::testDimensions();
+    KDTreeTests::testFrozenTree();
+    KDTreeTests::testMedianTies();
 
     UtilTest::containsAreaTest();
     UtilTest::containsPointTest();
@@ -20,6 +47,8 @@ int main() {
     UtilTest::splitTest();
     UtilTest::sqDistanceFromTest();
     UtilTest::pointDistanceTest();
+    UtilTest::workloadTest();
+    UtilTest::pointIOTest();
 
     cout << "All tests passed" << endl;
     return 0;
@@ -4,6 +4,9 @@
 
 #include <cassert>
 #include "../include/Util.h"
+#include "../include/Workload.h"
+#include "../include/TreeHelper.h"
+#include "../include/PointIO.h"
 #include "UtilTest.h"
 
 void UtilTest::splitTest() {
@@ -66,3 +69,114 @@ void UtilTest::pointDistanceTest() {
 
     assert(pointDistance(p, q) == 5);
 }
+
+void UtilTest::workloadTest() {
+    // more than one chunk, so the points are generated by several threads
+    int size = 3 * WORKLOAD_CHUNK + 123;
+    for (int d = 0; d < POINT_DISTRIBUTION_COUNT; d++) {
+        auto distribution = (PointDistribution) d;
+        Area area = workloadArea(size, distribution);
+        vector<Point> points = generatePoints(size, distribution);
+        assert((int) points.size() == size);
+        assert(points == generatePoints(size, distribution));
+        assert(points != generatePoints(size, distribution, WORKLOAD_SEED + 1));
+        for (auto &p: points) {
+            assert(containsPoint(area, p));
+        }
+        Point *pointArray = generatePointsArray(size, distribution);
+        assert(std::equal(points.begin(), points.end(), pointArray));
+        free(pointArray);
+
+        vector<Area> queryAreas = generateQueryAreas(points, area, 50, 0.01);
+        assert(queryAreas.size() == 50 && queryAreas == generateQueryAreas(points, area, 50, 0.01));
+        vector<Point> queryPoints = generateQueryPoints(points, 50);
+        for (auto &q: queryPoints) {
+            assert(std::find(points.begin(), points.end(), q) != points.end());
+        }
+        for (auto &q: generateQueryPoints(area, 50)) {
+            assert(containsPoint(area, q));
+        }
+
+        // every tree of the workload benchmarks can be built, the PR-Quadtree cannot split equal points
+        vector<Point> treePoints(points.begin(), points.begin() + 20000);
+        auto *kdbTree = buildTreeOnPoints<KDBTreeEfficient>(treePoints, area);
+        assert(kdbTree->contains(treePoints[777]));
+        destroyTree(kdbTree);
+        auto *sortKDTree = buildTreeOnPoints<SortKDTree>(treePoints, area);
+        assert(sortKDTree->contains(treePoints[777]));
+        destroyTree(sortKDTree);
+        if (distribution != DUPLICATES) {
+            auto *prTree = buildTreeOnPoints<PointRegionQuadTree>(treePoints, area);
+            assert(prTree->contains(treePoints[777]));
+            destroyTree(prTree);
+        }
+    }
+
+    vector<Point> duplicates = generatePoints(10000, DUPLICATES);
+    std::sort(duplicates.begin(), duplicates.end(), [](const Point &a, const Point &b) {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+    long distinct = std::unique(duplicates.begin(), duplicates.end()) - duplicates.begin();
+    assert(distinct <= 10000 / 16);
+}
+
+void UtilTest::pointIOTest() {
+    auto directory = std::filesystem::temp_directory_path();
+    string textPath = directory / "quadkd-util-test.txt";
+    string binaryPath = directory / "quadkd-util-test.bin";
+
+    // header, separators of every kind, blank and broken lines, no newline at the end
+    ofstream text(textPath);
+    text << "x,y\n1.5,2.5\n\n  3 ; -4e2\r\n5\t6\nbroken\n7,\n1e-3 , 8";
+    text.close();
+    vector<Point> expected{{1.5, 2.5}, {3, -400}, {5, 6}, {1e-3, 8}};
+    assert(loadPointsText(textPath) == expected);
+
+    // many lines, so the parts of several threads meet inside of lines
+    vector<Point> points = generatePoints(200000, CLUSTERED);
+    text.open(textPath);
+    text << setprecision(17);
+    for (auto &p: points) {
+        text << p.x << "," << p.y << "\n";
+    }
+    text.close();
+    for (int threads: {1, 3, 8}) {
+        assert(loadPointsText(textPath, threads) == points);
+    }
+
+    savePointsBinary(binaryPath, points.data(), (long) points.size());
+    {
+        MappedPointFile file(binaryPath);
+        assert(file.isZeroCopy() && file.size() == (long) points.size());
+        assert(std::equal(points.begin(), points.end(), file.data()));
+        assert(file.bounds() == boundingBox(points.data(), points.data() + points.size()));
+
+        // trees reorder the mapped points, the file keeps its order
+        Area area = file.bounds();
+        auto *kdbTree = new KDBTreeEfficient(file.data(), 0, area, 0, (int) file.size() - 1, 16);
+        kdbTree->buildTree();
+        for (int i = 0; i < 1000; i++) {
+            assert(kdbTree->contains(points[i * 200]));
+        }
+        delete kdbTree;
+    }
+    MappedPointFile file(binaryPath);
+    assert(std::equal(points.begin(), points.end(), file.data()));
+
+    savePointsBinary(binaryPath, points.data(), (long) points.size(), FLOAT32_COORDINATES);
+    MappedPointFile floats(binaryPath);
+    assert(!floats.isZeroCopy() && floats.coordinateType() == FLOAT32_COORDINATES);
+    for (long i = 0; i < floats.size(); i++) {
+        assert(floats.data()[i].x == (float) points[i].x && floats.data()[i].y == (float) points[i].y);
+    }
+
+    bool rejected = false;
+    try {
+        MappedPointFile notBinary(textPath);
+    } catch (const std::runtime_error &) {
+        rejected = true;
+    }
+    assert(rejected);
+    std::filesystem::remove(textPath);
+    std::filesystem::remove(binaryPath);
+}
@@ -20,6 +20,10 @@ public:
     static void sqDistanceFromTest();
 
     static void pointDistanceTest();
+
+    static void workloadTest();
+
+    static void pointIOTest();
 };
 
 